@@ -33,6 +33,7 @@ DECLARE_HUD_MESSAGE( CHudProgressBars, AddProgressBar );
 DECLARE_HUD_MESSAGE( CHudProgressBars, RemoveProgressBar );
 DECLARE_HUD_MESSAGE( CHudProgressBars, UpdateProgressBar );
 DECLARE_HUD_MESSAGE( CHudProgressBars, ConfigProgressBar );
+DECLARE_HUD_MESSAGE( CHudProgressBars, ProgressBarBatch );
 
 char *CleanupFloatText( char *str )
 {
@@ -94,6 +95,7 @@ CHudProgressBars::CHudProgressBars( const char *pElementName ) :
 	HOOK_HUD_MESSAGE( CHudProgressBars, RemoveProgressBar );
 	HOOK_HUD_MESSAGE( CHudProgressBars, UpdateProgressBar );
 	HOOK_HUD_MESSAGE( CHudProgressBars, ConfigProgressBar );
+	HOOK_HUD_MESSAGE( CHudProgressBars, ProgressBarBatch );
 }
 
 CHudProgressBars::~CHudProgressBars()
@@ -233,10 +235,59 @@ void CHudProgressBars::MsgFunc_UpdateProgressBar( bf_read &msg )
 	if ( id < 0 )
 		return;
 
+	SetProgressBarValue( id % GE_HUD_NUMPROGRESSBARS, msg.ReadFloat() );
+}
+
+void CHudProgressBars::MsgFunc_ConfigProgressBar( bf_read &msg )
+{
+	int id = msg.ReadByte();
+	if ( id < 0 )
+		return;
 	id %= GE_HUD_NUMPROGRESSBARS;
 
+	// Setup the title text
+	char title[64];
+	msg.ReadString( title, 64 );
+
+	// Check if we sent a color update
+	int iColor;
+	msg.ReadBits( &iColor, 32 );
+
+	SetProgressBarConfig( id, title, iColor );
+}
+
+// The server coalesces value and config updates for a frame into one message
+void CHudProgressBars::MsgFunc_ProgressBarBatch( bf_read &msg )
+{
+	int count = msg.ReadByte();
+	for ( int i=0; i < count; i++ )
+	{
+		int id = msg.ReadByte() % GE_HUD_NUMPROGRESSBARS;
+		int flags = msg.ReadByte();
+
+		if ( flags & 0x1 )
+			SetProgressBarValue( id, msg.ReadFloat() );
+
+		if ( flags & 0x6 )
+		{
+			// Fields that weren't sent use the usual "do not update" markers
+			char title[64] = "\r";
+			if ( flags & 0x2 )
+				msg.ReadString( title, 64 );
+
+			int iColor = 0;
+			if ( flags & 0x4 )
+				msg.ReadBits( &iColor, 32 );
+
+			SetProgressBarConfig( id, title, iColor );
+		}
+	}
+}
+
+void CHudProgressBars::SetProgressBarValue( int id, float value )
+{
 	sProgressBar *bar = m_vProgressBars[id];
-	bar->currValue = msg.ReadFloat();
+	bar->currValue = value;
 
 	// Set the progress indicator
 	if ( bar->flags & 0x1 )
@@ -253,20 +304,11 @@ void CHudProgressBars::MsgFunc_UpdateProgressBar( bf_read &msg )
 	}
 }
 
-void CHudProgressBars::MsgFunc_ConfigProgressBar( bf_read &msg )
+void CHudProgressBars::SetProgressBarConfig( int id, const char *title, int iColor )
 {
-	int id = msg.ReadByte();
-	if ( id < 0 )
-		return;
-	id %= GE_HUD_NUMPROGRESSBARS;
-
 	sProgressBar *bar = m_vProgressBars[id];
 	int orig_width = bar->pTitle->GetWide();
 
-	// Setup the title text
-	char title[64];
-	msg.ReadString( title, 64 );
-
 	// Check string update, '\r' indicates do not update
 	if ( title[0] != '\r' )
 	{
@@ -279,10 +321,6 @@ void CHudProgressBars::MsgFunc_ConfigProgressBar( bf_read &msg )
 			InvalidateLayout();
 	}
 
-	// Check if we sent a color update
-	int iColor;
-	msg.ReadBits( &iColor, 32 );
-
 	if ( iColor != 0 )
 	{
 		Color fgColor, bgColor;
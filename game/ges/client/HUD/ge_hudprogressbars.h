@@ -14,8 +14,7 @@
 #include "hudelement.h"
 #include <vgui_controls/label.h>
 #include <vgui_controls/ProgressBar.h>
-
-#define GE_HUD_NUMPROGRESSBARS 8
+#include "ge_shareddefs.h"
 
 struct sProgressBar
 {
@@ -50,11 +49,14 @@ public:
 	void MsgFunc_RemoveProgressBar( bf_read &msg );
 	void MsgFunc_UpdateProgressBar( bf_read &msg );
 	void MsgFunc_ConfigProgressBar( bf_read &msg );
+	void MsgFunc_ProgressBarBatch( bf_read &msg );
 
 protected:
 	virtual void PerformLayout();
 	virtual void ResetProgressBar( int id );
 	virtual void LayoutProgressBar( int id );
+	virtual void SetProgressBarValue( int id, float value );
+	virtual void SetProgressBarConfig( int id, const char *title, int iColor );
 	virtual void ApplySchemeSettings( vgui::IScheme *pScheme );
 
 private:
@@ -42,13 +42,70 @@ struct CGERadarContact
 	CHudTexture	*m_IconBelow;
 	Color	m_ColorOverride;
 	int		m_iType;			// What are we?
-	bool	m_bAlwaysVisible;	// Used by Python if we want to ignore the max distance
+	int		m_iTeam;			// Networked team of the contact
+	bool	m_bForceVisible;	// Used by Python if we want to ignore the max distance
+	bool	m_bAlwaysVisible;	// Forced visible or camping hard enough to be seen anywhere
 	int		m_iCampingPercent;	// For player types only
+	Vector	m_vOrigin;			// Last networked world position
 	Vector	m_vScaledPos;		// World to Radar scaled position
 	float	m_flAlphaMod;		// Modulation on the alpha based on position to player [0-1.0]
 	float	m_flBlinkMod;		// Modulation of the camping blink [0-1.0]
 };
 
+// Unordered set of radar slots that can be walked densely
+struct CGERadarSlotList
+{
+	CGERadarSlotList() {
+		m_iCount = 0;
+		for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+			m_iPos[i] = -1;
+	}
+
+	int Count( void ) { return m_iCount; }
+	int operator[]( int i ) { return m_iSlots[i]; }
+	bool Has( int slot ) { return m_iPos[slot] != -1; }
+
+	void Add( int slot ) {
+		if ( Has( slot ) )
+			return;
+		m_iPos[slot] = m_iCount;
+		m_iSlots[m_iCount++] = slot;
+	}
+
+	// Moves the last slot into the hole so removal is constant time
+	void Remove( int slot ) {
+		int pos = m_iPos[slot];
+		if ( pos == -1 )
+			return;
+		int last = m_iSlots[--m_iCount];
+		m_iSlots[pos] = last;
+		m_iPos[last] = pos;
+		m_iPos[slot] = -1;
+	}
+
+	void RemoveAll( void ) {
+		for ( int i=0; i < m_iCount; ++i )
+			m_iPos[ m_iSlots[i] ] = -1;
+		m_iCount = 0;
+	}
+
+	int m_iSlots[ MAX_NET_RADAR_ENTS ];
+	int m_iPos[ MAX_NET_RADAR_ENTS ];
+	int m_iCount;
+};
+
+// Everything about the local player that decides what and where we draw
+struct CGERadarView
+{
+	Vector	vOrigin;
+	float	flYaw;				// Radians
+	float	flRange;
+	int		iLocalSerial;
+	int		iObserverSerial;
+	int		iTeam;
+	bool	bHideEnemies;
+};
+
 class CGERadar : public CHudElement, public vgui::Panel
 {
 public:
@@ -65,11 +122,6 @@ public:
 	virtual void OnThink( void );
 	virtual void Paint( void );
 	
-	void UpdateContact( int iEntSerial, int type, bool bAlwaysVisible = false, Color colOverride = Color(0,0,0,0) );
-	void ValidateContacts();
-
-	int FindContact( int iEntSerial );
-	
 	virtual void FireGameEvent( IGameEvent *event );
 
 	void ClearAllContacts();
@@ -80,24 +132,32 @@ public:
 	static Color	s_ColorMI6;
 
 private:
+	void BuildView( C_BasePlayer *pLocalPlayer, CGERadarView &view );
+
+	void SyncContact( int slot, int flags );
+	void EvaluateContact( int slot );
 	void WorldToRadar( CGERadarContact *contact );
 
-	bool IsContactCamping( int iEntSerial );
-	bool IsContactInRange( const Vector location );
+	bool IsContactAllowed( CGERadarContact *contact );
 	bool IsContactInRange( CGERadarContact *contact );
-	float GetContactRange( const Vector location );
-	Vector GetContactPosition( CGERadarContact *contact );
-	float GetRadarRange( void );
+	float GetRadarRange( C_BasePlayer *pLocalPlayer );
 	void ResolveContactIcons( const char *szIcon, CGERadarContact *contact );
 
-	void MoveContact( int oldpos, int newpos );
+	void DropContact( int slot );
 	void ResetContact( int pos );
 
 	void DrawIconOnRadar( CGERadarContact *contact, Color col );
 
 private:
+	// Indexed by radar resource slot
 	CGERadarContact	m_radarContacts[ MAX_NET_RADAR_ENTS ];
-	int				m_iNumContacts;
+
+	CGERadarSlotList m_Tracked;		// Slots holding an entity the server wants drawn
+	CGERadarSlotList m_Visible;		// Tracked slots that made it on to our radar, in draw order
+	CGERadarSlotList m_Pending;		// Slots to reevaluate this think
+
+	CGERadarView	m_View;
+	bool			m_bResync;		// Pull every slot from the resource on the next think
 
 	float			m_flNextThink;
 
@@ -201,6 +261,9 @@ CGERadar::CGERadar( const char *pElementName ) :
 	m_iSideBuff = 8;
 	m_flRadarDiameter = 1.0f;
 
+	memset( &m_View, 0, sizeof(m_View) );
+	ClearAllContacts();
+
 	ListenForGameEvent( "round_start" );
 	ListenForGameEvent( "player_team" );
 }
@@ -314,7 +377,8 @@ void CGERadar::OnThink( void )
 		return;
 
 	// Don't worry about the radar if we don't even have a resource!
-	if ( !g_RR )
+	C_BasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
+	if ( !g_RR || !pLocalPlayer )
 	{
 		ThinkAdvance( 0.5f );
 		return;
@@ -328,154 +392,149 @@ void CGERadar::OnThink( void )
 		return;
 	}
 
-	CBasePlayer *pLocalPlayer = CBasePlayer::GetLocalPlayer();
+	CGERadarView view;
+	BuildView( pLocalPlayer, view );
 
-	// Go through our Radar Resource to get any new entities / updates to existing ones
-	int iEntSerial;
-	int iLocalSerial = pLocalPlayer->GetRefEHandle().ToInt();
-	for( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
-	{
-		iEntSerial = g_RR->GetEntSerial(i);
-		if ( iEntSerial != INVALID_EHANDLE_INDEX && g_RR->GetState(i) == RADAR_STATE_DRAW )
-		{
-			// Don't add enemy teams if the convar isn't set
-			if ( GEMPRules()->IsTeamplay() && !ge_radar_showenemyteam.GetBool() && g_RR->GetEntTeam(i) != pLocalPlayer->GetTeamNumber() && g_RR->GetType(i) == RADAR_TYPE_PLAYER )
-				continue;
+	// Anything that changes which contacts we filter out means every slot needs another look
+	bool bFilterChanged = m_bResync || view.iLocalSerial != m_View.iLocalSerial || view.iObserverSerial != m_View.iObserverSerial
+							|| view.iTeam != m_View.iTeam || view.bHideEnemies != m_View.bHideEnemies;
 
-			// Don't add yourself
-			if ( iEntSerial == iLocalSerial )
-				continue;
-
-			// Don't add the current observed target
-			if ( pLocalPlayer->IsObserver() && pLocalPlayer->GetObserverTarget() )
-			{
-				if ( pLocalPlayer->GetObserverTarget()->GetRefEHandle().ToInt() == iEntSerial )
-					continue;
-			}
+	// If we moved or turned every contact has to be transformed again
+	bool bViewChanged = bFilterChanged || view.vOrigin != m_View.vOrigin || view.flYaw != m_View.flYaw || view.flRange != m_View.flRange;
 
-			// DO LATER:
-			// Don't show contacts the gamerules say we shouldn't.
+	m_View = view;
 
+	// Always drain the resource so we don't see stale changes after a resync
+	int slots[ MAX_NET_RADAR_ENTS ], flags[ MAX_NET_RADAR_ENTS ];
+	int count = g_RR->ConsumeChanges( slots, flags );
 
+	if ( bFilterChanged )
+	{
+		m_bResync = false;
+		for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+			SyncContact( i, RADAR_CHANGE_INFO | RADAR_CHANGE_ORIGIN );
+	}
+	else
+	{
+		for ( int i=0; i < count; ++i )
+			SyncContact( slots[i], flags[i] );
+	}
 
-			// Never add a contact that is out of range initially or set to not draw on the radar (don't include campers!)
-			if ( !g_RR->GetAlwaysVisible(i) && !IsContactCamping(iEntSerial) && !IsContactInRange(g_RR->GetOrigin(i)) )
-				continue;
-
-			UpdateContact( iEntSerial, g_RR->GetType(i), g_RR->GetAlwaysVisible(i), g_RR->GetColor(i) );
+	// Camping lives in the player resource so we have to poll it
+	for ( int i=0; i < m_Tracked.Count(); ++i )
+	{
+		CGERadarContact *pContact = &m_radarContacts[ m_Tracked[i] ];
+		int percent = GEPlayerRes()->GetCampingPercent( pContact->GetEntindex() );
+		if ( percent != pContact->m_iCampingPercent )
+		{
+			pContact->m_iCampingPercent = percent;
+			m_Pending.Add( m_Tracked[i] );
 		}
 	}
 
-	ValidateContacts();
+	if ( bViewChanged )
+	{
+		for ( int i=0; i < m_Tracked.Count(); ++i )
+			EvaluateContact( m_Tracked[i] );
+	}
+	else
+	{
+		for ( int i=0; i < m_Pending.Count(); ++i )
+			EvaluateContact( m_Pending[i] );
+	}
+
+	m_Pending.RemoveAll();
 
 	ThinkAdvance( 0.025f );
 }
 
+void CGERadar::BuildView( C_BasePlayer *pLocalPlayer, CGERadarView &view )
+{
+	view.vOrigin = pLocalPlayer->GetAbsOrigin();
+	view.flRange = GetRadarRange( pLocalPlayer );
+	view.iLocalSerial = pLocalPlayer->GetRefEHandle().ToInt();
+	view.iTeam = pLocalPlayer->GetTeamNumber();
+	view.bHideEnemies = GEMPRules()->IsTeamplay() && !ge_radar_showenemyteam.GetBool();
+
+	C_BaseEntity *pTarget = pLocalPlayer->IsObserver() ? pLocalPlayer->GetObserverTarget() : NULL;
+	view.iObserverSerial = pTarget ? pTarget->GetRefEHandle().ToInt() : INVALID_EHANDLE_INDEX;
+
+	// If we're in first person spectate mode we should use the rotation of whoever we're spectating.
+	if ( pTarget && pLocalPlayer->GetObserverMode() == OBS_MODE_IN_EYE )
+		view.flYaw = (pLocalPlayer->GetLocalAngles().y * M_PI) * 0.0055555f;
+	else
+		view.flYaw = (pLocalPlayer->LocalEyeAngles().y * M_PI) * 0.0055555f;
+}
+
 //---------------------------------------------------------
-// Purpose: Register a radar contact in the list of contacts
+// Purpose: Pull the networked state of a radar slot into
+//			our contact table
 //---------------------------------------------------------
-void CGERadar::UpdateContact( int iEntSerial, int type, bool bAlwaysVisible /*= false*/, Color colOverride /*= Color(0,0,0)*/ )
+void CGERadar::SyncContact( int slot, int flags )
 {
-	// Never add the local player, and don't overflow the buffer
-	if( m_iNumContacts == MAX_NET_RADAR_ENTS )
-		return;
-
-	// See if we already have him in the list, if so update the information
-	int id = FindContact( iEntSerial );
+	CGERadarContact *pContact = &m_radarContacts[slot];
 
-	// If this is a new contact add it to the end of the list
-	if( id == -1 )
+	if ( flags & RADAR_CHANGE_INFO )
 	{
-		id = m_iNumContacts;
-		m_iNumContacts++;
-	}
-	
-	ResolveContactIcons( g_RR->GetIcon( g_RR->FindEntityIndex(iEntSerial) ), &m_radarContacts[id] );
+		int iEntSerial = g_RR->GetEntSerial( slot );
+		if ( iEntSerial == INVALID_EHANDLE_INDEX || g_RR->GetState( slot ) != RADAR_STATE_DRAW )
+		{
+			DropContact( slot );
+			return;
+		}
 
-	m_radarContacts[id].m_iSerial = iEntSerial;
-	m_radarContacts[id].m_iType = type;
-	m_radarContacts[id].m_ColorOverride = colOverride;
+		pContact->m_iSerial = iEntSerial;
+		pContact->m_iType = g_RR->GetType( slot );
+		pContact->m_iTeam = g_RR->GetEntTeam( slot );
+		pContact->m_bForceVisible = g_RR->GetAlwaysVisible( slot );
+		pContact->m_ColorOverride = g_RR->GetColor( slot );
+		pContact->m_vOrigin = g_RR->GetOrigin( slot );
+		pContact->m_iCampingPercent = GEPlayerRes()->GetCampingPercent( pContact->GetEntindex() );
+		ResolveContactIcons( g_RR->GetIcon( slot ), pContact );
 
-	// Resolve their scaled position on the radar
-	WorldToRadar( &m_radarContacts[id] );
+		m_Tracked.Add( slot );
+	}
+	else if ( m_Tracked.Has( slot ) )
+	{
+		pContact->m_vOrigin = g_RR->GetOrigin( slot );
+	}
+	else
+	{
+		// Moving around while not drawn, don't care
+		return;
+	}
 
-	// For camping checks
-	m_radarContacts[id].m_iCampingPercent = GEPlayerRes()->GetCampingPercent( m_radarContacts[id].GetEntindex() );
-	m_radarContacts[id].m_bAlwaysVisible = (m_radarContacts[id].m_iCampingPercent >= RADAR_CAMP_ALLVIS_PERCENT) ? true : bAlwaysVisible;
+	m_Pending.Add( slot );
 }
 
 //---------------------------------------------------------
-// Purpose: Go through all client known radar targets and see if any
-//			are too far away to show. If yes, remove them from the
-//			list.
+// Purpose: Decide if a tracked contact belongs on the radar
+//			and if so where
 //---------------------------------------------------------
-void CGERadar::ValidateContacts()
+void CGERadar::EvaluateContact( int slot )
 {
-	// Nothing to do without the radar resource
-	if ( !g_RR )
-		return;
+	CGERadarContact *pContact = &m_radarContacts[slot];
 
-	bool bRemove = false;
-	CBasePlayer *pLocalPlayer = CBasePlayer::GetLocalPlayer();
-	CGERadarContact *pContact;
-	int index = -1;
+	pContact->m_bAlwaysVisible = pContact->m_bForceVisible || pContact->m_iCampingPercent >= RADAR_CAMP_ALLVIS_PERCENT;
 
-	// Loop through all our contacts and remove the ones that are out of range
-	for( int i = 0 ; i < m_iNumContacts ; i++ )
+	if ( !IsContactAllowed( pContact ) || !IsContactInRange( pContact ) )
 	{
-		bRemove = false;
-
-		pContact = &m_radarContacts[i];
-		index = g_RR->FindEntityIndex( pContact->m_iSerial );
-
-		if ( index != -1 && pContact->m_iSerial != INVALID_EHANDLE_INDEX )
-		{
-			// Update state and visibility
-			if( g_RR->GetState(index) != RADAR_STATE_DRAW || !IsContactInRange( pContact ) )
-				bRemove = true;
-
-			// Update team status
-			if ( pContact->m_iType == RADAR_TYPE_PLAYER )
-			{
-				// Make sure we haven't changed teams and are tracking this sort of thing
-				if ( GEMPRules()->IsTeamplay() && !ge_radar_showenemyteam.GetBool() && g_RR->GetEntTeam(index) != pLocalPlayer->GetTeamNumber() )
-					bRemove = true;
+		m_Visible.Remove( slot );
+		return;
+	}
 
-				// Remove the currently observed target
-				if ( pLocalPlayer->IsObserver() && pLocalPlayer->GetObserverTarget() )
-				{
-					if ( pLocalPlayer->GetObserverTarget()->GetRefEHandle().ToInt() == pContact->m_iSerial )
-						bRemove = true;
-				}
-			}
-		}
-		else
-			bRemove = true;
+	m_Visible.Add( slot );
 
-		if ( bRemove )
-		{
-			// Time for this guy to go. Easiest thing is just to copy the last element 
-			// into this element's spot and then decrement the count of entities.
-			// We also decrement our current index so we can check this new guy next
-			MoveContact( --m_iNumContacts, i-- );
-		}
-	} 
+	// Resolve their scaled position on the radar
+	WorldToRadar( pContact );
 }
 
 void CGERadar::WorldToRadar( CGERadarContact *contact )
 {
-	// If we are out of range don't bother
-	if ( !IsContactInRange( contact ) )
-		return;
-
-	C_BasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
-	if ( !pLocalPlayer )
-		return;
-
-	Vector vContact = GetContactPosition(contact);
+	const Vector &vContact = contact->m_vOrigin;
 
-	float x_diff = vContact.x - pLocalPlayer->GetAbsOrigin().x;
-	float y_diff = vContact.y - pLocalPlayer->GetAbsOrigin().y;
+	float x_diff = vContact.x - m_View.vOrigin.x;
+	float y_diff = vContact.y - m_View.vOrigin.y;
 
 	// Supply epsilon values to avoid divide-by-zero
 	if(x_diff == 0.0f )
@@ -485,18 +544,11 @@ void CGERadar::WorldToRadar( CGERadarContact *contact )
 		y_diff = 0.001f;
 
 	float fRadarRadius = m_flRadarDiameter * 0.500f;
-	float fRange = GetRadarRange();
+	float fRange = m_View.flRange;
 	float fScale = fRange >= 1.000f ? fRadarRadius / fRange : 0.000f;
-	float dist = min( GetContactRange( vContact ), fRange );
+	float dist = min( (vContact - m_View.vOrigin).Length2D(), fRange );
 
 	float flOffset = atan(y_diff/x_diff);
-	float flPlayerY;
-
-	// If we're in first person spectate mode we should use the rotation of whoever we're spectating.
-	if (pLocalPlayer->IsObserver() && pLocalPlayer->GetObserverTarget() && pLocalPlayer->GetObserverMode() == OBS_MODE_IN_EYE)
-		flPlayerY = (pLocalPlayer->GetLocalAngles().y * M_PI) * 0.0055555f;
-	else
-		flPlayerY = (pLocalPlayer->LocalEyeAngles().y * M_PI) * 0.0055555f;
 
 	// Always add because atan will return neg angle w/ neg coeff
 	if ( x_diff < 0 )
@@ -504,7 +556,7 @@ void CGERadar::WorldToRadar( CGERadarContact *contact )
 	else
 		flOffset += M_TWOPI;
 
-	flOffset = flPlayerY - flOffset;
+	flOffset = m_View.flYaw - flOffset;
 
 	// Transform relative to radar source
 	float xnew_diff = dist * sin(flOffset);
@@ -517,7 +569,7 @@ void CGERadar::WorldToRadar( CGERadarContact *contact )
 	// Make sure we never leave our radar circle!
 	contact->m_vScaledPos.x = fRadarRadius + xnew_diff + m_iSideBuff;
 	contact->m_vScaledPos.y = fRadarRadius + ynew_diff + m_iSideBuff;
-	contact->m_vScaledPos.z = vContact.z - pLocalPlayer->GetAbsOrigin().z;
+	contact->m_vScaledPos.z = vContact.z - m_View.vOrigin.z;
 
 	// Figure out our alpha modulation
 	if ( !contact->m_bAlwaysVisible && dist > fRange * 0.8f )
@@ -545,10 +597,10 @@ void CGERadar::Paint()
 
 	// Now go through the list of radar targets and represent them on the radar screen
 	// by drawing their icons on top of the background.
-	for( int i = 0 ; i < m_iNumContacts ; i++ )
+	for( int i = 0 ; i < m_Visible.Count() ; i++ )
 	{
 		int alpha = 140;
-		CGERadarContact *pContact = &m_radarContacts[ i ];
+		CGERadarContact *pContact = &m_radarContacts[ m_Visible[i] ];
 		
 		Color col( 255, 255, 255, 255 );
 		if ( pContact->m_iType == RADAR_TYPE_PLAYER )
@@ -677,19 +729,17 @@ void CGERadar::DrawIconOnRadar( CGERadarContact *contact, Color col )
 	}
 }
 
-bool CGERadar::IsContactCamping( int iEntSerial )
+bool CGERadar::IsContactAllowed( CGERadarContact *contact )
 {
-	int index = iEntSerial & ((1 << MAX_EDICT_BITS) - 1);
-	return GEPlayerRes()->GetCampingPercent( index ) >= RADAR_CAMP_ALLVIS_PERCENT;
-}
+	// Don't add yourself or the current observed target
+	if ( contact->m_iSerial == m_View.iLocalSerial || contact->m_iSerial == m_View.iObserverSerial )
+		return false;
 
-bool CGERadar::IsContactInRange( const Vector location )
-{
-	C_BasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
-	if ( !pLocalPlayer )
+	// Don't add enemy teams if the convar isn't set
+	if ( m_View.bHideEnemies && contact->m_iType == RADAR_TYPE_PLAYER && contact->m_iTeam != m_View.iTeam )
 		return false;
 
-	return location.DistTo( pLocalPlayer->GetAbsOrigin() ) < GetRadarRange();
+	return true;
 }
 
 bool CGERadar::IsContactInRange( CGERadarContact *contact )
@@ -697,30 +747,11 @@ bool CGERadar::IsContactInRange( CGERadarContact *contact )
 	if ( contact->m_bAlwaysVisible )
 		return true;
 
-	return IsContactInRange( GetContactPosition(contact) );
-}
-
-float CGERadar::GetContactRange( const Vector location )
-{
-	C_BasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
-	if ( !pLocalPlayer )
-		return false;
-	Vector dist = pLocalPlayer->GetAbsOrigin() - location;
-
-	return dist.Length2D();
-}
-
-Vector CGERadar::GetContactPosition( CGERadarContact *contact )
-{
-	if ( !contact || !g_RR )
-		return vec3_origin;
-
-	return g_RR->GetOrigin( g_RR->FindEntityIndex( contact->m_iSerial ) );
+	return contact->m_vOrigin.DistTo( m_View.vOrigin ) < m_View.flRange;
 }
 
-float CGERadar::GetRadarRange( void )
+float CGERadar::GetRadarRange( C_BasePlayer *pLocalPlayer )
 {
-	CBasePlayer *pLocalPlayer = CBasePlayer::GetLocalPlayer();
 	float flMod = g_RR->GetRangeModifier( g_RR->FindEntityIndex( pLocalPlayer->GetRefEHandle().ToInt() ) );
 	return ge_radar_range.GetFloat() * flMod;
 }
@@ -813,39 +844,13 @@ void CGERadar::ResolveContactIcons( const char *szIcon, CGERadarContact *contact
 	}
 }
 
-//---------------------------------------------------------
-// Purpose: Search the contact list for a specific contact
-//---------------------------------------------------------
-int CGERadar::FindContact( int iEntSerial )
-{
-	for( int i = 0 ; i < m_iNumContacts ; i++ )
-	{
-		if( m_radarContacts[i].m_iSerial == iEntSerial )
-			return i;
-	}
-
-	return -1;
-}
-
-void CGERadar::MoveContact( int oldpos, int newpos )
+void CGERadar::DropContact( int slot )
 {
-	if ( oldpos < 0 || oldpos >= MAX_NET_RADAR_ENTS )
-		return;
-	if ( newpos < 0 || newpos >= MAX_NET_RADAR_ENTS )
-		return;
+	m_Tracked.Remove( slot );
+	m_Visible.Remove( slot );
+	m_Pending.Remove( slot );
 
-	m_radarContacts[newpos].m_iSerial = m_radarContacts[oldpos].m_iSerial;
-	m_radarContacts[newpos].m_iType = m_radarContacts[oldpos].m_iType;
-	m_radarContacts[newpos].m_bAlwaysVisible = m_radarContacts[oldpos].m_bAlwaysVisible;
-	m_radarContacts[newpos].m_ColorOverride = m_radarContacts[oldpos].m_ColorOverride;
-	m_radarContacts[newpos].m_iCampingPercent = m_radarContacts[oldpos].m_iCampingPercent;
-	m_radarContacts[newpos].m_Icon = m_radarContacts[oldpos].m_Icon;
-	m_radarContacts[newpos].m_IconAbove = m_radarContacts[oldpos].m_IconAbove;
-	m_radarContacts[newpos].m_IconBelow = m_radarContacts[oldpos].m_IconBelow;
-	m_radarContacts[newpos].m_vScaledPos = m_radarContacts[oldpos].m_vScaledPos;
-	m_radarContacts[newpos].m_flAlphaMod = m_radarContacts[oldpos].m_flAlphaMod;
-
-	ResetContact( oldpos );
+	ResetContact( slot );
 }
 
 void CGERadar::ClearAllContacts( void )
@@ -853,7 +858,12 @@ void CGERadar::ClearAllContacts( void )
 	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
 		ResetContact(i);
 
-	m_iNumContacts = 0;
+	m_Tracked.RemoveAll();
+	m_Visible.RemoveAll();
+	m_Pending.RemoveAll();
+
+	// Start over from whatever the resource has right now
+	m_bResync = true;
 }
 
 void CGERadar::ResetContact( int pos )
@@ -863,12 +873,15 @@ void CGERadar::ResetContact( int pos )
 
 	m_radarContacts[pos].m_iSerial = INVALID_EHANDLE_INDEX;
 	m_radarContacts[pos].m_iType = 0;
+	m_radarContacts[pos].m_iTeam = TEAM_UNASSIGNED;
+	m_radarContacts[pos].m_bForceVisible = false;
 	m_radarContacts[pos].m_bAlwaysVisible = false;
 	m_radarContacts[pos].m_ColorOverride = Color(0,0,0,0);
 	m_radarContacts[pos].m_iCampingPercent = 0;
 	m_radarContacts[pos].m_Icon = NULL;
 	m_radarContacts[pos].m_IconAbove = NULL;
 	m_radarContacts[pos].m_IconBelow = NULL;
+	m_radarContacts[pos].m_vOrigin = vec3_origin;
 	m_radarContacts[pos].m_vScaledPos = vec3_origin;
 	m_radarContacts[pos].m_flAlphaMod = 1.0f;
 	m_radarContacts[pos].m_flBlinkMod = 0;
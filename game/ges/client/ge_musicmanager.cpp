@@ -26,6 +26,9 @@ using namespace FMOD;
 
 #define GE_MUSIC_DEFAULTSCAPE	"__default__"
 #define FMOD_TRANSITION_TIME	1.5f
+#define FMOD_PREFETCH_TIME		10.0f	// Seconds before the end of a song that we start opening the next one
+#define FMOD_FADE_INTERVAL		20		// Milliseconds between fade steps
+#define FMOD_UPDATE_INTERVAL	1000	// Longest we let FMOD go without an update while playing
 #define CurrTime()				Plat_FloatTime()
 #define FMOD_CALL(call)			{FMOD_RESULT r = call; if ( r != FMOD_OK ) { DevMsg( "[FMOD] Error Code %i\n", r ); }}
 
@@ -67,24 +70,23 @@ void GEMusicVolume_Callback( IConVar *var, const char *pOldString, float flOldVa
 // CGEMusicManager
 // -----------------------
 
-CGEMusicManager::CGEMusicManager() : CAutoGameSystem( "GEMusicManager" )
+CGEMusicManager::CGEMusicManager() : CAutoGameSystemPerFrame( "GEMusicManager" )
 {
 	g_pGEMusicManager = this;
 	m_bRun = false;
 	m_bFMODRunning = false;
-	m_bLoadPlaylist = false;
-	m_bVolumeDirty = true;
 	m_iState = STATE_STOPPED;
 
 	m_szPlayList[0] = '\0';
-	// Start off with the default soundscape
-	Q_strncpy( m_szSoundscape, GE_MUSIC_DEFAULTSCAPE, 64 );
+	m_bInFocus = true;
 
 	m_CurrPlaylist = NULL;
+	m_nCurrSongIdx = -1;
 
 	m_fVolume = 1.0f;
 	m_fNextSongTime = 0;
 	m_fFadeStartTime = 0;
+	m_fPauseTime = 0;
 	m_iCurrSongLength = 0;
 
 	m_iFadeMode = FADE_NONE;
@@ -92,6 +94,10 @@ CGEMusicManager::CGEMusicManager() : CAutoGameSystem( "GEMusicManager" )
 	m_fFadeInPercent = 0;
 	m_fFadeOutPercent = 0;
 
+	m_pNextSound = NULL;
+	m_pNextPlaylist = NULL;
+	m_nNextSongIdx = -1;
+
 	m_pLastSong = NULL;
 	m_pCurrSong = NULL;
 
@@ -113,6 +119,12 @@ CGEMusicManager::~CGEMusicManager()
 	g_pGEMusicManager = NULL;
 }
 
+void CGEMusicManager::StopThread()
+{
+	m_bRun = false;
+	m_Wake.Set();
+}
+
 void CGEMusicManager::PostInit()
 {
 	ConVar *pVol = g_pCVar->FindVar( "snd_musicvolume" );
@@ -129,13 +141,41 @@ void CGEMusicManager::LevelInitPreEntity()
 	LoadPlayList( levelname );
 }
 
+void CGEMusicManager::Update( float frametime )
+{
+	// If we are on windows (why wouldn't we be?) check if we are the active window,
+	// the music thread only hears about it when it changes
+#ifdef _WIN32
+	bool bInFocus = GetForegroundWindow() == gWindowHandle;
+	if ( bInFocus != m_bInFocus )
+	{
+		m_bInFocus = bInFocus;
+		PostCommand( CMD_FOCUS, NULL, bInFocus ? 1.0f : 0 );
+	}
+#endif
+}
+
+void CGEMusicManager::PostCommand( int command, const char *arg /*= NULL*/, float value /*= 0*/ )
+{
+	m_Lock.Lock();
+
+	MusicCommand_t &cmd = m_Commands[ m_Commands.AddToTail() ];
+	cmd.iCommand = command;
+	Q_strncpy( cmd.szArg, arg ? arg : "", sizeof(cmd.szArg) );
+	cmd.fValue = value;
+
+	m_Lock.Unlock();
+
+	m_Wake.Set();
+}
+
 void CGEMusicManager::LoadPlayList( const char *levelname )
 {
 	// Only load a new playlist if it is different than the current
 	if ( Q_stricmp(levelname, m_szPlayList) )
 	{
 		Q_strncpy( m_szPlayList, levelname, sizeof(m_szPlayList) );
-		m_bLoadPlaylist = true;
+		PostCommand( CMD_PLAYLIST, levelname );
 	}
 }
 
@@ -154,44 +194,103 @@ void CGEMusicManager::ClearPlayList( void )
 
 void CGEMusicManager::SetSoundscape( const char *soundscape )
 {
-	m_Lock.Lock();
-
-	Q_strncpy( m_szSoundscape, soundscape, 64 );
-	m_bLoadSoundscape = true;
-
-	m_Lock.Unlock();
+	PostCommand( CMD_SOUNDSCAPE, soundscape );
 }
 
 void CGEMusicManager::SetVolume( float vol )
 {
-	m_fVolume = clamp( vol, 0, 1.0f );
-	m_bVolumeDirty = true;
+	PostCommand( CMD_VOLUME, NULL, clamp( vol, 0, 1.0f ) );
 }
 
 void CGEMusicManager::PauseMusic()
 {
-	if ( m_iState == STATE_PLAYING )
-	{
-		m_iState = STATE_PAUSED;
-		StartFade( FADE_OUT );
-		m_fPauseTime = CurrTime();
-		DevMsg( 2, "[FMOD] Music Paused\n" );
-	}
+	PostCommand( CMD_PAUSE );
 }
 
 void CGEMusicManager::ResumeMusic()
 {
-	if ( m_iState == STATE_PAUSED )
+	PostCommand( CMD_RESUME );
+}
+
+void CGEMusicManager::ProcessCommands()
+{
+	CUtlVector<MusicCommand_t> commands;
+
+	m_Lock.Lock();
+	commands.Swap( m_Commands );
+	m_Lock.Unlock();
+
+	for ( int i=0; i < commands.Count(); i++ )
 	{
-		if ( m_fNextSongTime > 0 )
-			m_fNextSongTime += (CurrTime() - m_fPauseTime);
+		const MusicCommand_t &cmd = commands[i];
 
-		m_iState = STATE_UNPAUSE;
-		StartFade( FADE_IN );
-		DevMsg( 2, "[FMOD] Music Resumed\n" );
+		switch ( cmd.iCommand )
+		{
+		case CMD_PLAYLIST:
+			InternalLoadPlaylist( cmd.szArg );
+			break;
+
+		case CMD_SOUNDSCAPE:
+			InternalLoadSoundscape( cmd.szArg );
+			break;
+
+		case CMD_VOLUME:
+			m_fVolume = cmd.fValue;
+			m_pMasterChannel->setVolume( m_fVolume );
+			break;
+
+		case CMD_PAUSE:
+			if ( m_iState == STATE_PLAYING )
+			{
+				m_iState = STATE_PAUSED;
+				StartFade( FADE_OUT );
+				m_fPauseTime = CurrTime();
+				DevMsg( 2, "[FMOD] Music Paused\n" );
+			}
+			break;
+
+		case CMD_RESUME:
+			if ( m_iState == STATE_PAUSED )
+			{
+				if ( m_fNextSongTime > 0 )
+					m_fNextSongTime += (CurrTime() - m_fPauseTime);
+
+				m_iState = STATE_UNPAUSE;
+				StartFade( FADE_IN );
+				DevMsg( 2, "[FMOD] Music Resumed\n" );
+			}
+			break;
+
+		case CMD_NEXTSONG:
+			m_fNextSongTime = 0;
+			break;
+
+		case CMD_FOCUS:
+			m_pMasterChannel->setMute( cmd.fValue == 0 );
+			break;
+		}
 	}
 }
 
+unsigned int CGEMusicManager::GetWaitTime()
+{
+	// Fades are the only thing that need a steady tick
+	if ( m_iFadeMode != FADE_NONE )
+		return FMOD_FADE_INTERVAL;
+
+	// Nothing is going to change until someone tells us to do something
+	if ( m_iState != STATE_PLAYING && m_iState != STATE_UNPAUSE )
+		return TT_INFINITE;
+
+	// Otherwise sleep until we need to open or start the next song
+	float wake = m_fNextSongTime;
+	if ( !m_pNextSound )
+		wake -= FMOD_PREFETCH_TIME;
+
+	float wait = (wake - CurrTime()) * 1000.0f;
+	return (unsigned int) clamp( wait, FMOD_FADE_INTERVAL, FMOD_UPDATE_INTERVAL );
+}
+
 int CGEMusicManager::Run()
 {
 	m_bRun = true;
@@ -221,46 +320,43 @@ int CGEMusicManager::Run()
 
 	// Get our master channel group for volume control
 	m_pSystem->getMasterChannelGroup( &m_pMasterChannel );
+	m_pMasterChannel->setVolume( m_fVolume );
 
 	m_bFMODRunning = true;
 
 	while ( m_bRun && m_bFMODRunning )
 	{
-		// Set our volume if needed
-		if ( m_bVolumeDirty )
-		{
-			m_pMasterChannel->setVolume( m_fVolume );
-			m_bVolumeDirty = false;
-		}
+		// Take care of anything the game asked for since we last woke up
+		ProcessCommands();
 
-		// Load the playlist if we need to
-		InternalLoadPlaylist();
+		if ( m_iState != STATE_PAUSED )
+		{
+			// Open the next song in the background a little while before we need it
+			if ( m_iState == STATE_PLAYING && !m_pNextSound && CurrTime() >= m_fNextSongTime - FMOD_PREFETCH_TIME )
+				PrefetchSong();
 
-		// Load the soundscape
-		InternalLoadSoundscape();
+			// Check if we need to go to the next song
+			if ( CurrTime() >= m_fNextSongTime )
+				NextSong();
+		}
 
-		// Check if we need to go to the next song
-		if ( m_iState != STATE_PAUSED && CurrTime() >= m_fNextSongTime )
-			NextSong();
+		// Check fade conditions
+		if ( m_iFadeMode != FADE_NONE )
+			FadeThink();
 
 		// Check pause conditions
 		PauseThink();
 
-		// Check fade conditions
-		FadeThink();
-
-		// See if we are the current active window
-		CheckWindowFocus();
-
 		// Standard FMOD call
 		m_pSystem->update();
 
-		// Sleep for 20 ms for load balancing
-		Sleep( 20 );
+		// Sleep until we are given a command or have something to do
+		m_Wake.Wait( GetWaitTime() );
 	}
 
 	// Close down FMOD
 	m_pMasterChannel->stop();
+	ReleasePrefetch();
 	EndSong( m_pLastSong );
 	EndSong( m_pCurrSong );
 	m_pSystem->release();
@@ -268,20 +364,18 @@ int CGEMusicManager::Run()
 	return 0;
 }
 
-void CGEMusicManager::InternalLoadPlaylist( void )
+void CGEMusicManager::InternalLoadPlaylist( const char *playlist )
 {
-	if ( !m_bLoadPlaylist )
-		return;
-
 	// Clear our playlist and stop playing music now
+	ReleasePrefetch();
 	ClearPlayList();
 
 	// Only load a new list if we are given one
-	if ( m_szPlayList[0] )
+	if ( playlist[0] )
 	{
 		// Try to load the level's music definition
 		char sz[128];
-		Q_snprintf( sz, sizeof(sz), "scripts/music/level_music_%s", m_szPlayList );
+		Q_snprintf( sz, sizeof(sz), "scripts/music/level_music_%s", playlist );
 
 		KeyValues *pKV = ReadEncryptedKVFile( filesystem, sz, NULL );
 		if ( !pKV )
@@ -327,7 +421,6 @@ void CGEMusicManager::InternalLoadPlaylist( void )
 	}
 
 	m_fNextSongTime = 0;
-	m_bLoadPlaylist = false;
 }
 
 void CGEMusicManager::EnforcePlaylist( bool force /*= false*/ )
@@ -340,38 +433,90 @@ void CGEMusicManager::EnforcePlaylist( bool force /*= false*/ )
 	}
 }
 
-void CGEMusicManager::InternalLoadSoundscape()
+void CGEMusicManager::InternalLoadSoundscape( const char *soundscape )
 {
-	if ( m_bLoadSoundscape )
+	// Cache this bad boy away
+	CUtlVector<char*> *oldlist = m_CurrPlaylist;
+
+	int idx = m_Playlists.Find( soundscape );
+	if ( idx != m_Playlists.InvalidIndex() )
+	{
+		// Use the new playlist
+		m_CurrPlaylist = m_Playlists.Element( idx );
+		m_nCurrSongIdx = -1;
+
+		DevMsg( 2, "[FMOD] Entering soundscape with playlist: %s", soundscape );
+	}
+	else
 	{
-		m_Lock.Lock();
+		// Go back to default
+		EnforcePlaylist( true );
+	}
 
-		// Cache this bad boy away
-		CUtlVector<char*> *oldlist = m_CurrPlaylist;
+	// Load a song from the list if it changed
+	if ( m_CurrPlaylist != oldlist )
+		NextSong();
+}
 
-		int idx = m_Playlists.Find( m_szSoundscape );
-		if ( idx != m_Playlists.InvalidIndex() )
-		{
-			// Use the new playlist
-			m_CurrPlaylist = m_Playlists.Element( idx );
-			m_nCurrSongIdx = -1;
+int CGEMusicManager::PickSong( void )
+{
+	int num_songs = m_CurrPlaylist->Count();
 
-			DevMsg( 2, "[FMOD] Entering soundscape with playlist: %s", m_szSoundscape );
-		}
-		else
+	int idx = 0;
+	if ( num_songs > 1 )
+	{
+		// Find us a random song index not including our last song
+		do
 		{
-			// Go back to default
-			EnforcePlaylist( true );
-		}
+			idx = GERandom<int>( num_songs );
+		} while ( idx == m_nCurrSongIdx );
+	}
 
-		// Load a song from the list if it changed
-		if ( m_CurrPlaylist != oldlist )
-			NextSong();
+	return idx;
+}
 
-		m_bLoadSoundscape = false;
+bool CGEMusicManager::OpenSong( int idx, bool background, FMOD::Sound **ppSound )
+{
+	const char *song_entry = m_CurrPlaylist->Element( idx );
 
-		m_Lock.Unlock();
+	char soundfile[1024];
+	Q_snprintf( soundfile, sizeof(soundfile), "%s/sound/%s", engine->GetGameDirectory(), song_entry );
+	Q_FixSlashes( soundfile );
+
+	// Background opens return right away, FMOD opens and buffers the stream on its own thread
+	FMOD_MODE mode = background ? (FMOD_DEFAULT | FMOD_NONBLOCKING) : FMOD_DEFAULT;
+
+	FMOD_RESULT result = m_pSystem->createStream( soundfile, mode, 0, ppSound );
+	if ( result != FMOD_OK )
+	{
+		Warning( "[FMOD] Failed to create sound stream '%s'! Error Code: %i\n", song_entry, result );
+		*ppSound = NULL;
+		return false;
 	}
+
+	DevMsg( 2, "[FMOD] %s song %s\n", background ? "Prefetching" : "Loaded", song_entry );
+	return true;
+}
+
+void CGEMusicManager::PrefetchSong( void )
+{
+	EnforcePlaylist();
+	if ( !m_CurrPlaylist || m_CurrPlaylist->Count() == 0 )
+		return;
+
+	m_nNextSongIdx = PickSong();
+	m_pNextPlaylist = m_CurrPlaylist;
+	OpenSong( m_nNextSongIdx, true, &m_pNextSound );
+}
+
+void CGEMusicManager::ReleasePrefetch( void )
+{
+	if ( m_pNextSound )
+		m_pNextSound->release();
+
+	m_pNextSound = NULL;
+	m_pNextPlaylist = NULL;
+	m_nNextSongIdx = -1;
 }
 
 void CGEMusicManager::NextSong( void ) 
@@ -386,32 +531,38 @@ void CGEMusicManager::NextSong( void )
 	if ( num_songs == 0 )
 		return;
 
-	int idx = 0;
-	if ( num_songs > 1 )
+	FMOD::Sound *pSound = NULL;
+	int idx = -1;
+
+	// Use the song we opened ahead of time if it came from this playlist
+	if ( m_pNextSound && m_pNextPlaylist == m_CurrPlaylist )
 	{
-		// Find us a random song index not including our last song
-		do
+		FMOD_OPENSTATE state;
+		m_pNextSound->getOpenState( &state, NULL, NULL, NULL );
+
+		// Still opening, we'll come back on the next tick rather than wait on it
+		if ( state == FMOD_OPENSTATE_LOADING || state == FMOD_OPENSTATE_CONNECTING || state == FMOD_OPENSTATE_BUFFERING )
+			return;
+
+		if ( state != FMOD_OPENSTATE_ERROR )
 		{
-			idx = GERandom<int>( num_songs );
-		} while ( idx == m_nCurrSongIdx );
+			pSound = m_pNextSound;
+			idx = m_nNextSongIdx;
+			m_pNextSound = NULL;
+		}
 	}
 
-	const char *song_entry = m_CurrPlaylist->Element( idx );
+	// The prefetch failed or is for a playlist we left, open one right now
+	ReleasePrefetch();
 
-	char soundfile[1024];
-	Q_snprintf( soundfile, sizeof(soundfile), "%s/sound/%s", engine->GetGameDirectory(), song_entry );
-	Q_FixSlashes( soundfile );
-
-	// Load the new song with FMOD
-	FMOD::Sound *pSound;
-	result = m_pSystem->createStream( soundfile, FMOD_DEFAULT, 0, &pSound );
-	if ( result != FMOD_OK )
+	if ( !pSound )
 	{
-		Warning( "[FMOD] Failed to create sound stream '%s'! Error Code: %i\n", song_entry, result );
-		return;
+		idx = PickSong();
+		if ( !OpenSong( idx, false, &pSound ) )
+			return;
 	}
 
-	DevMsg( 2, "[FMOD] Loaded song %s\n", song_entry );
+	const char *song_entry = m_CurrPlaylist->Element( idx );
 
 	// Make the current song the last song for fading purposes, make sure the last song is stopped
 	if ( m_pLastSong )
@@ -443,26 +594,6 @@ void CGEMusicManager::NextSong( void )
 	DevMsg( 2, "[FMOD] Playing song %s\n", song_entry );
 }
 
-void CGEMusicManager::CheckWindowFocus( void )
-{
-	static bool sbInFocus = true;
-
-	// If we are on windows (why wouldn't we be?) check if we are the active window
-#ifdef _WIN32
-	if ( m_pMasterChannel )
-	{
-		HWND active = GetForegroundWindow();
-		if ( active == gWindowHandle && !sbInFocus ) {
-			m_pMasterChannel->setMute( false );
-			sbInFocus = true;
-		} else if ( active != gWindowHandle && sbInFocus ) {
-			m_pMasterChannel->setMute( true );
-			sbInFocus = false;
-		}
-	}
-#endif
-}
-
 void CGEMusicManager::StartFade( int type )
 {
 	if ( m_iFadeMode != FADE_NONE && m_iFadeMode != type )
@@ -607,7 +738,7 @@ void CGEMusicManager::AddSong( const char *relative, const char *soundscape )
 
 void CGEMusicManager::DEBUG_NextSong()
 {
-	m_fNextSongTime = 0;
+	PostCommand( CMD_NEXTSONG );
 }
 
 // This could actually be useful for players/musicians testing their tracks.
@@ -20,7 +20,7 @@
 #define GE_MUSIC_MENU		"_menu"
 #define GE_MUSIC_DEFAULT	"_default"
 
-class CGEMusicManager : public CThread, public CAutoGameSystem
+class CGEMusicManager : public CThread, public CAutoGameSystemPerFrame
 {
 public:
 	CGEMusicManager();
@@ -40,6 +40,7 @@ public:
 	// Game Event Functions (these drive the thread actions)
 	void PostInit();
 	void LevelInitPreEntity();
+	void Update( float frametime );
 
 	// Debug functions
 	void DEBUG_NextSong();
@@ -47,23 +48,41 @@ public:
 protected:
 	// Thread controls
 	int Run();
-	void StopThread() { m_bRun = false; }
+	void StopThread();
 	void ClearPlayList();
 
+	// Commands are queued by the game and carried out on the music thread
+	enum {
+		CMD_PLAYLIST = 0,
+		CMD_SOUNDSCAPE,
+		CMD_VOLUME,
+		CMD_PAUSE,
+		CMD_RESUME,
+		CMD_NEXTSONG,
+		CMD_FOCUS,
+	};
+
+	void PostCommand( int command, const char *arg = NULL, float value = 0 );
+	void ProcessCommands();
+	unsigned int GetWaitTime();
+
 	void StartFade( int type );
 	void FadeThink();
 	void PauseThink();
 	void NextSong();
+	void PrefetchSong();
+	void ReleasePrefetch();
+	int  PickSong();
+	bool OpenSong( int idx, bool background, FMOD::Sound **ppSound );
 	void EndSong( FMOD::Channel *pChannel );
-	void CheckWindowFocus();
 
 	// Playlist functions
-	void InternalLoadPlaylist();
+	void InternalLoadPlaylist( const char *playlist );
 	void EnforcePlaylist( bool force = false );
 	void AddSong( const char* relative, const char* soundscape );
 
 	// Soundscape functions
-	void InternalLoadSoundscape();
+	void InternalLoadSoundscape( const char *soundscape );
 
 	enum {
 		STATE_STOPPED = 0,
@@ -73,20 +92,28 @@ protected:
 	};
 
 private:
+	struct MusicCommand_t
+	{
+		int		iCommand;
+		char	szArg[64];
+		float	fValue;
+	};
+
+	// Command queue (guarded by m_Lock)
+	CUtlVector<MusicCommand_t> m_Commands;
+	CThreadEvent m_Wake;
+
 	// Status flags (thread transient)
-	bool	m_bRun;
+	volatile bool m_bRun;
 	bool	m_bFMODRunning;
-	bool	m_bLoadPlaylist;
-	bool	m_bVolumeDirty;
 	int		m_iState;
-	// Soundscape transitions
-	char	m_szSoundscape[64];
-	bool	m_bLoadSoundscape;
 
-	// Music playlist controls
+	// Only touched by the game thread
 	char	m_szPlayList[64];
+	bool	m_bInFocus;
+
+	// Music playlist controls
 	int		m_nCurrSongIdx;
-	bool	m_bNewPlaylist;
 
 	// Playlist seperated by soundscape name
 	CUtlDict<CUtlVector<char*>*, int>	m_Playlists;
@@ -113,6 +140,11 @@ private:
 	// Current song length in milliseconds
 	unsigned int m_iCurrSongLength;
 
+	// Next song, opened in the background before the current one ends
+	FMOD::Sound			*m_pNextSound;
+	CUtlVector<char*>	*m_pNextPlaylist;
+	int					m_nNextSongIdx;
+
 	// FMOD Variables
 	FMOD::System		*m_pSystem;
 	FMOD::Channel		*m_pLastSong;
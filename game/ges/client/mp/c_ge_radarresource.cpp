@@ -61,6 +61,15 @@ C_GERadarResource::C_GERadarResource( void )
 	memset( m_ObjText, '\0', sizeof( m_ObjText ) );
 	memset( m_ObjToken, '\0', sizeof( m_ObjToken ) );
 
+	memset( m_LastSeen, 0, sizeof( m_LastSeen ) );
+	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+		m_LastSeen[i].iSerial = INVALID_EHANDLE_INDEX;
+
+	memset( m_iChangeFlags, 0, sizeof( m_iChangeFlags ) );
+	m_iNumChanged = 0;
+
+	memset( m_iEntSlot, -1, sizeof( m_iEntSlot ) );
+
 	g_RR = this;
 }
 
@@ -69,6 +78,90 @@ C_GERadarResource::~C_GERadarResource( void )
 	g_RR = NULL;
 }
 
+void C_GERadarResource::OnDataChanged( DataUpdateType_t type )
+{
+	BaseClass::OnDataChanged( type );
+
+	// Compare against what we saw last time so the radar only has to look at
+	// the slots that actually changed in this update
+	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+	{
+		SlotSnapshot_t &last = m_LastSeen[i];
+		int flags = (type == DATA_UPDATE_CREATED) ? (RADAR_CHANGE_INFO | RADAR_CHANGE_ORIGIN) : 0;
+
+		int iSerial = m_hEnt[i].ToInt();
+		if ( iSerial != last.iSerial )
+		{
+			UpdateEntSlot( i, last.iSerial, iSerial );
+			last.iSerial = iSerial;
+			flags |= RADAR_CHANGE_INFO;
+		}
+
+		if ( m_iEntTeam[i] != last.iTeam || m_flRangeMod[i] != last.flRangeMod || m_iType[i] != last.iType 
+			|| m_iState[i] != last.iState || m_bAllVisible[i] != last.bAllVisible || m_Color[i] != last.color )
+		{
+			last.iTeam = m_iEntTeam[i];
+			last.flRangeMod = m_flRangeMod[i];
+			last.iType = m_iType[i];
+			last.iState = m_iState[i];
+			last.bAllVisible = m_bAllVisible[i];
+			last.color = m_Color[i];
+			flags |= RADAR_CHANGE_INFO;
+		}
+
+		if ( Q_strcmp( m_szIcon[i], last.szIcon ) )
+		{
+			Q_strncpy( last.szIcon, m_szIcon[i], sizeof(last.szIcon) );
+			flags |= RADAR_CHANGE_INFO;
+		}
+
+		if ( m_vOrigin[i] != last.vOrigin )
+		{
+			last.vOrigin = m_vOrigin[i];
+			flags |= RADAR_CHANGE_ORIGIN;
+		}
+
+		if ( flags )
+			MarkSlotChanged( i, flags );
+	}
+}
+
+void C_GERadarResource::MarkSlotChanged( int idx, int flags )
+{
+	if ( !m_iChangeFlags[idx] )
+		m_iChangedSlots[m_iNumChanged++] = idx;
+
+	m_iChangeFlags[idx] |= flags;
+}
+
+void C_GERadarResource::UpdateEntSlot( int idx, int iOldSerial, int iNewSerial )
+{
+	if ( iOldSerial != INVALID_EHANDLE_INDEX )
+	{
+		int entry = iOldSerial & ENT_ENTRY_MASK;
+		if ( m_iEntSlot[entry] == idx )
+			m_iEntSlot[entry] = -1;
+	}
+
+	if ( iNewSerial != INVALID_EHANDLE_INDEX )
+		m_iEntSlot[iNewSerial & ENT_ENTRY_MASK] = idx;
+}
+
+int C_GERadarResource::ConsumeChanges( int *pSlots, int *pFlags )
+{
+	int count = m_iNumChanged;
+	for ( int i=0; i < count; ++i )
+	{
+		int idx = m_iChangedSlots[i];
+		pSlots[i] = idx;
+		pFlags[i] = m_iChangeFlags[idx];
+		m_iChangeFlags[idx] = 0;
+	}
+
+	m_iNumChanged = 0;
+	return count;
+}
+
 EHANDLE C_GERadarResource::GetEnt( int idx )
 {
 	if ( idx < 0 || idx >= MAX_NET_RADAR_ENTS )
@@ -217,22 +310,27 @@ bool C_GERadarResource::GetObjectivePulse( int idx )
 
 bool C_GERadarResource::FindEntity( int iSerial )
 {
-	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
-	{
-		if ( m_hEnt[i].ToInt() == iSerial )
-			return true;
-	}
-
-	return false;
+	return FindEntityIndex( iSerial ) != -1;
 }
 
 int C_GERadarResource::FindEntityIndex( int iSerial )
 {
-	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+	// Looking for an empty slot, nothing to index that by
+	if ( iSerial == INVALID_EHANDLE_INDEX )
 	{
-		if ( m_hEnt[i].ToInt() == iSerial )
-			return i;
+		for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
+		{
+			if ( m_hEnt[i].ToInt() == iSerial )
+				return i;
+		}
+
+		return -1;
 	}
 
+	// The slot map is only refreshed in OnDataChanged so double check it
+	int idx = m_iEntSlot[iSerial & ENT_ENTRY_MASK];
+	if ( idx != -1 && m_hEnt[idx].ToInt() == iSerial )
+		return idx;
+
 	return -1;
 }
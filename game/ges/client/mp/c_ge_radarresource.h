@@ -16,6 +16,13 @@
 #include "ge_shareddefs.h"
 #include "c_baseentity.h"
 
+// Change flags reported per slot by C_GERadarResource::ConsumeChanges
+enum
+{
+	RADAR_CHANGE_INFO	= (1 << 0),	// Entity, team, range, type, state, visibility, color or icon
+	RADAR_CHANGE_ORIGIN	= (1 << 1),	// Networked position only
+};
+
 class C_GERadarResource : public C_BaseEntity
 {
 	DECLARE_CLASS( C_GERadarResource, C_BaseEntity );
@@ -25,6 +32,8 @@ public:
 
 	C_GERadarResource( void );
 	~C_GERadarResource( void );
+
+	virtual void OnDataChanged( DataUpdateType_t type );
 	
 	bool		ForceRadarOn( void ) { return m_bForceOn; };
 
@@ -50,6 +59,10 @@ public:
 	bool		FindEntity( int iSerial );
 	int			FindEntityIndex( int iSerial );
 
+	// Fills pSlots and pFlags with every slot that changed since the last call
+	// and forgets about them, returns the number of slots written
+	int			ConsumeChanges( int *pSlots, int *pFlags );
+
 protected:
 	bool		m_bForceOn;
 
@@ -70,6 +83,33 @@ protected:
 	char		m_ObjText		[MAX_NET_RADAR_ENTS][32];
 	int			m_ObjMinDist	[MAX_NET_RADAR_ENTS];
 	bool		m_ObjPulse		[MAX_NET_RADAR_ENTS];
+
+private:
+	void		MarkSlotChanged( int idx, int flags );
+	void		UpdateEntSlot( int idx, int iOldSerial, int iNewSerial );
+
+	// What each slot looked like the last time we checked it for changes
+	struct SlotSnapshot_t
+	{
+		int		iSerial;
+		int		iTeam;
+		float	flRangeMod;
+		Vector	vOrigin;
+		int		iType;
+		int		iState;
+		bool	bAllVisible;
+		color32	color;
+		char	szIcon[255];
+	};
+
+	SlotSnapshot_t	m_LastSeen		[MAX_NET_RADAR_ENTS];
+
+	int			m_iChangeFlags		[MAX_NET_RADAR_ENTS];
+	int			m_iChangedSlots		[MAX_NET_RADAR_ENTS];
+	int			m_iNumChanged;
+
+	// Entity entry index to radar slot, -1 if the entity has no slot
+	short		m_iEntSlot			[NUM_ENT_ENTRIES];
 };
 
 extern C_GERadarResource *g_RR;
@@ -15,6 +15,7 @@
 #include "ge_player.h"
 #include "soundent.h"
 #include "ai_basenpc.h"
+#include "ge_ai_visibility.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -116,7 +117,13 @@ bool CGEAISense::ShouldSeeEntity( CBaseEntity *pSightEnt )
 
 bool CGEAISense::CanSeeEntity( CBaseEntity *pSightEnt )
 {
-	return ( GetPlayer()->FInViewCone( pSightEnt ) && GetPlayer()->FVisible( pSightEnt ) );
+	if ( !GetPlayer()->FInViewCone( pSightEnt ) )
+		return false;
+
+	if ( GEAIVisibility()->ShouldTrack( GetPlayer(), pSightEnt ) )
+		return GEAIVisibility()->IsVisible( GetPlayer(), pSightEnt );
+
+	return GetPlayer()->FVisible( pSightEnt );
 }
 
 //-----------------------------------------------------------------------------
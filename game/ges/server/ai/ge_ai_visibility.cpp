@@ -0,0 +1,153 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_ai_visibility.cpp
+//
+// Description:
+//     See Header
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cbase.h"
+#include "ge_ai_visibility.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+ConVar ge_ai_vis_matrix( "ge_ai_vis_matrix", "1", FCVAR_GAMEDLL, "Share line of sight results between NPCs and bots through the visibility matrix" );
+ConVar ge_ai_vis_refresh( "ge_ai_vis_refresh", "0.1", FCVAR_GAMEDLL, "Seconds a line of sight result is reused before it is traced again", true, 0.0f, true, 1.0f );
+ConVar ge_ai_vis_maxage( "ge_ai_vis_maxage", "0.3", FCVAR_GAMEDLL, "Seconds a stale line of sight result may be served while the trace budget is exhausted", true, 0.0f, true, 2.0f );
+ConVar ge_ai_vis_budget( "ge_ai_vis_budget", "64", FCVAR_GAMEDLL, "Line of sight traces the visibility matrix may run per tick before deferring refreshes, 0 is unlimited", true, 0.0f, false, 0.0f );
+
+static CGEAIVisibility g_GEAIVisibility;
+CGEAIVisibility *GEAIVisibility() { return &g_GEAIVisibility; }
+
+CGEAIVisibility::CGEAIVisibility()
+{
+	for ( int i=0; i < MAX_EDICTS; i++ )
+		m_iEdictSlot[i] = -1;
+
+	for ( int i=0; i < GE_AIVIS_MAX_SLOTS; i++ )
+		ClearSlot( i );
+
+	m_iBudgetTick = -1;
+	m_iBudgetUsed = 0;
+
+	ResetStats();
+}
+
+void CGEAIVisibility::ClearSlot( int slot )
+{
+	m_hSlotEnt[slot] = NULL;
+
+	for ( int i=0; i < GE_AIVIS_MAX_SLOTS; i++ )
+	{
+		m_Matrix[slot][i].iTick = m_Matrix[i][slot].iTick = -1;
+		m_Matrix[slot][i].bVisible = m_Matrix[i][slot].bVisible = false;
+	}
+}
+
+int CGEAIVisibility::GetSlot( CBaseEntity *pEnt )
+{
+	int idx = pEnt->entindex();
+	if ( idx < 0 || idx >= MAX_EDICTS )
+		return -1;
+
+	int slot = m_iEdictSlot[idx];
+	if ( slot != -1 && m_hSlotEnt[slot].Get() == pEnt )
+		return slot;
+
+	// Claim a slot whose owner has gone away
+	for ( int i=0; i < GE_AIVIS_MAX_SLOTS; i++ )
+	{
+		if ( m_hSlotEnt[i].Get() == NULL )
+		{
+			ClearSlot( i );
+			m_hSlotEnt[i] = pEnt;
+			m_iEdictSlot[idx] = i;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool CGEAIVisibility::ShouldTrack( CBaseEntity *pObserver, CBaseEntity *pTarget )
+{
+	if ( !ge_ai_vis_matrix.GetBool() || !pObserver || !pTarget || pObserver == pTarget )
+		return false;
+
+	// Untargetable entities fail FVisible without a trace, nothing to share
+	if ( pTarget->GetFlags() & FL_NOTARGET )
+		return false;
+
+	// Only the pairs that sensing hammers every think are worth tracking
+	return ( pObserver->IsPlayer() || pObserver->IsNPC() ) && ( pTarget->IsPlayer() || pTarget->IsNPC() );
+}
+
+bool CGEAIVisibility::IsVisible( CBaseEntity *pObserver, CBaseEntity *pTarget )
+{
+	int obs = GetSlot( pObserver );
+	int tgt = GetSlot( pTarget );
+
+	// Out of slots, just do the work
+	if ( obs == -1 || tgt == -1 )
+	{
+		m_Stats.iTraces++;
+		return pObserver->CBaseEntity::FVisible( pTarget, MASK_BLOCKLOS );
+	}
+
+	if ( m_iBudgetTick != gpGlobals->tickcount )
+	{
+		m_iBudgetTick = gpGlobals->tickcount;
+		m_iBudgetUsed = 0;
+	}
+
+	VisEntry_t &entry = m_Matrix[obs][tgt];
+
+	// Tick count restarts on level change, treat anything from the "future" as unknown
+	int age = entry.iTick == -1 ? -1 : gpGlobals->tickcount - entry.iTick;
+	if ( age >= 0 )
+	{
+		if ( age <= TIME_TO_TICKS( ge_ai_vis_refresh.GetFloat() ) )
+		{
+			m_Stats.iCached++;
+			return entry.bVisible;
+		}
+
+		// Over budget, keep serving the old answer as long as it isn't too old
+		int budget = ge_ai_vis_budget.GetInt();
+		if ( budget > 0 && m_iBudgetUsed >= budget && age <= TIME_TO_TICKS( ge_ai_vis_maxage.GetFloat() ) )
+		{
+			m_Stats.iDeferred++;
+			return entry.bVisible;
+		}
+	}
+
+	m_iBudgetUsed++;
+	m_Stats.iTraces++;
+
+	// Bypass the SDK's visibility cache, we are the cache
+	bool bVisible = pObserver->CBaseEntity::FVisible( pTarget, MASK_BLOCKLOS );
+
+	entry.iTick = gpGlobals->tickcount;
+	entry.bVisible = bVisible;
+
+	// The trace is symmetric unless we are untargetable or only one of us sees through nodraw
+	if ( !(pObserver->GetFlags() & FL_NOTARGET) && pObserver->IsPlayer() == pTarget->IsPlayer() )
+		m_Matrix[tgt][obs] = entry;
+
+	return bVisible;
+}
+
+CON_COMMAND( ge_ai_vis_stats, "Prints and resets the visibility matrix statistics" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	const CGEAIVisibility::VisStats_t &stats = GEAIVisibility()->GetStats();
+	int total = stats.iTraces + stats.iCached + stats.iDeferred;
+
+	Msg( "Visibility matrix: %i queries, %i traced, %i cached, %i deferred\n", total, stats.iTraces, stats.iCached, stats.iDeferred );
+	GEAIVisibility()->ResetStats();
+}
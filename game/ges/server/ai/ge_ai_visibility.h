@@ -0,0 +1,62 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_ai_visibility.h
+//
+// Description:
+//      Frame level line of sight matrix shared by every NPC and bot so that
+//      each observer/target pair is traced at most once per tick.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_AI_VISIBILITY_H
+#define GE_AI_VISIBILITY_H
+
+// Maximum number of players + NPCs that can take part in the matrix at once
+#define GE_AIVIS_MAX_SLOTS	128
+
+class CGEAIVisibility
+{
+public:
+	CGEAIVisibility();
+
+	// True if the matrix will answer FVisible( pTarget, MASK_BLOCKLOS ) for this pair
+	bool ShouldTrack( CBaseEntity *pObserver, CBaseEntity *pTarget );
+
+	// Line of sight from pObserver's eyes to pTarget's eyes, equivalent to
+	// CBaseEntity::FVisible( pTarget, MASK_BLOCKLOS ) but shared between callers
+	bool IsVisible( CBaseEntity *pObserver, CBaseEntity *pTarget );
+
+	struct VisStats_t
+	{
+		int iTraces;
+		int iCached;
+		int iDeferred;
+	};
+
+	const VisStats_t &GetStats() { return m_Stats; }
+	void ResetStats() { memset( &m_Stats, 0, sizeof(m_Stats) ); }
+
+private:
+	int  GetSlot( CBaseEntity *pEnt );
+	void ClearSlot( int slot );
+
+	struct VisEntry_t
+	{
+		int  iTick;
+		bool bVisible;
+	};
+
+	VisEntry_t	m_Matrix[ GE_AIVIS_MAX_SLOTS ][ GE_AIVIS_MAX_SLOTS ];
+	EHANDLE		m_hSlotEnt[ GE_AIVIS_MAX_SLOTS ];
+	short		m_iEdictSlot[ MAX_EDICTS ];
+
+	// Trace budget bookkeeping
+	int	m_iBudgetTick;
+	int m_iBudgetUsed;
+
+	VisStats_t	m_Stats;
+};
+
+CGEAIVisibility *GEAIVisibility();
+
+#endif
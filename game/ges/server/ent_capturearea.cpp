@@ -33,6 +33,8 @@ CGECaptureArea::CGECaptureArea()
 {
 	m_szGroupName[0] = '\0';
 	m_fRadius = 32.0f;
+	m_fRadiusSqr = m_fRadius * m_fRadius;
+	m_pDef = NULL;
 
 	AddEFlags( EFL_USE_PARTITION_WHEN_NOT_SOLID );
 }
@@ -101,6 +103,8 @@ void CGECaptureArea::SetRadius( float radius )
 		m_fRadius = CollisionProp()->BoundingRadius2D();
 	}
 
+	m_fRadiusSqr = m_fRadius * m_fRadius;
+
 	// Recalculate our bounds
 	CollisionProp()->MarkSurroundingBoundsDirty();
 
@@ -117,31 +121,62 @@ void CGECaptureArea::SetupGlow( bool state, Color glowColor /*=Color(255,255,255
 
 void CGECaptureArea::ClearTouchingEntities( void )
 {
-	m_hTouchingEntities.RemoveAll();
+	m_TouchingEntities.ClearAll();
+}
+
+CBaseCombatWeapon *CGECaptureArea::FindRequiredToken( CBaseCombatCharacter *pBCC )
+{
+	for ( int i=0; i < pBCC->WeaponCount(); i++ )
+	{
+		CGEWeapon *pWeapon = ToGEWeapon( pBCC->GetWeapon(i) );
+		if ( !pWeapon || pWeapon->GetWeaponID() != m_pDef->iRqdWeaponID || pWeapon->GetSubType() != 0 )
+			continue;
+
+		// Generic tokens share an id, classnames are pooled so this is a pointer compare
+		if ( m_pDef->iRqdWeaponID != WEAPON_TOKEN || IDENT_STRINGS( pWeapon->m_iClassname, m_pDef->iszRqdToken ) )
+			return pWeapon;
+	}
+
+	return NULL;
 }
 
 void CGECaptureArea::Touch( CBaseEntity *pOther )
 {
-	if ( !pOther->IsPlayer() && !pOther->IsNPC() )
+	if ( !m_pDef || (!pOther->IsPlayer() && !pOther->IsNPC()) )
+		return;
+
+	// Check if we are touching us already
+	int idx = pOther->entindex();
+	if ( idx < 0 || idx >= MAX_EDICTS || m_TouchingEntities.IsBitSet( idx ) )
 		return;
 
-	if ( !GEMPRules()->GetTokenManager()->CanTouchCaptureArea( m_szGroupName, pOther ) )
+	CBaseCombatCharacter *pBCC = pOther->MyCombatCharacterPointer();
+	if ( !pBCC )
 		return;
 
-	// Check if we are touching us already
-	EHANDLE hPlayer = pOther->GetRefEHandle();
-	if ( m_hTouchingEntities.Find( hPlayer ) != m_hTouchingEntities.InvalidIndex() )
+	// Python edits our definition in place, pick up the new requirements
+	if ( !m_pDef->bCompiled )
+		m_pDef->Compile();
+
+	// Test for teamplay membership if required
+	int team = pBCC->GetTeamNumber();
+	if ( team < 0 || team >= 32 || !(m_pDef->iTeamMask & (1 << team)) )
 		return;
 
+	// Test for token ownership if required
+	CBaseCombatWeapon *pToken = NULL;
+	if ( m_pDef->iRqdWeaponID != WEAPON_NONE )
+	{
+		pToken = FindRequiredToken( pBCC );
+		if ( !pToken )
+			return;
+	}
+
 	// We have passed all filters and this is a fresh touch, now enforce the radius
-	if ( pOther->GetAbsOrigin().DistTo( GetAbsOrigin() ) <= m_fRadius )
+	if ( pOther->GetAbsOrigin().DistToSqr( GetAbsOrigin() ) <= m_fRadiusSqr )
 	{
 		// Put us on the touching list
-		m_hTouchingEntities.AddToTail( hPlayer );
-
-		// Resolve our held token (note we must use the pOther)
-		const char *szToken = GEMPRules()->GetTokenManager()->GetCaptureAreaToken(m_szGroupName);
-		CGEWeapon *pToken = (CGEWeapon*) pOther->MyCombatCharacterPointer()->Weapon_OwnsThisType( szToken );
+		m_TouchingEntities.Set( idx );
 
 		// Resolve the player (or bot proxy)
 		CGEPlayer *pPlayer = ToGEMPPlayer( pOther );
@@ -149,15 +184,17 @@ void CGECaptureArea::Touch( CBaseEntity *pOther )
 			pPlayer = ToGEBotPlayer( pOther );
 
 		// Notify the Gameplay
-		GEGameplay()->GetScenario()->OnCaptureAreaEntered( this, pPlayer, pToken );
+		GEGameplay()->GetScenario()->OnCaptureAreaEntered( this, pPlayer, (CGEWeapon*) pToken );
 	}
 }
 
 void CGECaptureArea::EndTouch( CBaseEntity *pOther )
 {
-	EHANDLE hPlayer = pOther->GetRefEHandle();
-	if ( m_hTouchingEntities.FindAndRemove( hPlayer ) )
+	int idx = pOther->entindex();
+	if ( idx >= 0 && idx < MAX_EDICTS && m_TouchingEntities.IsBitSet( idx ) )
 	{
+		m_TouchingEntities.Clear( idx );
+
 		// Resolve the player (or bot proxy)
 		CGEPlayer *pPlayer = ToGEMPPlayer( pOther );
 		if ( !pPlayer )
@@ -14,6 +14,9 @@
 #endif
 
 #include "baseanimating.h"
+#include "bitvec.h"
+
+class CGECaptureAreaDef;
 
 class CGECaptureArea : public CBaseAnimating
 {
@@ -37,6 +40,10 @@ public:
 	const char *GetGroupName() { return m_szGroupName; }
 	void SetRadius( float radius );
 
+	// Set by the TokenManager when we are linked to (or unlinked from) our group
+	void SetCaptureAreaDef( CGECaptureAreaDef *pDef ) { m_pDef = pDef; }
+	CGECaptureAreaDef *GetCaptureAreaDef() { return m_pDef; }
+
 	void SetupGlow( bool state, Color glowColor = Color(255,255,255), float glowDist = 350.0f );
 
 private:
@@ -48,11 +55,17 @@ private:
 	CNetworkVar( int, m_GlowColor );
 	CNetworkVar( float, m_GlowDist );
 
+	// Returns the held weapon that satisfies our group's token requirement
+	CBaseCombatWeapon *FindRequiredToken( CBaseCombatCharacter *pBCC );
+
 	char m_szGroupName[32];
 	float m_fRadius;
+	float m_fRadiusSqr;
+
+	CGECaptureAreaDef *m_pDef;
 
-	// Entities currently being touched by this capture area
-	CUtlVector< EHANDLE >	m_hTouchingEntities;
+	// Entities currently being touched by this capture area, by entity index
+	CBitVec< MAX_EDICTS >	m_TouchingEntities;
 };
 
 #endif
@@ -0,0 +1,64 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_benchmark.h
+//
+// Description:
+//      Section timers for the headless tick benchmark (ge_benchmark). They are
+//      only compiled in when the server is built with GES_BENCHMARK, otherwise
+//      GE_BENCH_SCOPE expands to nothing.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_BENCHMARK_H
+#define GE_BENCHMARK_H
+
+enum GEBenchSection_t
+{
+	GEBENCH_GAMERULES = 0,	// CGEMPRules::Think
+	GEBENCH_SPAWNSELECT,	// CGEMPPlayer::EntSelectSpawnPoint
+	GEBENCH_TOKENS,			// CGETokenManager::EnforceTokens
+	GEBENCH_RADAR,			// CGERadarResource::RadarThink
+
+	GEBENCH_SECTION_COUNT,
+};
+
+#ifdef GES_BENCHMARK
+#include "tier0/fasttimer.h"
+
+// True while a benchmark run is being measured
+extern bool g_bGEBenchmarking;
+
+void GEBench_AddSample( int section, const CCycleCount &duration );
+
+// Times the rest of the enclosing scope against the given section.
+// Nested sections are inclusive of their children.
+class CGEBenchScope
+{
+public:
+	CGEBenchScope( int section )
+	{
+		m_iSection = g_bGEBenchmarking ? section : -1;
+		if ( m_iSection != -1 )
+			m_Timer.Start();
+	}
+
+	~CGEBenchScope()
+	{
+		if ( m_iSection != -1 )
+		{
+			m_Timer.End();
+			GEBench_AddSample( m_iSection, m_Timer.GetDuration() );
+		}
+	}
+
+private:
+	int			m_iSection;
+	CFastTimer	m_Timer;
+};
+
+#define GE_BENCH_SCOPE( section ) CGEBenchScope _benchScope( section )
+#else
+#define GE_BENCH_SCOPE( section )
+#endif
+
+#endif
@@ -19,6 +19,8 @@
 #include "gemp_player.h"
 #include "ge_weapon.h"
 #include "grenade_gebase.h"
+#include "ge_telemetry.h"
+#include "tier0/fasttimer.h"
 
 #include "gemp_gamerules.h"
 
@@ -30,60 +32,22 @@
 // ----------------------------------------------------
 // GEPlayerStats definitions
 // ----------------------------------------------------
-GEPlayerStats::GEPlayerStats( CBasePlayer *player )
+GEPlayerStats::GEPlayerStats( void )
 {
-	m_hPlayer = player;
 	ResetRoundStats();
 	ResetMatchStats();
 }
 
-void GEPlayerStats::AddStat( int idx, int amt )
-{
-	if ( idx >= 0 && idx < GE_AWARD_MAX )
-		m_iRoundStats[idx] += amt;
-}
-
-void GEPlayerStats::SetStat( int idx, int amt )
-{
-	if ( idx >= 0 && idx < GE_AWARD_MAX )
-		m_iRoundStats[idx] = amt;
-}
-
-int GEPlayerStats::GetRoundStat( int idx )
-{
-	if ( idx >= 0 && idx < GE_AWARD_MAX )
-		return m_iRoundStats[idx];
-	return 0;
-}
-
-int GEPlayerStats::GetMatchStat( int idx )
-{
-	if ( idx >= 0 && idx < GE_AWARD_MAX )
-		return m_iMatchStats[idx];
-	return 0;
-}
-
 void GEPlayerStats::ResetRoundStats( void )
 {
-	for ( int i=0; i < GE_AWARD_MAX; i++ )
-		m_iRoundStats[i] = 0;
-
 	for ( int i=0; i < WEAPON_MAX; i++ )
 		m_iWeaponsHeldTime[i] = m_iWeaponsKills[i] = 0;
 
 	m_iDeaths = 0;
 }
 
-void GEPlayerStats::AddRoundToMatchStats( void )
-{
-	for ( int i=0; i < GE_AWARD_MAX; i++ )
-		m_iMatchStats[i] += m_iRoundStats[i];
-}
-
 void GEPlayerStats::ResetMatchStats( void )
 {
-	for ( int i=0; i < GE_AWARD_MAX; i++ )
-		m_iMatchStats[i] = 0;
 	for ( int i=0; i < WEAPON_MAX; i++ )
 		m_iMatchWeapons[i] = 0;
 	m_iDeaths = 0;
@@ -101,33 +65,65 @@ CGEStats::CGEStats( void )
 	gamestats = &s_GEStats;
 	m_iRoundCount = 0;
 	m_flRoundStartTime = 0.0f;
+
+	memset( m_bConnected, 0, sizeof(m_bConnected) );
+	memset( m_iRoundStats, 0, sizeof(m_iRoundStats) );
+	memset( m_iMatchStats, 0, sizeof(m_iMatchStats) );
+
+	for ( int i=0; i < GE_AWARD_GIVEMAX; i++ )
+	{
+		m_Leaders[i].iFirst = m_Leaders[i].iSecond = -1;
+		m_Leaders[i].bDirty = false;
+	}
 }
 
 CGEStats::~CGEStats( void )
 {
-	m_pPlayerStats.PurgeAndDeleteElements();
 }
 
 void CGEStats::ResetRoundStats( void )
 {
-	for ( int i=0; i < m_pPlayerStats.Count(); i++ )
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
+	{
+		if ( !m_bConnected[i] )
+			continue;
+
+		for ( int a=0; a < GE_AWARD_MAX; a++ )
+		{
+			m_iMatchStats[a][i] += m_iRoundStats[a][i];
+			m_iRoundStats[a][i] = 0;
+		}
+
+		m_PlayerStats[i].ResetRoundStats();
+	}
+
+	// Everyone is tied at zero again, seed each leaderboard with that tie (the first two
+	// connected players) so the stat events keep it current from the first kill on
+	for ( int a=0; a < GE_AWARD_GIVEMAX; a++ )
 	{
-		m_pPlayerStats[i]->AddRoundToMatchStats();
-		m_pPlayerStats[i]->ResetRoundStats();
+		ScanLeaders( a, false, false, m_Leaders[a].iFirst, m_Leaders[a].iSecond );
+		m_Leaders[a].bDirty = false;
 	}
 
 	m_flRoundStartTime = gpGlobals->curtime;
 	m_iRoundCount++;
+
+	GETelemetry()->SetRound( m_iRoundCount );
+	GETelemetry()->Record( GE_TELEMETRY_ROUNDSTART, NULL, NULL, WEAPON_NONE, m_iRoundCount );
 }
 
 void CGEStats::ResetMatchStats( void )
 {
-	for ( int i=0; i < m_pPlayerStats.Count(); i++ )
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
 	{
-		m_pPlayerStats[i]->ResetRoundStats();
+		if ( m_bConnected[i] )
+			m_PlayerStats[i].ResetRoundStats();
 	}
 
 	m_iRoundCount = 0;
+
+	// Every match gets its own telemetry file
+	GETelemetry()->BeginMatch();
 }
 
 int CGEStats::GetPlayerStat( int idx, CBasePlayer *player )
@@ -136,29 +132,170 @@ int CGEStats::GetPlayerStat( int idx, CBasePlayer *player )
 	if ( iPlayer == -1 || (idx < 0 || idx >= GE_AWARD_MAX) )
 		return 0;
 
-	return m_pPlayerStats[iPlayer]->GetRoundStat(idx);
+	return GetRoundStat( iPlayer, idx );
 }
 
 GEPlayerStats *CGEStats::FindPlayerStats( CBasePlayer *player )
 {
-	for (int i=0; i < m_pPlayerStats.Count(); i++)
+	int iPlayer = FindPlayer( player );
+	return iPlayer != -1 ? &m_PlayerStats[iPlayer] : NULL;
+}
+
+int CGEStats::FindPlayer( CBasePlayer *player )
+{
+	if ( !player )
+		return -1;
+
+	int idx = player->entindex();
+	if ( idx <= 0 || idx > MAX_PLAYERS || !m_bConnected[idx] )
+		return -1;
+
+	return idx;
+}
+
+void CGEStats::AddStat( int iPlayer, int idx, int amt )
+{
+	if ( idx < 0 || idx >= GE_AWARD_MAX || amt == 0 )
+		return;
+
+	int old = m_iRoundStats[idx][iPlayer];
+	m_iRoundStats[idx][iPlayer] += amt;
+	UpdateLeaders( idx, iPlayer, old );
+}
+
+void CGEStats::SetStat( int iPlayer, int idx, int amt )
+{
+	if ( idx < 0 || idx >= GE_AWARD_MAX )
+		return;
+
+	int old = m_iRoundStats[idx][iPlayer];
+	m_iRoundStats[idx][iPlayer] = amt;
+	UpdateLeaders( idx, iPlayer, old );
+}
+
+bool CGEStats::IsStatBetter( int iAward, int a, int b )
+{
+	return GetAwardSort(iAward) == GE_SORT_HIGH ? a > b : a < b;
+}
+
+int CGEStats::GetAwardStat( int iAward, int iPlayer, bool bMatch )
+{
+	// The match report averages the match stats over the rounds played
+	if ( bMatch )
+		return m_iMatchStats[iAward][iPlayer] / max( m_iRoundCount, 1 );
+
+	return m_iRoundStats[iAward][iPlayer];
+}
+
+// Keeps the award's top two current for a single changed stat, only falling
+// back to a rescan (done lazily at report time) when a leader loses ground
+void CGEStats::UpdateLeaders( int iAward, int iPlayer, int oldStat )
+{
+	if ( iAward >= GE_AWARD_GIVEMAX )
+		return;
+
+	AwardLeaders_t &leaders = m_Leaders[iAward];
+	if ( leaders.bDirty )
+		return;
+
+	int stat = m_iRoundStats[iAward][iPlayer];
+	bool bWorse = IsStatBetter( iAward, oldStat, stat );
+
+	if ( iPlayer == leaders.iFirst )
+	{
+		if ( bWorse && leaders.iSecond != -1 && IsStatBetter( iAward, m_iRoundStats[iAward][leaders.iSecond], stat ) )
+			leaders.bDirty = true;
+	}
+	else if ( iPlayer == leaders.iSecond )
 	{
-		if ( m_pPlayerStats[i]->GetPlayer() == player )
-			return m_pPlayerStats[i];
+		if ( bWorse )
+			leaders.bDirty = true;
+		else if ( IsStatBetter( iAward, stat, m_iRoundStats[iAward][leaders.iFirst] ) )
+		{
+			leaders.iSecond = leaders.iFirst;
+			leaders.iFirst = iPlayer;
+		}
 	}
+	else if ( !bWorse )
+	{
+		if ( leaders.iFirst == -1 || IsStatBetter( iAward, stat, m_iRoundStats[iAward][leaders.iFirst] ) )
+		{
+			leaders.iSecond = leaders.iFirst;
+			leaders.iFirst = iPlayer;
+		}
+		else if ( leaders.iSecond == -1 || IsStatBetter( iAward, stat, m_iRoundStats[iAward][leaders.iSecond] ) )
+		{
+			leaders.iSecond = iPlayer;
+		}
+	}
+}
+
+void CGEStats::ScanLeaders( int iAward, bool bMatch, bool bEligibleOnly, int &iFirst, int &iSecond )
+{
+	iFirst = iSecond = -1;
+	int first = 0, second = 0;
 
-	return NULL;
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
+	{
+		if ( !m_bConnected[i] || (bEligibleOnly && !IsAwardEligible(i)) )
+			continue;
+
+		int stat = GetAwardStat( iAward, i, bMatch );
+		if ( iFirst == -1 || IsStatBetter( iAward, stat, first ) )
+		{
+			iSecond = iFirst;
+			second = first;
+			iFirst = i;
+			first = stat;
+		}
+		else if ( iSecond == -1 || IsStatBetter( iAward, stat, second ) )
+		{
+			iSecond = i;
+			second = stat;
+		}
+	}
 }
 
-int CGEStats::FindPlayer( CBasePlayer *player )
+bool CGEStats::GetAwardLeaders( int iAward, bool bMatch, int &iFirst, int &iSecond )
 {
-	for (int i=0; i < m_pPlayerStats.Count(); i++)
+	if ( !bMatch )
 	{
-		if ( m_pPlayerStats[i]->GetPlayer() == player )
-			return i;
+		AwardLeaders_t &leaders = m_Leaders[iAward];
+		if ( leaders.bDirty )
+		{
+			ScanLeaders( iAward, false, false, leaders.iFirst, leaders.iSecond );
+			leaders.bDirty = false;
+		}
+
+		iFirst = leaders.iFirst;
+		iSecond = leaders.iSecond;
+
+		if ( iFirst != -1 && iSecond != -1 && IsAwardEligible(iFirst) && IsAwardEligible(iSecond) )
+			return true;
+	}
+
+	// Match reports and leaders that can't take an award need a filtered pass
+	ScanLeaders( iAward, bMatch, true, iFirst, iSecond );
+	return iSecond != -1;
+}
+
+bool CGEStats::IsAwardEligible( int iPlayer )
+{
+	// Don't try to give awards to invalid players
+	CGEPlayer *pPlayer = m_PlayerStats[iPlayer].GetPlayer();
+	return pPlayer && pPlayer->GetTeamNumber() != TEAM_SPECTATOR;
+}
+
+int CGEStats::CountAwardEligible( void )
+{
+	int count = 0;
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
+	{
+		if ( m_bConnected[i] && IsAwardEligible(i) )
+			count++;
 	}
 
-	return -1;
+	return count;
 }
 
 void CGEStats::SetAwardsInEvent( IGameEvent *pEvent )
@@ -167,26 +304,21 @@ void CGEStats::SetAwardsInEvent( IGameEvent *pEvent )
 	if ( GEMPRules()->GetNumActivePlayers() < 2 )
 		return;
 
-	CUtlVector<GEStatSort*> vAwards;
-	GEStatSort *award;
+	CUtlVectorFixed<GEStatSort, GE_AWARD_GIVEMAX> vAwards;
+	GEStatSort award;
 	int i;
 
 	// Prevent divide by zero
 	if ( m_iRoundCount == 0 )
 		m_iRoundCount = 1;
 
+	int iEligible = CountAwardEligible();
+
 	for ( i=0; i < GE_AWARD_GIVEMAX; i++ )
 	{
-		// Check for valid award
-		if ( AwardIDToIdent(i) )
-		{
-			award = new GEStatSort;
-			// See if we are going to give this one out, if so store it, if not erase the dummy var
-			if ( GetAwardWinner(i, *award) )
-				vAwards.AddToTail( award );
-			else
-				delete award;
-		}
+		// Check for valid award and see if we are going to give this one out
+		if ( AwardIDToIdent(i) && GetAwardWinner(i, iEligible, award) )
+			vAwards.AddToTail( award );
 	}
 
 	// Sort our ratios from High to Low
@@ -200,18 +332,16 @@ void CGEStats::SetAwardsInEvent( IGameEvent *pEvent )
 		if ( i == 6 )
 			break;
 
-		pPlayer = m_pPlayerStats[ vAwards[i]->idx ]->GetPlayer();
+		pPlayer = m_PlayerStats[ vAwards[i].idx ].GetPlayer();
 		if ( !pPlayer )
 			continue;
 
 		Q_snprintf( eventid, 16, "award%i_id", i+1 );
 		Q_snprintf( eventwinner, 16, "award%i_winner", i+1 );
 
-		pEvent->SetInt( eventid, vAwards[i]->m_iAward );
+		pEvent->SetInt( eventid, vAwards[i].m_iAward );
 		pEvent->SetInt( eventwinner, pPlayer->entindex() );
 	}
-
-	vAwards.PurgeAndDeleteElements();
 }
 
 void CGEStats::SetFavoriteWeapons( void )
@@ -219,9 +349,9 @@ void CGEStats::SetFavoriteWeapons( void )
 	GEWeaponSort wep;
 	CGEPlayer *pPlayer;
 
-	for ( int i=0; i < m_pPlayerStats.Count(); i++ )
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
 	{
-		if ( !m_pPlayerStats[i]->GetPlayer() )
+		if ( !m_bConnected[i] || !m_PlayerStats[i].GetPlayer() )
 			continue;
 
 		wep.m_iWeaponID = WEAPON_NONE;
@@ -229,18 +359,36 @@ void CGEStats::SetFavoriteWeapons( void )
 
 		if ( GetFavoriteWeapon( i, wep ) )
 		{
-			pPlayer = ToGEPlayer( m_pPlayerStats[i]->GetPlayer() );
+			pPlayer = ToGEPlayer( m_PlayerStats[i].GetPlayer() );
 			pPlayer->SetFavoriteWeapon( wep.m_iWeaponID );
 			// Increment our preferred weapon for the match
-			m_pPlayerStats[i]->m_iMatchWeapons[ wep.m_iWeaponID ]++;
+			m_PlayerStats[i].m_iMatchWeapons[ wep.m_iWeaponID ]++;
 		}
 	}
 }
 
 void CGEStats::Event_PlayerConnected( CBasePlayer *pBasePlayer )
 {
-	GEPlayerStats *playerstats = new GEPlayerStats( pBasePlayer );
-	m_pPlayerStats.AddToTail( playerstats );
+	int idx = pBasePlayer->entindex();
+	if ( idx > 0 && idx <= MAX_PLAYERS )
+	{
+		m_PlayerStats[idx].SetPlayer( pBasePlayer );
+		m_PlayerStats[idx].ResetRoundStats();
+		m_PlayerStats[idx].ResetMatchStats();
+		m_bConnected[idx] = true;
+
+		for ( int a=0; a < GE_AWARD_MAX; a++ )
+			m_iRoundStats[a][idx] = m_iMatchStats[a][idx] = 0;
+
+		// We join at zero which might already beat a low sorted award
+		for ( int a=0; a < GE_AWARD_GIVEMAX; a++ )
+		{
+			if ( GetAwardSort(a) == GE_SORT_HIGH )
+				UpdateLeaders( a, idx, INT_MIN );
+			else
+				UpdateLeaders( a, idx, INT_MAX );
+		}
+	}
 
 	BaseClass::Event_PlayerConnected( pBasePlayer );
 }
@@ -251,9 +399,14 @@ void CGEStats::Event_PlayerDisconnected( CBasePlayer *pBasePlayer )
 
 	if ( iPlayer != -1 )
 	{
-		GEPlayerStats *stat = m_pPlayerStats[iPlayer];
-		m_pPlayerStats.Remove(iPlayer);
-		delete stat;
+		m_bConnected[iPlayer] = false;
+		m_PlayerStats[iPlayer].SetPlayer( NULL );
+
+		for ( int a=0; a < GE_AWARD_GIVEMAX; a++ )
+		{
+			if ( m_Leaders[a].iFirst == iPlayer || m_Leaders[a].iSecond == iPlayer )
+				m_Leaders[a].bDirty = true;
+		}
 	}
 
 	BaseClass::Event_PlayerDisconnected( pBasePlayer );
@@ -272,23 +425,23 @@ void CGEStats::Event_PlayerKilled( CBasePlayer *pPlayer, const CTakeDamageInfo &
 	if ( gePlayer->IsObserver() || gePlayer->GetTeamNumber() == TEAM_SPECTATOR )
 		return;
 
-	m_pPlayerStats[iVictim]->m_iDeaths++;
-	float deaths = (float)m_pPlayerStats[iVictim]->m_iDeaths;
+	m_PlayerStats[iVictim].m_iDeaths++;
+	float deaths = (float)m_PlayerStats[iVictim].m_iDeaths;
 	float lifetime = gpGlobals->curtime - gePlayer->GetSpawnTime();
 
-	m_pPlayerStats[iVictim]->AddStat( GE_INNING_VAL, lifetime );
-	m_pPlayerStats[iVictim]->AddStat( GE_INNING_SQ, lifetime*lifetime );
+	AddStat( iVictim, GE_INNING_VAL, lifetime );
+	AddStat( iVictim, GE_INNING_SQ, lifetime*lifetime );
 
 	int inn;
-	int inn_val = m_pPlayerStats[iVictim]->GetRoundStat( GE_INNING_VAL );
-	int inn_sq = m_pPlayerStats[iVictim]->GetRoundStat( GE_INNING_SQ );
+	int inn_val = GetRoundStat( iVictim, GE_INNING_VAL );
+	int inn_sq = GetRoundStat( iVictim, GE_INNING_SQ );
 
 	// Calculate the running standard deviation of our innings
 	float inn_sd = sqrt( (float)(inn_sq - (float)(inn_val*inn_val) / deaths) / deaths );
 	
-	inn = (int)((float)inn_val/(float)m_pPlayerStats[iVictim]->m_iDeaths - inn_sd);
-	m_pPlayerStats[iVictim]->SetStat( GE_AWARD_LONGIN, inn );
-	m_pPlayerStats[iVictim]->SetStat( GE_AWARD_SHORTIN, inn );
+	inn = (int)((float)inn_val/(float)m_PlayerStats[iVictim].m_iDeaths - inn_sd);
+	SetStat( iVictim, GE_AWARD_LONGIN, inn );
+	SetStat( iVictim, GE_AWARD_SHORTIN, inn );
 
 	// Fake a weapon switch so we can record their usage time of the weapon
 	Event_WeaponSwitch( pPlayer, pPlayer->GetActiveWeapon(), NULL );
@@ -296,8 +449,27 @@ void CGEStats::Event_PlayerKilled( CBasePlayer *pPlayer, const CTakeDamageInfo &
 	//test if its a fall death
 	if( !info.GetInflictor() )
 	{
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_PROFESSIONAL, -5);
+		AddStat( iVictim, GE_AWARD_PROFESSIONAL, -5);
+	}
+}
+
+// Explosives (grenades, mines, rockets) don't carry a weapon, they are their own inflictor
+static int GetDamageWeaponID( const CTakeDamageInfo &info )
+{
+	if ( info.GetWeapon() )
+	{
+		CGEWeapon *pWeapon = ToGEWeapon( (CBaseCombatWeapon*)info.GetWeapon() );
+		return pWeapon ? pWeapon->GetWeaponID() : WEAPON_NONE;
+	}
+
+	CBaseEntity *pInflictor = info.GetInflictor();
+	if ( pInflictor && !pInflictor->IsNPC() && Q_stristr( pInflictor->GetClassname(), "npc_" ) )
+	{
+		CGEBaseGrenade *pGrenade = ToGEGrenade( pInflictor );
+		return pGrenade ? pGrenade->GetWeaponID() : WEAPON_NONE;
 	}
+
+	return WEAPON_NONE;
 }
 
 void CGEStats::Event_PlayerKilledOther( CBasePlayer *pAttacker, CBaseEntity *pVictim, const CTakeDamageInfo &info )
@@ -322,27 +494,28 @@ void CGEStats::Event_PlayerKilledOther( CBasePlayer *pAttacker, CBaseEntity *pVi
 	// Check for suicide
 	if ( pVictim == pAttacker )
 	{
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_PROFESSIONAL, -15 );
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_MOSTLYHARMLESS, 50 );
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_LEMMING, 3 );
+		AddStat( iVictim, GE_AWARD_PROFESSIONAL, -15 );
+		AddStat( iVictim, GE_AWARD_MOSTLYHARMLESS, 50 );
+		AddStat( iVictim, GE_AWARD_LEMMING, 3 );
+
+		GETelemetry()->Record( GE_TELEMETRY_KILL, pAttacker, pVictim, WEAPON_NONE, info.GetDamage(), pBaseVictim->LastHitGroup(), GE_TELEMETRY_FL_SUICIDE );
 	}
 	else
 	{
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_PROFESSIONAL , -5 );
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_MOSTLYHARMLESS, 30 );
+		AddStat( iVictim, GE_AWARD_PROFESSIONAL , -5 );
+		AddStat( iVictim, GE_AWARD_MOSTLYHARMLESS, 30 );
 
-		m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_DEADLY , 50 );
-		m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_PROFESSIONAL , 5 );
+		AddStat( iAttacker, GE_AWARD_DEADLY , 50 );
+		AddStat( iAttacker, GE_AWARD_PROFESSIONAL , 5 );
 
-		int weapid = WEAPON_NONE;
-		if ( info.GetWeapon() )
-			weapid = ToGEWeapon( (CBaseCombatWeapon*)info.GetWeapon() )->GetWeaponID();
-		else if ( !info.GetInflictor()->IsNPC() && Q_stristr( info.GetInflictor()->GetClassname(), "npc_" ) )
-			weapid = ToGEGrenade( info.GetInflictor() )->GetWeaponID();
+		int weapid = GetDamageWeaponID( info );
 
 		if ( weapid != WEAPON_NONE )
 			// Increment our kills with this weapon
-			m_pPlayerStats[iAttacker]->m_iWeaponsKills[weapid]++;
+			m_PlayerStats[iAttacker].m_iWeaponsKills[weapid]++;
+
+		int hitgroup = pBaseVictim->LastHitGroup();
+		GETelemetry()->Record( GE_TELEMETRY_KILL, pAttacker, pVictim, weapid, info.GetDamage(), hitgroup, hitgroup == HITGROUP_HEAD ? GE_TELEMETRY_FL_HEADSHOT : 0 );
 	}
 
 	BaseClass::Event_PlayerKilledOther( pAttacker, pVictim, info );
@@ -352,17 +525,27 @@ void CGEStats::Event_WeaponFired( CBasePlayer *pShooter, bool bPrimary, char con
 {
 	// Take off 1 point for every shot fired
 	int iPlayer = FindPlayer( pShooter );
-	m_pPlayerStats[iPlayer]->AddStat( GE_AWARD_MARKSMANSHIP, -1 );
+	if ( iPlayer == -1 )
+		return;
+	AddStat( iPlayer, GE_AWARD_MARKSMANSHIP, -1 );
 	// Add 1 point to our frantic score
-	m_pPlayerStats[iPlayer]->AddStat( GE_AWARD_FRANTIC, 1 );
+	AddStat( iPlayer, GE_AWARD_FRANTIC, 1 );
+
+	if ( GETelemetry()->IsRecording() )
+	{
+		CGEWeapon *pWeapon = ToGEWeapon( pShooter->GetActiveWeapon() );
+		GETelemetry()->Record( GE_TELEMETRY_FIRE, pShooter, NULL, pWeapon ? pWeapon->GetWeaponID() : WEAPON_NONE, bPrimary ? 1.0f : 0.0f );
+	}
 }
 
 void CGEStats::Event_WeaponHit( CBasePlayer *pShooter, bool bPrimary, char const *pchWeaponName, const CTakeDamageInfo &info )
 {
 	int iPlayer = FindPlayer( pShooter );
-	m_pPlayerStats[iPlayer]->AddStat( GE_AWARD_MARKSMANSHIP, 1 );
+	if ( iPlayer == -1 )
+		return;
+	AddStat( iPlayer, GE_AWARD_MARKSMANSHIP, 1 );
 	// Take away a frantic point since they actually hit something
-	m_pPlayerStats[iPlayer]->AddStat( GE_AWARD_FRANTIC, -1 );
+	AddStat( iPlayer, GE_AWARD_FRANTIC, -1 );
 }
 
 void CGEStats::Event_PlayerDamage( CBasePlayer *pBasePlayer, const CTakeDamageInfo &info )
@@ -373,22 +556,30 @@ void CGEStats::Event_PlayerDamage( CBasePlayer *pBasePlayer, const CTakeDamageIn
 	int iVictim = FindPlayer( pBasePlayer );
 	
 	CBasePlayer* pAttacker = static_cast<CBasePlayer*>(info.GetAttacker());
-	if( !pAttacker->IsPlayer() )
+	if( !pAttacker || !pAttacker->IsPlayer() )
 		return;
 	int iAttacker = FindPlayer( pAttacker );
+	if ( iVictim == -1 || iAttacker == -1 )
+		return;
+
+	if ( GETelemetry()->IsRecording() )
+	{
+		int flags = iAttacker == iVictim ? GE_TELEMETRY_FL_SUICIDE : 0;
+		GETelemetry()->Record( GE_TELEMETRY_DAMAGE, pAttacker, pBasePlayer, GetDamageWeaponID( info ), info.GetDamage(), pBasePlayer->LastHitGroup(), flags );
+	}
 
 	// We hurt ourselves...
 	if ( iAttacker == iVictim )
 	{
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_PROFESSIONAL, -2);
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_LEMMING, 1 );
+		AddStat( iVictim, GE_AWARD_PROFESSIONAL, -2);
+		AddStat( iVictim, GE_AWARD_LEMMING, 1 );
 		return;
 	}
 
 	// Add the inflicted damage to our Most Deadly stat
-	m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_DEADLY, info.GetDamage() );
+	AddStat( iAttacker, GE_AWARD_DEADLY, info.GetDamage() );
 	// Add to the victim's mostly harmless award 1/2 the damage
-	m_pPlayerStats[iVictim]->AddStat( GE_AWARD_MOSTLYHARMLESS, info.GetDamage() / 2 );
+	AddStat( iVictim, GE_AWARD_MOSTLYHARMLESS, info.GetDamage() / 2 );
 
 	// See where this attack hit and then apply appropriate marksmanship points
 	int points = 0;
@@ -408,12 +599,12 @@ void CGEStats::Event_PlayerDamage( CBasePlayer *pBasePlayer, const CTakeDamageIn
 			points = 1; break;
 	}
 
-	m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_MARKSMANSHIP, points );
+	AddStat( iAttacker, GE_AWARD_MARKSMANSHIP, points );
 
 	// test if its fall damage
 	if( !info.GetInflictor() )
 	{
-		m_pPlayerStats[iVictim]->AddStat( GE_AWARD_PROFESSIONAL, -2);
+		AddStat( iVictim, GE_AWARD_PROFESSIONAL, -2);
 		return;
 	}
 
@@ -456,25 +647,25 @@ void CGEStats::Event_PlayerDamage( CBasePlayer *pBasePlayer, const CTakeDamageIn
 
 		if ( ang > 2.10f ) {
 			scale = RemapValClamped( ang, 2.10f, 3.14f, 0.2f, 1.0f );
-			m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_HONORABLE, 10*scale );
+			AddStat( iAttacker, GE_AWARD_HONORABLE, 10*scale );
 		} else if ( ang < 1.05f ) {
 			scale = RemapValClamped( ang, 0.0f, 1.05f, 0.2f, 1.0f );
-			m_pPlayerStats[iAttacker]->AddStat( GE_AWARD_DISHONORABLE, 10*scale );
+			AddStat( iAttacker, GE_AWARD_DISHONORABLE, 10*scale );
 		}
 	}
 
 	//Attacker using slappers, Victim not
 	if( pWeapon->GetWeaponID() == WEAPON_SLAPPERS && pVicWeapon->GetWeaponID() != WEAPON_SLAPPERS )
 	{
-		m_pPlayerStats[iAttacker]->AddStat(GE_AWARD_DEADLY, 10);
-		m_pPlayerStats[iAttacker]->AddStat(GE_AWARD_HONORABLE, 10);
+		AddStat( iAttacker, GE_AWARD_DEADLY, 10);
+		AddStat( iAttacker, GE_AWARD_HONORABLE, 10);
 	}
 	
 	//Victim using slappers, Attacker not
 	if( pWeapon->GetWeaponID() != WEAPON_SLAPPERS && pVicWeapon->GetWeaponID() == WEAPON_SLAPPERS )
 	{
-		m_pPlayerStats[iAttacker]->AddStat(GE_AWARD_DISHONORABLE, 10);
-		m_pPlayerStats[iAttacker]->AddStat(GE_AWARD_PROFESSIONAL, -5);
+		AddStat( iAttacker, GE_AWARD_DISHONORABLE, 10);
+		AddStat( iAttacker, GE_AWARD_PROFESSIONAL, -5);
 	}
 
 	BaseClass::Event_PlayerDamage( pBasePlayer, info );
@@ -487,7 +678,7 @@ void CGEStats::Event_PlayerTraveled( CBasePlayer *pBasePlayer, float distanceInI
 		return;
 
 	// Record the absolute number of feet traveled, the farther they go the more frantic they are
-	m_pPlayerStats[iPlayer]->AddStat(GE_AWARD_FRANTIC, distanceInInches / 12);
+	AddStat( iPlayer, GE_AWARD_FRANTIC, distanceInInches / 12);
 
 	BaseClass::Event_PlayerTraveled( pBasePlayer, distanceInInches, bInVehicle, bSprinting );
 }
@@ -502,7 +693,7 @@ void CGEStats::Event_WeaponSwitch( CBasePlayer *player, CBaseCombatWeapon *currW
 	if ( !pGEWeapon || pGEWeapon->GetWeaponID() <= WEAPON_NONE || pGEWeapon->GetWeaponID() >= WEAPON_MAX )
 		return;
 
-	m_pPlayerStats[iPlayer]->m_iWeaponsHeldTime[pGEWeapon->GetWeaponID()] += pGEWeapon->GetHeldTime();
+	m_PlayerStats[iPlayer].m_iWeaponsHeldTime[pGEWeapon->GetWeaponID()] += pGEWeapon->GetHeldTime();
 }
 
 void CGEStats::Event_PickedArmor( CBasePlayer *pBasePlayer, int amt )
@@ -514,10 +705,12 @@ void CGEStats::Event_PickedArmor( CBasePlayer *pBasePlayer, int amt )
 
 	// The less armor they actually pickup the higher their AC10 will be
 	// thus the person with the highest AC10 is clearly picking up a lot of armor for little gain
-	m_pPlayerStats[iPlayer]->AddStat(GE_AWARD_AC10, pPlayer->GetMaxArmor() - amt);
+	AddStat( iPlayer, GE_AWARD_AC10, pPlayer->GetMaxArmor() - amt);
 
 	// Every armor pick pulls them out by 2 points to seperate people who pick armor often and those that don't pick at all
-	m_pPlayerStats[iPlayer]->AddStat(GE_AWARD_NOTAC10, 2);
+	AddStat( iPlayer, GE_AWARD_NOTAC10, 2);
+
+	GETelemetry()->Record( GE_TELEMETRY_ARMOR, pBasePlayer, NULL, WEAPON_NONE, amt );
 }
 
 void CGEStats::Event_PickedAmmo( CBasePlayer *pBasePlayer, int amt )
@@ -526,12 +719,13 @@ void CGEStats::Event_PickedAmmo( CBasePlayer *pBasePlayer, int amt )
 	if ( iPlayer == -1 )
 		return;
 
-	m_pPlayerStats[iPlayer]->AddStat(GE_AWARD_WTA, amt);
+	AddStat( iPlayer, GE_AWARD_WTA, amt);
+
+	GETelemetry()->Record( GE_TELEMETRY_AMMO, pBasePlayer, NULL, WEAPON_NONE, amt );
 }
 
-bool CGEStats::GetAwardWinner( int iAward, GEStatSort &winner )
+bool CGEStats::GetAwardWinner( int iAward, int iEligible, GEStatSort &winner )
 {
-	CUtlVector<GEStatSort*> stats;
 	if ( GEMPRules()->GetNumActivePlayers() < 2 )
 		return false;
 
@@ -539,50 +733,31 @@ bool CGEStats::GetAwardWinner( int iAward, GEStatSort &winner )
 	winner.m_iAward = -1;
 	winner.m_iStat = 0;
 
-	CGEPlayer *pPlayer = NULL;
-	// First parse out all the award to player information
-	for ( int i=0; i < m_pPlayerStats.Count(); i++ )
-	{
-		// Don't try to give awards to invalid players
-		pPlayer = m_pPlayerStats[i]->GetPlayer();
-		if ( !pPlayer )
-			continue;
-		if ( pPlayer->GetTeamNumber() == TEAM_SPECTATOR )
-			continue;
-
-		GEStatSort *entry = new GEStatSort;
-		entry->idx = i;
-
-		// If this is the last report, then take the match stats, average them over the rounds, and use that as our stat
-		if ( GEGameplay()->IsInFinalIntermission() )
-			entry->m_iStat = m_pPlayerStats[i]->GetMatchStat( iAward ) / m_iRoundCount;
-		else
-			entry->m_iStat = m_pPlayerStats[i]->GetRoundStat( iAward );
+	// Make sure after our checks we have at least two players to do awards for
+	if ( iEligible < 2 )
+		return false;
 
-		stats.AddToTail( entry );
-	}
+	// If this is the last report, then take the match stats, average them over the rounds, and use that as our stat
+	bool bMatch = GEGameplay()->IsInFinalIntermission();
 
-	// Make sure after our checks we have at least two players to do awards for
-	if ( stats.Count() < 2 )
+	int iFirst, iSecond;
+	if ( !GetAwardLeaders( iAward, bMatch, iFirst, iSecond ) )
 		return false;
 
-	float playerrat = (float)(stats.Count() + GE_STATS_PLAYERRATIO) / (float)stats.Count();
+	int firstStat = GetAwardStat( iAward, iFirst, bMatch );
+	int secondStat = GetAwardStat( iAward, iSecond, bMatch );
 
-	if ( GetAwardSort(iAward) == GE_SORT_HIGH )
-		stats.Sort( &CGEStats::StatSortHigh );
-	else
-	{
-		stats.Sort( &CGEStats::StatSortLow );
-		// Since we are sorting low we have to invert our player ratio
-		playerrat = 1 / playerrat;
-	}
+	float playerrat = (float)(iEligible + GE_STATS_PLAYERRATIO) / (float)iEligible;
 
+	// Since we are sorting low we have to invert our player ratio
+	if ( GetAwardSort(iAward) != GE_SORT_HIGH )
+		playerrat = 1 / playerrat;
 
 	// Prevent divide by zero and inflation
-	if ( stats[1]->m_iStat == 0 )
-		stats[1]->m_iStat = 1;
+	if ( secondStat == 0 )
+		secondStat = 1;
 
-	float statrat = (float)stats[0]->m_iStat / (float)stats[1]->m_iStat;
+	float statrat = (float)firstStat / (float)secondStat;
 	
 	// Low sort should have a ratio less than the inverted playerrat
 	if ( GetAwardSort(iAward) == GE_SORT_HIGH ? statrat > playerrat : statrat < playerrat )
@@ -591,25 +766,61 @@ bool CGEStats::GetAwardWinner( int iAward, GEStatSort &winner )
 		if ( statrat == 0 )
 			statrat = 1;
 
-		winner.idx = stats[0]->idx;
+		winner.idx = iFirst;
 		winner.m_iStat = (GetAwardSort(iAward) == GE_SORT_HIGH ? statrat : 1/statrat) * 1000;  // 3 decimal precision
 		winner.m_iAward = iAward;
-
-		stats.PurgeAndDeleteElements();
 		return true;
 	}
 
-	stats.PurgeAndDeleteElements();
 	return false;
 }
 
+void CGEStats::BenchmarkAwards( int iterations )
+{
+	int iEligible = CountAwardEligible();
+	GEStatSort winner;
+	int given = 0;
+
+	// Steady state, leaderboards are kept current by the stat events
+	CFastTimer timer;
+	timer.Start();
+	for ( int n=0; n < iterations; n++ )
+	{
+		for ( int i=0; i < GE_AWARD_GIVEMAX; i++ )
+		{
+			if ( AwardIDToIdent(i) && GetAwardWinner( i, iEligible, winner ) )
+				given++;
+		}
+	}
+	timer.End();
+	float flCached = timer.GetDuration().GetMicrosecondsF() / max( iterations, 1 );
+
+	// Worst case, every leaderboard lost a leader and has to rescan its column
+	timer.Start();
+	for ( int n=0; n < iterations; n++ )
+	{
+		for ( int i=0; i < GE_AWARD_GIVEMAX; i++ )
+		{
+			m_Leaders[i].bDirty = true;
+			if ( AwardIDToIdent(i) && GetAwardWinner( i, iEligible, winner ) )
+				given++;
+		}
+	}
+	timer.End();
+	float flRescan = timer.GetDuration().GetMicrosecondsF() / max( iterations, 1 );
+
+	Msg( "Award selection for %i eligible players over %i iterations (%i awarded):\n", iEligible, iterations, given );
+	Msg( "  leaderboards current: %0.3f us per report\n", flCached );
+	Msg( "  leaderboards rescanned: %0.3f us per report\n", flRescan );
+}
+
 bool CGEStats::GetFavoriteWeapon( int iPlayer, GEWeaponSort &fav )
 {
-	if ( iPlayer < 0 || iPlayer >= m_pPlayerStats.Count() )
+	if ( iPlayer <= 0 || iPlayer > MAX_PLAYERS || !m_bConnected[iPlayer] )
 		return false;
 
-	GEPlayerStats *stats = m_pPlayerStats[iPlayer];
-	CBasePlayer *pPlayer = ToBasePlayer( m_pPlayerStats[iPlayer]->GetPlayer() );
+	GEPlayerStats *stats = &m_PlayerStats[iPlayer];
+	CBasePlayer *pPlayer = ToBasePlayer( stats->GetPlayer() );
 
 	if ( !pPlayer || !stats )
 		return false;
@@ -697,4 +908,13 @@ CON_COMMAND( ge_showstats, "USAGE: ge_showstats [PLAYERID]\n Shows PLAYERID's cu
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
+
+CON_COMMAND( ge_stats_benchmark, "USAGE: ge_stats_benchmark [ITERATIONS]\n Times the award selection done for each round report with the current players" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	int iterations = args.ArgC() > 1 ? atoi( args.Arg(1) ) : 1000;
+	GEStats()->BenchmarkAwards( max( iterations, 1 ) );
+}
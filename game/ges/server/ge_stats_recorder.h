@@ -22,22 +22,17 @@
 
 extern CGEPlayer *ToGEPlayer( CBaseEntity *pEntity );
 
+// Per player bookkeeping that isn't an award counter, award counters live
+// in per award columns on CGEStats so leaderboards walk contiguous memory
 class GEPlayerStats
 {
 public:
-	GEPlayerStats( CBasePlayer *player );
+	GEPlayerStats();
 
 	void SetPlayer( CBasePlayer *player ) { m_hPlayer = player; };
 	CGEPlayer *GetPlayer( void ) { return ToGEPlayer( m_hPlayer.Get() ); };
 
-	void AddStat( int idx, int amt );
-	void SetStat( int idx, int amt );
-
-	int GetRoundStat( int idx );
-	int GetMatchStat( int idx );
-
 	void ResetRoundStats( void );
-	void AddRoundToMatchStats( void );
 	void ResetMatchStats( void );
 
 	int m_iDeaths; // Used to keep track of ACTUAL deaths
@@ -49,14 +44,10 @@ public:
 	int m_iMatchWeapons[ WEAPON_MAX ];
 
 private:
-	int m_iRoundStats[ GE_AWARD_MAX ];
-	int m_iMatchStats[ GE_AWARD_MAX ];
-
 	EHANDLE m_hPlayer;
 };
 
-// This is used to build a new vector for sorting out the winner of a
-// certain stat (for speedier sorts)
+// Award results as handed to the round report
 struct GEStatSort
 {
 	int idx;
@@ -87,6 +78,9 @@ public:
 	void SetAwardsInEvent( IGameEvent* pEvent );
 	void SetFavoriteWeapons( void );
 
+	// Times the award selection done for every round report
+	void BenchmarkAwards( int iterations );
+
 	virtual void Event_PlayerConnected( CBasePlayer *pBasePlayer );
 	virtual void Event_PlayerDisconnected( CBasePlayer *pBasePlayer );
 
@@ -102,20 +96,47 @@ public:
 	virtual void Event_PickedArmor( CBasePlayer *pBasePlayer, int amt );
 	virtual void Event_PickedAmmo( CBasePlayer *pBasePlayer, int amt );
 
-	static int StatSortHigh( GEStatSort* const *a, GEStatSort* const *b ) { return ( (*b)->m_iStat - (*a)->m_iStat ); };
-	static int StatSortLow( GEStatSort* const *a, GEStatSort* const *b ) { return ( (*a)->m_iStat - (*b)->m_iStat ); };
+	static int StatSortHigh( const GEStatSort *a, const GEStatSort *b ) { return ( b->m_iStat - a->m_iStat ); };
 	static int WeaponSort( GEWeaponSort* const *a, GEWeaponSort* const *b ) { return ( (*b)->m_iPercentage - (*a)->m_iPercentage ); };
 
 private:
-	CUtlVector<GEPlayerStats*> m_pPlayerStats;
-	int m_iRoundCount;
-	float m_flRoundStartTime;
-
-	bool GetAwardWinner( int iAward, GEStatSort &winner );
+	// Award counters, always go through these so the leaderboards stay current
+	void AddStat( int iPlayer, int idx, int amt );
+	void SetStat( int iPlayer, int idx, int amt );
+	int  GetRoundStat( int iPlayer, int idx ) { return m_iRoundStats[idx][iPlayer]; }
+
+	// Running top two of each award's round column over every connected player
+	struct AwardLeaders_t
+	{
+		int  iFirst;
+		int  iSecond;
+		bool bDirty;	// A leader lost ground, rescan the column when asked
+	};
+
+	bool IsStatBetter( int iAward, int a, int b );
+	int  GetAwardStat( int iAward, int iPlayer, bool bMatch );
+	void UpdateLeaders( int iAward, int iPlayer, int oldStat );
+	void ScanLeaders( int iAward, bool bMatch, bool bEligibleOnly, int &iFirst, int &iSecond );
+	bool GetAwardLeaders( int iAward, bool bMatch, int &iFirst, int &iSecond );
+	bool IsAwardEligible( int iPlayer );
+	int  CountAwardEligible( void );
+
+	bool GetAwardWinner( int iAward, int iEligible, GEStatSort &winner );
 	bool GetFavoriteWeapon( int iPlayer, GEWeaponSort &fav );
 
 	GEPlayerStats *FindPlayerStats( CBasePlayer *player );
 	int FindPlayer( CBasePlayer *player );
+
+	// Indexed by player entity index
+	GEPlayerStats	m_PlayerStats[ MAX_PLAYERS + 1 ];
+	bool			m_bConnected[ MAX_PLAYERS + 1 ];
+
+	int m_iRoundStats[ GE_AWARD_MAX ][ MAX_PLAYERS + 1 ];
+	int m_iMatchStats[ GE_AWARD_MAX ][ MAX_PLAYERS + 1 ];
+	AwardLeaders_t m_Leaders[ GE_AWARD_GIVEMAX ];
+
+	int m_iRoundCount;
+	float m_flRoundStartTime;
 };
 
 inline CGEStats *GEStats()
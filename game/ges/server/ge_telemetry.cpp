@@ -0,0 +1,315 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_telemetry.cpp
+//
+// Description:
+//     See Header
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cbase.h"
+#include "ge_telemetry.h"
+#include "ge_gameplay.h"
+#include "filesystem.h"
+#include <time.h>
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+#define GE_TELEMETRY_DIR	"telemetry"
+#define GE_TELEMETRY_MASK	( GE_TELEMETRY_RING_SIZE - 1 )
+
+ConVar ge_telemetry( "ge_telemetry", "0", FCVAR_GAMEDLL, "Record kills, damage, weapon fire and pickups to binary match files in the telemetry folder, takes effect at the next match" );
+ConVar ge_telemetry_maxsize( "ge_telemetry_maxsize", "64", FCVAR_GAMEDLL, "Size in MB a telemetry file may reach before the match continues in a new file", true, 1.0f, true, 1024.0f );
+
+// Drains the ring to disk until asked to stop
+class CGETelemetryWriter : public CThread
+{
+public:
+	CGETelemetryWriter( CGETelemetry *pOwner )
+	{
+		m_pOwner = pOwner;
+		m_bStop = false;
+
+		SetName( "GETelemetryWriter" );
+		Start();
+	}
+
+	void Wake() { m_Wake.Set(); }
+
+	void Stop()
+	{
+		m_bStop = true;
+		m_Wake.Set();
+		Join();
+	}
+
+protected:
+	virtual int Run()
+	{
+		while ( !m_bStop )
+		{
+			m_Wake.Wait( 100 );
+			m_pOwner->Drain();
+		}
+
+		// Pick up anything queued right before we were stopped
+		m_pOwner->Drain();
+		m_pOwner->CloseFile();
+		return 0;
+	}
+
+	CGETelemetry *m_pOwner;
+	CThreadEvent m_Wake;
+	volatile bool m_bStop;
+};
+
+static CGETelemetry g_GETelemetry;
+CGETelemetry *GETelemetry() { return &g_GETelemetry; }
+
+CGETelemetry::CGETelemetry() : CAutoGameSystem( "CGETelemetry" )
+{
+	m_iPendingSeq = 0;
+	m_pWriter = NULL;
+	m_bRecording = false;
+	m_iRound = 0;
+
+	m_hFile = FILESYSTEM_INVALID_HANDLE;
+	m_iFileSize = 0;
+	m_iWritten = 0;
+}
+
+void CGETelemetry::LevelShutdownPreEntity()
+{
+	EndMatch();
+}
+
+void CGETelemetry::Shutdown()
+{
+	EndMatch();
+
+	if ( m_pWriter )
+	{
+		m_pWriter->Stop();
+		delete m_pWriter;
+		m_pWriter = NULL;
+	}
+}
+
+void CGETelemetry::BeginMatch()
+{
+	EndMatch();
+
+	if ( !ge_telemetry.GetBool() )
+		return;
+
+	if ( !m_pWriter )
+		m_pWriter = new CGETelemetryWriter( this );
+
+	// The writer picks this up when it reaches our open record, by then any
+	// earlier open record that used this slot is long gone
+	int slot = m_iPendingSeq++ % GE_TELEMETRY_MAX_PENDING;
+	PendingFile_t &pending = m_Pending[slot];
+	memset( &pending, 0, sizeof(pending) );
+
+	GETelemetryHeader_t &header = pending.header;
+	header.magic = GE_TELEMETRY_MAGIC;
+	header.version = GE_TELEMETRY_VERSION;
+	header.headerSize = sizeof(GETelemetryHeader_t);
+	header.recordSize = sizeof(GETelemetryRecord_t);
+	header.startTime = (unsigned int) time( NULL );
+	header.tickInterval = gpGlobals->interval_per_tick;
+	Q_strncpy( header.map, STRING(gpGlobals->mapname), sizeof(header.map) );
+	if ( GEGameplay() && GEGameplay()->GetScenario() )
+		Q_strncpy( header.gameplay, GEGameplay()->GetScenario()->GetIdent(), sizeof(header.gameplay) );
+
+	char szTime[32];
+	time_t now = header.startTime;
+	strftime( szTime, sizeof(szTime), "%Y%m%d_%H%M%S", localtime( &now ) );
+	Q_snprintf( pending.szBaseName, sizeof(pending.szBaseName), GE_TELEMETRY_DIR "/%s_%s", header.map, szTime );
+
+	GETelemetryRecord_t rec;
+	memset( &rec, 0, sizeof(rec) );
+	rec.type = CONTROL_OPEN;
+	rec.actor = slot;
+
+	m_iRound = 0;
+	m_bRecording = Push( rec );
+}
+
+void CGETelemetry::EndMatch()
+{
+	if ( !m_bRecording )
+		return;
+
+	m_bRecording = false;
+
+	GETelemetryRecord_t rec;
+	memset( &rec, 0, sizeof(rec) );
+	rec.type = CONTROL_CLOSE;
+	Push( rec );
+
+	m_pWriter->Wake();
+}
+
+void CGETelemetry::Record( GETelemetryType_t type, CBaseEntity *pActor, CBaseEntity *pTarget, int weapon, float amount, int hitgroup /*= 0*/, int flags /*= 0*/ )
+{
+	if ( !m_bRecording )
+		return;
+
+	GETelemetryRecord_t rec;
+	rec.type = type;
+	rec.weapon = weapon > 0 ? weapon : 0;
+	rec.hitgroup = hitgroup;
+	rec.flags = flags;
+	rec.tick = gpGlobals->tickcount;
+	rec.actor = pActor && pActor->IsPlayer() ? ((CBasePlayer*)pActor)->GetUserID() : 0;
+	rec.target = pTarget && pTarget->IsPlayer() ? ((CBasePlayer*)pTarget)->GetUserID() : 0;
+	rec.amount = amount;
+	rec.round = m_iRound;
+
+	// Damage and kills are about where the victim was standing
+	CBaseEntity *pWhere = pTarget ? pTarget : pActor;
+	if ( pWhere )
+	{
+		const Vector &pos = pWhere->GetAbsOrigin();
+		rec.pos[0] = pos.x;
+		rec.pos[1] = pos.y;
+		rec.pos[2] = pos.z;
+	}
+	else
+	{
+		rec.pos[0] = rec.pos[1] = rec.pos[2] = 0;
+	}
+
+	Push( rec );
+}
+
+bool CGETelemetry::Push( const GETelemetryRecord_t &rec )
+{
+	unsigned int head = m_iHead;
+	unsigned int used = head - m_iTail;
+
+	if ( used >= GE_TELEMETRY_RING_SIZE )
+	{
+		m_iDropped++;
+		return false;
+	}
+
+	m_Ring[ head & GE_TELEMETRY_MASK ] = rec;
+	// Interlocked so the record is visible before the writer sees the new head
+	m_iHead = head + 1;
+
+	// Don't wait out the writer's sleep if we are filling up fast
+	if ( used == GE_TELEMETRY_RING_SIZE / 2 && m_pWriter )
+		m_pWriter->Wake();
+
+	return true;
+}
+
+// Writer thread
+void CGETelemetry::Drain()
+{
+	unsigned int tail = m_iTail;
+	unsigned int head = m_iHead;
+
+	while ( tail != head )
+	{
+		const GETelemetryRecord_t &rec = m_Ring[ tail & GE_TELEMETRY_MASK ];
+		if ( rec.type >= CONTROL_OPEN )
+		{
+			HandleControl( rec );
+			m_iTail = ++tail;
+			continue;
+		}
+
+		// Write out the run of records up to the next control record or the end of the ring
+		unsigned int run = 1;
+		while ( tail + run != head && ((tail + run) & GE_TELEMETRY_MASK) != 0 && m_Ring[ (tail + run) & GE_TELEMETRY_MASK ].type < CONTROL_OPEN )
+			run++;
+
+		WriteRecords( &rec, run );
+
+		tail += run;
+		m_iTail = tail;
+	}
+}
+
+// Writer thread
+void CGETelemetry::HandleControl( const GETelemetryRecord_t &rec )
+{
+	CloseFile();
+
+	if ( rec.type == CONTROL_OPEN )
+	{
+		m_Current = m_Pending[ rec.actor % GE_TELEMETRY_MAX_PENDING ];
+		OpenFile();
+	}
+}
+
+// Writer thread
+void CGETelemetry::WriteRecords( const GETelemetryRecord_t *pRecords, int count )
+{
+	if ( m_hFile == FILESYSTEM_INVALID_HANDLE )
+		return;
+
+	unsigned int bytes = count * sizeof(GETelemetryRecord_t);
+	unsigned int maxsize = (unsigned int) ge_telemetry_maxsize.GetInt() * 1024 * 1024;
+
+	// Continue the match in a new part instead of growing forever
+	if ( m_iFileSize + bytes > maxsize )
+	{
+		CloseFile();
+		m_Current.header.part++;
+		if ( !OpenFile() )
+			return;
+	}
+
+	filesystem->Write( pRecords, bytes, m_hFile );
+	m_iFileSize += bytes;
+	m_iWritten += count;
+}
+
+// Writer thread
+bool CGETelemetry::OpenFile()
+{
+	char szFile[MAX_PATH];
+	Q_snprintf( szFile, sizeof(szFile), "%s_%02u" GE_TELEMETRY_EXTENSION, m_Current.szBaseName, m_Current.header.part );
+
+	filesystem->CreateDirHierarchy( GE_TELEMETRY_DIR, "MOD" );
+	m_hFile = filesystem->Open( szFile, "wb", "MOD" );
+	if ( m_hFile == FILESYSTEM_INVALID_HANDLE )
+	{
+		Warning( "[Telemetry] Failed to open %s for writing\n", szFile );
+		return false;
+	}
+
+	filesystem->Write( &m_Current.header, sizeof(GETelemetryHeader_t), m_hFile );
+	m_iFileSize = sizeof(GETelemetryHeader_t);
+	return true;
+}
+
+// Writer thread
+void CGETelemetry::CloseFile()
+{
+	if ( m_hFile == FILESYSTEM_INVALID_HANDLE )
+		return;
+
+	filesystem->Close( m_hFile );
+	m_hFile = FILESYSTEM_INVALID_HANDLE;
+}
+
+void CGETelemetry::PrintStatus()
+{
+	Msg( "Telemetry: %s, %u records written, %u dropped, %u queued\n", m_bRecording ? "recording" : "idle",
+		(unsigned int) m_iWritten, (unsigned int) m_iDropped, (unsigned int) m_iHead - (unsigned int) m_iTail );
+}
+
+CON_COMMAND( ge_telemetry_status, "Shows how much match telemetry has been written and dropped" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	GETelemetry()->PrintStatus();
+}
@@ -0,0 +1,92 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_telemetry.h
+//
+// Description:
+//      Binary match telemetry fed by CGEStats. Records go into a single
+//      producer / single consumer ring that a worker thread drains into
+//      rotating match files, the game thread never touches the disk.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_TELEMETRY_H
+#define GE_TELEMETRY_H
+
+#include "igamesystem.h"
+#include "threadtools.h"
+#include "ge_telemetry_format.h"
+
+// Number of records the ring can hold, must be a power of two
+#define GE_TELEMETRY_RING_SIZE		16384
+// Number of match headers that can be queued before the writer picks them up
+#define GE_TELEMETRY_MAX_PENDING	4
+
+class CGETelemetryWriter;
+
+class CGETelemetry : public CAutoGameSystem
+{
+public:
+	CGETelemetry();
+
+	virtual void LevelShutdownPreEntity();
+	virtual void Shutdown();
+
+	// Closes the current match file and starts a new one on the writer
+	void BeginMatch();
+	void EndMatch();
+
+	void SetRound( int round ) { m_iRound = round; }
+
+	bool IsRecording() { return m_bRecording; }
+
+	// Queue a record, drops it if the writer has fallen behind instead of waiting
+	void Record( GETelemetryType_t type, CBaseEntity *pActor, CBaseEntity *pTarget, int weapon, float amount, int hitgroup = 0, int flags = 0 );
+
+	void PrintStatus();
+
+private:
+	friend class CGETelemetryWriter;
+
+	// Internal record types used to drive the writer, never written out
+	enum
+	{
+		CONTROL_OPEN = 0xF0,
+		CONTROL_CLOSE,
+	};
+
+	bool Push( const GETelemetryRecord_t &rec );
+	void Drain();
+	void HandleControl( const GETelemetryRecord_t &rec );
+	void WriteRecords( const GETelemetryRecord_t *pRecords, int count );
+	bool OpenFile();
+	void CloseFile();
+
+	GETelemetryRecord_t	m_Ring[ GE_TELEMETRY_RING_SIZE ];
+	CInterlockedUInt	m_iHead;	// Only written by the game thread
+	CInterlockedUInt	m_iTail;	// Only written by the writer thread
+	CInterlockedUInt	m_iDropped;
+
+	struct PendingFile_t
+	{
+		GETelemetryHeader_t header;
+		char				szBaseName[MAX_PATH];
+	};
+
+	// Filled in by the game thread, read by the writer when it reaches the open record
+	PendingFile_t	m_Pending[ GE_TELEMETRY_MAX_PENDING ];
+	int				m_iPendingSeq;
+
+	CGETelemetryWriter *m_pWriter;
+	bool	m_bRecording;
+	int		m_iRound;
+
+	// Writer thread state
+	FileHandle_t	m_hFile;
+	PendingFile_t	m_Current;
+	unsigned int	m_iFileSize;
+	unsigned int	m_iWritten;
+};
+
+CGETelemetry *GETelemetry();
+
+#endif
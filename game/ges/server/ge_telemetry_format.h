@@ -0,0 +1,73 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_telemetry_format.h
+//
+// Description:
+//      On disk layout of the binary match telemetry files. A file is a single
+//      header followed by fixed size records, the record count comes from the
+//      file size so files can be mapped straight into memory while they are
+//      still being written. Shared with the standalone telemetry reader so
+//      this must not depend on anything from the SDK.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_TELEMETRY_FORMAT_H
+#define GE_TELEMETRY_FORMAT_H
+
+#define GE_TELEMETRY_MAGIC		0x4D544547	// "GETM"
+#define GE_TELEMETRY_VERSION	1
+#define GE_TELEMETRY_EXTENSION	".getm"
+
+enum GETelemetryType_t
+{
+	GE_TELEMETRY_ROUNDSTART = 0,	// actor: round number
+	GE_TELEMETRY_KILL,				// actor: attacker, target: victim, amount: damage of the killing blow
+	GE_TELEMETRY_DAMAGE,			// actor: attacker, target: victim, amount: damage taken
+	GE_TELEMETRY_FIRE,				// actor: shooter
+	GE_TELEMETRY_ARMOR,				// actor: player, amount: armor gained
+	GE_TELEMETRY_AMMO,				// actor: player, amount: ammo gained
+
+	GE_TELEMETRY_TYPE_COUNT,
+};
+
+// Record flags
+#define GE_TELEMETRY_FL_HEADSHOT	0x01
+#define GE_TELEMETRY_FL_SUICIDE		0x02
+
+#pragma pack(push, 1)
+
+struct GETelemetryHeader_t
+{
+	unsigned int	magic;
+	unsigned int	version;
+	unsigned int	headerSize;
+	unsigned int	recordSize;
+	unsigned int	startTime;		// Unix time the match started
+	unsigned int	part;			// Files are split once they reach ge_telemetry_maxsize
+	float			tickInterval;
+	unsigned int	reserved;
+	char			map[64];
+	char			gameplay[32];
+};
+
+struct GETelemetryRecord_t
+{
+	unsigned char	type;			// GETelemetryType_t
+	unsigned char	weapon;			// GEWeaponID, 0 if none
+	unsigned char	hitgroup;
+	unsigned char	flags;
+	unsigned int	tick;
+	unsigned short	actor;			// Player user ids, 0 if none
+	unsigned short	target;
+	float			amount;
+	float			pos[3];			// Where the actor (or victim for damage/kills) was
+	unsigned int	round;
+};
+
+#pragma pack(pop)
+
+// Keep the layout identical on every compiler that reads or writes these
+typedef char GETelemetryHeaderSizeCheck_t[ sizeof(GETelemetryHeader_t) == 128 ? 1 : -1 ];
+typedef char GETelemetryRecordSizeCheck_t[ sizeof(GETelemetryRecord_t) == 32 ? 1 : -1 ];
+
+#endif
@@ -20,6 +20,7 @@
 #include "gemp_player.h"
 #include "gemp_gamerules.h"
 #include "ge_mapmanager.h"
+#include "ge_setuprecord.h"
 
 #include "team.h"
 #include "script_parser.h"
@@ -204,51 +205,20 @@ void CGEBaseGameplayManager::Shutdown()
 
 void CGEBaseGameplayManager::ParseLogData()
 {
-	char *contents = (char*)UTIL_LoadFileForMe("gamesetuprecord.txt", NULL);
+	const CUtlVector<char*> &vModes = GESetupRecord()->GetList( SETUPRECORD_MODES );
 
-	if (!contents)
+	for (int i = 0; i < vModes.Count(); i++)
 	{
-		Msg("No rotation log!\n");
-		return;
-	}
-
-	CUtlVector<char*> lines;
-	char linebuffer[64];
-	Q_SplitString(contents, "\n", lines);
-
-	bool readingmodes = false;
-
-	for (int i = 0; i < lines.Count(); i++)
-	{
-		// Ignore comments
-		if (!Q_strncmp(lines[i], "//", 2))
-			continue;
-
-		if (readingmodes)
+		// We could create a bunch of new strings, or we could just make use of the scenario list which already exists.
+		for (int j = 0; j < m_vScenarioList.Count(); j++)
 		{
-			if (!Q_strncmp(lines[i], "-", 1)) // Our symbol for the end of a block.
-				break;
-
-			Q_StrLeft(lines[i], -1, linebuffer, 64); // Take off the newline character.
-
-			// We could create a bunch of new strings, or we could just make use of the scenario list which already exists.
-			for (int i = 0; i < m_vScenarioList.Count(); i++)
+			if (!Q_strcmp(vModes[i], m_vScenarioList[j]))
 			{
-				if (!Q_strcmp(linebuffer, m_vScenarioList[i]))
-				{
-					m_vRecentScenarioList.AddToTail(m_vScenarioList[i]);
-					break;
-				}
+				m_vRecentScenarioList.AddToTail(m_vScenarioList[j]);
+				break;
 			}
 		}
-
-		if (!Q_strncmp(lines[i], "Modes:", 6))
-			readingmodes = true;
 	}
-
-	// NOTE: We do not purge the data!
-	ClearStringVector(lines);
-	delete[] contents;
 }
 
 void CGEBaseGameplayManager::GetRecentModes(CUtlVector<const char*> &modenames)
@@ -23,6 +23,7 @@
 #include "filesystem.h"
 
 #include "ge_playerspawn.h"
+#include "ge_setuprecord.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -227,44 +228,13 @@ void CGELoadoutManager::ParseGameplayAffinity( void )
 
 void CGELoadoutManager::ParseLogData()
 {
-	char *contents = (char*)UTIL_LoadFileForMe("gamesetuprecord.txt", NULL);
+	const CUtlVector<char*> &vLoadouts = GESetupRecord()->GetList( SETUPRECORD_LOADOUTS );
 
-	if (!contents)
+	for (int i = 0; i < vLoadouts.Count(); i++)
 	{
-		Msg("No rotation log!\n");
-		return;
-	}
-
-	CUtlVector<char*> lines;
-	char linebuffer[64];
-	Q_SplitString(contents, "\n", lines);
-
-	bool readingweps = false;
-
-	for (int i = 0; i < lines.Count(); i++)
-	{
-		// Ignore comments
-		if (!Q_strncmp(lines[i], "//", 2))
-			continue;
-
-		if (readingweps)
-		{
-			if (!Q_strncmp(lines[i], "-", 1)) // Our symbol for the end of a block.
-				break;
-
-			Q_StrLeft(lines[i], -1, linebuffer, 64); // Take off the newline character.
-
-			if (IsLoadout(linebuffer))
-				m_pRecentLoadouts.AddToTail(GetLoadout(linebuffer));
-		}
-
-		if (!Q_strncmp(lines[i], "Weps:", 5))
-			readingweps = true;
+		if (IsLoadout(vLoadouts[i]))
+			m_pRecentLoadouts.AddToTail(GetLoadout(vLoadouts[i]));
 	}
-
-	// NOTE: We do not purge the data!
-	ClearStringVector(lines);
-	delete[] contents;
 }
 
 void CGELoadoutManager::GetRecentLoadouts(CUtlVector<CGELoadout*> &loadouts)
@@ -19,9 +19,11 @@
 #include "ge_utils.h"
 #include "script_parser.h"
 #include "filesystem.h"
+#include "utlbuffer.h"
 
 #include "ge_playerspawn.h"
 #include "ge_mapmanager.h"
+#include "ge_setuprecord.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -32,13 +34,15 @@ ConVar ge_mapchooser_usemapcycle("ge_mapchooser_usemapcycle", "0", FCVAR_GAMEDLL
 ConVar ge_mapchooser_resthreshold("ge_mapchooser_resthreshold", "14", FCVAR_GAMEDLL, "The mapchooser will do everything it can to avoid switching between maps with this combined resintensity.");
 
 
-CGEMapManager::CGEMapManager(void)
+CGEMapManager::CGEMapManager(void) : m_SelectionIndex(k_eDictCompareTypeCaseSensitive)
 {
 	m_pCurrentSelectionData = NULL;
+	m_pDefaultSelectionData = NULL;
 }
 
 CGEMapManager::~CGEMapManager(void)
 {
+	m_SelectionIndex.RemoveAll();
 	m_pSelectionData.PurgeAndDeleteElements();
 	m_pLoadoutBlacklist.PurgeAndDeleteElements();
 	m_pMapGamemodes.PurgeAndDeleteElements();
@@ -54,6 +58,13 @@ void CGEMapManager::ParseMapSelectionData(void)
 	const char *baseDir = "scripts/maps/";
 	char filePath[256] = "";
 
+	// Selection values of every script we parsed last time, keyed by map name
+	CUtlDict<MapSelectionCacheEntry, int> cache;
+	LoadSelectionCache(cache);
+
+	bool cachedirty = false;
+	int reused = 0;
+
 	FileFindHandle_t finder;
 	const char *filename = filesystem->FindFirstEx("scripts/maps/*.txt", "MOD", &finder);
 
@@ -64,119 +75,114 @@ void CGEMapManager::ParseMapSelectionData(void)
 		Q_strlower(mapname);
 
 		// First see if we already have this.
-		for (int i = 0; i < m_pSelectionData.Count(); i++)
+		int idx = m_SelectionIndex.Find(mapname);
+		if (idx != m_SelectionIndex.InvalidIndex())
 		{
-			if (!strcmp(m_pSelectionData[i]->mapname, mapname))
-			{
-				delete m_pSelectionData[i];
-				m_pSelectionData.Remove(i);  // Get rid of it so we can update it.
-				break;  // We're just looking for one thing so we don't need to shift everything over and keep scanning like we otherwise would.
-			}
-		}
-		
-		MapSelectionData *pMapSelectionData = new MapSelectionData;
-
-		Q_strncpy(pMapSelectionData->mapname, mapname, 32); // We already have our map name.
-		
-		// Set the defaults for everything else
-		
-		int *valueptrs[5] = { &pMapSelectionData->baseweight, &pMapSelectionData->minplayers, &pMapSelectionData->maxplayers, &pMapSelectionData->teamthreshold, &pMapSelectionData->resintensity };
-		char *keyvalues[5] = { "BaseWeight", "MinPlayers", "MaxPlayers", "TeamThreshold", "ResIntensity" };
-		bool hasvalue[5] = { false, false, false, false, false };
-		int valuedefaults[5] = { 500, 0, 16, 12, 4 };
+			MapSelectionData *pOld = m_SelectionIndex[idx];
+			m_pSelectionData.FindAndRemove(pOld); // Get rid of it so we can update it.
+			m_SelectionIndex.RemoveAt(idx);
 
+			if (pOld == m_pDefaultSelectionData)
+				m_pDefaultSelectionData = NULL;
 
-		for (int v = 0; v < 5; v++)
-		{
-			*valueptrs[v] = valuedefaults[v]; // Set our default values incase the file is missing one.
+			delete pOld;
 		}
-		
-		// Load the file
+
 		Q_strncpy(filePath, baseDir, 256);
 		Q_strncat(filePath, filename, 256);
-		char *contents = (char*)UTIL_LoadFileForMe(filePath, NULL);
-		
-		if (contents)
-		{
-			CUtlVector<char*> lines;
-			CUtlVector<char*> data;
-			Q_SplitString(contents, "\n", lines);
-
-			bool skippingblock = false;
-
-			for (int i = 0; i < lines.Count(); i++)
-			{
-				// Ignore comments
-				if (!Q_strncmp(lines[i], "//", 2))
-					continue;
-
-				if (!skippingblock && Q_strstr(lines[i], "{")) // We've found an opening bracket, so we no longer care about anything until we hit the closing bracket.
-					skippingblock = true;
 
-				// If we're skipping over a bracketed section just ignore everything until the end.
-				if (skippingblock)
-				{
-					if (!Q_strstr(lines[i], "}")) // We don't actually care about the datablocks right now, so just look for the terminator.
-						continue; 
-					else
-						skippingblock = false;
-				}
+		MapSelectionData *pMapSelectionData = new MapSelectionData;
 
-				// Otherwise try parsing the line: [field]\s+[data]
-				if (Q_ExtractData(lines[i], data))
-				{	
-					for (int v = 0; v < 5; v++)
-					{
-						if (!Q_strcmp(data[0] , keyvalues[v]))
-						{
-							if (data.Count() > 1)
-								*valueptrs[v] = atoi(data[1]);
+		// Only reparse scripts that changed since we cached them
+		long filetime = filesystem->GetFileTime(filePath, "MOD");
+		int cacheidx = cache.Find(mapname);
 
-							hasvalue[v] = true;
+		bool parsed = true;
+		if (cacheidx != cache.InvalidIndex() && filetime != 0 && cache[cacheidx].filetime == filetime)
+		{
+			*pMapSelectionData = cache[cacheidx].data;
+			reused++;
+		}
+		else
+		{
+			parsed = ParseMapSelectionFile(filePath, mapname, pMapSelectionData);
 
-							if (hasvalue[0] && hasvalue[1] && hasvalue[2] && hasvalue[3] && hasvalue[4]) //If we got all of our values why are we still here?
-								break;
-						}
-					}
-				}
+			if (parsed)
+			{
+				if (cacheidx == cache.InvalidIndex())
+					cacheidx = cache.Insert(mapname);
 
-				// Clear the data set (do not purge!)
-				data.RemoveAll();
+				cache[cacheidx].data = *pMapSelectionData;
+				cache[cacheidx].filetime = filetime;
+				cachedirty = true;
 			}
+		}
 
+		if (parsed)
+		{
 			m_pSelectionData.AddToTail(pMapSelectionData);
+			m_SelectionIndex.Insert(mapname, pMapSelectionData);
 
 			if (!Q_strcmp("default", mapname)) // If this is our default map data, keep a record of it.
 				m_pDefaultSelectionData = pMapSelectionData;
-
-			// NOTE: We do not purge the data!
-			ClearStringVector(lines);
 		}
-
-		delete[] contents;
+		else
+		{
+			delete pMapSelectionData;
+		}
 
 		// Get the next one
 		filename = filesystem->FindNext(finder);
 	}
 	
 	filesystem->FindClose(finder);
+
+	// Scripts that were removed since last time don't need to stay in the cache
+	for (int i = cache.First(); i != cache.InvalidIndex(); )
+	{
+		int next = cache.Next(i);
+		if (m_SelectionIndex.Find(cache.GetElementName(i)) == m_SelectionIndex.InvalidIndex())
+		{
+			cache.RemoveAt(i);
+			cachedirty = true;
+		}
+		i = next;
+	}
+
+	if (cachedirty)
+		SaveSelectionCache(cache);
+
+	DevMsg("Loaded selection data for %d maps, %d from cache\n", m_pSelectionData.Count(), reused);
+
+	BuildPlayerCountBuckets();
 }
 
-void CGEMapManager::ParseLogData()
+bool CGEMapManager::ParseMapSelectionFile(const char *filePath, const char *mapname, MapSelectionData *pMapSelectionData)
 {
-	char *contents = (char*)UTIL_LoadFileForMe("gamesetuprecord.txt", NULL);
-
+	char *contents = (char*)UTIL_LoadFileForMe(filePath, NULL);
 	if (!contents)
+		return false;
+
+	Q_strncpy(pMapSelectionData->mapname, mapname, 32); // We already have our map name.
+
+	// Set the defaults for everything else
+
+	int *valueptrs[5] = { &pMapSelectionData->baseweight, &pMapSelectionData->minplayers, &pMapSelectionData->maxplayers, &pMapSelectionData->teamthreshold, &pMapSelectionData->resintensity };
+	char *keyvalues[5] = { "BaseWeight", "MinPlayers", "MaxPlayers", "TeamThreshold", "ResIntensity" };
+	bool hasvalue[5] = { false, false, false, false, false };
+	int valuedefaults[5] = { 500, 0, 16, 12, 4 };
+
+
+	for (int v = 0; v < 5; v++)
 	{
-		Msg("No rotation log!\n");
-		return;
+		*valueptrs[v] = valuedefaults[v]; // Set our default values incase the file is missing one.
 	}
 
 	CUtlVector<char*> lines;
-	char linebuffer[64];
+	CUtlVector<char*> data;
 	Q_SplitString(contents, "\n", lines);
 
-	bool readingmaps = false;
+	bool skippingblock = false;
 
 	for (int i = 0; i < lines.Count(); i++)
 	{
@@ -184,26 +190,110 @@ void CGEMapManager::ParseLogData()
 		if (!Q_strncmp(lines[i], "//", 2))
 			continue;
 
-		if (readingmaps)
+		if (!skippingblock && Q_strstr(lines[i], "{")) // We've found an opening bracket, so we no longer care about anything until we hit the closing bracket.
+			skippingblock = true;
+
+		// If we're skipping over a bracketed section just ignore everything until the end.
+		if (skippingblock)
 		{
-			if (!Q_strncmp(lines[i], "-", 1)) // Our symbol for the end of a block.
-				break;
+			if (!Q_strstr(lines[i], "}")) // We don't actually care about the datablocks right now, so just look for the terminator.
+				continue; 
+			else
+				skippingblock = false;
+		}
 
-			Q_StrLeft(lines[i], -1, linebuffer, 64); // Take off the newline character.
+		// Otherwise try parsing the line: [field]\s+[data]
+		if (Q_ExtractData(lines[i], data))
+		{	
+			for (int v = 0; v < 5; v++)
+			{
+				if (!Q_strcmp(data[0] , keyvalues[v]))
+				{
+					if (data.Count() > 1)
+						*valueptrs[v] = atoi(data[1]);
 
-			MapSelectionData *mapData = GetMapSelectionData(linebuffer);
+					hasvalue[v] = true;
 
-			if (mapData)
-				m_pRecentMaps.AddToTail(mapData);
+					if (hasvalue[0] && hasvalue[1] && hasvalue[2] && hasvalue[3] && hasvalue[4]) //If we got all of our values why are we still here?
+						break;
+				}
+			}
 		}
 
-		if (!Q_strncmp(lines[i], "Maps:", 5))
-			readingmaps = true;
+		// Nothing holds on to the extracted fields
+		ClearStringVector(data);
 	}
 
-	// NOTE: We do not purge the data!
 	ClearStringVector(lines);
 	delete[] contents;
+
+	return true;
+}
+
+void CGEMapManager::LoadSelectionCache(CUtlDict<MapSelectionCacheEntry, int> &cache)
+{
+	CUtlBuffer buf;
+	if (!filesystem->ReadFile(MAPSELECTION_CACHE_FILE, "MOD", buf))
+		return;
+
+	// Anything that doesn't look exactly like what we write gets rebuilt from the scripts
+	if (buf.GetInt() != MAPSELECTION_CACHE_VERSION || buf.GetInt() != sizeof(MapSelectionCacheEntry))
+		return;
+
+	int count = buf.GetInt();
+	if (count < 0 || buf.GetBytesRemaining() != count * (int)sizeof(MapSelectionCacheEntry))
+		return;
+
+	for (int i = 0; i < count; i++)
+	{
+		MapSelectionCacheEntry entry;
+		buf.Get(&entry, sizeof(entry));
+		entry.data.mapname[sizeof(entry.data.mapname) - 1] = '\0';
+
+		cache.Insert(entry.data.mapname, entry);
+	}
+}
+
+void CGEMapManager::SaveSelectionCache(CUtlDict<MapSelectionCacheEntry, int> &cache)
+{
+	CUtlBuffer buf;
+	buf.PutInt(MAPSELECTION_CACHE_VERSION);
+	buf.PutInt(sizeof(MapSelectionCacheEntry));
+	buf.PutInt(cache.Count());
+
+	for (int i = cache.First(); i != cache.InvalidIndex(); i = cache.Next(i))
+		buf.Put(&cache[i], sizeof(MapSelectionCacheEntry));
+
+	filesystem->WriteFile(MAPSELECTION_CACHE_FILE, "MOD", buf);
+}
+
+void CGEMapManager::BuildPlayerCountBuckets(void)
+{
+	for (int n = 0; n < MAPSELECTION_BUCKETS; n++)
+		m_pPlayerCountBuckets[n].RemoveAll();
+
+	// A map is in range for every playercount from its minimum to its maximum, inclusive
+	for (int i = 0; i < m_pSelectionData.Count(); i++)
+	{
+		int low = max(m_pSelectionData[i]->minplayers, 0);
+		int high = min(m_pSelectionData[i]->maxplayers, MAPSELECTION_BUCKETS - 1);
+
+		for (int n = low; n <= high; n++)
+			m_pPlayerCountBuckets[n].AddToTail(m_pSelectionData[i]);
+	}
+}
+
+void CGEMapManager::ParseLogData()
+{
+	const CUtlVector<char*> &vMaps = GESetupRecord()->GetList( SETUPRECORD_MAPS );
+
+	for (int i = 0; i < vMaps.Count(); i++)
+	{
+		MapSelectionData *mapData = GetMapSelectionData(vMaps[i]);
+
+		if (mapData)
+			m_pRecentMaps.AddToTail(mapData);
+	}
 }
 
 void CGEMapManager::ParseMapData(const char *mapname)
@@ -214,13 +304,7 @@ void CGEMapManager::ParseMapData(const char *mapname)
 	m_pCurrentSelectionData = NULL; // Zero this out so we don't keep the pointer to the old map data.
 
 	// We already parsed the selection data so just grab that now.
-	for (int i = 0; i < m_pSelectionData.Count(); i++)
-	{
-		if (!strcmp(m_pSelectionData[i]->mapname, mapname))
-		{
-			m_pCurrentSelectionData = m_pSelectionData[i];
-		}
-	}
+	m_pCurrentSelectionData = GetMapSelectionData(mapname);
 
 	if (!m_pCurrentSelectionData)
 		m_pCurrentSelectionData = m_pDefaultSelectionData;
@@ -397,11 +481,9 @@ void CGEMapManager::ParseCurrentMapData(void)
 
 MapSelectionData* CGEMapManager::GetMapSelectionData(const char *mapname)
 {
-	for (int i = 0; i < m_pSelectionData.Count(); i++)
-	{
-		if (!strcmp(m_pSelectionData[i]->mapname, mapname))
-			return m_pSelectionData[i];
-	}
+	int idx = m_SelectionIndex.Find(mapname);
+	if (idx != m_SelectionIndex.InvalidIndex())
+		return m_SelectionIndex[idx];
 
 	return NULL; // We didn't find it, so they get nothing!
 }
@@ -493,34 +575,40 @@ void CGEMapManager::GetViableMapList(int iNumPlayers, CUtlVector<char*> &mapname
 
 	DevMsg("---Choosing Map for playercount %d---\n", iNumPlayers);
 
-	for (int i = 0; i < m_pSelectionData.Count(); i++)
+	// Only the maps whose player range covers this count can be picked
+	if (iNumPlayers < 0 || iNumPlayers >= MAPSELECTION_BUCKETS)
+		return;
+
+	const CUtlVector< MapSelectionData* > &candidates = m_pPlayerCountBuckets[iNumPlayers];
+
+	for (int i = 0; i < candidates.Count(); i++)
 	{
-		int lowerbound = m_pSelectionData[i]->minplayers - 1; // Have to add and subtract one here so the range is inclusive.
-		int upperbound = m_pSelectionData[i]->maxplayers + 1; // and also smoothly tapers off in weight with our formula.
+		int lowerbound = candidates[i]->minplayers - 1; // Have to add and subtract one here so the range is inclusive.
+		int upperbound = candidates[i]->maxplayers + 1; // and also smoothly tapers off in weight with our formula.
 
 		if (ge_mapchooser_avoidteamplay.GetBool()) // If we want to avoid teamplay our playercount has to come in below the teamthresh.
-			upperbound = min(m_pSelectionData[i]->teamthreshold, m_pSelectionData[i]->maxplayers + 1);
+			upperbound = min(candidates[i]->teamthreshold, candidates[i]->maxplayers + 1);
 
-		DevMsg("Looking at %s, with high %d, low %d\n", m_pSelectionData[i]->mapname, upperbound, lowerbound);
-		if (lowerbound < iNumPlayers && upperbound > iNumPlayers && engine->IsMapValid(m_pSelectionData[i]->mapname)) //It's within range, calculate weight adjustment.
+		DevMsg("Looking at %s, with high %d, low %d\n", candidates[i]->mapname, upperbound, lowerbound);
+		if (lowerbound < iNumPlayers && upperbound > iNumPlayers && engine->IsMapValid(candidates[i]->mapname)) //It's within range, calculate weight adjustment.
 		{
-			mapnames.AddToTail(m_pSelectionData[i]->mapname);
+			mapnames.AddToTail(candidates[i]->mapname);
 
-			int mapweight = m_pSelectionData[i]->baseweight;
+			int mapweight = candidates[i]->baseweight;
 			float playerradius = (upperbound - lowerbound) * 0.5;
 			float centercount = (upperbound + lowerbound) * 0.5;
 			float weightscale = 1 - abs(centercount - (float)iNumPlayers) / playerradius; // The closer we are to the center of our range the higher our weight is.
 			int finalweight = round(mapweight * weightscale);
 
-			if (m_pSelectionData[i] == m_pCurrentSelectionData)
+			if (candidates[i] == m_pCurrentSelectionData)
 				currentmapindex = mapnames.Count() - 1; // Record the current map index so we can remove it later if we have any other viable maps.
 
-			DevMsg("Added %s with weight %d\n", m_pSelectionData[i]->mapname, finalweight);
+			DevMsg("Added %s with weight %d\n", candidates[i]->mapname, finalweight);
 
 			mapweights.AddToTail(finalweight);
-			mapintensities.AddToTail(m_pSelectionData[i]->resintensity);
+			mapintensities.AddToTail(candidates[i]->resintensity);
 
-			if ( m_pSelectionData[i]->resintensity + currentResIntensity < intensitythresh && m_pSelectionData[i] != m_pCurrentSelectionData )
+			if ( candidates[i]->resintensity + currentResIntensity < intensitythresh && candidates[i] != m_pCurrentSelectionData )
 				goodintensitycount++;
 		}
 	}
@@ -11,6 +11,7 @@
 #include "ge_gameplay.h"
 #include "ge_loadout.h"
 #include "ge_spawner.h"
+#include "utldict.h"
 
 // Struct that holds data relevant to map selection
 struct MapSelectionData
@@ -23,6 +24,19 @@ struct MapSelectionData
 	int		resintensity;
 };
 
+// Selection values of a map script as stored in the on disk cache
+struct MapSelectionCacheEntry
+{
+	MapSelectionData data;
+	long	filetime;
+};
+
+#define MAPSELECTION_CACHE_FILE		"mapselection.cache"
+#define MAPSELECTION_CACHE_VERSION	1
+
+// One bucket of candidate maps per possible playercount
+#define MAPSELECTION_BUCKETS		(MAX_PLAYERS + 1)
+
 struct MapWeightData
 {
 	char	mapname[32];
@@ -84,9 +98,25 @@ public:
 
 private:
 
+	// Parse the selection values out of a single map script file
+	bool ParseMapSelectionFile( const char *filePath, const char *mapname, MapSelectionData *pMapSelectionData );
+
+	// Cache of parsed map scripts so we only reparse the ones that changed
+	void LoadSelectionCache( CUtlDict<MapSelectionCacheEntry, int> &cache );
+	void SaveSelectionCache( CUtlDict<MapSelectionCacheEntry, int> &cache );
+
+	// Sort the maps into m_pPlayerCountBuckets
+	void BuildPlayerCountBuckets(void);
+
 	// Array that holds data from all the maps relevant to selection.
 	CUtlVector< MapSelectionData* >	m_pSelectionData;
 
+	// Map name lookup into m_pSelectionData
+	CUtlDict< MapSelectionData*, int >	m_SelectionIndex;
+
+	// Maps whose player range covers each playercount, in m_pSelectionData order
+	CUtlVector< MapSelectionData* >	m_pPlayerCountBuckets[MAPSELECTION_BUCKETS];
+
 	// Pointer to the selection data of the current map
 	MapSelectionData* m_pCurrentSelectionData;
 
@@ -13,15 +13,15 @@
 #include "ge_playerspawn.h"
 #include "gemp_gamerules.h"
 #include "gemp_player.h"
+#include "ge_spawngrid.h"
 #include "ai_network.h"
 #include "ge_ai.h"
 #include "ai_node.h"
+#include "collisionutils.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
 
-// Efficiency of our desirability calcs
-#define SPAWNER_CALC_EFFICIENCY		1.0f
 // Fade time cap
 #define SPAWNER_USEFADE_LIMIT		40.0f
 // Death time cap
@@ -40,6 +40,15 @@
 // Spawnflag to disallow bots to use this point
 #define SF_NO_BOTS 0x1
 
+// Player visibility states stored in the per-tick cache
+enum
+{
+	SPAWNER_VIS_UNKNOWN = 0,
+	SPAWNER_VIS_NOPVS,
+	SPAWNER_VIS_OCCLUDED,
+	SPAWNER_VIS_CLEAR,
+};
+
 LINK_ENTITY_TO_CLASS( info_player_deathmatch, CGEPlayerSpawn );
 LINK_ENTITY_TO_CLASS( info_player_spectator, CGEPlayerSpawn );
 LINK_ENTITY_TO_CLASS( info_player_janus, CGEPlayerSpawn );
@@ -47,12 +56,12 @@ LINK_ENTITY_TO_CLASS( info_player_mi6, CGEPlayerSpawn );
 
 BEGIN_DATADESC( CGEPlayerSpawn )
 	DEFINE_KEYFIELD( m_flDesirabilityMultiplier, FIELD_FLOAT, "desirability" ),
-	// Think
-	DEFINE_THINKFUNC( Think ),
 END_DATADESC()
 
 ConVar ge_debug_playerspawns( "ge_debug_playerspawns", "0", FCVAR_CHEAT | FCVAR_GAMEDLL, "Debug spawn point locations and desirability, 1=DM, 2=MI6, 3=Janus" );
 
+CGEPlayerSpawn::ThreatStats_t CGEPlayerSpawn::s_ThreatStats;
+
 CGEPlayerSpawn::CGEPlayerSpawn( void ) 
 	: m_iTeam( TEAM_INVALID )
 { 
@@ -63,6 +72,7 @@ CGEPlayerSpawn::CGEPlayerSpawn( void )
 	m_fDeathFadeTime = 0;
 	m_fMaxSpawnDist = 0;
 	m_flDesirabilityMultiplier = 1;
+	InvalidateThreatCache();
 }
 
 void CGEPlayerSpawn::Spawn( void )
@@ -87,8 +97,7 @@ void CGEPlayerSpawn::Spawn( void )
 	// Multiply the default weight by the hammer modifer
 	m_iBaseDesirability = SPAWNER_DEFAULT_WEIGHT * m_flDesirabilityMultiplier;
 
-	SetThink( &CGEPlayerSpawn::Think );
-	SetNextThink( gpGlobals->curtime );
+	// We don't think, the spawner scheduler draws our debug overlay
 }
 
 void CGEPlayerSpawn::OnInit( void )
@@ -96,16 +105,6 @@ void CGEPlayerSpawn::OnInit( void )
 	ResetTrackers();
 }
 
-void CGEPlayerSpawn::Think( void )
-{
-	SetNextThink( gpGlobals->curtime + SPAWNER_CALC_EFFICIENCY );
-
-	// If we are debugging spawners show it now
-	if ( ge_debug_playerspawns.GetBool() )
-		DEBUG_ShowOverlay( SPAWNER_CALC_EFFICIENCY );
-}
-
-
 int CGEPlayerSpawn::GetDesirability(CGEPlayer *pRequestor)
 {
 	//Calculates proximity modifier, and ticks down use and death modifiers.
@@ -128,18 +127,97 @@ int CGEPlayerSpawn::GetDesirability(CGEPlayer *pRequestor)
 	if (GEMPRules()->IsTeamplay() && GEMPRules()->IsTeamSpawnSwapped() && m_iTeam >= FIRST_GAME_TEAM)
 		myTeam = (myTeam == TEAM_JANUS) ? TEAM_MI6 : TEAM_JANUS;
 
-	m_iLastEnemyWeight = m_iLastUseWeight = m_iLastDeathWeight = 0;
+	m_iLastUseWeight = m_iLastDeathWeight = 0;
+
+	// The enemy weight only depends on the requestor when a DM spawn is used in teamplay
+	int requestorTeam = TEAM_UNASSIGNED;
+	if (GEMPRules()->IsTeamplay() && myTeam == TEAM_UNASSIGNED)
+		requestorTeam = pRequestor->GetTeamNumber();
+
+	m_iLastEnemyWeight = GetEnemyWeight(myTeam, requestorTeam);
+
+	// Spit out percentage of death time
+	float timeDiff = m_fDeathFadeTime - gpGlobals->curtime;
+	m_iLastDeathWeight = RemapValClamped(timeDiff, 0, SPAWNER_DEATHFADE_LIMIT, 0, SPAWNER_MAX_DEATH_WEIGHT);
+
+	// Spit out percentage of use time
+	timeDiff = m_fUseFadeTime - gpGlobals->curtime;
+	m_iLastUseWeight = RemapValClamped(timeDiff, 0, SPAWNER_USEFADE_LIMIT, 0, SPAWNER_MAX_USE_WEIGHT);
+
+	//-------------------
+	// PERSONAL MODIFIERS
+	//-------------------
+
+
+	CGEMPPlayer *pUniquePlayer = ToGEMPPlayer(pRequestor);
+
+	// Zero out these penalties because they might not get calculated again.
+	m_iUniLastDeathWeight = m_iUniLastUseWeight = 0;
+
+	// They haven't had their first death yet, so don't bother with this nonsense.
+	if (pUniquePlayer->GetLastDeath() == Vector(-1, -1, -1))
+		return clamp(m_iBaseDesirability - m_iLastEnemyWeight - m_iLastUseWeight - m_iLastDeathWeight, 0, SPAWNER_DEFAULT_WEIGHT);
+	
+	// Calculate penalty based on where requesting player last died.
+	float dist = (pUniquePlayer->GetLastDeath() - GetAbsOrigin()).Length2D();
+
+	if (dist < SPAWNER_MAX_ENEMY_DIST)
+		m_iUniLastDeathWeight = (1 - dist / SPAWNER_MAX_ENEMY_DIST) * 0.75 * SPAWNER_MAX_DEATH_WEIGHT;
+
+	// If player spawned within 40 seconds, also calculate penalty based on where they last spawned.  If not double death multiplier.
+	if (pUniquePlayer->GetLastSpawnTime() > gpGlobals->curtime - 40)
+	{
+		dist = (pUniquePlayer->GetLastSpawn() - GetAbsOrigin()).Length2D();
+
+		if (dist < SPAWNER_MAX_ENEMY_DIST)
+			m_iUniLastUseWeight = (1 - dist / SPAWNER_MAX_ENEMY_DIST) * 0.75 * SPAWNER_MAX_USE_WEIGHT;
+	}
+	else
+		m_iUniLastDeathWeight *= 2;
+
+	// Return a sum of our weight factors
+	return clamp(m_iBaseDesirability - m_iLastEnemyWeight - m_iLastUseWeight - m_iLastDeathWeight - m_iUniLastDeathWeight - m_iUniLastUseWeight, 0, SPAWNER_DEFAULT_WEIGHT);
+}
+
+int CGEPlayerSpawn::GetEnemyWeight( int myTeam, int requestorTeam )
+{
+	// Every requestor in the same tick sees the same players, so only calculate this once
+	int idx = clamp( requestorTeam, 0, MAX_GE_TEAMS - 1 );
+	if ( m_iThreatTick[idx] == gpGlobals->tickcount && m_iThreatTeam[idx] == myTeam )
+	{
+		s_ThreatStats.iThreatCached++;
+		return m_iThreatWeight[idx];
+	}
+
+	s_ThreatStats.iThreatCalcs++;
+
+	m_iThreatTick[idx] = gpGlobals->tickcount;
+	m_iThreatTeam[idx] = myTeam;
+	m_iThreatWeight[idx] = CalcEnemyWeight( myTeam, requestorTeam );
+
+	return m_iThreatWeight[idx];
+}
+
+int CGEPlayerSpawn::CalcEnemyWeight( int myTeam, int requestorTeam )
+{
+	int enemyWeight = 0;
+	float floorheight = GEMPRules()->GetMapFloorHeight();
+
+	// Only players within our max threat distance can matter, let the grid find them for us
+	CGEPlayer *pPlayers[MAX_PLAYERS];
+	int count = GEMPRules()->GetSpawnGrid()->GetPlayersInRadius2D( GetAbsOrigin(), SPAWNER_MAX_ENEMY_DIST, pPlayers, MAX_PLAYERS );
 
 	// Calculate most threatening player, based on proximity, weapon, health, and PVS.
-	FOR_EACH_PLAYER(pPlayer)
+	for (int i = 0; i < count; i++)
 	{
-		if (pPlayer->IsObserver() || pPlayer->IsDead())
+		CGEPlayer *pPlayer = pPlayers[i];
+		if (!pPlayer || pPlayer->IsObserver() || pPlayer->IsDead())
 			continue;
 
 		// Check team affiliation
 		bool onMyTeam = false;
 		if (GEMPRules()->IsTeamplay() && (pPlayer->GetTeamNumber() == myTeam ||
-			(myTeam == TEAM_UNASSIGNED && pPlayer->GetTeamNumber() == pRequestor->GetTeamNumber())))
+			(myTeam == TEAM_UNASSIGNED && pPlayer->GetTeamNumber() == requestorTeam)))
 			onMyTeam = true;
 
 		Vector diff = pPlayer->GetAbsOrigin() - GetAbsOrigin();
@@ -155,15 +233,15 @@ int CGEPlayerSpawn::GetDesirability(CGEPlayer *pRequestor)
 		// even if it is possible dropping down is often a hassle and not always worth 
 		// it for a spawn kill.  If they are higher consider them further than that because going up
 		// is even harder.  Hopefully this doesn't cause too many problems around stairs.
-		float floorheight = GEMPRules()->GetMapFloorHeight();
-
 		if (diff.z > floorheight)
 			dist += 200;
 		else if (diff.z < floorheight * -1)
 			dist += 300;
 
+		int vis = GetPlayerVisibility(pPlayer);
+
 		// If player is not in the PVS, check to see how we should treat them.
-		if (!CheckInPVS(pPlayer))
+		if (vis == SPAWNER_VIS_NOPVS)
 		{
 			// If they aren't even on our floor and have no easy way of getting to us, ignore them.
 			if (abs(diff.z) > floorheight)
@@ -172,18 +250,12 @@ int CGEPlayerSpawn::GetDesirability(CGEPlayer *pRequestor)
 			dist *= 2.00;
 			dist += 300;
 		}
-		else
+		else if (vis == SPAWNER_VIS_CLEAR)
 		{
-			trace_t		tr;
-			UTIL_TraceLine(GetAbsOrigin() + Vector(0, 0, 32), pPlayer->EyePosition(), MASK_OPAQUE, pPlayer, COLLISION_GROUP_NONE, &tr);
-
-			if (tr.fraction == 1.0f)
-			{
-				if (dist > SPAWNER_MAX_ENEMY_DIST / 2)
-					dist -= SPAWNER_MAX_ENEMY_DIST / 2;
-				else
-					dist = 0;
-			}
+			if (dist > SPAWNER_MAX_ENEMY_DIST / 2)
+				dist -= SPAWNER_MAX_ENEMY_DIST / 2;
+			else
+				dist = 0;
 		}
 
 		// Scale threat by health level of player.  Players with very low health are
@@ -210,56 +282,62 @@ int CGEPlayerSpawn::GetDesirability(CGEPlayer *pRequestor)
 
 		// Finally, compare the calculated threat level to the highest one on record and
 		// replace it if higher.
-		if (abs(threat) > abs(m_iLastEnemyWeight))
-			m_iLastEnemyWeight = min(100, threat);
+		if (abs(threat) > abs(enemyWeight))
+			enemyWeight = min(100, threat);
 
 	}
-	END_OF_PLAYER_LOOP()
 
 	//scale value to the max enemy weight.
-	m_iLastEnemyWeight = RemapValClamped(m_iLastEnemyWeight, 0, 100, 0, SPAWNER_MAX_ENEMY_WEIGHT);
-
-	// Spit out percentage of death time
-	float timeDiff = m_fDeathFadeTime - gpGlobals->curtime;
-	m_iLastDeathWeight = RemapValClamped(timeDiff, 0, SPAWNER_DEATHFADE_LIMIT, 0, SPAWNER_MAX_DEATH_WEIGHT);
+	return RemapValClamped(enemyWeight, 0, 100, 0, SPAWNER_MAX_ENEMY_WEIGHT);
+}
 
-	// Spit out percentage of use time
-	timeDiff = m_fUseFadeTime - gpGlobals->curtime;
-	m_iLastUseWeight = RemapValClamped(timeDiff, 0, SPAWNER_USEFADE_LIMIT, 0, SPAWNER_MAX_USE_WEIGHT);
+int CGEPlayerSpawn::GetPlayerVisibility( CGEPlayer *player )
+{
+	// Visibility does not depend on the requestor, so share it for the whole tick
+	if ( m_iVisTick != gpGlobals->tickcount )
+	{
+		memset( m_iVisCache, SPAWNER_VIS_UNKNOWN, sizeof(m_iVisCache) );
+		m_iVisTick = gpGlobals->tickcount;
+	}
 
-	//-------------------
-	// PERSONAL MODIFIERS
-	//-------------------
+	int idx = player->entindex();
+	if ( idx < 0 || idx > MAX_PLAYERS )
+		return SPAWNER_VIS_NOPVS;
 
+	if ( m_iVisCache[idx] != SPAWNER_VIS_UNKNOWN )
+	{
+		s_ThreatStats.iVisCached++;
+		return m_iVisCache[idx];
+	}
 
-	CGEMPPlayer *pUniquePlayer = ToGEMPPlayer(pRequestor);
+	s_ThreatStats.iVisChecks++;
 
-	// Zero out these penalties because they might not get calculated again.
-	m_iUniLastDeathWeight = m_iUniLastUseWeight = 0;
+	if ( !CheckInPVS( player ) )
+	{
+		m_iVisCache[idx] = SPAWNER_VIS_NOPVS;
+	}
+	else
+	{
+		trace_t		tr;
+		UTIL_TraceLine( GetAbsOrigin() + Vector(0, 0, 32), player->EyePosition(), MASK_OPAQUE, player, COLLISION_GROUP_NONE, &tr );
 
-	// They haven't had their first death yet, so don't bother with this nonsense.
-	if (pUniquePlayer->GetLastDeath() == Vector(-1, -1, -1))
-		return clamp(m_iBaseDesirability - m_iLastEnemyWeight - m_iLastUseWeight - m_iLastDeathWeight, 0, SPAWNER_DEFAULT_WEIGHT);
-	
-	// Calculate penalty based on where requesting player last died.
-	float dist = (pUniquePlayer->GetLastDeath() - GetAbsOrigin()).Length2D();
+		m_iVisCache[idx] = (tr.fraction == 1.0f) ? SPAWNER_VIS_CLEAR : SPAWNER_VIS_OCCLUDED;
+	}
 
-	if (dist < SPAWNER_MAX_ENEMY_DIST)
-		m_iUniLastDeathWeight = (1 - dist / SPAWNER_MAX_ENEMY_DIST) * 0.75 * SPAWNER_MAX_DEATH_WEIGHT;
+	return m_iVisCache[idx];
+}
 
-	// If player spawned within 40 seconds, also calculate penalty based on where they last spawned.  If not double death multiplier.
-	if (pUniquePlayer->GetLastSpawnTime() > gpGlobals->curtime - 40)
+void CGEPlayerSpawn::InvalidateThreatCache( void )
+{
+	for ( int i = 0; i < MAX_GE_TEAMS; i++ )
 	{
-		dist = (pUniquePlayer->GetLastSpawn() - GetAbsOrigin()).Length2D();
-
-		if (dist < SPAWNER_MAX_ENEMY_DIST)
-			m_iUniLastUseWeight = (1 - dist / SPAWNER_MAX_ENEMY_DIST) * 0.75 * SPAWNER_MAX_USE_WEIGHT;
+		m_iThreatTick[i] = -1;
+		m_iThreatTeam[i] = TEAM_INVALID;
+		m_iThreatWeight[i] = 0;
 	}
-	else
-		m_iUniLastDeathWeight *= 2;
 
-	// Return a sum of our weight factors
-	return clamp(m_iBaseDesirability - m_iLastEnemyWeight - m_iLastUseWeight - m_iLastDeathWeight - m_iUniLastDeathWeight - m_iUniLastUseWeight, 0, SPAWNER_DEFAULT_WEIGHT);
+	m_iVisTick = -1;
+	memset( m_iVisCache, SPAWNER_VIS_UNKNOWN, sizeof(m_iVisCache) );
 }
 
 bool CGEPlayerSpawn::IsOccupied( void )
@@ -271,11 +349,21 @@ bool CGEPlayerSpawn::IsOccupied( void )
 	if ( gpGlobals->curtime < (m_fLastUseTime + 0.5f) )
 		return true;
 
-	CBaseEntity *pList[32];
-	int count = UTIL_EntitiesInBox( pList, 32, GetAbsOrigin() + VEC_HULL_MIN, GetAbsOrigin() + VEC_HULL_MAX, 0 );
-	for ( int i = 0; i < count; i++ )
+	Vector mins = GetAbsOrigin() + VEC_HULL_MIN;
+	Vector maxs = GetAbsOrigin() + VEC_HULL_MAX;
+
+	if ( GEMPRules()->GetSpawnGrid()->IsPlayerInBox( mins, maxs ) )
+		return true;
+
+	// The grid only knows about players, any other combat characters have to be checked directly
+	CAI_BaseNPC **ppAIs = g_AI_Manager.AccessAIs();
+	for ( int i = 0; i < g_AI_Manager.NumAIs(); i++ )
 	{
-		if ( (pList[i]->IsPlayer() || pList[i]->IsNPC()) && pList[i]->IsAlive() && !(pList[i]->GetEFlags() & EF_NODRAW) )
+		CAI_BaseNPC *pNPC = ppAIs[i];
+		if ( !pNPC->IsAlive() || (pNPC->GetEFlags() & EF_NODRAW) )
+			continue;
+
+		if ( IsBoxIntersectingBox( pNPC->GetAbsOrigin() + pNPC->WorldAlignMins(), pNPC->GetAbsOrigin() + pNPC->WorldAlignMaxs(), mins, maxs ) )
 			return true;
 	}
 
@@ -300,6 +388,21 @@ void CGEPlayerSpawn::NotifyOnDeath( float dist )
 		m_fDeathFadeTime = min(m_fDeathFadeTime + boost, gpGlobals->curtime + SPAWNER_DEATHFADE_LIMIT);
 }
 
+void CGEPlayerSpawn::NotifyNearbyOnDeath( const Vector &deathPos )
+{
+	// The grid never returns more spawners than we have, so size the list from that
+	int maxCount = GERules()->GetSpawnersOfType( SPAWN_PLAYER )->Count();
+	if ( maxCount == 0 )
+		return;
+
+	// Only DM spawns within our max death distance care about this
+	CGEPlayerSpawn **pSpawns = (CGEPlayerSpawn**) stackalloc( maxCount * sizeof(CGEPlayerSpawn*) );
+	int count = GEMPRules()->GetSpawnGrid()->GetSpawnersInRadius2D( deathPos, SPAWNER_MAX_DEATH_DIST, SPAWN_PLAYER, pSpawns, maxCount );
+
+	for ( int i = 0; i < count; i++ )
+		pSpawns[i]->NotifyOnDeath( UTIL_DistApprox( deathPos, pSpawns[i]->GetAbsOrigin() ) );
+}
+
 void CGEPlayerSpawn::NotifyOnUse( void )
 {
 	const CUtlVector<EHANDLE> *vSpawns = GERules()->GetSpawnersOfType(SPAWN_PLAYER);
@@ -364,6 +467,8 @@ void CGEPlayerSpawn::ResetTrackers( void )
 
 	// Reset Weights
 	m_iLastDeathWeight = m_iLastUseWeight = m_iLastEnemyWeight = 0;
+
+	InvalidateThreatCache();
 }
 
 bool CGEPlayerSpawn::CheckInPVS( CGEPlayer *player )
@@ -25,18 +25,30 @@ public:
 	DECLARE_DATADESC();
 
 	virtual void Spawn( void );
-	virtual void Think( void );
 
 	bool IsBotFriendly();
 	bool IsOccupied();
 
 	void NotifyOnDeath( float dist );
+	static void NotifyNearbyOnDeath( const Vector &deathPos );
 	void NotifyOnUse();
 	void SetUseFadeTime(float usetime);
 
 	// Returns desirability weighting (high weight, high desirability)
 	int GetDesirability( CGEPlayer *pRequestor );
 
+	// Threat cache statistics, reset by the spawn selection debug readout
+	struct ThreatStats_t
+	{
+		int iThreatCalcs;
+		int iThreatCached;
+		int iVisChecks;
+		int iVisCached;
+	};
+
+	static ThreatStats_t &GetThreatStats() { return s_ThreatStats; }
+	static void ResetThreatStats() { memset( &s_ThreatStats, 0, sizeof(s_ThreatStats) ); }
+
 	// Debugging
 	void DEBUG_ShowOverlay( float duration );
 
@@ -50,6 +62,12 @@ protected:
 
 	bool CheckInPVS( CGEPlayer *player );
 
+	// Enemy weight shared by every requestor of this tick, see GetDesirability
+	int  GetEnemyWeight( int myTeam, int requestorTeam );
+	int  CalcEnemyWeight( int myTeam, int requestorTeam );
+	int  GetPlayerVisibility( CGEPlayer *player );
+	void InvalidateThreatCache();
+
 private:
 	int m_iBaseDesirability;
 
@@ -69,6 +87,17 @@ private:
 	byte m_iPVS[ MAX_MAP_CLUSTERS/8 ];
 	bool m_bFoundPVS;
 
+	// Per-tick threat cache, indexed by the requestor team that affects friendliness
+	int  m_iThreatTick[ MAX_GE_TEAMS ];
+	int  m_iThreatTeam[ MAX_GE_TEAMS ];
+	int  m_iThreatWeight[ MAX_GE_TEAMS ];
+
+	// Per-tick player visibility cache, indexed by player entindex
+	int  m_iVisTick;
+	byte m_iVisCache[ MAX_PLAYERS + 1 ];
+
+	static ThreatStats_t s_ThreatStats;
+
 	// KeyValues
 	int   m_iTeam;
 	float m_flDesirabilityMultiplier;
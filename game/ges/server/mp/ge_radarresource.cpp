@@ -10,6 +10,9 @@
 #include "cbase.h"
 #include "ge_radarresource.h"
 #include "ge_player.h"
+#include "gemp_player.h"
+#include "gemp_gamerules.h"
+#include "ge_benchmark.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -22,7 +25,7 @@ IMPLEMENT_SERVERCLASS_ST( CGERadarResource, DT_GERadarResource )
 	SendPropArray3( SENDINFO_ARRAY3(m_hEnt), SendPropEHandle( SENDINFO_ARRAY(m_hEnt) ) ),
 	SendPropArray3( SENDINFO_ARRAY3(m_iEntTeam), SendPropInt( SENDINFO_ARRAY(m_iEntTeam) ) ),
 	SendPropArray3( SENDINFO_ARRAY3(m_flRangeMod), SendPropFloat( SENDINFO_ARRAY(m_flRangeMod) ) ),
-	SendPropArray3( SENDINFO_ARRAY3(m_vOrigin), SendPropVector( SENDINFO_ARRAY(m_vOrigin), -1, SPROP_COORD_MP_LOWPRECISION|SPROP_CHANGES_OFTEN ) ),
+	SendPropArray3( SENDINFO_ARRAY3(m_vOrigin), SendPropVector( SENDINFO_ARRAY(m_vOrigin), -1, SPROP_COORD_MP_INTEGRAL|SPROP_CHANGES_OFTEN ) ),
 	SendPropArray3( SENDINFO_ARRAY3(m_iType), SendPropInt( SENDINFO_ARRAY(m_iType), 4 ) ),
 	SendPropArray3( SENDINFO_ARRAY3(m_iState), SendPropInt( SENDINFO_ARRAY(m_iState), 4, SPROP_CHANGES_OFTEN ) ),
 	SendPropArray3( SENDINFO_ARRAY3(m_bAllVisible), SendPropBool( SENDINFO_ARRAY(m_bAllVisible) ) ),
@@ -47,10 +50,27 @@ LINK_ENTITY_TO_CLASS( radar_resource, CGERadarResource );
 CGERadarResource *g_pRadarResource;
 
 extern ConVar ge_allowradar;
+extern ConVar ge_radar_range;
+extern ConVar ge_radar_showenemyteam;
+
+ConVar ge_radar_cullcontacts( "ge_radar_cullcontacts", "1", FCVAR_GAMEDLL, "Only update radar contact positions when a player could see them on their radar or a bot could query them" );
+
+// Radar origins are snapped to this grid, anything finer is invisible on the radar
+#define RADAR_ORIGIN_GRID		8.0f
+// Extra range given to viewers so contacts are updated before they come into view
+#define RADAR_CULL_MARGIN		256.0f
+
+static Vector QuantizeRadarOrigin( const Vector &origin )
+{
+	return Vector( RoundFloatToInt( origin.x / RADAR_ORIGIN_GRID ) * RADAR_ORIGIN_GRID,
+				   RoundFloatToInt( origin.y / RADAR_ORIGIN_GRID ) * RADAR_ORIGIN_GRID,
+				   RoundFloatToInt( origin.z / RADAR_ORIGIN_GRID ) * RADAR_ORIGIN_GRID );
+}
 
 void CGERadarResource::Spawn( void )
 {
 	m_bForceOn = false;
+	m_iNumViewers = 0;
 
 	for ( int i=0; i < MAX_NET_RADAR_ENTS; i++ )
 		ResetContact( i );
@@ -105,7 +125,7 @@ void CGERadarResource::AddRadarContact( CBaseEntity *pEnt, int type /*=RADAR_TYP
 		// Initialize relevant fields
 		m_hEnt.Set( pos, pEnt );
 		m_iEntTeam.Set( pos, pEnt->GetTeamNumber() );
-		m_vOrigin.Set( pos, pEnt->GetAbsOrigin() );
+		m_vOrigin.Set( pos, QuantizeRadarOrigin( pEnt->GetAbsOrigin() ) );
 	}
 	
 	// Populate any new fields
@@ -229,6 +249,11 @@ void CGERadarResource::DropAllContacts( void )
 
 void CGERadarResource::RadarThink( void )
 {
+	GE_BENCH_SCOPE( GEBENCH_RADAR );
+
+	// Figure out who is actually looking at a radar this think
+	CollectViewers();
+
 	CBaseEntity *pEnt;	
 	for ( int i=0; i < MAX_NET_RADAR_ENTS; ++i )
 	{
@@ -250,13 +275,13 @@ void CGERadarResource::RadarThink( void )
 			// Update our draw state
 			UpdateState(i);
 
-			// Update our location if we will be drawn
+			// Update our location if we will be drawn, culled contacts are never drawn
 			if ( m_iState.Get(i) == RADAR_STATE_DRAW )
 			{
-				// Update our known position (within 8 units) or any change in z direction
-				Vector origin = pEnt->GetAbsOrigin();
+				// Only network a new position when it moves to a new radar grid point
+				Vector origin = QuantizeRadarOrigin( pEnt->GetAbsOrigin() );
 
-				if ( m_vOrigin.Get(i).DistToSqr(origin) >= 64.0f || abs(m_vOrigin.Get(i).z - origin.z) >= 1.0f )
+				if ( m_vOrigin.Get(i) != origin )
 					m_vOrigin.Set( i, origin );
 			}
 		}
@@ -270,6 +295,8 @@ void CGERadarResource::UpdateState( int pos )
 	if ( pos < 0 || pos >= MAX_NET_RADAR_ENTS )
 		return;
 
+	int state = RADAR_STATE_NODRAW;
+
 	CBaseEntity *pEnt = m_hEnt.Get(pos).Get();
 	if ( pEnt )
 	{
@@ -281,20 +308,102 @@ void CGERadarResource::UpdateState( int pos )
 			CGEPlayer *pPlayer = ToGEPlayer(pEnt);
 
 			if (!pPlayer->IsAlive() || pPlayer->IsObserver() || pPlayer->GetTeamNumber() == TEAM_SPECTATOR || pPlayer->IsRadarCloaked())
-				m_iState.Set( pos, RADAR_STATE_NODRAW );
+				state = RADAR_STATE_NODRAW;
 			else
-				m_iState.Set( pos, RADAR_STATE_DRAW );
+				state = RADAR_STATE_DRAW;
 		}
 		else
 		{
 			if ( pEnt->IsEFlagSet( EF_NODRAW ) )
-				m_iState.Set( pos, RADAR_STATE_NODRAW );
+				state = RADAR_STATE_NODRAW;
 			else
-				m_iState.Set( pos, RADAR_STATE_DRAW );
+				state = RADAR_STATE_DRAW;
 		}
+
+		// Culled contacts stop getting position updates, hide them so clients don't draw a stale spot
+		if ( state == RADAR_STATE_DRAW && !IsContactWanted( pos, pEnt ) )
+			state = RADAR_STATE_NODRAW;
 	}
-	else
-		m_iState.Set( pos, RADAR_STATE_NODRAW );
+
+	m_iState.Set( pos, state );
+}
+
+void CGERadarResource::CollectViewers( void )
+{
+	m_iNumViewers = 0;
+
+	for ( int i=1; i <= gpGlobals->maxClients; i++ )
+	{
+		CGEPlayer *pPlayer = ToGEPlayer( UTIL_PlayerByIndex(i) );
+
+		// Bots count too, their AI reads contacts through GEMPGameRules.ListContactsNear
+		if ( !pPlayer || !pPlayer->IsConnected() )
+			continue;
+
+		RadarViewer &viewer = m_Viewers[m_iNumViewers++];
+		viewer.iSlot = i - 1;
+		viewer.iTeam = pPlayer->GetTeamNumber();
+		viewer.vOrigin = pPlayer->GetAbsOrigin();
+		viewer.bBot = pPlayer->IsFakeClient();
+
+		// Same range the client uses in CGERadar::GetRadarRange, plus some room to move. Bots
+		// query at the unmodified range so never give them less than that.
+		float rangeMod = m_flRangeMod.Get(i - 1);
+		if ( viewer.bBot )
+			rangeMod = max( rangeMod, 1.0f );
+
+		float range = ge_radar_range.GetFloat() * rangeMod + RADAR_CULL_MARGIN;
+		viewer.flRangeSqr = range * range;
+	}
+}
+
+bool CGERadarResource::IsContactWanted( int pos, CBaseEntity *pEnt )
+{
+	if ( !ge_radar_cullcontacts.GetBool() )
+		return true;
+
+	// Objectives and always visible contacts are shown regardless of range
+	if ( m_ObjStatus.Get(pos) || m_bAllVisible.Get(pos) )
+		return true;
+
+	bool bIsPlayer = m_iType.Get(pos) == RADAR_TYPE_PLAYER;
+	bool bTeamplay = GEMPRules()->IsTeamplay();
+	bool bTeamFilter = bTeamplay && !ge_radar_showenemyteam.GetBool();
+
+	// Campers show up on everyone's radar
+	if ( bIsPlayer )
+	{
+		CGEMPPlayer *pPlayer = ToGEMPPlayer( pEnt );
+		if ( pPlayer && pPlayer->GetCampingPercent() >= RADAR_CAMP_ALLVIS_PERCENT )
+			return true;
+	}
+
+	const Vector &origin = pEnt->GetAbsOrigin();
+
+	for ( int i=0; i < m_iNumViewers; i++ )
+	{
+		const RadarViewer &viewer = m_Viewers[i];
+
+		// Never shown on your own radar
+		if ( viewer.iSlot == pos )
+			continue;
+
+		if ( bIsPlayer && bTeamplay )
+		{
+			// Teammate target ID icons use radar positions at any range
+			if ( viewer.iTeam == m_iEntTeam.Get(pos) )
+				return true;
+
+			// Same team filter the client uses when adding player contacts, bot AI sees every team
+			if ( bTeamFilter && !viewer.bBot )
+				continue;
+		}
+
+		if ( viewer.vOrigin.DistToSqr( origin ) < viewer.flRangeSqr )
+			return true;
+	}
+
+	return false;
 }
 
 int CGERadarResource::FindEntity( EHANDLE hEnt )
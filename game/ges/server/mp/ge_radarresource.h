@@ -44,12 +44,28 @@ private:
 	void RadarThink( void );
 	void UpdateState( int pos );
 
+	// Position culling, contacts no viewer could see are hidden and stop moving
+	void CollectViewers( void );
+	bool IsContactWanted( int pos, CBaseEntity *pEnt );
+
 	int  FindEntity( EHANDLE hEnt );
 	int  FindNextOpenSlot( CBaseEntity *pEnt );
 
 	void ResetContact( int pos );
 	void ResetObjective( int pos );
 
+	struct RadarViewer
+	{
+		int		iSlot;
+		int		iTeam;
+		Vector	vOrigin;
+		float	flRangeSqr;
+		bool	bBot;
+	};
+
+	RadarViewer m_Viewers[ MAX_PLAYERS ];
+	int			m_iNumViewers;
+
 // Public so we can expose info to NPC's
 public:
 	CNetworkVar( bool, m_bForceOn );
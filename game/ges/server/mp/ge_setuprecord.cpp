@@ -0,0 +1,202 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_setuprecord.cpp
+//
+// Description:
+//     See Header
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cbase.h"
+#include "ge_setuprecord.h"
+#include "ge_utils.h"
+#include "filesystem.h"
+#include "threadtools.h"
+#include "utlbuffer.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+#define SETUPRECORD_FILE	"gamesetuprecord.txt"
+
+// Section headers in the order they are written out
+static const char *g_szSetupRecordHeaders[SETUPRECORD_COUNT] =
+{
+	"Maps:",
+	"Modes:",
+	"Weps:",
+};
+
+// Writes a snapshot of the record to disk so level change doesn't wait on the filesystem
+class CGESetupRecordWriter : public CThread
+{
+public:
+	CGESetupRecordWriter( const CUtlBuffer &buf )
+	{
+		m_Buffer.Put( buf.Base(), buf.TellPut() );
+
+		SetName( "GESetupRecordWriter" );
+		Start();
+	}
+
+protected:
+	virtual int Run()
+	{
+		FileHandle_t file = filesystem->Open( SETUPRECORD_FILE, "w", "MOD" );
+		if ( file )
+		{
+			filesystem->Write( m_Buffer.Base(), m_Buffer.TellPut(), file );
+			filesystem->Close( file );
+		}
+
+		return 0;
+	}
+
+	CUtlBuffer m_Buffer;
+};
+
+static char *CopyString( const char *str )
+{
+	char *out = new char[Q_strlen(str)+1];
+	Q_strcpy( out, str );
+	return out;
+}
+
+static CGESetupRecord g_GESetupRecord;
+CGESetupRecord *GESetupRecord() { return &g_GESetupRecord; }
+
+CGESetupRecord::CGESetupRecord() : CAutoGameSystem( "CGESetupRecord" )
+{
+	m_bLoaded = false;
+	m_pWriter = NULL;
+}
+
+CGESetupRecord::~CGESetupRecord()
+{
+	for ( int i=0; i < SETUPRECORD_COUNT; i++ )
+		ClearStringVector( m_vLists[i] );
+}
+
+void CGESetupRecord::Shutdown()
+{
+	WaitForWrite();
+}
+
+void CGESetupRecord::WaitForWrite()
+{
+	if ( !m_pWriter )
+		return;
+
+	m_pWriter->Join();
+	delete m_pWriter;
+	m_pWriter = NULL;
+}
+
+void CGESetupRecord::Load()
+{
+	m_bLoaded = true;
+
+	char *contents = (char*)UTIL_LoadFileForMe( SETUPRECORD_FILE, NULL );
+	if ( !contents )
+	{
+		Msg( "No rotation log!\n" );
+		return;
+	}
+
+	int reading = -1;
+	char linebuffer[64];
+
+	for ( char *line = contents; *line; )
+	{
+		char *next = Q_strstr( line, "\n" );
+		if ( next )
+			*next++ = '\0';
+		else
+			next = line + Q_strlen( line );
+
+		// Drop carriage returns and stray spaces left over from hand edits
+		Q_strncpy( linebuffer, line, sizeof(linebuffer) );
+		GEUTIL_StripWhitespace( linebuffer );
+
+		if ( !Q_strncmp( linebuffer, "//", 2 ) )
+		{
+			// Ignore comments
+		}
+		else if ( reading != -1 )
+		{
+			if ( linebuffer[0] == '-' ) // Our symbol for the end of a block.
+				reading = -1;
+			else if ( linebuffer[0] )
+				m_vLists[reading].AddToTail( CopyString( linebuffer ) );
+		}
+		else
+		{
+			for ( int i=0; i < SETUPRECORD_COUNT; i++ )
+			{
+				if ( !Q_strcmp( linebuffer, g_szSetupRecordHeaders[i] ) )
+				{
+					reading = i;
+					break;
+				}
+			}
+		}
+
+		line = next;
+	}
+
+	delete[] contents;
+}
+
+const CUtlVector<char*> &CGESetupRecord::GetList( GESetupRecordList_t list )
+{
+	if ( !m_bLoaded )
+		Load();
+
+	return m_vLists[list];
+}
+
+bool CGESetupRecord::SetList( GESetupRecordList_t list, const CUtlVector<const char*> &entries )
+{
+	CUtlVector<char*> &vList = m_vLists[list];
+
+	bool changed = vList.Count() != entries.Count();
+	for ( int i=0; !changed && i < entries.Count(); i++ )
+		changed = Q_strcmp( vList[i], entries[i] ) != 0;
+
+	if ( !changed )
+		return false;
+
+	ClearStringVector( vList );
+	for ( int i=0; i < entries.Count(); i++ )
+		vList.AddToTail( CopyString( entries[i] ) );
+
+	return true;
+}
+
+void CGESetupRecord::SetRecord( const CUtlVector<const char*> &maps, const CUtlVector<const char*> &modes, const CUtlVector<const char*> &loadouts )
+{
+	if ( !m_bLoaded )
+		Load();
+
+	// Evaluate all three, don't short circuit
+	bool changed = SetList( SETUPRECORD_MAPS, maps );
+	changed = SetList( SETUPRECORD_MODES, modes ) || changed;
+	changed = SetList( SETUPRECORD_LOADOUTS, loadouts ) || changed;
+
+	if ( !changed )
+		return;
+
+	CUtlBuffer buf( 0, 0, CUtlBuffer::TEXT_BUFFER );
+	for ( int i=0; i < SETUPRECORD_COUNT; i++ )
+	{
+		buf.Printf( "%s\n", g_szSetupRecordHeaders[i] );
+		for ( int j=0; j < m_vLists[i].Count(); j++ )
+			buf.Printf( "%s\n", m_vLists[i][j] );
+		buf.PutString( "-\n" );
+	}
+
+	// Only one write in flight at a time, the previous one is long done by now
+	WaitForWrite();
+	m_pWriter = new CGESetupRecordWriter( buf );
+}
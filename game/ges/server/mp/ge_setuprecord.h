@@ -0,0 +1,57 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_setuprecord.h
+//
+// Description:
+//      In memory copy of gamesetuprecord.txt (the recent map, mode and
+//      loadout rotation history). The file is parsed once per server
+//      session and written back on a worker thread during level change.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_SETUPRECORD_H
+#define GE_SETUPRECORD_H
+
+#include "igamesystem.h"
+
+enum GESetupRecordList_t
+{
+	SETUPRECORD_MAPS = 0,
+	SETUPRECORD_MODES,
+	SETUPRECORD_LOADOUTS,
+
+	SETUPRECORD_COUNT,
+};
+
+class CGESetupRecordWriter;
+
+class CGESetupRecord : public CAutoGameSystem
+{
+public:
+	CGESetupRecord();
+	~CGESetupRecord();
+
+	// Makes sure the last write hit the disk before the dll goes away
+	virtual void Shutdown();
+
+	// Recent entries of the given list, most recent first
+	const CUtlVector<char*> &GetList( GESetupRecordList_t list );
+
+	// Replaces the record and queues a background write if anything changed
+	void SetRecord( const CUtlVector<const char*> &maps, const CUtlVector<const char*> &modes, const CUtlVector<const char*> &loadouts );
+
+private:
+	void Load();
+	void WaitForWrite();
+
+	bool SetList( GESetupRecordList_t list, const CUtlVector<const char*> &entries );
+
+	CUtlVector<char*>	m_vLists[SETUPRECORD_COUNT];
+	bool				m_bLoaded;
+
+	CGESetupRecordWriter *m_pWriter;
+};
+
+CGESetupRecord *GESetupRecord();
+
+#endif
@@ -10,11 +10,11 @@
 #include "gemp_gamerules.h"
 #include "ge_tokenmanager.h"
 #include "ge_spawner.h"
+#include "ge_spawnerscheduler.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
 
-#define SPAWNER_THINK_INTERVAL		0.5f
 #define SPAWNER_MAX_MOVE_DIST		4096.0f	//This value is 64 squared.
 #define SPAWNER_MOVE_CHECK_INTERVAL 5.0f
 
@@ -22,8 +22,6 @@ BEGIN_DATADESC( CGESpawner )
 	DEFINE_KEYFIELD( m_iSlot, FIELD_INTEGER, "slot" ),
 	DEFINE_KEYFIELD( m_bOrigDisableState, FIELD_BOOLEAN, "StartDisabled"),
 	DEFINE_KEYFIELD( m_bResetOnNewRound, FIELD_BOOLEAN, "ResetOnNewRound"),
-	// Think
-	DEFINE_THINKFUNC( Think ),
 	// Inputs
 	DEFINE_INPUTFUNC(FIELD_VOID, "Enable", InputEnable),
 	DEFINE_INPUTFUNC(FIELD_VOID, "Disable", InputDisable),
@@ -53,6 +51,7 @@ CGESpawner::CGESpawner( void )
 	m_bDisabled = false;
 	m_bResetOnNewRound = true;
 	m_szBaseEntity[0] = m_szOverrideEntity[0] = '\0';
+	m_iScheduleId = -1;
 }
 
 void CGESpawner::Spawn( void )
@@ -64,8 +63,15 @@ void CGESpawner::Spawn( void )
 
 	m_bDisabled = m_bOrigDisableState;
 
-	SetThink( &CGESpawner::Think );
-	SetNextThink( gpGlobals->curtime );
+	// The scheduler runs us from now on instead of thinking
+	GESpawnerScheduler()->AddSpawner( this );
+	GESpawnerScheduler()->Wake( this );
+}
+
+void CGESpawner::UpdateOnRemove( void )
+{
+	GESpawnerScheduler()->RemoveSpawner( this );
+	BaseClass::UpdateOnRemove();
 }
 
 void CGESpawner::Init( void )
@@ -75,9 +81,11 @@ void CGESpawner::Init( void )
 
 	if (m_bResetOnNewRound)
 		m_bDisabled = m_bOrigDisableState;
+
+	GESpawnerScheduler()->Wake( this );
 }
 
-void CGESpawner::Think( void )
+float CGESpawner::RunSchedule( void )
 {
 	CBaseEntity *pCurrEnt = m_hCurrentEntity.Get();
 
@@ -104,60 +112,77 @@ void CGESpawner::Think( void )
 		m_fNextMoveCheck = gpGlobals->curtime + SPAWNER_MOVE_CHECK_INTERVAL;
 	}
 
-	// Show a debug box if we are asking for it
-	if ( ge_debug_itemspawns.GetBool() )
+	// Tokens are handed out by the token manager, keep asking it
+	if ( IsOverridden() && !m_bDisabled )
+		return gpGlobals->curtime + SPAWNER_THINK_INTERVAL;
+
+	// While we hold something the scheduler watches it for pickups
+	if ( m_hCurrentEntity.Get() )
+		return m_fNextMoveCheck;
+
+	// Nothing to do until we are enabled or given something to spawn
+	if ( m_bDisabled || !IsValid() )
+		return -1;
+
+	if ( gpGlobals->curtime < m_fNextSpawnTime )
+		return m_fNextSpawnTime;
+
+	// Our rules are holding us back, check again in a bit
+	return gpGlobals->curtime + SPAWNER_THINK_INTERVAL;
+}
+
+void CGESpawner::DEBUG_ShowOverlay( float duration )
+{
+	CBaseEntity *pCurrEnt = m_hCurrentEntity.Get();
+
+	Color c( 120, 120, 120, 120 );
+	if ( IsOverridden() )
 	{
-		Color c( 120, 120, 120, 120 );
-		if ( IsOverridden() )
+		c.SetColor( 200, 200, 200, 200 );
+	}
+	else
+	{
+		switch ( GetSlot() )
+		{
+		case 0: c.SetColor( 96, 0, 120, 120 ); break;
+		case 1: c.SetColor( 0, 24, 248, 120 ); break;
+		case 2: c.SetColor( 0, 192, 216, 120 ); break;
+		case 3: c.SetColor( 0, 180, 0, 120 ); break;
+		case 4: c.SetColor( 141, 252, 0, 120 ); break;
+		case 5: c.SetColor( 227, 252, 0, 120 ); break;
+		case 6: c.SetColor( 248, 143, 0, 120 ); break;
+		case 7: c.SetColor( 248, 0, 0, 120 ); break;
+		}
+	}
+
+	if ( ge_debug_itemspawns.GetInt() < 2 || IsOverridden() )
+	{
+		Vector mins( -20, -30, 0 );
+		Vector maxs( 20, 30, 20 );
+		debugoverlay->AddBoxOverlay2( GetAbsOrigin(), mins, maxs, GetAbsAngles(), c, c, duration );
+
+		char tempstr[64];
+		int pos = 1;
+		EntityText( pos, GetClassname(), duration );
+
+		if ( GetSlot() >= 0 )
 		{
-			c.SetColor( 200, 200, 200, 200 );
+			Q_snprintf( tempstr, 64, "Slot: %d", GetSlot() + 1 );
+			EntityText( ++pos, tempstr, duration );
 		}
-		else
+
+		if ( !pCurrEnt && (IsValid() || IsOverridden()) && gpGlobals->curtime < m_fNextSpawnTime )
 		{
-			switch ( GetSlot() )
-			{
-			case 0: c.SetColor( 96, 0, 120, 120 ); break;
-			case 1: c.SetColor( 0, 24, 248, 120 ); break;
-			case 2: c.SetColor( 0, 192, 216, 120 ); break;
-			case 3: c.SetColor( 0, 180, 0, 120 ); break;
-			case 4: c.SetColor( 141, 252, 0, 120 ); break;
-			case 5: c.SetColor( 227, 252, 0, 120 ); break;
-			case 6: c.SetColor( 248, 143, 0, 120 ); break;
-			case 7: c.SetColor( 248, 0, 0, 120 ); break;
-			}
+			Q_snprintf( tempstr, 64, "Spawn in %0.1f secs", m_fNextSpawnTime - gpGlobals->curtime );
+			EntityText( ++pos, tempstr, duration );
 		}
 
-		if ( ge_debug_itemspawns.GetInt() < 2 || IsOverridden() )
+		if ( IsOverridden() )
 		{
-			Vector mins( -20, -30, 0 );
-			Vector maxs( 20, 30, 20 );
-			debugoverlay->AddBoxOverlay2( GetAbsOrigin(), mins, maxs, GetAbsAngles(), c, c, SPAWNER_THINK_INTERVAL );
-
-			char tempstr[64];
-			int pos = 1;
-			EntityText( pos, GetClassname(), SPAWNER_THINK_INTERVAL );
-
-			if ( GetSlot() >= 0 )
-			{
-				Q_snprintf( tempstr, 64, "Slot: %d", GetSlot() + 1 );
-				EntityText( ++pos, tempstr, SPAWNER_THINK_INTERVAL );
-			}
-
-			if ( !pCurrEnt && (IsValid() || IsOverridden()) && gpGlobals->curtime < m_fNextSpawnTime )
-			{
-				Q_snprintf( tempstr, 64, "Spawn in %0.1f secs", m_fNextSpawnTime - gpGlobals->curtime );
-				EntityText( ++pos, tempstr, SPAWNER_THINK_INTERVAL );
-			}
-
-			if ( IsOverridden() )
-			{
-				Q_snprintf( tempstr, 64, "OVERIDDEN (%s)", m_szOverrideEntity );
-				EntityText( ++pos, tempstr, SPAWNER_THINK_INTERVAL );
-			}
+			Q_snprintf( tempstr, 64, "OVERIDDEN (%s)", m_szOverrideEntity );
+			EntityText( ++pos, tempstr, duration );
 		}
 	}
-
-	SetNextThink( gpGlobals->curtime + SPAWNER_THINK_INTERVAL );
 }
 
 int CGESpawner::ShouldRespawn( void )
@@ -202,6 +227,7 @@ void CGESpawner::SetOverride( const char *szClassname, float secToSpawn /*=0*/ )
 		OnEntOverridden( m_szOverrideEntity );
 		// Set our next respawn time
 		m_fNextSpawnTime = gpGlobals->curtime + secToSpawn;
+		GESpawnerScheduler()->Wake( this );
 	}
 	else
 	{
@@ -223,6 +249,7 @@ void CGESpawner::SetBaseEnt( const char *szClassname )
 		RemoveEnt();
 		// Set our next respawn time
 		m_fNextSpawnTime = gpGlobals->curtime; // + GetRespawnDelay()??
+		GESpawnerScheduler()->Wake( this );
 	}
 	else
 	{
@@ -289,16 +316,18 @@ void CGESpawner::OnEntPicked( void )
 
 void CGESpawner::OnEnabled( void )
 {
-	SetThink( &CGESpawner::Think );
-	SetNextThink( gpGlobals->curtime );
 	m_fNextSpawnTime = gpGlobals->curtime;
+	GESpawnerScheduler()->Wake( this );
 }
 
 void CGESpawner::OnDisabled( void )
 {
-	SetThink( NULL );
-	SetNextThink( TICK_NEVER_THINK );
+	GESpawnerScheduler()->Sleep( this );
 	RemoveEnt();
+
+	// Let the token manager move our token somewhere else
+	if ( IsOverridden() && GEMPRules() )
+		GEMPRules()->GetTokenManager()->OnTokenSpawnerDisabled( this );
 }
 
 void CGESpawner::SetEnabled( bool state )
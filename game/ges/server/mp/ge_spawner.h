@@ -11,20 +11,28 @@
 
 #include "ge_shareddefs.h"
 
+// How often spawners poll conditions they can't be told about (token limits, gamerules)
+#define SPAWNER_THINK_INTERVAL		0.5f
+
 class CGESpawner : public CPointEntity
 {
 public:
 	DECLARE_CLASS( CGESpawner, CPointEntity );
 	DECLARE_DATADESC();
 
+	friend class CGESpawnerScheduler;
+
 	CGESpawner();
 
 	// Basic Entity Functions
 	void Spawn();
+	void UpdateOnRemove();
 
 	// Basic operations
 	void Init();
-	void Think();
+
+	// Called by the spawner scheduler, returns the next time we need to run or -1 to sleep
+	float RunSchedule();
 
 	void SpawnEnt(int spawnstate);
 	void RemoveEnt();
@@ -54,6 +62,9 @@ public:
 	void InputEnableResetting(inputdata_t &inputdata);
 	void InputDisableResetting(inputdata_t &inputdata);
 
+	// Debugging
+	void DEBUG_ShowOverlay( float duration );
+
 protected:
 	// Should we respawn now?
 	virtual int ShouldRespawn();
@@ -89,6 +100,8 @@ private:
 	float m_fNextMoveCheck;
 
 	EHANDLE m_hCurrentEntity;
+
+	int m_iScheduleId;
 };
 
 #endif
@@ -0,0 +1,376 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_spawnerscheduler.cpp
+//
+// Description:
+//     See Header
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cbase.h"
+#include "ge_spawnerscheduler.h"
+#include "ge_spawner.h"
+#include "ge_playerspawn.h"
+#include "ge_gamerules.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+// How often player spawn points redraw their debug overlay
+#define GE_SPAWNSCHED_PLAYERDEBUG_INTERVAL	1.0f
+
+extern ConVar ge_debug_itemspawns;
+extern ConVar ge_debug_playerspawns;
+
+static CGESpawnerScheduler g_GESpawnerScheduler;
+CGESpawnerScheduler *GESpawnerScheduler() { return &g_GESpawnerScheduler; }
+
+CGESpawnerScheduler::CGESpawnerScheduler() : CAutoGameSystemPerFrame( "CGESpawnerScheduler" )
+{
+	Reset();
+	ResetStats();
+}
+
+void CGESpawnerScheduler::Reset()
+{
+	m_vEntries.RemoveAll();
+	m_vWatch.RemoveAll();
+	m_vDue.RemoveAll();
+
+	m_iFreeHead = -1;
+	m_iNumSpawners = 0;
+
+	for ( int i=0; i < ARRAYSIZE(m_iBucketHead); i++ )
+		m_iBucketHead[i] = -1;
+
+	m_iWheelTick = gpGlobals ? gpGlobals->tickcount : 0;
+
+	m_flNextWatch = 0;
+	m_flNextItemDebug = 0;
+	m_flNextPlayerDebug = 0;
+}
+
+void CGESpawnerScheduler::AddSpawner( CGESpawner *pSpawner )
+{
+	if ( pSpawner->m_iScheduleId != -1 )
+		return;
+
+	int id = m_iFreeHead;
+	if ( id != -1 )
+		m_iFreeHead = m_vEntries[id].iNext;
+	else
+		id = m_vEntries.AddToTail();
+
+	SpawnerEntry_t &entry = m_vEntries[id];
+	entry.pSpawner = pSpawner;
+	entry.hWatch = NULL;
+	entry.iWakeTick = 0;
+	entry.iBucket = entry.iNext = entry.iPrev = -1;
+	entry.iWatchPos = -1;
+
+	pSpawner->m_iScheduleId = id;
+	m_iNumSpawners++;
+}
+
+void CGESpawnerScheduler::RemoveSpawner( CGESpawner *pSpawner )
+{
+	int id = pSpawner->m_iScheduleId;
+	if ( id < 0 || id >= m_vEntries.Count() || m_vEntries[id].pSpawner != pSpawner )
+		return;
+
+	Unlink( id );
+	Unwatch( id );
+
+	SpawnerEntry_t &entry = m_vEntries[id];
+	entry.pSpawner = NULL;
+	entry.hWatch = NULL;
+	entry.iNext = m_iFreeHead;
+	m_iFreeHead = id;
+
+	pSpawner->m_iScheduleId = -1;
+	m_iNumSpawners--;
+}
+
+void CGESpawnerScheduler::Wake( CGESpawner *pSpawner )
+{
+	int id = pSpawner->m_iScheduleId;
+	if ( id != -1 )
+		Schedule( id, m_iWheelTick );
+}
+
+void CGESpawnerScheduler::Sleep( CGESpawner *pSpawner )
+{
+	int id = pSpawner->m_iScheduleId;
+	if ( id != -1 )
+		Unlink( id );
+}
+
+int CGESpawnerScheduler::GetNumScheduled()
+{
+	int count = 0;
+	for ( int i=0; i < m_vEntries.Count(); i++ )
+	{
+		if ( m_vEntries[i].pSpawner && m_vEntries[i].iBucket != -1 )
+			count++;
+	}
+
+	return count;
+}
+
+void CGESpawnerScheduler::Schedule( int id, int tick )
+{
+	tick = max( tick, m_iWheelTick );
+
+	// Keep whichever wake up comes first
+	SpawnerEntry_t &entry = m_vEntries[id];
+	if ( entry.iBucket != -1 )
+	{
+		if ( entry.iWakeTick <= tick )
+			return;
+
+		Unlink( id );
+	}
+
+	Link( id, tick );
+}
+
+void CGESpawnerScheduler::Link( int id, int tick )
+{
+	SpawnerEntry_t &entry = m_vEntries[id];
+	entry.iWakeTick = tick;
+
+	int delta = tick - m_iWheelTick;
+	if ( delta < GE_SPAWNSCHED_L0_SIZE )
+		entry.iBucket = tick & GE_SPAWNSCHED_L0_MASK;
+	else if ( delta < GE_SPAWNSCHED_L0_SIZE * (GE_SPAWNSCHED_L1_SIZE - 1) )
+		entry.iBucket = GE_SPAWNSCHED_L0_SIZE + ((tick >> GE_SPAWNSCHED_L0_BITS) & GE_SPAWNSCHED_L1_MASK);
+	else
+		entry.iBucket = GE_SPAWNSCHED_OVERFLOW;
+
+	entry.iPrev = -1;
+	entry.iNext = m_iBucketHead[entry.iBucket];
+
+	if ( entry.iNext != -1 )
+		m_vEntries[entry.iNext].iPrev = id;
+
+	m_iBucketHead[entry.iBucket] = id;
+}
+
+void CGESpawnerScheduler::Unlink( int id )
+{
+	SpawnerEntry_t &entry = m_vEntries[id];
+	if ( entry.iBucket == -1 )
+		return;
+
+	if ( entry.iPrev != -1 )
+		m_vEntries[entry.iPrev].iNext = entry.iNext;
+	else
+		m_iBucketHead[entry.iBucket] = entry.iNext;
+
+	if ( entry.iNext != -1 )
+		m_vEntries[entry.iNext].iPrev = entry.iPrev;
+
+	entry.iBucket = entry.iNext = entry.iPrev = -1;
+}
+
+void CGESpawnerScheduler::Cascade( int bucket )
+{
+	// Relinking against the current tick drops everyone a level closer to the inner wheel
+	int id = m_iBucketHead[bucket];
+	m_iBucketHead[bucket] = -1;
+
+	while ( id != -1 )
+	{
+		int next = m_vEntries[id].iNext;
+		m_vEntries[id].iBucket = -1;
+		Link( id, max( m_vEntries[id].iWakeTick, m_iWheelTick ) );
+		id = next;
+	}
+}
+
+void CGESpawnerScheduler::Advance( int toTick )
+{
+	while ( m_iWheelTick <= toTick )
+	{
+		int t = m_iWheelTick;
+
+		if ( (t & GE_SPAWNSCHED_L0_MASK) == 0 )
+		{
+			int outer = (t >> GE_SPAWNSCHED_L0_BITS) & GE_SPAWNSCHED_L1_MASK;
+			if ( outer == 0 )
+				Cascade( GE_SPAWNSCHED_OVERFLOW );
+
+			Cascade( GE_SPAWNSCHED_L0_SIZE + outer );
+		}
+
+		// Everyone left in this bucket is due right now
+		int bucket = t & GE_SPAWNSCHED_L0_MASK;
+		int id = m_iBucketHead[bucket];
+		m_iBucketHead[bucket] = -1;
+
+		while ( id != -1 )
+		{
+			SpawnerEntry_t &entry = m_vEntries[id];
+			int next = entry.iNext;
+			entry.iBucket = entry.iNext = entry.iPrev = -1;
+			m_vDue.AddToTail( id );
+			id = next;
+		}
+
+		m_iWheelTick++;
+	}
+}
+
+void CGESpawnerScheduler::Rebase()
+{
+	// The clock went backwards (new map), our wake times mean nothing anymore
+	for ( int i=0; i < m_vEntries.Count(); i++ )
+		Unlink( i );
+
+	m_iWheelTick = gpGlobals->tickcount;
+
+	for ( int i=0; i < m_vEntries.Count(); i++ )
+	{
+		if ( m_vEntries[i].pSpawner )
+			Link( i, m_iWheelTick );
+	}
+}
+
+void CGESpawnerScheduler::RunSpawner( int id )
+{
+	CGESpawner *pSpawner = m_vEntries[id].pSpawner;
+	if ( !pSpawner )
+		return;
+
+	float flWake = pSpawner->RunSchedule();
+
+	// We could have been removed while running
+	if ( m_vEntries[id].pSpawner != pSpawner )
+		return;
+
+	if ( flWake >= 0 )
+		Schedule( id, TIME_TO_TICKS( flWake ) );
+
+	// Keep the watch list in sync with what we are holding on to
+	SpawnerEntry_t &entry = m_vEntries[id];
+	entry.hWatch = pSpawner->GetEnt();
+
+	if ( entry.hWatch.Get() && entry.iWatchPos == -1 )
+	{
+		entry.iWatchPos = m_vWatch.AddToTail( id );
+	}
+	else if ( !entry.hWatch.Get() )
+	{
+		Unwatch( id );
+	}
+}
+
+void CGESpawnerScheduler::Unwatch( int id )
+{
+	int pos = m_vEntries[id].iWatchPos;
+	if ( pos == -1 )
+		return;
+
+	// FastRemove swaps the last watched spawner into our spot
+	m_vWatch.FastRemove( pos );
+	if ( pos < m_vWatch.Count() )
+		m_vEntries[ m_vWatch[pos] ].iWatchPos = pos;
+
+	m_vEntries[id].iWatchPos = -1;
+}
+
+void CGESpawnerScheduler::WatchPass()
+{
+	// Anything that lost its entity (picked up or removed) gets to run next tick
+	for ( int i=0; i < m_vWatch.Count(); i++ )
+	{
+		SpawnerEntry_t &entry = m_vEntries[ m_vWatch[i] ];
+		CBaseEntity *pEnt = entry.hWatch.Get();
+
+		if ( !pEnt || pEnt->GetOwnerEntity() != entry.pSpawner )
+			Schedule( m_vWatch[i], m_iWheelTick );
+	}
+
+	m_Stats.iWatchChecks += m_vWatch.Count();
+}
+
+void CGESpawnerScheduler::DebugPass()
+{
+	if ( ge_debug_itemspawns.GetBool() && gpGlobals->curtime >= m_flNextItemDebug )
+	{
+		for ( int i=0; i < m_vEntries.Count(); i++ )
+		{
+			if ( m_vEntries[i].pSpawner )
+				m_vEntries[i].pSpawner->DEBUG_ShowOverlay( SPAWNER_THINK_INTERVAL );
+		}
+
+		m_flNextItemDebug = gpGlobals->curtime + SPAWNER_THINK_INTERVAL;
+	}
+
+	if ( ge_debug_playerspawns.GetBool() && gpGlobals->curtime >= m_flNextPlayerDebug && GERules() )
+	{
+		for ( int type = SPAWN_PLAYER; type <= SPAWN_PLAYER_SPECTATOR; type++ )
+		{
+			const CUtlVector<EHANDLE> *vSpawns = GERules()->GetSpawnersOfType( type );
+			if ( !vSpawns )
+				continue;
+
+			for ( int i=0; i < vSpawns->Count(); i++ )
+			{
+				CGEPlayerSpawn *pSpawn = (CGEPlayerSpawn*) vSpawns->Element(i).Get();
+				if ( pSpawn )
+					pSpawn->DEBUG_ShowOverlay( GE_SPAWNSCHED_PLAYERDEBUG_INTERVAL );
+			}
+		}
+
+		m_flNextPlayerDebug = gpGlobals->curtime + GE_SPAWNSCHED_PLAYERDEBUG_INTERVAL;
+	}
+}
+
+void CGESpawnerScheduler::FrameUpdatePostEntityThink()
+{
+	if ( gpGlobals->tickcount < m_iWheelTick - 1 )
+	{
+		Rebase();
+		m_flNextWatch = m_flNextItemDebug = m_flNextPlayerDebug = 0;
+	}
+
+	// Spawners only hold on to one entity, so spotting pickups is a cheap sweep
+	if ( gpGlobals->curtime >= m_flNextWatch )
+	{
+		WatchPass();
+		m_flNextWatch = gpGlobals->curtime + SPAWNER_THINK_INTERVAL;
+	}
+
+	Advance( gpGlobals->tickcount );
+
+	// Spawners woken while we run wait for the next tick
+	int runs = m_vDue.Count();
+	for ( int i=0; i < m_vDue.Count(); i++ )
+		RunSpawner( m_vDue[i] );
+
+	m_vDue.RemoveAll();
+
+	m_Stats.iTicks++;
+	m_Stats.iRuns += runs;
+	m_Stats.iLastRuns = runs;
+	m_Stats.iPeak = max( m_Stats.iPeak, runs );
+
+	DebugPass();
+}
+
+CON_COMMAND( ge_spawner_stats, "Prints and resets the spawner scheduler statistics" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	CGESpawnerScheduler *pSched = GESpawnerScheduler();
+	const CGESpawnerScheduler::SchedStats_t &stats = pSched->GetStats();
+
+	float avg = stats.iTicks > 0 ? (float)stats.iRuns / stats.iTicks : 0;
+
+	Msg( "Spawner scheduler: %i spawners, %i scheduled, %i watched\n", pSched->GetNumSpawners(), pSched->GetNumScheduled(), pSched->GetNumWatched() );
+	Msg( "  %i ticks, %i spawner runs (%0.2f per tick, peak %i, last %i), %i pickup checks\n", stats.iTicks, stats.iRuns, avg, stats.iPeak, stats.iLastRuns, stats.iWatchChecks );
+	pSched->ResetStats();
+}
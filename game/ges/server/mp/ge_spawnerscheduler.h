@@ -0,0 +1,110 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_spawnerscheduler.h
+//
+// Description:
+//      Hierarchical timer wheel that runs item spawners only when they have
+//      something to do instead of letting each one think on its own.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_SPAWNERSCHEDULER_H
+#define GE_SPAWNERSCHEDULER_H
+
+#include "igamesystem.h"
+
+class CGESpawner;
+
+// Inner wheel, one bucket per tick
+#define GE_SPAWNSCHED_L0_BITS	8
+#define GE_SPAWNSCHED_L0_SIZE	(1 << GE_SPAWNSCHED_L0_BITS)
+#define GE_SPAWNSCHED_L0_MASK	(GE_SPAWNSCHED_L0_SIZE - 1)
+// Outer wheel, one bucket per full turn of the inner wheel
+#define GE_SPAWNSCHED_L1_BITS	6
+#define GE_SPAWNSCHED_L1_SIZE	(1 << GE_SPAWNSCHED_L1_BITS)
+#define GE_SPAWNSCHED_L1_MASK	(GE_SPAWNSCHED_L1_SIZE - 1)
+// Anything further out than the outer wheel waits here
+#define GE_SPAWNSCHED_OVERFLOW	(GE_SPAWNSCHED_L0_SIZE + GE_SPAWNSCHED_L1_SIZE)
+
+class CGESpawnerScheduler : public CAutoGameSystemPerFrame
+{
+public:
+	CGESpawnerScheduler();
+
+	virtual void LevelInitPreEntity() { Reset(); }
+	virtual void LevelShutdownPostEntity() { Reset(); }
+	virtual void FrameUpdatePostEntityThink();
+
+	void AddSpawner( CGESpawner *pSpawner );
+	void RemoveSpawner( CGESpawner *pSpawner );
+
+	// Run the spawner on the next tick
+	void Wake( CGESpawner *pSpawner );
+	// Take the spawner out of the wheel until it is woken again
+	void Sleep( CGESpawner *pSpawner );
+
+	struct SchedStats_t
+	{
+		int iTicks;			// Ticks that were sampled
+		int iRuns;			// Spawner updates across all ticks
+		int iPeak;			// Most spawner updates in a single tick
+		int iLastRuns;		// Spawner updates in the last tick
+		int iWatchChecks;	// Pickup checks done in the watch pass
+	};
+
+	const SchedStats_t &GetStats() { return m_Stats; }
+	void ResetStats() { memset( &m_Stats, 0, sizeof(m_Stats) ); }
+
+	int GetNumSpawners()	{ return m_iNumSpawners; }
+	int GetNumScheduled();
+	int GetNumWatched()		{ return m_vWatch.Count(); }
+
+private:
+	void Reset();
+
+	void Schedule( int id, int tick );
+	void Link( int id, int tick );
+	void Unlink( int id );
+	void Cascade( int bucket );
+	void Advance( int toTick );
+	void Rebase();
+
+	void RunSpawner( int id );
+	void Unwatch( int id );
+	void WatchPass();
+	void DebugPass();
+
+	struct SpawnerEntry_t
+	{
+		CGESpawner	*pSpawner;		// NULL if this entry is free
+		EHANDLE		hWatch;			// Entity we handed out, checked for pickups in the watch pass
+		int			iWakeTick;
+		int			iBucket;		// -1 if not in the wheel
+		int			iNext;			// Wheel links, iNext doubles as the free list link
+		int			iPrev;
+		int			iWatchPos;		// Position in m_vWatch, -1 if not watched
+	};
+
+	// Contiguous spawner state, entries are recycled through the free list
+	CUtlVector<SpawnerEntry_t> m_vEntries;
+	int m_iFreeHead;
+	int m_iNumSpawners;
+
+	// Spawners holding an entity, walked together in the watch pass
+	CUtlVector<int> m_vWatch;
+
+	int m_iBucketHead[ GE_SPAWNSCHED_OVERFLOW + 1 ];
+	int m_iWheelTick;				// Next tick the wheel will process
+
+	CUtlVector<int> m_vDue;
+
+	float m_flNextWatch;
+	float m_flNextItemDebug;
+	float m_flNextPlayerDebug;
+
+	SchedStats_t m_Stats;
+};
+
+CGESpawnerScheduler *GESpawnerScheduler();
+
+#endif
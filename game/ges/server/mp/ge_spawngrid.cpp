@@ -0,0 +1,254 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_spawngrid.cpp
+//
+// Description:
+//     See Header
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cbase.h"
+#include "ge_spawngrid.h"
+#include "ge_playerspawn.h"
+#include "ge_player.h"
+#include "ge_gamerules.h"
+#include "collisionutils.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+// Players are only rebucketed once per tick, give them a bit of room to move within it
+#define GE_SPAWNGRID_SLACK		64.0f
+
+CGESpawnGrid::CGESpawnGrid()
+{
+	for ( int i=0; i < ARRAYSIZE(m_iPlayerHead); i++ )
+	{
+		m_iPlayerHead[i] = -1;
+		m_iSpawnerHead[i] = -1;
+	}
+
+	for ( int i=0; i <= MAX_PLAYERS; i++ )
+		m_iPlayerCell[i] = m_iPlayerNext[i] = m_iPlayerPrev[i] = -1;
+
+	m_iPlayerTick = -1;
+	m_iSpawnerVersion = -1;
+}
+
+int CGESpawnGrid::CellForPosition( const Vector &pos )
+{
+	int x = clamp( (int)(pos.x + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+	int y = clamp( (int)(pos.y + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+	return y * GE_SPAWNGRID_DIM + x;
+}
+
+void CGESpawnGrid::CellRange( const Vector &mins, const Vector &maxs, int &x0, int &y0, int &x1, int &y1 )
+{
+	x0 = clamp( (int)(mins.x + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+	y0 = clamp( (int)(mins.y + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+	x1 = clamp( (int)(maxs.x + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+	y1 = clamp( (int)(maxs.y + MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE, 0, GE_SPAWNGRID_DIM - 1 );
+}
+
+void CGESpawnGrid::LinkPlayer( int idx, int cell )
+{
+	m_iPlayerCell[idx] = cell;
+	m_iPlayerPrev[idx] = -1;
+	m_iPlayerNext[idx] = m_iPlayerHead[cell];
+
+	if ( m_iPlayerHead[cell] != -1 )
+		m_iPlayerPrev[ m_iPlayerHead[cell] ] = idx;
+
+	m_iPlayerHead[cell] = idx;
+}
+
+void CGESpawnGrid::UnlinkPlayer( int idx )
+{
+	int cell = m_iPlayerCell[idx];
+	if ( cell == -1 )
+		return;
+
+	if ( m_iPlayerPrev[idx] != -1 )
+		m_iPlayerNext[ m_iPlayerPrev[idx] ] = m_iPlayerNext[idx];
+	else
+		m_iPlayerHead[cell] = m_iPlayerNext[idx];
+
+	if ( m_iPlayerNext[idx] != -1 )
+		m_iPlayerPrev[ m_iPlayerNext[idx] ] = m_iPlayerPrev[idx];
+
+	m_iPlayerCell[idx] = m_iPlayerNext[idx] = m_iPlayerPrev[idx] = -1;
+}
+
+void CGESpawnGrid::UpdatePlayer( CGEPlayer *pPlayer )
+{
+	if ( !pPlayer )
+		return;
+
+	int idx = pPlayer->entindex();
+	if ( idx <= 0 || idx > MAX_PLAYERS )
+		return;
+
+	// Observers and the dead are not part of the grid
+	int cell = -1;
+	if ( !pPlayer->IsObserver() && !pPlayer->IsDead() )
+		cell = CellForPosition( pPlayer->GetAbsOrigin() );
+
+	// Only touch the buckets if we actually changed cells
+	if ( cell == m_iPlayerCell[idx] )
+		return;
+
+	UnlinkPlayer( idx );
+	if ( cell != -1 )
+		LinkPlayer( idx, cell );
+}
+
+void CGESpawnGrid::UpdatePlayers()
+{
+	if ( m_iPlayerTick == gpGlobals->tickcount )
+		return;
+
+	m_iPlayerTick = gpGlobals->tickcount;
+
+	for ( int i=1; i <= MAX_PLAYERS; i++ )
+	{
+		CGEPlayer *pPlayer = i <= gpGlobals->maxClients ? ToGEPlayer( UTIL_PlayerByIndex(i) ) : NULL;
+		if ( pPlayer )
+			UpdatePlayer( pPlayer );
+		else
+			UnlinkPlayer( i );
+	}
+}
+
+void CGESpawnGrid::UpdateSpawners()
+{
+	// Gamerules bumps the version every time it rebuilds its spawner lists
+	if ( m_iSpawnerVersion == GERules()->GetSpawnerLocationsVersion() )
+		return;
+
+	m_iSpawnerVersion = GERules()->GetSpawnerLocationsVersion();
+	m_vSpawners.RemoveAll();
+
+	for ( int i=0; i < ARRAYSIZE(m_iSpawnerHead); i++ )
+		m_iSpawnerHead[i] = -1;
+
+	for ( int type = SPAWN_PLAYER; type <= SPAWN_PLAYER_SPECTATOR; type++ )
+	{
+		const CUtlVector<EHANDLE> *vSpawns = GERules()->GetSpawnersOfType( type );
+		if ( !vSpawns )
+			continue;
+
+		for ( int i=0; i < vSpawns->Count(); i++ )
+		{
+			CBaseEntity *pSpawn = vSpawns->Element(i).Get();
+			if ( !pSpawn )
+				continue;
+
+			int cell = CellForPosition( pSpawn->GetAbsOrigin() );
+
+			int idx = m_vSpawners.AddToTail();
+			m_vSpawners[idx].hSpawner = pSpawn;
+			m_vSpawners[idx].iType = type;
+			m_vSpawners[idx].iNext = m_iSpawnerHead[cell];
+			m_iSpawnerHead[cell] = idx;
+		}
+	}
+}
+
+int CGESpawnGrid::GetPlayersInRadius2D( const Vector &pos, float radius, CGEPlayer **pList, int maxCount )
+{
+	UpdatePlayers();
+
+	Vector extent( radius + GE_SPAWNGRID_SLACK, radius + GE_SPAWNGRID_SLACK, 0 );
+	int x0, y0, x1, y1;
+	CellRange( pos - extent, pos + extent, x0, y0, x1, y1 );
+
+	// Gather candidates by entity index so callers see the same order as FOR_EACH_PLAYER
+	bool bFound[ MAX_PLAYERS + 1 ];
+	memset( bFound, 0, sizeof(bFound) );
+
+	float radiusSqr = radius * radius;
+	for ( int y = y0; y <= y1; y++ )
+	{
+		for ( int x = x0; x <= x1; x++ )
+		{
+			for ( int idx = m_iPlayerHead[ y * GE_SPAWNGRID_DIM + x ]; idx != -1; idx = m_iPlayerNext[idx] )
+			{
+				CBaseEntity *pPlayer = UTIL_PlayerByIndex( idx );
+				if ( pPlayer && (pPlayer->GetAbsOrigin() - pos).Length2DSqr() <= radiusSqr )
+					bFound[idx] = true;
+			}
+		}
+	}
+
+	int count = 0;
+	for ( int i=1; i <= MAX_PLAYERS && count < maxCount; i++ )
+	{
+		if ( bFound[i] )
+			pList[count++] = ToGEPlayer( UTIL_PlayerByIndex(i) );
+	}
+
+	return count;
+}
+
+bool CGESpawnGrid::IsPlayerInBox( const Vector &mins, const Vector &maxs )
+{
+	UpdatePlayers();
+
+	// Expand our search by a player hull so we catch anyone straddling a cell edge
+	Vector extent( VEC_HULL_MAX.x + GE_SPAWNGRID_SLACK, VEC_HULL_MAX.y + GE_SPAWNGRID_SLACK, 0 );
+	int x0, y0, x1, y1;
+	CellRange( mins - extent, maxs + extent, x0, y0, x1, y1 );
+
+	for ( int y = y0; y <= y1; y++ )
+	{
+		for ( int x = x0; x <= x1; x++ )
+		{
+			for ( int idx = m_iPlayerHead[ y * GE_SPAWNGRID_DIM + x ]; idx != -1; idx = m_iPlayerNext[idx] )
+			{
+				CBaseEntity *pPlayer = UTIL_PlayerByIndex( idx );
+				if ( !pPlayer || !pPlayer->IsAlive() || (pPlayer->GetEFlags() & EF_NODRAW) )
+					continue;
+
+				const Vector &origin = pPlayer->GetAbsOrigin();
+				if ( IsBoxIntersectingBox( mins, maxs, origin + VEC_HULL_MIN, origin + VEC_HULL_MAX ) )
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int CGESpawnGrid::GetSpawnersInRadius2D( const Vector &pos, float radius, int type, CGEPlayerSpawn **pList, int maxCount )
+{
+	UpdateSpawners();
+
+	Vector extent( radius, radius, 0 );
+	int x0, y0, x1, y1;
+	CellRange( pos - extent, pos + extent, x0, y0, x1, y1 );
+
+	int count = 0;
+	for ( int y = y0; y <= y1; y++ )
+	{
+		for ( int x = x0; x <= x1; x++ )
+		{
+			for ( int idx = m_iSpawnerHead[ y * GE_SPAWNGRID_DIM + x ]; idx != -1; idx = m_vSpawners[idx].iNext )
+			{
+				if ( m_vSpawners[idx].iType != type )
+					continue;
+
+				CGEPlayerSpawn *pSpawn = (CGEPlayerSpawn*) m_vSpawners[idx].hSpawner.Get();
+				if ( !pSpawn )
+					continue;
+
+				if ( count >= maxCount )
+					return count;
+
+				pList[count++] = pSpawn;
+			}
+		}
+	}
+
+	return count;
+}
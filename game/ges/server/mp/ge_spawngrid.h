@@ -0,0 +1,72 @@
+//////////  Copyright  2016, Goldeneye Source. All rights reserved. ///////////
+//
+// ge_spawngrid.h
+//
+// Description:
+//      Uniform 2D grid over player spawners and live players used to
+//      limit spawn point scoring to the players that can actually matter.
+//
+// Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GE_SPAWNGRID_H
+#define GE_SPAWNGRID_H
+
+#include "worldsize.h"
+
+class CGEPlayer;
+class CGEPlayerSpawn;
+
+// Size of each grid cell in world units
+#define GE_SPAWNGRID_CELL_SIZE	512
+// Number of cells along one axis of the grid (covers the whole world)
+#define GE_SPAWNGRID_DIM		( (2 * MAX_COORD_INTEGER) / GE_SPAWNGRID_CELL_SIZE )
+
+class CGESpawnGrid
+{
+public:
+	CGESpawnGrid();
+
+	// Rebucket a single player right away (ie, after they were moved to a spawn point)
+	void UpdatePlayer( CGEPlayer *pPlayer );
+
+	// Fills pList with live players within radius (2D) of pos, in entity index order
+	int  GetPlayersInRadius2D( const Vector &pos, float radius, CGEPlayer **pList, int maxCount );
+
+	// Returns true if a live, visible player's hull overlaps the given box
+	bool IsPlayerInBox( const Vector &mins, const Vector &maxs );
+
+	// Fills pList with player spawners of the given type in the cells within radius (2D) of pos,
+	// callers are expected to do their own exact distance check
+	int  GetSpawnersInRadius2D( const Vector &pos, float radius, int type, CGEPlayerSpawn **pList, int maxCount );
+
+private:
+	void UpdatePlayers();
+	void UpdateSpawners();
+
+	int  CellForPosition( const Vector &pos );
+	void CellRange( const Vector &mins, const Vector &maxs, int &x0, int &y0, int &x1, int &y1 );
+
+	void LinkPlayer( int idx, int cell );
+	void UnlinkPlayer( int idx );
+
+	// Player buckets, intrusive doubly linked lists of entity indices
+	short m_iPlayerHead[ GE_SPAWNGRID_DIM * GE_SPAWNGRID_DIM ];
+	short m_iPlayerCell[ MAX_PLAYERS + 1 ];
+	short m_iPlayerNext[ MAX_PLAYERS + 1 ];
+	short m_iPlayerPrev[ MAX_PLAYERS + 1 ];
+	int	  m_iPlayerTick;
+
+	// Spawner buckets, singly linked lists into m_vSpawners
+	struct SpawnerEntry
+	{
+		EHANDLE hSpawner;
+		int		iType;
+		int		iNext;
+	};
+
+	CUtlVector<SpawnerEntry> m_vSpawners;
+	int  m_iSpawnerHead[ GE_SPAWNGRID_DIM * GE_SPAWNGRID_DIM ];
+	int  m_iSpawnerVersion;
+};
+
+#endif
@@ -17,12 +17,15 @@
 #include "gemp_gamerules.h"
 #include "ge_generictoken.h"
 #include "ge_loadoutmanager.h"
+#include "ge_benchmark.h"
 
 #include "ge_tokenmanager.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
 
+ConVar ge_debug_tokenregistry( "ge_debug_tokenregistry", "0", FCVAR_CHEAT | FCVAR_GAMEDLL, "Cross check the token registry against a full entity scan on every enforcement" );
+
 // -------------------- //
 //     Definitions      //
 // -------------------- //
@@ -38,6 +41,7 @@ CGETokenDef::CGETokenDef()
 	glowDist = 350.0f;
 	bAllowSwitch = true;
 	bDirty = true;
+	bNeedsEnforce = true;
 }
 
 CGECaptureAreaDef::CGECaptureAreaDef()
@@ -53,6 +57,41 @@ CGECaptureAreaDef::CGECaptureAreaDef()
 	fSpread = 500.0f;
 	iLocations = CGETokenManager::LOC_NONE;
 	bDirty = true;
+	bCompiled = false;
+}
+
+CGECaptureAreaDef::~CGECaptureAreaDef()
+{
+	// Make sure no straggling area keeps pointing at us
+	for ( int i=0; i < vAreas.Count(); i++ )
+	{
+		if ( vAreas[i].Get() )
+			vAreas[i]->SetCaptureAreaDef( NULL );
+	}
+}
+
+void CGECaptureAreaDef::Compile()
+{
+	iRqdWeaponID = WEAPON_NONE;
+	iszRqdToken = NULL_STRING;
+
+	if ( rqdToken[0] )
+	{
+		iszRqdToken = AllocPooledString( rqdToken );
+
+		// Generic tokens have no alias, they all share WEAPON_TOKEN and are told apart by classname
+		iRqdWeaponID = AliasToWeaponID( rqdToken );
+		if ( iRqdWeaponID == WEAPON_NONE )
+			iRqdWeaponID = WEAPON_TOKEN;
+	}
+
+	if ( rqdTeam == TEAM_UNASSIGNED )
+		iTeamMask = ~0;
+	else if ( rqdTeam > 0 && rqdTeam < 32 )
+		iTeamMask = 1 << rqdTeam;
+	else
+		iTeamMask = 0;
+	bCompiled = true;
 }
 
 
@@ -106,12 +145,17 @@ CGETokenDef* CGETokenManager::GetTokenDefForEdit( const char *szClassName )
 		Q_strncpy( pDef->szClassName, szClassName, MAX_ENTITY_NAME );
 		m_vTokenTypes.Insert( szClassName, pDef );
 
+		// Pick up anything of this type that is already in the world, from here on
+		// the token callbacks keep our list current
+		ScanTokens( szClassName, pDef->vTokens );
+
 		// TODO: This should be handled by an interface
 		// Notify our loadout manager in case we need to adjust the weapon set
 		GEMPRules()->GetLoadoutManager()->OnTokenAdded( szClassName );
 	}
 
 	pDef->bDirty = true;
+	pDef->bNeedsEnforce = true;
 	return pDef;
 }
 
@@ -185,8 +229,9 @@ CGECaptureAreaDef* CGETokenManager::GetCaptureAreaDefForEdit( const char *szName
 		m_vCaptureAreas.Insert( szName, ca );
 	}
 
-	// Always mark us dirty
+	// Always mark us dirty, our requirements are about to change
 	ca->bDirty = true;
+	ca->bCompiled = false;
 
 	return ca;
 }
@@ -319,7 +364,10 @@ void CGETokenManager::OnTokenSpawned( CGEWeapon *pToken )
 			ApplyTokenSettings( ttype, pToken );
 
 			// Add us to the list
-			ttype->vTokens.AddToTail( pToken );
+			if ( !ttype->vTokens.HasElement( pToken ) )
+				ttype->vTokens.AddToTail( pToken );
+
+			ttype->bNeedsEnforce = true;
 				
 			// Tell the Python scenario
 			GEGameplay()->GetScenario()->OnTokenSpawned( pToken );
@@ -344,6 +392,7 @@ void CGETokenManager::OnTokenRemoved( CGEWeapon *pToken )
 
 		// Remove us from the list
 		ttype->vTokens.FindAndRemove( pToken );
+		ttype->bNeedsEnforce = true;
 	}
 }
 
@@ -361,9 +410,19 @@ void CGETokenManager::OnTokenDropped( CGEWeapon *pToken, CGEPlayer *pPlayer )
 		GEGameplay()->GetScenario()->OnTokenDropped( pToken, pPlayer );
 }
 
+void CGETokenManager::OnTokenSpawnerDisabled( CGESpawner *pSpawner )
+{
+	// Have enforcement hand our token to another spawner
+	CGETokenDef *ttype = GetTokenDef( pSpawner->GetOverrideClass() );
+	if ( ttype )
+		ttype->bNeedsEnforce = true;
+}
+
 void CGETokenManager::OnCaptureAreaSpawned( CGECaptureArea *pArea )
 {
 	CGECaptureAreaDef *ca = GetCapAreaDef( pArea->GetGroupName() );
+	pArea->SetCaptureAreaDef( ca );
+
 	if ( ca )
 	{
 		ca->vAreas.AddToTail( pArea->GetRefEHandle() );
@@ -377,7 +436,9 @@ void CGETokenManager::OnCaptureAreaSpawned( CGECaptureArea *pArea )
 
 void CGETokenManager::OnCaptureAreaRemoved( CGECaptureArea *pArea )
 {
-	CGECaptureAreaDef *ca = GetCapAreaDef( pArea->GetGroupName() );
+	CGECaptureAreaDef *ca = pArea->GetCaptureAreaDef();
+	pArea->SetCaptureAreaDef( NULL );
+
 	if ( ca )
 	{
 		GEGameplay()->GetScenario()->OnCaptureAreaRemoved( pArea );
@@ -503,6 +564,7 @@ void CGETokenManager::ResetTokenSpawners( const char *name /*=NULL*/, int count
 
 			// Finally subtract from our token limit
 			ttype->iLimit -= toRemove;
+			ttype->bNeedsEnforce = true;
 		}
 	}
 }
@@ -537,6 +599,7 @@ void CGETokenManager::RemoveTokenEnt( CGEWeapon *pToken, bool bAdjustLimit /*=tr
 	if ( bAdjustLimit )
 	{
 		ttype->iLimit--;
+		ttype->bNeedsEnforce = true;
 
 		// Reset the first empty spawner
 		for ( int i=0; i < ttype->vSpawners.Count(); i++ )
@@ -616,15 +679,26 @@ void CGETokenManager::RemoveCaptureAreas( const char *name /*=NULL*/, int count
 	else
 	{
 		// Remove all the capture points from the world
-		CBaseEntity *pCP = gEntList.FindEntityByClassname( NULL, "ge_capturearea" );
+		CBaseEntity *pCP = gEntList.NextEntByClassname( NULL, "ge_capturearea" );
 		while( pCP )
 		{
 			pCP->Remove();
-			pCP = gEntList.FindEntityByClassname( pCP, "ge_capturearea" );
+			pCP = gEntList.NextEntByClassname( pCP, "ge_capturearea" );
 		}
 
+		// Removal is deferred, unlink the areas now so they don't reach back into a definition
+		// that Reset is about to delete
 		FOR_EACH_DICT( m_vCaptureAreas, idx )
-			m_vCaptureAreas[idx]->vAreas.RemoveAll();
+		{
+			CGECaptureAreaDef *ca = m_vCaptureAreas[idx];
+			for ( int i=0; i < ca->vAreas.Count(); i++ )
+			{
+				if ( ca->vAreas[i].Get() )
+					ca->vAreas[i]->SetCaptureAreaDef( NULL );
+			}
+
+			ca->vAreas.RemoveAll();
+		}
 	}
 }
 
@@ -924,6 +998,8 @@ int CGETokenManager::FilterSpawnersForCapArea( CGECaptureAreaDef *ca, int spawne
 
 void CGETokenManager::EnforceTokens( void )
 {
+	GE_BENCH_SCOPE( GEBENCH_TOKENS );
+
 	if ( gpGlobals->curtime < m_flNextEnforcement || !GEGameplay()->IsInRound() )
 		return;
 
@@ -934,13 +1010,25 @@ void CGETokenManager::EnforceTokens( void )
 		SpawnCaptureAreas();
 	}
 
+	if ( ge_debug_tokenregistry.GetBool() )
+		ValidateTokens();
+
 	FOR_EACH_DICT( m_vTokenTypes, idx )
 	{
 		CGETokenDef *pDef = m_vTokenTypes[idx];
 
-		// Update known token locations
-		pDef->vTokens.RemoveAll();
-		FindTokens( pDef->szClassName, pDef->vTokens );
+		// Nothing happened to this type since we last looked at it
+		if ( !pDef->bDirty && !pDef->bNeedsEnforce )
+			continue;
+
+		pDef->bNeedsEnforce = false;
+
+		// Drop tokens that went away without telling us
+		for ( int k=0; k < pDef->vTokens.Count(); k++ )
+		{
+			if ( !pDef->vTokens[k].Get() )
+				pDef->vTokens.Remove(k--);
+		}
 
 		// Check dirty flag
 		if ( pDef->bDirty )
@@ -966,9 +1054,18 @@ void CGETokenManager::EnforceTokens( void )
 		// Adjust our token amounts if needed
 		int diff = pDef->iLimit - pDef->vTokens.Count();
 		if ( diff > 0 )
+		{
 			SpawnTokens( pDef->szClassName );
+
+			// Keep looking for spawners until we have enough, the ones we
+			// have will report back through OnTokenSpawned
+			if ( pDef->vSpawners.Count() < pDef->iLimit )
+				pDef->bNeedsEnforce = true;
+		}
 		else if ( diff < 0 )
+		{
 			RemoveTokens( pDef->szClassName, abs(diff) );
+		}
 	}
 
 	FOR_EACH_DICT( m_vCaptureAreas, idx )
@@ -1077,12 +1174,65 @@ void CGETokenManager::FindTokens( const char *szClassName, CUtlVector<EHANDLE> &
 	if ( !pDef )
 		return;
 
-	CBaseEntity *pEnt = gEntList.FindEntityByClassname( NULL, szClassName );
+	for ( int i=0; i < pDef->vTokens.Count(); i++ )
+	{
+		if ( pDef->vTokens[i].Get() )
+			tokens.AddToTail( pDef->vTokens[i] );
+	}
+}
+
+void CGETokenManager::ScanTokens( const char *szClassName, CUtlVector<EHANDLE> &tokens )
+{
+	tokens.RemoveAll();
+
+	CBaseEntity *pEnt = gEntList.NextEntByClassname( NULL, szClassName );
 	while ( pEnt )
 	{
-		tokens.AddToTail( pEnt );
-		pEnt = gEntList.FindEntityByClassname( pEnt, szClassName );
+		// Already had UpdateOnRemove called, it just hasn't been deleted yet
+		if ( !pEnt->IsMarkedForDeletion() )
+			tokens.AddToTail( pEnt );
+
+		pEnt = gEntList.NextEntByClassname( pEnt, szClassName );
+	}
+}
+
+int CGETokenManager::ValidateTokens( bool bFix /*=true*/ )
+{
+	int mismatched = 0;
+	CUtlVector<EHANDLE> found;
+
+	FOR_EACH_DICT( m_vTokenTypes, idx )
+	{
+		CGETokenDef *pDef = m_vTokenTypes[idx];
+		ScanTokens( pDef->szClassName, found );
+
+		int tracked = 0;
+		bool bMatch = true;
+		for ( int i=0; i < pDef->vTokens.Count(); i++ )
+		{
+			if ( !pDef->vTokens[i].Get() )
+				continue;
+
+			tracked++;
+			if ( !found.HasElement( pDef->vTokens[i] ) )
+				bMatch = false;
+		}
+
+		if ( bMatch && tracked == found.Count() )
+			continue;
+
+		mismatched++;
+		Warning( "[TknMgr] Token registry for %s is out of sync (%i tracked, %i in world)!\n", pDef->szClassName, tracked, found.Count() );
+
+		if ( bFix )
+		{
+			pDef->vTokens.RemoveAll();
+			pDef->vTokens.AddVectorToTail( found );
+			pDef->bNeedsEnforce = true;
+		}
 	}
+
+	return mismatched;
 }
 
 CGETokenDef *CGETokenManager::GetTokenDef( const char *szClassName )
@@ -40,10 +40,11 @@ public:
 	float	glowDist;			// Glow distance
 
 	bool	bDirty;				// Indicates we need to refresh our spawned tokens
+	bool	bNeedsEnforce;		// Our tokens, spawners, or limit changed since the last enforcement
 
 	// Remember which spawners we affected
 	CUtlVector< CHandle<CGESpawner> > vSpawners;
-	// Retain a list of tokens we know about
+	// Every live token of this type, kept up to date by the token callbacks
 	CUtlVector<EHANDLE> vTokens;
 
 private:
@@ -55,6 +56,10 @@ class CGECaptureAreaDef
 {
 public:
 	CGECaptureAreaDef();
+	~CGECaptureAreaDef();
+
+	// Resolve the requirements below into the fields our areas test on touch
+	void  Compile();
 
 	char  szClassName[MAX_ENTITY_NAME];
 	char  szModelName[MAX_MODEL_PATH];
@@ -69,6 +74,12 @@ public:
 	char  rqdToken[MAX_ENTITY_NAME];
 	int   rqdTeam;
 
+	// Compiled requirements, only valid while bCompiled is set
+	int		 iRqdWeaponID;	// WEAPON_NONE if no token is required
+	string_t iszRqdToken;	// Pooled classname of the required token
+	int		 iTeamMask;		// Bit per team allowed to enter
+	bool	 bCompiled;
+
 	bool  bDirty;	// Indicates we need to refresh our spawned capture areas
 
 	CUtlVector< CHandle<CGECaptureArea> > vAreas;
@@ -117,6 +128,8 @@ public:
 
 	// Returns the list of tokens of a specific type
 	void FindTokens( const char *szClassName, CUtlVector<EHANDLE> &tokens );
+	// Checks every token registry against a full entity scan, returns the number of mismatched types
+	int  ValidateTokens( bool bFix = true );
 
 	// Internal checkers for spawner entities and weapons
 	bool ShouldSpawnToken( const char *szClassName, CGESpawner *pSpawner );
@@ -137,6 +150,9 @@ public:
 	void OnTokenPicked( CGEWeapon *pToken, CGEPlayer *pPlayer );
 	void OnTokenDropped( CGEWeapon *pToken, CGEPlayer *pPlayer );
 
+	// Called from CGESpawner
+	void OnTokenSpawnerDisabled( CGESpawner *pSpawner );
+
 	// Called from CGECaptureArea
 	void OnCaptureAreaSpawned( CGECaptureArea *pArea );
 	void OnCaptureAreaRemoved( CGECaptureArea *pArea );
@@ -167,6 +183,9 @@ private:
 	CGETokenDef			*GetTokenDef( const char *szClassName );
 	CGECaptureAreaDef	*GetCapAreaDef( const char *szName );
 
+	// Walks the entity list for tokens of a type, only used to seed and validate the registry
+	void ScanTokens( const char *szClassName, CUtlVector<EHANDLE> &tokens );
+
 	void ApplyTokenSettings( CGETokenDef *ttype, CGEWeapon *pToken = NULL );
 	void ApplyCapAreaSettings( CGECaptureAreaDef *ca, CGECaptureArea *pArea = NULL );
 
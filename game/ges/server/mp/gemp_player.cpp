@@ -17,9 +17,11 @@
 #include "ammodef.h"
 #include "viewport_panel_names.h"
 #include "networkstringtable_gamedll.h"
+#include "tier0/fasttimer.h"
 
 #include "ge_utils.h"
 #include "ge_playerspawn.h"
+#include "ge_spawngrid.h"
 #include "ge_gameplay.h"
 #include "ge_radarresource.h"
 #include "ge_tokenmanager.h"
@@ -30,6 +32,7 @@
 #include "ge_player_shared.h"
 #include "gebot_player.h"
 #include "gemp_gamerules.h"
+#include "ge_benchmark.h"
 
 #include "gemp_player.h"
 
@@ -381,6 +384,9 @@ void CGEMPPlayer::Spawn()
 			return;
 		}
 
+		// Make sure spawn scoring sees us at our new location during this tick
+		GEMPRules()->GetSpawnGrid()->UpdatePlayer( this );
+
 		int noSkins = atoi(engine->GetClientConVarValue(entindex(), "cl_ge_nowepskins"));
 
 		// Create a dummy skin list, fill it out, and then transmit anything that changed.
@@ -848,6 +854,8 @@ void CGEMPPlayer::ShowTeamNotice( const char *title, const char *msg, const char
 
 CBaseEntity* CGEMPPlayer::EntSelectSpawnPoint()
 {
+	GE_BENCH_SCOPE( GEBENCH_SPAWNSELECT );
+
 	// This call ensures we always default to info_player_deathmatch if none of the other spawn types exist
 	int iSpawnerType = GEMPRules()->GetSpawnPointType( this );
 	CGEPlayerSpawn *pSpot = NULL;
@@ -878,8 +886,13 @@ CBaseEntity* CGEMPPlayer::EntSelectSpawnPoint()
 		}
 	}
 
+	CFastTimer selectTimer;
 	if ( ge_debug_playerspawns.GetBool() )
+	{
 		Msg( "Started Spawn Point Selection!\n" );
+		CGEPlayerSpawn::ResetThreatStats();
+		selectTimer.Start();
+	}
 
 	const CUtlVector<EHANDLE> *vSpots = GERules()->GetSpawnersOfType( iSpawnerType );
 	CUtlVector<CGEPlayerSpawn*> vSpawners;
@@ -929,6 +942,15 @@ CBaseEntity* CGEMPPlayer::EntSelectSpawnPoint()
 		}
 	}
 
+	if ( ge_debug_playerspawns.GetBool() )
+	{
+		// Show how much work the shared threat cache saved us during this selection
+		selectTimer.End();
+		const CGEPlayerSpawn::ThreatStats_t &stats = CGEPlayerSpawn::GetThreatStats();
+		Msg( "Scored %i spawn points in %0.3f ms (threat: %i calculated, %i cached; visibility: %i traced, %i cached)\n", 
+			vSpots->Count(), selectTimer.GetDuration().GetMillisecondsF(), stats.iThreatCalcs, stats.iThreatCached, stats.iVisChecks, stats.iVisCached );
+	}
+
 	// If we didn't find any spots bail out early
 	if ( vSpawners.Count() == 0 )
 	{
@@ -1331,12 +1353,11 @@ void CGEMPPlayer::PreThink()
 					engine->ServerCommand(command);
 				}
 
-				if (IsOnList(LIST_SKINS, m_iSteamIDHash))
+				uint64 skinsCode;
+				if (GetListSkins(m_iSteamIDHash, skinsCode))
 				{
 					DevMsg("OWNS AUTHED SKIN: %s (%s)\n", GetPlayerName(), steamID);
-
-					int skinIndex = vSkinsHash.Find(m_iSteamIDHash);
-					m_iSkinsCode = vSkinsValues[skinIndex];
+					m_iSkinsCode = skinsCode;
 				}
 			}
 		}
@@ -1413,14 +1434,7 @@ void CGEMPPlayer::Event_Killed( const CTakeDamageInfo &info )
 void CGEMPPlayer::NotifyOnDeath()
 {
 	// Notify nearby spawn points of our death (DM Spawns Only)
-	const CUtlVector<EHANDLE> *vSpawns = GERules()->GetSpawnersOfType( SPAWN_PLAYER );
-	Vector myPos = GetAbsOrigin();
-	for ( int i=(vSpawns->Count()-1); i >= 0; i-- )
-	{
-		CGEPlayerSpawn *pSpawn = (CGEPlayerSpawn*) vSpawns->Element(i).Get();
-		float dist = UTIL_DistApprox( myPos, pSpawn->GetAbsOrigin() );
-		pSpawn->NotifyOnDeath( dist );
-	}
+	CGEPlayerSpawn::NotifyNearbyOnDeath( GetAbsOrigin() );
 }
 
 bool CGEMPPlayer::HandleCommand_JoinTeam( int team )
@@ -232,7 +232,10 @@ public:
 
 	void Cleanup()
 	{
-		TRYFUNC( this->get_override("Cleanup")() );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "Cleanup" );
+			TRYFUNC( this->get_override("Cleanup")() );
+		}
 		self = bp::object();
 	}
 
@@ -243,36 +246,50 @@ public:
 
 	const char *GetNPCModel( void )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "GetModel" );
 		TRYFUNCRET( this->get_override("GetModel")(), NULL );
 	}
 
 	Class_T Classify( void )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "Classify" );
 		TRYFUNCRET( this->get_override("Classify")(), CLASS_NONE );
 	}
 
 	void OnSpawn( void )
 	{
-		TRYFUNC( this->get_override("OnSpawn")() );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnSpawn" );
+			TRYFUNC( this->get_override("OnSpawn")() );
+		}
 		PY_CALLHOOKS( FUNC_AI_ONSPAWN, bp::make_tuple() );
 	}
 
 	void OnSetDifficulty( int level )
 	{
-		TRYFUNC( this->get_override("OnSetDifficulty")(level) );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnSetDifficulty" );
+			TRYFUNC( this->get_override("OnSetDifficulty")(level) );
+		}
 		PY_CALLHOOKS( FUNC_AI_SETDIFFICULTY, bp::make_tuple(level) );
 	}
 
 	void OnLooked( int dist )
 	{
 		PY_CALLHOOKS( FUNC_AI_ONLOOKED, bp::make_tuple(dist) );
-		TRYFUNC( this->get_override("OnLooked")(dist) );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnLooked" );
+			TRYFUNC( this->get_override("OnLooked")(dist) );
+		}
 	}
 
 	void OnListened( void )
 	{
 		PY_CALLHOOKS( FUNC_AI_ONLISTENED, bp::make_tuple() );
-		TRYFUNC( this->get_override("OnListened")() );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnListened" );
+			TRYFUNC( this->get_override("OnListened")() );
+		}
 	}
 
 	void OnPickupItem( void )
@@ -282,23 +299,29 @@ public:
 
 	bool IsValidEnemy( CBaseEntity *pEnemy )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "IsValidEnemy" );
 		TRYFUNCRET( this->get_override("IsValidEnemy")(bp::ptr(pEnemy)), true );
 	}
 
 	void GatherConditions( void )
 	{
-		TRYFUNC( this->get_override("GatherConditions")() );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "GatherConditions" );
+			TRYFUNC( this->get_override("GatherConditions")() );
+		}
 		PY_CALLHOOKS( FUNC_AI_GATHERCONDITIONS, bp::make_tuple() );
 	}
 
 	NPC_STATE SelectIdealState( void )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "SelectIdealState" );
 		TRYFUNCRET( this->get_override("SelectIdealState")(), NPC_STATE_INVALID );
 	}
 
 	int SelectSchedule( void )
 	{
 		PY_CALLHOOKS( FUNC_AI_SELECTSCHEDULE, bp::make_tuple() );
+		PY_PROFILE_SCOPE( self.ptr(), "SelectSchedule" );
 		try {
 			CGEPySchedule *sched = this->get_override("SelectSchedule")();
 			return sched->id_;
@@ -310,6 +333,7 @@ public:
 
 	int  TranslateSchedule( int schedule )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "TranslateSchedule" );
 		try {
 			CGEPySchedule *sched = this->get_override("TranslateSchedule")( schedule );
 			return sched->id_;
@@ -321,21 +345,25 @@ public:
 
 	bool ShouldInterruptSchedule( int schedule )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "ShouldInterruptSchedule" );
 		TRYFUNCRET( this->get_override("ShouldInterruptSchedule")(schedule), false );
 	}
 
 	bool CheckStartTask( const Task_t* task ) 
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "CheckStartTask" );
 		TRYFUNCRET( this->get_override("CheckStartTask")(task->iTask, task->flTaskData), false );
 	}
 
 	bool CheckRunTask( const Task_t* task ) 
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "CheckRunTask" );
 		TRYFUNCRET( this->get_override("CheckRunTask")(task->iTask, task->flTaskData), false );
 	}
 
 	void OnDebugCommand( const char *cmd )
 	{
+		PY_PROFILE_SCOPE( self.ptr(), "OnDebugCommand" );
 		TRYFUNC( this->get_override("OnDebugCommand")(cmd) );
 	}
 
@@ -444,6 +472,8 @@ public:
 	void SetTarget( CBaseEntity *target )		{ m_pOuter->SetTarget( target ); }
 	void SetTargetPos( const Vector &origin )	{ m_pOuter->SetTargetPos( origin ); }
 	bool IsSelected()							{ return (m_pOuter->m_debugOverlays & OVERLAY_NPC_SELECTED_BIT) != 0; }
+	bool HasLineOfSight( CBaseEntity *pEnt )	{ return pEnt && m_pOuter->FVisible( pEnt ); }
+	bool CanSeeEntity( CBaseEntity *pEnt )		{ return pEnt && m_pOuter->FInViewCone( pEnt ) && m_pOuter->FVisible( pEnt ); }
 
 	// State
 	int GetMaxHealth()							{ return m_pOuter->GetBotPlayer()->GetMaxHealth(); }
@@ -517,6 +547,7 @@ public:
 
 	CGEBaseNPC* CreateNPC( const char *name, CNPC_GEBase *parent )
 	{
+		PY_PROFILE_SCOPE( "CAiManager", "CreateNPC" );
 		try {
 			bp::object npc = bp::call<bp::object>( this->get_override("CreateNPC").ptr(), name, bp::ptr(parent) );
 
@@ -616,6 +647,8 @@ BOOST_PYTHON_MODULE(GEAi)
 		// Custom functions
 		.def("GetSeenEntities", &CGEPyBaseNPC::GetSeenEntities)
 		.def("GetHeardSounds", &CGEPyBaseNPC::GetHeardSounds)
+		.def("HasLineOfSight", &CGEPyBaseNPC::HasLineOfSight)
+		.def("CanSeeEntity", &CGEPyBaseNPC::CanSeeEntity)
 		.def("GetHeldWeapons", &CGEPyBaseNPC::GetHeldWeapons)
 		.def("GetHeldWeaponIds", &CGEPyBaseNPC::GetHeldWeaponIds)
 		.def("Say", &CGEPyBaseNPC::Say)
@@ -737,12 +770,12 @@ CON_COMMAND( ge_ai_reboot, "Reboots the AI Manager and all bots" )
 	CreateAiManager();
 
 	// Loop through all npc_gebase entities and reboot their python link
-	CNPC_GEBase *pNPC = (CNPC_GEBase*) gEntList.FindEntityByClassname( NULL, "npc_gebase" );
+	CNPC_GEBase *pNPC = (CNPC_GEBase*) gEntList.NextEntByClassname( NULL, "npc_gebase" );
 	while( pNPC )
 	{
 		pNPC->ClearSchedule( "Reboot" );
 		pNPC->InitPyInterface( pNPC->GetIdent() );
-		pNPC = (CNPC_GEBase*) gEntList.FindEntityByClassname( pNPC, "npc_gebase" );
+		pNPC = (CNPC_GEBase*) gEntList.NextEntByClassname( pNPC, "npc_gebase" );
 	}
 
 	// Reload the tasks, schedules, and conditions from python
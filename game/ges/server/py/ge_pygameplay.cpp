@@ -21,6 +21,7 @@
 #include "ge_tokenmanager.h"
 
 #include "ge_pymanager.h"
+#include "ge_pyscenariocache.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -254,12 +255,111 @@ private:
 	CUtlMap<int, sHelpPane*> m_vHelpPanes;
 };
 
+// Scenario hooks we dispatch into Python, resolved once per load
+enum GEScenarioHook_t
+{
+	SCENARIO_ONPLAYERCONNECT = 0,
+	SCENARIO_ONPLAYERDISCONNECT,
+	SCENARIO_ONTHINK,
+	SCENARIO_BEFORESETUPROUND,
+	SCENARIO_ONROUNDBEGIN,
+	SCENARIO_ONROUNDEND,
+	SCENARIO_ONCVARCHANGED,
+	SCENARIO_CANPLAYERRESPAWN,
+	SCENARIO_CANPLAYERHAVEITEM,
+	SCENARIO_CANPLAYERCHANGECHAR,
+	SCENARIO_CALCULATECUSTOMDAMAGE,
+	SCENARIO_SHOULDFORCEPICKUP,
+	SCENARIO_ONPLAYERSPAWN,
+	SCENARIO_ONPLAYEROBSERVER,
+	SCENARIO_ONPLAYERKILLED,
+	SCENARIO_ONPLAYERSAY,
+	SCENARIO_CANPLAYERCHANGETEAM,
+	SCENARIO_ONCAPTUREAREASPAWNED,
+	SCENARIO_ONCAPTUREAREAREMOVED,
+	SCENARIO_ONCAPTUREAREAENTERED,
+	SCENARIO_ONCAPTUREAREAEXITED,
+	SCENARIO_ONWEAPONSPAWNED,
+	SCENARIO_ONWEAPONREMOVED,
+	SCENARIO_ONARMORSPAWNED,
+	SCENARIO_ONARMORREMOVED,
+	SCENARIO_ONAMMOSPAWNED,
+	SCENARIO_ONAMMOREMOVED,
+	SCENARIO_ONTOKENSPAWNED,
+	SCENARIO_ONTOKENREMOVED,
+	SCENARIO_ONTOKENPICKED,
+	SCENARIO_ONTOKENDROPPED,
+	SCENARIO_ONTOKENATTACK,
+	SCENARIO_ONENEMYTOKENTOUCHED,
+	SCENARIO_CANROUNDEND,
+	SCENARIO_CANMATCHEND,
+	SCENARIO_GETTEAMPLAY,
+
+	SCENARIO_HOOK_COUNT
+};
+
+struct GEScenarioHookInfo_t
+{
+	const char *szName;
+	// The shared Python base only stubs this out, so it can be skipped if the scenario doesn't override it
+	bool bStubbedByBase;
+};
+
+static const GEScenarioHookInfo_t g_ScenarioHooks[ SCENARIO_HOOK_COUNT ] =
+{
+	{ "OnPlayerConnect", false },
+	{ "OnPlayerDisconnect", false },
+	{ "OnThink", true },
+	{ "BeforeSetupRound", false },
+	{ "OnRoundBegin", false },
+	{ "OnRoundEnd", false },
+	{ "OnCVarChanged", false },
+	{ "CanPlayerRespawn", true },
+	{ "CanPlayerHaveItem", true },
+	{ "CanPlayerChangeChar", false },
+	{ "CalculateCustomDamage", true },
+	{ "ShouldForcePickup", true },
+	{ "OnPlayerSpawn", false },
+	{ "OnPlayerObserver", false },
+	{ "OnPlayerKilled", false },
+	{ "OnPlayerSay", false },
+	{ "CanPlayerChangeTeam", false },
+	{ "OnCaptureAreaSpawned", true },
+	{ "OnCaptureAreaRemoved", true },
+	{ "OnCaptureAreaEntered", true },
+	{ "OnCaptureAreaExited", true },
+	{ "OnWeaponSpawned", true },
+	{ "OnWeaponRemoved", true },
+	{ "OnArmorSpawned", true },
+	{ "OnArmorRemoved", true },
+	{ "OnAmmoSpawned", true },
+	{ "OnAmmoRemoved", true },
+	{ "OnTokenSpawned", true },
+	{ "OnTokenRemoved", true },
+	{ "OnTokenPicked", true },
+	{ "OnTokenDropped", true },
+	{ "OnTokenAttack", true },
+	{ "OnEnemyTokenTouched", true },
+	{ "CanRoundEnd", true },
+	{ "CanMatchEnd", true },
+	{ "GetTeamPlay", false },
+};
+
+// The shared Python base every official scenario derives from, its versions of the
+// hooks marked bStubbedByBase above do nothing
+#define GE_SCENARIO_STUB_MODULE	"GamePlay"
+#define GE_SCENARIO_STUB_CLASS	"GEScenario"
+
+// Times the rest of the enclosing scope against the scenario's class and the given hook
+#define PROFILE_HOOK( hook ) PY_PROFILE_SCOPE( self.ptr(), g_ScenarioHooks[hook].szName )
+
 class CGEPyScenario : public CGEBaseScenario, public bp::wrapper<CGEPyScenario>
 {
 public:
 	CGEPyScenario()
 	{
 		m_szDescription[0] = '\0';
+		m_bHooksResolved = false;
 	}
 
 	~CGEPyScenario()
@@ -272,7 +372,13 @@ public:
 protected:
 	virtual void Init()
 	{
-		TRYFUNC( this->get_override("OnLoadGamePlay")() );
+		// Figure out what this scenario actually implements before anything calls into it
+		ResolveHooks();
+
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnLoadGamePlay" );
+			TRYFUNC( this->get_override("OnLoadGamePlay")() );
+		}
 
 		// Load scenario help from python
 		TRYFUNC( this->get_override("GetScenarioHelp")(bp::ptr(&m_ScenarioHelp)) );
@@ -280,10 +386,14 @@ protected:
 
 	virtual void Shutdown()
 	{
-		TRYFUNC( this->get_override("OnUnloadGamePlay")() );
+		{
+			PY_PROFILE_SCOPE( self.ptr(), "OnUnloadGamePlay" );
+			TRYFUNC( this->get_override("OnUnloadGamePlay")() );
+		}
 
 		// Clear us out in case we get reloaded
 		m_ScenarioHelp.ClearHelp();
+		ClearHooks();
 
 		// Remove our instance
 		self = bp::object();
@@ -339,63 +449,107 @@ public:
 		m_ScenarioHelp.SendHelp( pPlayer );
 
 		PY_CALLHOOKS( FUNC_GP_PLAYERCONNECT, bp::make_tuple(bp::ptr(pPlayer)) );
-		TRYFUNC( this->get_override("OnPlayerConnect")(bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONPLAYERCONNECT ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONPLAYERCONNECT );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONPLAYERCONNECT ).ptr(), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void ClientDisconnect( CGEPlayer *pPlayer )
 	{
-		TRYFUNC( this->get_override("OnPlayerDisconnect")(bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONPLAYERDISCONNECT ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONPLAYERDISCONNECT );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONPLAYERDISCONNECT ).ptr(), bp::ptr(pPlayer) ) );
+		}
 		PY_CALLHOOKS( FUNC_GP_PLAYERDISCONNECT, bp::make_tuple(bp::ptr(pPlayer)) );
 	}
 
 	virtual void OnThink()
 	{
 		PY_CALLHOOKS( FUNC_GP_THINK, bp::make_tuple() );
-		TRYFUNC( this->get_override("OnThink")() );
+		if ( HasHook( SCENARIO_ONTHINK ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTHINK );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTHINK ).ptr() ) );
+		}
 	}
 
 	virtual void BeforeSetupRound()
 	{
-		TRYFUNC( this->get_override("BeforeSetupRound")() );
+		if ( HasHook( SCENARIO_BEFORESETUPROUND ) )
+		{
+			PROFILE_HOOK( SCENARIO_BEFORESETUPROUND );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_BEFORESETUPROUND ).ptr() ) );
+		}
 	}
 
 	virtual void OnRoundBegin()
 	{
 		PY_CALLHOOKS( FUNC_GP_ROUNDBEGIN, bp::make_tuple() );
-		TRYFUNC( this->get_override("OnRoundBegin")() );
+		if ( HasHook( SCENARIO_ONROUNDBEGIN ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONROUNDBEGIN );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONROUNDBEGIN ).ptr() ) );
+		}
 	}
 
 	virtual void OnRoundEnd()
 	{
 		PY_CALLHOOKS( FUNC_GP_ROUNDEND, bp::make_tuple() );
-		TRYFUNC( this->get_override("OnRoundEnd")() );
+		if ( HasHook( SCENARIO_ONROUNDEND ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONROUNDEND );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONROUNDEND ).ptr() ) );
+		}
 	}
 
 	virtual void OnCVarChanged(const char* name, const char* oldvalue, const char* newvalue)
 	{
-		TRYFUNC( this->get_override("OnCVarChanged")(name, oldvalue, newvalue) );
+		if ( HasHook( SCENARIO_ONCVARCHANGED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONCVARCHANGED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONCVARCHANGED ).ptr(), name, oldvalue, newvalue ) );
+		}
 	}
 
 
 	virtual bool CanPlayerRespawn(CGEPlayer *pPlayer)
 	{
-		TRYFUNCRET( this->get_override("CanPlayerRespawn")(bp::ptr(pPlayer)), true );
+		if ( !HasHook( SCENARIO_CANPLAYERRESPAWN ) )
+			return true;
+
+		PROFILE_HOOK( SCENARIO_CANPLAYERRESPAWN );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_CANPLAYERRESPAWN ).ptr(), bp::ptr(pPlayer) ), true );
 	}
 
 	virtual bool CanPlayerHaveItem(CGEPlayer *pPlayer, CBaseEntity *pEntity)
 	{
-		TRYFUNCRET( this->get_override("CanPlayerHaveItem")(bp::ptr(pPlayer), bp::ptr(pEntity)), true );
+		if ( !HasHook( SCENARIO_CANPLAYERHAVEITEM ) )
+			return true;
+
+		PROFILE_HOOK( SCENARIO_CANPLAYERHAVEITEM );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_CANPLAYERHAVEITEM ).ptr(), bp::ptr(pPlayer), bp::ptr(pEntity) ), true );
 	}
 
 	virtual bool CanPlayerChangeChar(CGEPlayer* pPlayer, const char* szIdent)
 	{
-		TRYFUNCRET( this->get_override("CanPlayerChangeChar")(bp::ptr(pPlayer), szIdent), true );
+		if ( !HasHook( SCENARIO_CANPLAYERCHANGECHAR ) )
+			return true;
+
+		PROFILE_HOOK( SCENARIO_CANPLAYERCHANGECHAR );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_CANPLAYERCHANGECHAR ).ptr(), bp::ptr(pPlayer), szIdent ), true );
 	}
 
 	virtual void CalculateCustomDamage(CGEPlayer *pVictim, const CTakeDamageInfo &inputInfo, float &health, float &armor)
 	{
+		if ( !HasHook( SCENARIO_CALCULATECUSTOMDAMAGE ) )
+			return;
+
+		PROFILE_HOOK( SCENARIO_CALCULATECUSTOMDAMAGE );
 		try {
-			bp::tuple tpl = this->get_override("CalculateCustomDamage")(bp::ptr(pVictim), inputInfo, health, armor);
+			bp::object tpl = bp::call<bp::object>( GetHook( SCENARIO_CALCULATECUSTOMDAMAGE ).ptr(), bp::ptr(pVictim), inputInfo, health, armor );
 			health = bp::extract<float>(tpl[0]);
 			armor = bp::extract<float>(tpl[1]);
 		} catch( bp::error_already_set const & ) {
@@ -405,36 +559,60 @@ public:
 
 	virtual bool ShouldForcePickup(CGEPlayer *pPlayer, CBaseEntity *pEntity)
 	{
-		TRYFUNCRET( this->get_override("ShouldForcePickup")(bp::ptr(pPlayer), bp::ptr(pEntity)), false );
+		if ( !HasHook( SCENARIO_SHOULDFORCEPICKUP ) )
+			return false;
+
+		PROFILE_HOOK( SCENARIO_SHOULDFORCEPICKUP );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_SHOULDFORCEPICKUP ).ptr(), bp::ptr(pPlayer), bp::ptr(pEntity) ), false );
 	}
 	
 	virtual void OnPlayerSpawn(CGEPlayer *pPlayer)
 	{
 		PY_CALLHOOKS( FUNC_GP_PLAYERSPAWN, bp::make_tuple(bp::ptr(pPlayer)) );
-		TRYFUNC( this->get_override("OnPlayerSpawn")(bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONPLAYERSPAWN ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONPLAYERSPAWN );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONPLAYERSPAWN ).ptr(), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void OnPlayerObserver(CGEPlayer *pPlayer)
 	{
 		PY_CALLHOOKS( FUNC_GP_PLAYEROBSERVER, bp::make_tuple(bp::ptr(pPlayer)) );
-		TRYFUNC( this->get_override("OnPlayerObserver")(bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONPLAYEROBSERVER ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONPLAYEROBSERVER );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONPLAYEROBSERVER ).ptr(), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void OnPlayerKilled(CGEPlayer *pVictim, CGEPlayer *pKiller, CBaseEntity *pWeapon)
 	{
 		PY_CALLHOOKS( FUNC_GP_PLAYERKILLED, bp::make_tuple(bp::ptr(pVictim), bp::ptr(pKiller), bp::ptr(pWeapon)) );
-		TRYFUNC( this->get_override("OnPlayerKilled")(bp::ptr(pVictim), bp::ptr(pKiller), bp::ptr(pWeapon)) );
+		if ( HasHook( SCENARIO_ONPLAYERKILLED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONPLAYERKILLED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONPLAYERKILLED ).ptr(), bp::ptr(pVictim), bp::ptr(pKiller), bp::ptr(pWeapon) ) );
+		}
 	}
 
 	virtual bool OnPlayerSay(CGEPlayer* pPlayer, const char* text)
 	{
-		TRYFUNCRET( this->get_override("OnPlayerSay")(bp::ptr(pPlayer), text), false );
+		if ( !HasHook( SCENARIO_ONPLAYERSAY ) )
+			return false;
+
+		PROFILE_HOOK( SCENARIO_ONPLAYERSAY );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_ONPLAYERSAY ).ptr(), bp::ptr(pPlayer), text ), false );
 	}
 
 	virtual bool CanPlayerChangeTeam(CGEPlayer *pPlayer, int iOldTeam, int iNewTeam, bool wasForced )
 	{
 		bool ret = true;
-		TRYFUNC( ret = this->get_override("CanPlayerChangeTeam")(bp::ptr(pPlayer), iOldTeam, iNewTeam, wasForced) );
+		if ( HasHook( SCENARIO_CANPLAYERCHANGETEAM ) )
+		{
+			PROFILE_HOOK( SCENARIO_CANPLAYERCHANGETEAM );
+			TRYFUNC( ret = bp::call<bool>( GetHook( SCENARIO_CANPLAYERCHANGETEAM ).ptr(), bp::ptr(pPlayer), iOldTeam, iNewTeam, wasForced ) );
+		}
 		// Call our hook only if we actually changed teams
 		if ( ret )
 			PY_CALLHOOKS( FUNC_GP_PLAYERTEAM, bp::make_tuple(bp::ptr(pPlayer), iOldTeam, iNewTeam, wasForced ) );
@@ -445,106 +623,263 @@ public:
 
 	virtual void OnCaptureAreaSpawned( CGECaptureArea *pCapture )
 	{
-		TRYFUNC( this->get_override("OnCaptureAreaSpawned")(bp::ptr(pCapture)) );
+		if ( HasHook( SCENARIO_ONCAPTUREAREASPAWNED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONCAPTUREAREASPAWNED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONCAPTUREAREASPAWNED ).ptr(), bp::ptr(pCapture) ) );
+		}
 	}
 
 	virtual void OnCaptureAreaRemoved( CGECaptureArea *pCapture )
 	{
-		TRYFUNC( this->get_override("OnCaptureAreaRemoved")(bp::ptr(pCapture)) );
+		if ( HasHook( SCENARIO_ONCAPTUREAREAREMOVED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONCAPTUREAREAREMOVED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONCAPTUREAREAREMOVED ).ptr(), bp::ptr(pCapture) ) );
+		}
 	}
 
 	virtual void OnCaptureAreaEntered( CGECaptureArea *pCapture, CGEPlayer *pPlayer, CGEWeapon *pToken )
 	{
-		TRYFUNC( this->get_override("OnCaptureAreaEntered")(bp::ptr(pCapture), bp::ptr(pPlayer), bp::ptr(pToken)) );
+		if ( HasHook( SCENARIO_ONCAPTUREAREAENTERED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONCAPTUREAREAENTERED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONCAPTUREAREAENTERED ).ptr(), bp::ptr(pCapture), bp::ptr(pPlayer), bp::ptr(pToken) ) );
+		}
 	}
 	
 	virtual void OnCaptureAreaExited( CGECaptureArea *pCapture, CGEPlayer *pPlayer )
 	{
-		TRYFUNC( this->get_override("OnCaptureAreaExited")(bp::ptr(pCapture), bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONCAPTUREAREAEXITED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONCAPTUREAREAEXITED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONCAPTUREAREAEXITED ).ptr(), bp::ptr(pCapture), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void OnWeaponSpawned( CGEWeapon *pWeapon )
 	{
 		PY_CALLHOOKS( FUNC_GP_WEAPONSPAWNED, bp::make_tuple(bp::ptr(pWeapon)) );
-		TRYFUNC( this->get_override("OnWeaponSpawned")(bp::ptr(pWeapon)) );
+		if ( HasHook( SCENARIO_ONWEAPONSPAWNED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONWEAPONSPAWNED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONWEAPONSPAWNED ).ptr(), bp::ptr(pWeapon) ) );
+		}
 	}
 
 	virtual void OnWeaponRemoved( CGEWeapon *pWeapon )
 	{
 		PY_CALLHOOKS( FUNC_GP_WEAPONREMOVED, bp::make_tuple(bp::ptr(pWeapon)) );
-		TRYFUNC( this->get_override("OnWeaponRemoved")(bp::ptr(pWeapon)) );
+		if ( HasHook( SCENARIO_ONWEAPONREMOVED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONWEAPONREMOVED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONWEAPONREMOVED ).ptr(), bp::ptr(pWeapon) ) );
+		}
 	}
 
 	virtual void OnArmorSpawned( CBaseEntity *pArmor )
 	{
 		PY_CALLHOOKS( FUNC_GP_ARMORSPAWNED, bp::make_tuple(bp::ptr(pArmor)) );
-		TRYFUNC( this->get_override("OnArmorSpawned")(bp::ptr(pArmor)) );
+		if ( HasHook( SCENARIO_ONARMORSPAWNED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONARMORSPAWNED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONARMORSPAWNED ).ptr(), bp::ptr(pArmor) ) );
+		}
 	}
 
 	virtual void OnArmorRemoved( CBaseEntity *pArmor )
 	{
 		PY_CALLHOOKS( FUNC_GP_ARMORREMOVED, bp::make_tuple(bp::ptr(pArmor)) );
-		TRYFUNC( this->get_override("OnArmorRemoved")(bp::ptr(pArmor)) );
+		if ( HasHook( SCENARIO_ONARMORREMOVED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONARMORREMOVED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONARMORREMOVED ).ptr(), bp::ptr(pArmor) ) );
+		}
 	}
 
 	virtual void OnAmmoSpawned( CBaseEntity *pAmmo )
 	{
 		PY_CALLHOOKS( FUNC_GP_AMMOSPAWNED, bp::make_tuple(bp::ptr(pAmmo)) );
-		TRYFUNC( this->get_override("OnAmmoSpawned")(bp::ptr(pAmmo)) );
+		if ( HasHook( SCENARIO_ONAMMOSPAWNED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONAMMOSPAWNED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONAMMOSPAWNED ).ptr(), bp::ptr(pAmmo) ) );
+		}
 	}
 
 	virtual void OnAmmoRemoved( CBaseEntity *pAmmo )
 	{
 		PY_CALLHOOKS( FUNC_GP_AMMOREMOVED, bp::make_tuple(bp::ptr(pAmmo)) );
-		TRYFUNC( this->get_override("OnAmmoRemoved")(bp::ptr(pAmmo)) );
+		if ( HasHook( SCENARIO_ONAMMOREMOVED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONAMMOREMOVED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONAMMOREMOVED ).ptr(), bp::ptr(pAmmo) ) );
+		}
 	}
 
 	virtual void OnTokenSpawned( CGEWeapon *pToken )
 	{
-		TRYFUNC( this->get_override("OnTokenSpawned")(bp::ptr(pToken)) );
+		if ( HasHook( SCENARIO_ONTOKENSPAWNED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTOKENSPAWNED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTOKENSPAWNED ).ptr(), bp::ptr(pToken) ) );
+		}
 	}
 
 	virtual void OnTokenRemoved( CGEWeapon *pToken )
 	{
-		TRYFUNC( this->get_override("OnTokenRemoved")(bp::ptr(pToken)) );
+		if ( HasHook( SCENARIO_ONTOKENREMOVED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTOKENREMOVED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTOKENREMOVED ).ptr(), bp::ptr(pToken) ) );
+		}
 	}
 
 	virtual void OnTokenPicked( CGEWeapon *pToken, CGEPlayer *pPlayer )
 	{
-		TRYFUNC( this->get_override("OnTokenPicked")(bp::ptr(pToken), bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONTOKENPICKED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTOKENPICKED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTOKENPICKED ).ptr(), bp::ptr(pToken), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void OnTokenDropped( CGEWeapon *pToken, CGEPlayer *pPlayer )
 	{
-		TRYFUNC( this->get_override("OnTokenDropped")(bp::ptr(pToken), bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONTOKENDROPPED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTOKENDROPPED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTOKENDROPPED ).ptr(), bp::ptr(pToken), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual void OnTokenAttack( CGEWeapon *pToken, CGEPlayer *pPlayer, Vector position, Vector forward )
 	{
-		TRYFUNC( this->get_override("OnTokenAttack")(bp::ptr(pToken), bp::ptr(pPlayer), position, forward) );
+		if ( HasHook( SCENARIO_ONTOKENATTACK ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONTOKENATTACK );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONTOKENATTACK ).ptr(), bp::ptr(pToken), bp::ptr(pPlayer), position, forward ) );
+		}
 	}
 
 	virtual void OnEnemyTokenTouched(CGEWeapon *pToken, CGEPlayer *pPlayer)
 	{
-		TRYFUNC( this->get_override("OnEnemyTokenTouched")(bp::ptr(pToken), bp::ptr(pPlayer)) );
+		if ( HasHook( SCENARIO_ONENEMYTOKENTOUCHED ) )
+		{
+			PROFILE_HOOK( SCENARIO_ONENEMYTOKENTOUCHED );
+			TRYFUNC( bp::call<void>( GetHook( SCENARIO_ONENEMYTOKENTOUCHED ).ptr(), bp::ptr(pToken), bp::ptr(pPlayer) ) );
+		}
 	}
 
 	virtual bool CanRoundEnd()
 	{
-		TRYFUNCRET( this->get_override("CanRoundEnd")(), true );
+		if ( !HasHook( SCENARIO_CANROUNDEND ) )
+			return true;
+
+		PROFILE_HOOK( SCENARIO_CANROUNDEND );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_CANROUNDEND ).ptr() ), true );
 	}
 
 	virtual bool CanMatchEnd()
 	{
-		TRYFUNCRET( this->get_override("CanMatchEnd")(), true );
+		if ( !HasHook( SCENARIO_CANMATCHEND ) )
+			return true;
+
+		PROFILE_HOOK( SCENARIO_CANMATCHEND );
+		TRYFUNCRET( bp::call<bool>( GetHook( SCENARIO_CANMATCHEND ).ptr() ), true );
 	}
 
 	virtual int GetTeamPlay()
 	{
-		TRYFUNCRET( this->get_override("GetTeamPlay")() , 0 );
+		if ( !HasHook( SCENARIO_GETTEAMPLAY ) )
+			return 0;
+
+		PROFILE_HOOK( SCENARIO_GETTEAMPLAY );
+		TRYFUNCRET( bp::call<int>( GetHook( SCENARIO_GETTEAMPLAY ).ptr() ), 0 );
 	}
 
 private:
+	// Builds the dispatch table, hooks that resolve to nothing (or to a stub in the shared
+	// Python base) are left empty so we never transition into Python for them
+	void ResolveHooks()
+	{
+		ClearHooks();
+
+		if ( self.is_none() )
+			return;
+
+		m_bHooksResolved = true;
+
+		// The shared base's namespace, so we can recognize its stubs by identity. Scenarios
+		// that don't derive from it (or a missing module) simply get no stub filtering.
+		bp::object cls, stubs;
+		try {
+			cls = self.attr( "__class__" );
+			stubs = bp::import( GE_SCENARIO_STUB_MODULE ).attr( GE_SCENARIO_STUB_CLASS ).attr( "__dict__" );
+		} catch ( bp::error_already_set const & ) {
+			PyErr_Clear();
+		}
+
+		for ( int i=0; i < SCENARIO_HOOK_COUNT; i++ )
+		{
+			const GEScenarioHookInfo_t &info = g_ScenarioHooks[i];
+
+			try {
+				bp::override hook = this->get_override( info.szName );
+				if ( !hook )
+					continue;
+
+				// Inherited unchanged from the shared base's stub
+				if ( info.bStubbedByBase && !stubs.is_none() && IsStub( cls, stubs, info.szName ) )
+					continue;
+
+				m_Hooks[i] = hook;
+			} catch ( bp::error_already_set const & ) {
+				HandlePythonException();
+			}
+		}
+	}
+
+	void ClearHooks()
+	{
+		// Drop our references to the bound methods so the instance can be released
+		for ( int i=0; i < SCENARIO_HOOK_COUNT; i++ )
+			m_Hooks[i] = bp::object();
+
+		m_bHooksResolved = false;
+	}
+
+	// True if the function cls resolves name to is the shared base's own stub
+	bool IsStub( bp::object cls, bp::object stubs, const char *name )
+	{
+		if ( !stubs.contains( name ) )
+			return false;
+
+		bp::object mro = cls.attr( "__mro__" );
+		for ( int i=0; i < bp::len( mro ); i++ )
+		{
+			bp::object dict = mro[i].attr( "__dict__" );
+			if ( dict.contains( name ) )
+				return bp::object( dict[name] ).ptr() == bp::object( stubs[name] ).ptr();
+		}
+
+		return false;
+	}
+
+	bool HasHook( GEScenarioHook_t hook )
+	{
+		if ( !m_bHooksResolved )
+			ResolveHooks();
+
+		return !m_Hooks[hook].is_none();
+	}
+
+	bp::object &GetHook( GEScenarioHook_t hook ) { return m_Hooks[hook]; }
+
+	// Dispatch table of the hooks this scenario implements (None if it doesn't)
+	bp::object m_Hooks[ SCENARIO_HOOK_COUNT ];
+	bool m_bHooksResolved;
+
 	// Cached gameplay desc (might include (MOD) if it is not official)
 	char m_szDescription[38];
 	// Full featured help module
@@ -558,7 +893,6 @@ public:
 	CGEGameplayManager()
 	{
 		m_BlankScenario = new CGEPyScenario();
-		LoadScenarioMD5File();
 	}
 	
 	~CGEGameplayManager()
@@ -625,6 +959,7 @@ public:
 		try
 		{
 			// Load the scenario from Python Gameplay Manager
+			PY_PROFILE_SCOPE( "CGamePlayManager", "LoadScenario" );
 			scenario = bp::call<bp::object>( this->get_override("LoadScenario").ptr(), ident );
 			
 			// Check for load failure
@@ -647,27 +982,9 @@ public:
 		// Realign our ident
 		ident = pScenario->GetIdent();
 
-		// Check to see if this scenario is "official"
-		CUtlBuffer buf;
-		char md5hash[33] = "nogood";
-		bool is_official = false;
-
-		char pyFile[128];
-		Q_snprintf( pyFile, 128, "%s\\ges\\GamePlay\\%s.py", GEPy()->GetRootPath(), ident );
-
-		// Calculate the MD5 sum of the Python file
-		if ( filesystem->ReadFile( pyFile, "MOD", buf ) )
-			GEUTIL_MD5( (char*)buf.Base(), md5hash, 33 );
-
-		// Compare the MD5 hash to our known hash list
-		for( int i=0; i < bp::len( m_md5Hashes ); i++ )
-		{
-			if ( Q_stricmp( bp::extract<const char*>(m_md5Hashes[i]), md5hash ) == 0 )
-			{
-				is_official = true;
-				break;
-			}
-		}
+		// Check to see if this scenario is "official", the cache only rehashes it if it changed on disk
+		char md5hash[33];
+		bool is_official = GEPyScenarioCache()->IsOfficial( ident, md5hash, sizeof(md5hash) );
 
 		DevMsg( "Scenario MD5 Sum: %s (%s)\n", md5hash, is_official ? "OFFICIAL" : "MODDED" );
 
@@ -677,41 +994,11 @@ public:
 		return true;
 	}
 
-	void LoadScenarioMD5File( void )
-	{
-		// Clear out the MD5 list
-		m_md5Hashes = bp::list();
-
-		KeyValues *pKV = new KeyValues("Hashes" );
-		char *szFilename = "python/gphashes.txt";
-
-		CUtlBuffer buffer;
-		// Decrypt the file so we can read it
-		GEUTIL_DEncryptFile( szFilename, GERules()->GetEncryptionKey(), false );
-		pKV->LoadFromFile( filesystem, szFilename, "MOD" );
-		// Don't let people edit their file while in game
-		GEUTIL_DEncryptFile( szFilename, GERules()->GetEncryptionKey() );
-
-		KeyValues *pKey = pKV->GetFirstSubKey();
-		if ( pKey )
-		{
-			while ( pKey )
-			{
-				if ( !Q_strcasecmp(pKey->GetName(), "hash") )
-					m_md5Hashes.append(pKey->GetString());
-
-				pKey = pKey->GetNextKey();
-			}
-		}
-	}
-
 private:
 	// Storing the python instance of the loaded scenario
 	bp::object m_Scenario;
 	// A "blank" scenario to prevent null pointers
 	CGEPyScenario *m_BlankScenario;
-	// The scenario MD5 list
-	bp::list m_md5Hashes;
 };
 
 CGEPyScenario *pyGetScenario( void )
@@ -160,12 +160,12 @@ void pyDisableArmorSpawns()
 	// Disable armor spawns in the gamerules
 	GEMPRules()->SetArmorSpawnState(false);
 
-	CBaseEntity *pArmor = gEntList.FindEntityByClassname( NULL, "item_armorvest*" );
+	CBaseEntity *pArmor = gEntList.NextEntByClassname( NULL, "item_armorvest*" );
 	while (pArmor)
 	{
 		// Respawn the armor, but it won't materialize
 		pArmor->Respawn();
-		pArmor = gEntList.FindEntityByClassname( pArmor, "item_armorvest*" );
+		pArmor = gEntList.NextEntByClassname( pArmor, "item_armorvest*" );
 	}
 }
 
@@ -174,13 +174,13 @@ void pyEnableArmorSpawns()
 	// Disable armor spawns in the gamerules
 	GEMPRules()->SetArmorSpawnState(true);
 
-	CBaseEntity *pArmor = gEntList.FindEntityByClassname(NULL, "item_armorvest*");
+	CBaseEntity *pArmor = gEntList.NextEntByClassname(NULL, "item_armorvest*");
 	while (pArmor)
 	{
 		// Respawn the armors
 		pArmor->Respawn();
 		((CGEArmorVest*)pArmor)->Materialize();
-		pArmor = gEntList.FindEntityByClassname(pArmor, "item_armorvest*");
+		pArmor = gEntList.NextEntByClassname(pArmor, "item_armorvest*");
 	}
 }
 
@@ -14,6 +14,7 @@
 #include "filesystem.h"
 #include "script_parser.h"
 #include "ge_pymanager.h"
+#include "ge_pyscenariocache.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -110,6 +111,9 @@ void CPythonManager::InitDll()
 
 		// Execute our initialization routines
 		bp::import( "ges" );
+
+		// Get the scenario digests and bytecode out of the way before the first map loads
+		GEPyScenarioCache()->Init();
 	}
 	catch ( bp::error_already_set const & )
 	{
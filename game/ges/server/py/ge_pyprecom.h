@@ -54,6 +54,8 @@ enum GES_EVENTHOOK
 	FUNC_AI_SETDIFFICULTY,
 };
 
-#define PY_CALLHOOKS( hook, args ) TRYFUNC( this->get_override("CallEventHooks")( hook, args ) )
+#include "ge_pyprofile.h"
+
+#define PY_CALLHOOKS( hook, args ) { PY_PROFILE_SCOPE( self.ptr(), #hook ); TRYFUNC( this->get_override("CallEventHooks")( hook, args ) ) }
 
 #endif
@@ -0,0 +1,203 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : Server
+//   File        : ge_pyprofile.cpp
+//   Description :
+//      See Header
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+#include "ge_pyprecom.h"
+#include "ge_pyprofile.h"
+#include "filesystem.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+bool g_bGEPyProfiling = false;
+
+static CGEPyProfiler g_GEPyProfiler;
+CGEPyProfiler *GEPyProfiler() { return &g_GEPyProfiler; }
+
+void CGEPyProfileScope::Start( const char *owner, const char *hook )
+{
+	m_iEntry = GEPyProfiler()->FindOrAddEntry( owner, hook );
+	m_iStartBlocks = _Py_GetAllocatedBlocks();
+	GEPyProfiler()->EnterScope();
+	m_Timer.Start();
+}
+
+void CGEPyProfileScope::End()
+{
+	m_Timer.End();
+	GEPyProfiler()->LeaveScope( m_Timer.GetDuration() );
+	GEPyProfiler()->AddSample( m_iEntry, m_Timer.GetDuration(), (int)(_Py_GetAllocatedBlocks() - m_iStartBlocks) );
+}
+
+int CGEPyProfiler::FindOrAddEntry( const char *owner, const char *hook )
+{
+	char key[130];
+	Q_snprintf( key, sizeof(key), "%s:%s", owner, hook );
+
+	int idx = m_Lookup.Find( key );
+	if ( idx != m_Lookup.InvalidIndex() )
+		return m_Lookup[idx];
+
+	int entry = m_Entries.AddToTail();
+	ProfileEntry_t &e = m_Entries[entry];
+	Q_strncpy( e.szOwner, owner, sizeof(e.szOwner) );
+	Q_strncpy( e.szHook, hook, sizeof(e.szHook) );
+	e.iCalls = 0;
+	e.total.Init();
+	e.max.Init();
+	e.iAllocated = 0;
+
+	m_Lookup.Insert( key, entry );
+	return entry;
+}
+
+void CGEPyProfiler::AddSample( int entry, const CCycleCount &duration, int allocated )
+{
+	// A reset from inside a hook can pull the entry out from under us
+	if ( !m_Entries.IsValidIndex( entry ) )
+		return;
+
+	ProfileEntry_t &e = m_Entries[entry];
+	e.iCalls++;
+	e.total += duration;
+	e.iAllocated += allocated;
+
+	if ( e.max.IsLessThan( duration ) )
+		e.max = duration;
+}
+
+void CGEPyProfiler::LeaveScope( const CCycleCount &duration )
+{
+	if ( --m_iDepth == 0 )
+		m_TopLevel += duration;
+}
+
+void CGEPyProfiler::Reset()
+{
+	// Leave the depth alone, we may be resetting from inside a hook
+	m_Entries.RemoveAll();
+	m_Lookup.RemoveAll();
+	m_TopLevel.Init();
+}
+
+int CGEPyProfiler::SortByTotal( const ProfileEntry_t *a, const ProfileEntry_t *b )
+{
+	if ( a->total.IsLessThan( b->total ) )
+		return 1;
+	return b->total.IsLessThan( a->total ) ? -1 : 0;
+}
+
+void CGEPyProfiler::Print( int limit )
+{
+	if ( !m_Entries.Count() )
+	{
+		Msg( "No Python profile data recorded%s\n", g_bGEPyProfiling ? "" : ", use 'ge_py_profile start'" );
+		return;
+	}
+
+	CUtlVector<ProfileEntry_t> sorted;
+	sorted.CopyArray( m_Entries.Base(), m_Entries.Count() );
+	sorted.Sort( SortByTotal );
+
+	// Roll the hooks up to their owning class
+	CUtlVector<ProfileEntry_t> owners;
+	CUtlDict<int, int> ownerLookup;
+	for ( int i=0; i < sorted.Count(); i++ )
+	{
+		int idx = ownerLookup.Find( sorted[i].szOwner );
+		if ( idx == ownerLookup.InvalidIndex() )
+		{
+			int o = owners.AddToTail( sorted[i] );
+			Q_strncpy( owners[o].szHook, "*", sizeof(owners[o].szHook) );
+			ownerLookup.Insert( sorted[i].szOwner, o );
+			continue;
+		}
+
+		ProfileEntry_t &o = owners[ ownerLookup[idx] ];
+		o.iCalls += sorted[i].iCalls;
+		o.total += sorted[i].total;
+		o.iAllocated += sorted[i].iAllocated;
+		if ( o.max.IsLessThan( sorted[i].max ) )
+			o.max = sorted[i].max;
+	}
+	owners.Sort( SortByTotal );
+
+	Msg( "%-24s %-28s %8s %10s %8s %8s %10s\n", "Class", "Hook", "Calls", "Total ms", "Avg ms", "Max ms", "Allocated" );
+	for ( int i=0; i < sorted.Count() && (limit <= 0 || i < limit); i++ )
+	{
+		const ProfileEntry_t &e = sorted[i];
+		Msg( "%-24s %-28s %8i %10.2f %8.3f %8.3f %10lld\n", e.szOwner, e.szHook, e.iCalls, e.total.GetMillisecondsF(),
+			e.total.GetMillisecondsF() / e.iCalls, e.max.GetMillisecondsF(), e.iAllocated );
+	}
+
+	Msg( "\nPer class totals (nested hooks are counted in their callers too):\n" );
+	for ( int i=0; i < owners.Count(); i++ )
+	{
+		const ProfileEntry_t &e = owners[i];
+		Msg( "%-24s %8i calls %10.2f ms total %8.3f ms max %10lld allocated\n", e.szOwner, e.iCalls,
+			e.total.GetMillisecondsF(), e.max.GetMillisecondsF(), e.iAllocated );
+	}
+}
+
+bool CGEPyProfiler::DumpCSV( const char *filename )
+{
+	FileHandle_t file = filesystem->Open( filename, "w", "MOD" );
+	if ( !file )
+		return false;
+
+	filesystem->FPrintf( file, "class,hook,calls,total_ms,avg_ms,max_ms,allocated_blocks\n" );
+	for ( int i=0; i < m_Entries.Count(); i++ )
+	{
+		const ProfileEntry_t &e = m_Entries[i];
+		filesystem->FPrintf( file, "%s,%s,%i,%.4f,%.4f,%.4f,%lld\n", e.szOwner, e.szHook, e.iCalls, e.total.GetMillisecondsF(),
+			e.iCalls ? e.total.GetMillisecondsF() / e.iCalls : 0.0, e.max.GetMillisecondsF(), e.iAllocated );
+	}
+
+	filesystem->Close( file );
+	return true;
+}
+
+CON_COMMAND( ge_py_profile, "Profiles C++ to Python calls per scenario/AI class and hook.\n\tUsage: ge_py_profile <start|stop|reset|print [count]|dump [file.csv]>" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	const char *cmd = args.ArgC() > 1 ? args[1] : "";
+
+	if ( !Q_stricmp( cmd, "start" ) )
+	{
+		g_bGEPyProfiling = true;
+		Msg( "Python profiling started\n" );
+	}
+	else if ( !Q_stricmp( cmd, "stop" ) )
+	{
+		g_bGEPyProfiling = false;
+		Msg( "Python profiling stopped\n" );
+	}
+	else if ( !Q_stricmp( cmd, "reset" ) )
+	{
+		GEPyProfiler()->Reset();
+	}
+	else if ( !Q_stricmp( cmd, "print" ) )
+	{
+		GEPyProfiler()->Print( args.ArgC() > 2 ? atoi( args[2] ) : 0 );
+	}
+	else if ( !Q_stricmp( cmd, "dump" ) )
+	{
+		const char *filename = args.ArgC() > 2 ? args[2] : "ge_py_profile.csv";
+		if ( GEPyProfiler()->DumpCSV( filename ) )
+			Msg( "Python profile written to %s\n", filename );
+		else
+			Warning( "Failed to write Python profile to %s\n", filename );
+	}
+	else
+	{
+		Msg( "Python profiling is %s\n", g_bGEPyProfiling ? "running" : "stopped" );
+		Msg( "Usage: ge_py_profile <start|stop|reset|print [count]|dump [file.csv]>\n" );
+	}
+}
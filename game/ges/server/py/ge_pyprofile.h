@@ -0,0 +1,98 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : Server
+//   File        : ge_pyprofile.h
+//   Description :
+//      Per hook timing of C++ -> Python calls so server operators can find
+//      which scenario or AI script is eating the frame. Controlled with the
+//      ge_py_profile console command, costs a single bool test when off.
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+#ifndef GE_PYPROFILE_H
+#define GE_PYPROFILE_H
+#ifdef _WIN32
+#pragma once
+#endif
+
+#include "tier0/fasttimer.h"
+#include "utldict.h"
+
+// True while ge_py_profile is recording
+extern bool g_bGEPyProfiling;
+
+class CGEPyProfiler
+{
+public:
+	// Returns the entry for this owner (Python class) and hook, creating it if needed
+	int  FindOrAddEntry( const char *owner, const char *hook );
+	void AddSample( int entry, const CCycleCount &duration, int allocated );
+
+	void Reset();
+	void Print( int limit );
+	bool DumpCSV( const char *filename );
+
+	// Time spent in Python counting only the outermost hook of each call chain
+	const CCycleCount &GetTopLevelTotal() { return m_TopLevel; }
+	void EnterScope() { m_iDepth++; }
+	void LeaveScope( const CCycleCount &duration );
+
+private:
+	struct ProfileEntry_t
+	{
+		char		szOwner[64];
+		char		szHook[64];
+		int			iCalls;
+		CCycleCount	total;
+		CCycleCount	max;
+		int64		iAllocated;
+	};
+
+	static int SortByTotal( const ProfileEntry_t *a, const ProfileEntry_t *b );
+
+	CUtlVector<ProfileEntry_t>	m_Entries;
+	CUtlDict<int, int>			m_Lookup;
+
+	int							m_iDepth;
+	CCycleCount					m_TopLevel;
+};
+
+CGEPyProfiler *GEPyProfiler();
+
+// Times the rest of the enclosing scope against owner's class and the given hook.
+// Nested scopes are inclusive of their children.
+class CGEPyProfileScope
+{
+public:
+	CGEPyProfileScope( PyObject *owner, const char *hook )
+	{
+		m_iEntry = -1;
+		if ( g_bGEPyProfiling && owner && owner != Py_None )
+			Start( Py_TYPE( owner )->tp_name, hook );
+	}
+
+	CGEPyProfileScope( const char *owner, const char *hook )
+	{
+		m_iEntry = -1;
+		if ( g_bGEPyProfiling )
+			Start( owner, hook );
+	}
+
+	~CGEPyProfileScope()
+	{
+		if ( m_iEntry != -1 )
+			End();
+	}
+
+private:
+	void Start( const char *owner, const char *hook );
+	void End();
+
+	int			m_iEntry;
+	Py_ssize_t	m_iStartBlocks;
+	CFastTimer	m_Timer;
+};
+
+#define PY_PROFILE_SCOPE( owner, hook ) CGEPyProfileScope _pyProfileScope( owner, hook )
+
+#endif
@@ -0,0 +1,164 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : Server
+//   File        : ge_pyscenariocache.cpp
+//   Description :
+//      See Header
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+#include "ge_pyprecom.h"
+#include "ge_pyscenariocache.h"
+#include "ge_pymanager.h"
+#include "filesystem.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+#define GE_SCENARIO_DIR		"ges/GamePlay"
+#define GE_SCENARIO_HASHES	"python/gphashes.txt"
+
+static CGEPyScenarioCache g_GEPyScenarioCache;
+CGEPyScenarioCache *GEPyScenarioCache() { return &g_GEPyScenarioCache; }
+
+CGEPyScenarioCache::CGEPyScenarioCache()
+	: m_OfficialDigests( k_eDictCompareTypeCaseInsensitive ), m_Scenarios( k_eDictCompareTypeCaseInsensitive )
+{
+}
+
+void CGEPyScenarioCache::Init()
+{
+	LoadOfficialDigests();
+	m_Scenarios.RemoveAll();
+
+	char search[MAX_PATH];
+	Q_snprintf( search, sizeof(search), "%s/%s/*.py", GEPy()->GetRootPath(), GE_SCENARIO_DIR );
+
+	FileFindHandle_t hFind;
+	const char *pFile = filesystem->FindFirstEx( search, "MOD", &hFind );
+	while ( pFile )
+	{
+		// Skip the package's own modules
+		if ( Q_strncmp( pFile, "__", 2 ) )
+		{
+			char ident[64];
+			Q_StripExtension( pFile, ident, sizeof(ident) );
+			FindOrUpdateEntry( ident );
+		}
+
+		pFile = filesystem->FindNext( hFind );
+	}
+	filesystem->FindClose( hFind );
+
+	DevMsg( "Cached %i scenarios against %i official digests\n", m_Scenarios.Count(), m_OfficialDigests.Count() );
+}
+
+void CGEPyScenarioCache::LoadOfficialDigests()
+{
+	m_OfficialDigests.RemoveAll();
+
+	KeyValues *pKV = new KeyValues( "Hashes" );
+
+	// Decrypt the file in memory, it never hits the disk unencrypted
+	CUtlBuffer buffer;
+	if ( GEUTIL_ReadEncryptedFile( GE_SCENARIO_HASHES, "MOD", GEUTIL_GetSecretHash(), buffer ) )
+	{
+		buffer.PutChar( '\0' );
+		pKV->LoadFromBuffer( GE_SCENARIO_HASHES, (const char*) buffer.Base(), filesystem, "MOD" );
+	}
+
+	for ( KeyValues *pKey = pKV->GetFirstSubKey(); pKey; pKey = pKey->GetNextKey() )
+	{
+		if ( !Q_strcasecmp( pKey->GetName(), "hash" ) && m_OfficialDigests.Find( pKey->GetString() ) == m_OfficialDigests.InvalidIndex() )
+			m_OfficialDigests.Insert( pKey->GetString(), true );
+	}
+
+	pKV->deleteThis();
+}
+
+int CGEPyScenarioCache::FindOrUpdateEntry( const char *ident )
+{
+	char path[MAX_PATH];
+	Q_snprintf( path, sizeof(path), "%s/%s/%s.py", GEPy()->GetRootPath(), GE_SCENARIO_DIR, ident );
+
+	// A cheap stat tells us if the entry we have is still good
+	long filetime = filesystem->GetFileTime( path, "MOD" );
+
+	int idx = m_Scenarios.Find( ident );
+	if ( idx != m_Scenarios.InvalidIndex() && m_Scenarios[idx].iFileTime == filetime )
+		return idx;
+
+	ScenarioEntry_t entry;
+	entry.iFileTime = filetime;
+	HashScenario( path, entry );
+	CompileScenario( path );
+
+	if ( idx == m_Scenarios.InvalidIndex() )
+		idx = m_Scenarios.Insert( ident, entry );
+	else
+		m_Scenarios[idx] = entry;
+
+	return idx;
+}
+
+bool CGEPyScenarioCache::HashScenario( const char *path, ScenarioEntry_t &entry )
+{
+	Q_strncpy( entry.szDigest, "nogood", sizeof(entry.szDigest) );
+	entry.bOfficial = false;
+
+	CUtlBuffer buf;
+	if ( !filesystem->ReadFile( path, "MOD", buf ) )
+		return false;
+
+	buf.PutChar( '\0' );
+	GEUTIL_MD5( (char*)buf.Base(), entry.szDigest, sizeof(entry.szDigest) );
+
+	entry.bOfficial = m_OfficialDigests.Find( entry.szDigest ) != m_OfficialDigests.InvalidIndex();
+	return true;
+}
+
+void CGEPyScenarioCache::CompileScenario( const char *path )
+{
+	char fullPath[MAX_PATH];
+	if ( !filesystem->RelativePathToFullPath( path, "MOD", fullPath, sizeof(fullPath) ) )
+		return;
+
+	// Writes the bytecode to __pycache__ at our optimization level so the import skips the compile
+	try
+	{
+		bp::import( "py_compile" ).attr( "compile" )( fullPath );
+	}
+	catch ( bp::error_already_set const & )
+	{
+		HandlePythonException();
+	}
+}
+
+bool CGEPyScenarioCache::IsOfficial( const char *ident, char *digest /*= NULL*/, int digestLen /*= 0*/ )
+{
+	int idx = FindOrUpdateEntry( ident );
+
+	if ( digest )
+		Q_strncpy( digest, m_Scenarios[idx].szDigest, digestLen );
+
+	return m_Scenarios[idx].bOfficial;
+}
+
+void CGEPyScenarioCache::Print()
+{
+	Msg( "%-24s %-33s %s\n", "Scenario", "Digest", "Official" );
+
+	for ( int i = m_Scenarios.First(); i != m_Scenarios.InvalidIndex(); i = m_Scenarios.Next( i ) )
+		Msg( "%-24s %-33s %s\n", m_Scenarios.GetElementName( i ), m_Scenarios[i].szDigest, m_Scenarios[i].bOfficial ? "yes" : "no" );
+}
+
+CON_COMMAND( ge_py_scenariocache, "Lists the cached scenario digests, pass 'rebuild' to rehash and recompile every scenario" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	if ( args.ArgC() > 1 && !Q_stricmp( args[1], "rebuild" ) )
+		GEPyScenarioCache()->Init();
+
+	GEPyScenarioCache()->Print();
+}
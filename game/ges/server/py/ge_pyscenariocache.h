@@ -0,0 +1,54 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : Server
+//   File        : ge_pyscenariocache.h
+//   Description :
+//      Digests and byte compiles every gameplay scenario once when Python
+//      starts so loading one only has to look up whether it is official.
+//      Entries are rehashed if the file's modification time changes.
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+#ifndef GE_PYSCENARIOCACHE_H
+#define GE_PYSCENARIOCACHE_H
+#ifdef _WIN32
+#pragma once
+#endif
+
+#include "utldict.h"
+
+class CGEPyScenarioCache
+{
+public:
+	CGEPyScenarioCache();
+
+	// Loads the official digests then hashes and compiles everything in python/ges/GamePlay
+	void Init();
+
+	// True if the scenario source matches an official digest, optionally copies out the digest
+	bool IsOfficial( const char *ident, char *digest = NULL, int digestLen = 0 );
+
+	void Print();
+
+private:
+	struct ScenarioEntry_t
+	{
+		long	iFileTime;
+		char	szDigest[33];
+		bool	bOfficial;
+	};
+
+	void LoadOfficialDigests();
+
+	// Returns the cache index for this scenario, (re)building the entry if the file changed
+	int  FindOrUpdateEntry( const char *ident );
+	bool HashScenario( const char *path, ScenarioEntry_t &entry );
+	void CompileScenario( const char *path );
+
+	CUtlDict<bool, int>				m_OfficialDigests;
+	CUtlDict<ScenarioEntry_t, int>	m_Scenarios;
+};
+
+CGEPyScenarioCache *GEPyScenarioCache();
+
+#endif
@@ -30,52 +30,219 @@
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
 
-void pyClientPrint( bp::object plr_dest, int msg_dest, std::string msg, std::string param1, std::string param2, std::string param3, std::string param4 )
+// Fills a caller owned filter with the players addressed by a Python destination
+// (None for everyone, a player, or a team id). Returns false if dest is not valid.
+static bool GEHud_BuildFilter( bp::object &dest, CRecipientFilter &filter, bool bVerbose = true )
 {
-	bp::extract<CGEPlayer*> to_player( plr_dest );
-	bp::extract<int> to_team( plr_dest );
-
-	CRecipientFilter *filter = NULL;
+	bp::extract<CGEPlayer*> to_player( dest );
+	bp::extract<int> to_team( dest );
 
-	if ( plr_dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
+	if ( dest.is_none() )
+		filter.AddAllPlayers();
 	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
+		filter.AddRecipient( to_player() );
 	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
+		filter.CopyFrom( CGETeamRecipientFilter( to_team() ) );
 	else
-		to_player(); // Issues verbose error message
-	
-	if ( filter )
 	{
-		filter->MakeReliable();
-		UTIL_ClientPrintFilter( *filter, msg_dest, msg.c_str(), param1.c_str(), param2.c_str(), param3.c_str(), param4.c_str() );
-		delete filter;
+		if ( bVerbose )
+			to_player(); // Issues verbose error message
+		return false;
 	}
+
+	filter.MakeReliable();
+	return true;
 }
 
-#define MAX_NETCHANNEL 10
-int g_iMsgChannel = 5;
-void pyHudMessage( bp::object dest, const char *msg, float x, float y, Color col, float holdtime, int chan = -1 )
+//-----------------------------------------------------------------------------
+// Collects progress bar updates issued during a tick and sends them once per
+// recipient in the same frame. Repeated updates to the same bar collapse into
+// the latest value/title/color so scenarios can update every think for free.
+//-----------------------------------------------------------------------------
+#define GE_HUDBATCH_VALUE	0x1
+#define GE_HUDBATCH_TITLE	0x2
+#define GE_HUDBATCH_COLOR	0x4
+
+#define GE_HUDBATCH_MAXTITLE 64
+
+class CGEHudMessageBatcher : public CAutoGameSystemPerFrame
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
+public:
+	CGEHudMessageBatcher() : CAutoGameSystemPerFrame( "CGEHudMessageBatcher" )
+	{
+		ClearAll();
+	}
 
-	CRecipientFilter *filter = NULL;
+	void QueueProgressBar( const CRecipientFilter &filter, int idx, float value, const char *title, int iColor );
+	void DropProgressBar( const CRecipientFilter &filter, int idx );
 
-	// Figure out where to send us
-	if ( dest.is_none() )
-		filter = new CBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		// Ignore this if we gave bad params
+	virtual void FrameUpdatePostEntityThink() { Flush(); }
+	virtual void LevelShutdownPostEntity() { ClearAll(); }
+
+private:
+	struct PendingBar_t
+	{
+		int   flags;
+		float value;
+		int   color;
+		char  title[GE_HUDBATCH_MAXTITLE];
+	};
+
+	void Flush();
+	void FlushPlayer( int client );
+	void ClearAll()
+	{
+		memset( m_Pending, 0, sizeof(m_Pending) );
+		memset( m_bDirty, 0, sizeof(m_bDirty) );
+	}
+
+	PendingBar_t m_Pending[ MAX_PLAYERS + 1 ][ GE_HUD_NUMPROGRESSBARS ];
+	bool		 m_bDirty[ MAX_PLAYERS + 1 ];
+};
+
+static CGEHudMessageBatcher g_GEHudBatcher;
+
+void CGEHudMessageBatcher::QueueProgressBar( const CRecipientFilter &filter, int idx, float value, const char *title, int iColor )
+{
+	// Same mapping the client applies to the byte we send
+	idx = (idx & 0xFF) % GE_HUD_NUMPROGRESSBARS;
+
+	int flags = 0;
+	if ( value != INT_MAX )
+		flags |= GE_HUDBATCH_VALUE;
+	// '\r' indicates do not update the title, a color of 0 leaves the color alone
+	if ( title[0] != '\r' )
+		flags |= GE_HUDBATCH_TITLE;
+	if ( iColor != 0 )
+		flags |= GE_HUDBATCH_COLOR;
+
+	if ( !flags )
 		return;
 
-	// Make us reliable
-	filter->MakeReliable();
+	for ( int i=0; i < filter.GetRecipientCount(); i++ )
+	{
+		int client = filter.GetRecipientIndex(i);
+		if ( client <= 0 || client > MAX_PLAYERS )
+			continue;
+
+		PendingBar_t &bar = m_Pending[client][idx];
+		bar.flags |= flags;
+
+		if ( flags & GE_HUDBATCH_VALUE )
+			bar.value = value;
+		if ( flags & GE_HUDBATCH_TITLE )
+			Q_strncpy( bar.title, title, GE_HUDBATCH_MAXTITLE );
+		if ( flags & GE_HUDBATCH_COLOR )
+			bar.color = iColor;
+
+		m_bDirty[client] = true;
+	}
+}
+
+void CGEHudMessageBatcher::DropProgressBar( const CRecipientFilter &filter, int idx )
+{
+	idx = (idx & 0xFF) % GE_HUD_NUMPROGRESSBARS;
+
+	for ( int i=0; i < filter.GetRecipientCount(); i++ )
+	{
+		int client = filter.GetRecipientIndex(i);
+		if ( client > 0 && client <= MAX_PLAYERS )
+			m_Pending[client][idx].flags = 0;
+	}
+}
+
+void CGEHudMessageBatcher::Flush()
+{
+	for ( int i=1; i <= gpGlobals->maxClients && i <= MAX_PLAYERS; i++ )
+	{
+		if ( m_bDirty[i] )
+			FlushPlayer( i );
+	}
+}
+
+void CGEHudMessageBatcher::FlushPlayer( int client )
+{
+	m_bDirty[client] = false;
+
+	CBasePlayer *pPlayer = UTIL_PlayerByIndex( client );
+	if ( !pPlayer || !pPlayer->IsConnected() || pPlayer->IsFakeClient() )
+	{
+		memset( m_Pending[client], 0, sizeof(m_Pending[client]) );
+		return;
+	}
+
+	CSingleUserRecipientFilter filter( pPlayer );
+	filter.MakeReliable();
+
+	int bar = 0;
+	while ( bar < GE_HUD_NUMPROGRESSBARS )
+	{
+		// Pack as many bars as fit into a single message, leaving a byte for the count
+		int size = 1, count = 0, last = bar;
+		for ( ; last < GE_HUD_NUMPROGRESSBARS; last++ )
+		{
+			const PendingBar_t &pending = m_Pending[client][last];
+			if ( !pending.flags )
+				continue;
+
+			int entry = 2;
+			if ( pending.flags & GE_HUDBATCH_VALUE )
+				entry += 4;
+			if ( pending.flags & GE_HUDBATCH_TITLE )
+				entry += Q_strlen( pending.title ) + 1;
+			if ( pending.flags & GE_HUDBATCH_COLOR )
+				entry += 4;
+
+			if ( count > 0 && size + entry > MAX_USER_MSG_DATA )
+				break;
+
+			size += entry;
+			count++;
+		}
+
+		if ( count > 0 )
+		{
+			UserMessageBegin( filter, "ProgressBarBatch" );
+			WRITE_BYTE( count );
+			for ( ; bar < last; bar++ )
+			{
+				PendingBar_t &pending = m_Pending[client][bar];
+				if ( !pending.flags )
+					continue;
+
+				WRITE_BYTE( bar );
+				WRITE_BYTE( pending.flags );
+				if ( pending.flags & GE_HUDBATCH_VALUE )
+					WRITE_FLOAT( pending.value );
+				if ( pending.flags & GE_HUDBATCH_TITLE )
+					WRITE_STRING( pending.title );
+				if ( pending.flags & GE_HUDBATCH_COLOR )
+					WRITE_BITS( &pending.color, 32 );
+
+				pending.flags = 0;
+			}
+			MessageEnd();
+		}
+
+		bar = last;
+	}
+}
+
+void pyClientPrint( bp::object plr_dest, int msg_dest, std::string msg, std::string param1, std::string param2, std::string param3, std::string param4 )
+{
+	CRecipientFilter filter;
+	if ( GEHud_BuildFilter( plr_dest, filter ) )
+		UTIL_ClientPrintFilter( filter, msg_dest, msg.c_str(), param1.c_str(), param2.c_str(), param3.c_str(), param4.c_str() );
+}
+
+#define MAX_NETCHANNEL 10
+int g_iMsgChannel = 5;
+void pyHudMessage( bp::object dest, const char *msg, float x, float y, Color col, float holdtime, int chan = -1 )
+{
+	// Ignore this if we gave bad params
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter, false ) )
+		return;
 
 	// Figure out which channel to use
 	if ( chan < 0 || chan >= MAX_NETCHANNEL )
@@ -85,7 +252,7 @@ void pyHudMessage( bp::object dest, const char *msg, float x, float y, Color col
 	}
 
 	// Shoot out the message
-	UserMessageBegin( *filter, "HudMsg" );
+	UserMessageBegin( filter, "HudMsg" );
 		WRITE_BYTE ( chan & 0xFF );
 		WRITE_FLOAT( x );
 		WRITE_FLOAT( y );
@@ -104,47 +271,27 @@ void pyHudMessage( bp::object dest, const char *msg, float x, float y, Color col
 		WRITE_FLOAT( 0 );		 // fxtime
 		WRITE_STRING( msg );
 	MessageEnd();
-
-	// Cleanup
-	delete filter;
 }
 
 void pyPopupMessage( bp::object dest, std::string title, std::string msg, std::string img )
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
-
-	CRecipientFilter *filter = NULL;
-	
-	if ( dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		to_player(); // Issues verbose error message
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter ) )
+		return;
 
-	if ( filter )
+	int nMsg = g_pStringTableGameplay->FindStringIndex( msg.c_str() );
+	if ( nMsg == INVALID_STRING_INDEX )
 	{
-		filter->MakeReliable();
-
-		int nMsg = g_pStringTableGameplay->FindStringIndex( msg.c_str() );
-		if ( nMsg == INVALID_STRING_INDEX )
-		{
-			bool save = engine->LockNetworkStringTables( false );
-			nMsg = g_pStringTableGameplay->AddString( true, msg.c_str() );
-			engine->LockNetworkStringTables( save );
-		}
-
-		UserMessageBegin( *filter, "PopupMessage" );
-		WRITE_STRING( title.c_str() );
-		WRITE_STRING( img.c_str() );
-		WRITE_SHORT( nMsg );
-		MessageEnd();
-
-		delete filter;
+		bool save = engine->LockNetworkStringTables( false );
+		nMsg = g_pStringTableGameplay->AddString( true, msg.c_str() );
+		engine->LockNetworkStringTables( save );
 	}
+
+	UserMessageBegin( filter, "PopupMessage" );
+	WRITE_STRING( title.c_str() );
+	WRITE_STRING( img.c_str() );
+	WRITE_SHORT( nMsg );
+	MessageEnd();
 }
 
 void pyEmitGameplayEvent( std::string name, std::string value1, std::string value2, std::string value3, std::string value4, bool sendtoclients )
@@ -377,144 +524,62 @@ void pyPlaySound( const char* soundname, bool bDimMusic = false )
 
 void pyInitHudProgressBar( bp::object dest, int idx, std::string title, int flags, float maxValue, float x, float y, int w, int h, Color col, float currValue )
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter ) )
+		return;
 
-	CRecipientFilter *filter = NULL;
-	if ( dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		to_player(); // Issues verbose error message
-
-	if ( filter )
-	{
-		filter->MakeReliable();
-
-		int xPer = clamp(x,-1.0f,1.0f) * 100;
-		int yPer = clamp(y,-1.0f,1.0f) * 100;
-		int iColor = col.GetRawColor();
-
-		UserMessageBegin( *filter, "AddProgressBar" );
-		WRITE_BYTE(idx);
-		WRITE_BITS(&flags, 3);
-		WRITE_FLOAT(maxValue);
-		WRITE_FLOAT(currValue);
-		WRITE_CHAR(xPer);
-		WRITE_CHAR(yPer);
-		WRITE_SHORT(w);
-		WRITE_SHORT(h);
-		WRITE_BITS(&iColor, 32);
-		WRITE_STRING(title.c_str());
-		MessageEnd();
-
-		delete filter;
-	}
+	// The add resets the bar on the client, anything still queued for it is stale
+	g_GEHudBatcher.DropProgressBar( filter, idx );
+
+	int xPer = clamp(x,-1.0f,1.0f) * 100;
+	int yPer = clamp(y,-1.0f,1.0f) * 100;
+	int iColor = col.GetRawColor();
+
+	UserMessageBegin( filter, "AddProgressBar" );
+	WRITE_BYTE(idx);
+	WRITE_BITS(&flags, 3);
+	WRITE_FLOAT(maxValue);
+	WRITE_FLOAT(currValue);
+	WRITE_CHAR(xPer);
+	WRITE_CHAR(yPer);
+	WRITE_SHORT(w);
+	WRITE_SHORT(h);
+	WRITE_BITS(&iColor, 32);
+	WRITE_STRING(title.c_str());
+	MessageEnd();
 }
 
 void pyUpdateHudProgressBar( bp::object dest, int idx, float value, std::string title, Color color )
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
-
-	CRecipientFilter *filter = NULL;
-	if ( dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		to_player(); // Issues verbose error message
-
-	if ( filter )
-	{
-		filter->MakeReliable();
-
-		// Send the Update message if we need to
-		if ( value != INT_MAX )
-		{
-			UserMessageBegin( *filter, "UpdateProgressBar" );
-			WRITE_BYTE(idx);
-			WRITE_FLOAT(value);
-			MessageEnd();
-		}
-
-		// Send the config message if we need to
-		int iColor = color.GetRawColor();
-		if ( title != "\r" || iColor != 0 )
-		{
-			UserMessageBegin( *filter, "ConfigProgressBar" );
-			WRITE_BYTE(idx);
-			WRITE_STRING(title.c_str());
-			WRITE_BITS(&iColor, 32);
-			MessageEnd();
-		}
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter ) )
+		return;
 
-		delete filter;
-	}
+	// Sent at the end of the frame with everything else queued for this player
+	g_GEHudBatcher.QueueProgressBar( filter, idx, value, title.c_str(), color.GetRawColor() );
 }
 
 // DEPRECATED FUNCTION
 void pyConfigHudProgressBar( bp::object dest, int idx, std::string title, Color color )
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
-
-	CRecipientFilter *filter = NULL;
-	if ( dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		to_player(); // Issues verbose error message
-
-	if ( filter )
-	{
-		filter->MakeReliable();
-
-		int iColor = color.GetRawColor();
-
-		UserMessageBegin( *filter, "ConfigProgressBar" );
-		WRITE_BYTE(idx);
-		WRITE_STRING(title.c_str());
-		WRITE_BITS(&iColor, 32);
-		MessageEnd();
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter ) )
+		return;
 
-		delete filter;
-	}
+	g_GEHudBatcher.QueueProgressBar( filter, idx, INT_MAX, title.c_str(), color.GetRawColor() );
 }
 
 void pyRemoveHudProgressBar( bp::object dest, int idx )
 {
-	bp::extract<CGEPlayer*> to_player( dest );
-	bp::extract<int> to_team( dest );
-
-	CRecipientFilter *filter = NULL;
-	if ( dest.is_none() )
-		filter = new CReliableBroadcastRecipientFilter;
-	else if ( to_player.check() )
-		filter = new CSingleUserRecipientFilter( to_player() );
-	else if ( to_team.check() )
-		filter = new CGETeamRecipientFilter( to_team() );
-	else
-		to_player(); // Issues verbose error message
-
-	if ( filter )
-	{
-		filter->MakeReliable();
+	CRecipientFilter filter;
+	if ( !GEHud_BuildFilter( dest, filter ) )
+		return;
 
-		UserMessageBegin( *filter, "RemoveProgressBar" );
-		WRITE_BYTE(idx);
-		MessageEnd();
+	g_GEHudBatcher.DropProgressBar( filter, idx );
 
-		delete filter;
-	}
+	UserMessageBegin( filter, "RemoveProgressBar" );
+	WRITE_BYTE(idx);
+	MessageEnd();
 }
 
 void pyParticleEffect( CBasePlayer *pPlayer, const char* attachment, const char* effect, bool bFollow )
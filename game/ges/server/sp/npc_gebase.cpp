@@ -22,6 +22,7 @@
 #include "ge_shareddefs.h"
 #include "ent_hat.h"
 #include "ge_ai.h"
+#include "ge_ai_visibility.h"
 #include "ge_weapon.h"
 #include "ge_gameplay.h"
 #include "ge_tokenmanager.h"
@@ -631,6 +632,16 @@ bool CNPC_GEBase::IsValidEnemy( CBaseEntity *pEnemy )
 	return BaseClass::IsValidEnemy( pEnemy );
 }
 
+bool CNPC_GEBase::FVisible( CBaseEntity *pEntity, int traceMask, CBaseEntity **ppBlocker )
+{
+	// Sensing, aiming and python all ask the same questions of the same players every tick,
+	// let the shared visibility matrix answer them when the caller doesn't care about the blocker
+	if ( traceMask == MASK_BLOCKLOS && !ppBlocker && GEAIVisibility()->ShouldTrack( this, pEntity ) )
+		return GEAIVisibility()->IsVisible( this, pEntity );
+
+	return BaseClass::FVisible( pEntity, traceMask, ppBlocker );
+}
+
 void CNPC_GEBase::FireBullets( const FireBulletsInfo_t &info )
 {
 	FireBulletsInfo_t modinfo = info;
@@ -75,6 +75,8 @@ public:
 	virtual void	OnListened( void );
 
 	virtual	bool	IsValidEnemy( CBaseEntity *pEnemy );
+	virtual bool	FVisible( CBaseEntity *pEntity, int traceMask = MASK_BLOCKLOS, CBaseEntity **ppBlocker = NULL );
+	virtual bool	FVisible( const Vector &vecTarget, int traceMask = MASK_BLOCKLOS, CBaseEntity **ppBlocker = NULL ) { return BaseClass::FVisible( vecTarget, traceMask, ppBlocker ); }
 	virtual void	GatherConditions( void );
 	virtual int		GetSoundInterests( void );
 	NPC_STATE		SelectIdealState( void );
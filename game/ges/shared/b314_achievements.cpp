@@ -65,23 +65,23 @@ protected:
 		AddAwardType( GE_AWARD_FRANTIC );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pLocalPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pLocalPlayer = event.pLocalPlayer;
 		if ( !pLocalPlayer ) return;
 		int localid = pLocalPlayer->entindex();
 
-		if ( Q_strcmp( event->GetName(), "round_end" ) == 0 && event->GetBool("showreport") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END && event.bShowReport )
 		{
 			// We must also win the round, so filter out round loss events
-			if ( !(event->GetInt("winnerid") == localid) )
+			if ( !(event.iWinnerID == localid) )
 			{
 				// Make sure we can achieve this next round
 				if ( IsChar() ) SetCharForRound( true );
 				return;
 			}
 		}
-		CGEAchBaseAwardType::FireGameEvent_Internal( event );
+		CGEAchBaseAwardType::FireGEEvent( event );
 	}
 };
 DECLARE_GE_ACHIEVEMENT( CAchHaydayMayday, ACHIEVEMENT_GES_HAYDAYMAYDAY, "GES_HAYDAYMAYDAY", 30, GE_ACH_UNLOCKED );
@@ -143,18 +143,18 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( Q_strcmp( event->GetName(), "round_end" ) == 0 && event->GetBool("showreport") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END && event.bShowReport )
 		{
-			CBasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
+			CBasePlayer *pLocalPlayer = event.pLocalPlayer;
 			if (!pLocalPlayer) return;
 			int localid = pLocalPlayer->entindex();
 
 			// If we won 4 or more awards we win this achievement
-			if ( GetAwardsForPlayer(event, localid) >= 4 && FindAwardForPlayer(event, GE_AWARD_DEADLY, localid)
-				&& FindAwardForPlayer(event, GE_AWARD_PROFESSIONAL, localid) && FindAwardForPlayer(event, GE_AWARD_MARKSMANSHIP, localid)
-				&& event->GetInt("winnerid") == localid && CalcPlayerCount() >= 4 )
+			if ( GetAwardsForPlayer(event.pEvent, localid) >= 4 && FindAwardForPlayer(event.pEvent, GE_AWARD_DEADLY, localid)
+				&& FindAwardForPlayer(event.pEvent, GE_AWARD_PROFESSIONAL, localid) && FindAwardForPlayer(event.pEvent, GE_AWARD_MARKSMANSHIP, localid)
+				&& event.iWinnerID == localid && CalcPlayerCount() >= 4 )
 				IncrementCount();
 		}
 	}
@@ -175,16 +175,16 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( Q_strcmp( event->GetName(), "round_end" ) == 0 && event->GetBool("showreport") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END && event.bShowReport )
 		{
-			CBasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
+			CBasePlayer *pLocalPlayer = event.pLocalPlayer;
 			if (!pLocalPlayer) return;
 			int localid = pLocalPlayer->entindex();
 
 			// Win all 6 awards in 1 round to win this achievement
-			if ( GetAwardsForPlayer(event, localid) == 6 && event->GetInt("winnerid") == localid && CalcPlayerCount() >= 4 )
+			if ( GetAwardsForPlayer(event.pEvent, localid) == 6 && event.iWinnerID == localid && CalcPlayerCount() >= 4 )
 				IncrementCount();
 		}
 	}
@@ -280,18 +280,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing, we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we killed them with a skinned weapon, we did it!
-		if (event->GetInt("weaponid") < WEAPON_SPAWNMAX && event->GetInt("weaponskin") > 0)
+		if (event.iWeaponID < WEAPON_SPAWNMAX && event.pEvent->GetInt("weaponskin") > 0)
 			IncrementCount();
 	}
 };
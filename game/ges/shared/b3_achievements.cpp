@@ -214,33 +214,33 @@ protected:
 		ListenForGameEvent( "player_death" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		C_GEMPPlayer *pLocalPlayer = ToGEMPPlayer(C_BasePlayer::GetLocalPlayer());
+		C_GEMPPlayer *pLocalPlayer = ToGEMPPlayer(event.pLocalPlayer);
 		if ( !pLocalPlayer )
 			return;
 
-		if ( Q_strcmp( event->GetName(), "round_start" ) == 0 )
+		if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_iCampingPoints = 0;
 		}
-		else if ( Q_strcmp( event->GetName(), "round_end" ) == 0 )
+		else if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			if ( !event->GetBool("showreport") )
+			if ( !event.bShowReport )
 				return;
 
 			m_iCampingPoints += CalcCampingPoints( GEPlayerRes()->GetCampingPercent(pLocalPlayer->entindex()) );
 
 			// If we have more than 4 players AND the person earned enough camping points, he is an octopussy
-			if ( CalcPlayerCount() >= 4 && m_iCampingPoints > ACH_OCTOPUSSY_POINTSREQ && event->GetInt("roundlength") > 120 )
+			if ( CalcPlayerCount() >= 4 && m_iCampingPoints > ACH_OCTOPUSSY_POINTSREQ && event.iRoundLength > 120 )
 				IncrementCount();
 		}
-		else if ( Q_stricmp( event->GetName(), "player_death" ) == 0 )
+		else if ( event.iType == GE_ACHEVENT_PLAYER_DEATH )
 		{
-			int localid = pLocalPlayer->GetUserID();
+			int localid = event.iLocalUserID;
 
 			// Check if we were camping during our kills / death
-			if ( event->GetInt("attacker") != localid && event->GetInt("userid") != localid )
+			if ( event.iAttackerID != localid && event.iUserID != localid )
 				return;
 	
 			// Rate our camping level based on the percentage of bad camping
@@ -284,21 +284,21 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( Q_strcmp( event->GetName(), "round_start" ) == 0 )
+		if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_bMeleeOnly = true;
 		}
-		else if ( Q_strcmp( event->GetName(), "round_end" ) == 0 )
+		else if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			CBasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
-			if (!pLocalPlayer || !event->GetBool("showreport")) return;
+			CBasePlayer *pLocalPlayer = event.pLocalPlayer;
+			if (!pLocalPlayer || !event.bShowReport) return;
 			int localid = pLocalPlayer->entindex();
 			
 			// If we made it the whole round without killing with a weapon AND we won the round they get it!
-			if ( localid == event->GetInt("winnerid") && m_bMeleeOnly && CalcPlayerCount() >= 4 
-				&& event->GetInt("roundlength") > 30 && GEPlayerRes()->GetFrags( localid ) > 0 )
+			if ( localid == event.iWinnerID && m_bMeleeOnly && CalcPlayerCount() >= 4 
+				&& event.iRoundLength > 30 && GEPlayerRes()->GetFrags( localid ) > 0 )
 				IncrementCount();
 		}
 	}
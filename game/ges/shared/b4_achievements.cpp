@@ -109,17 +109,17 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !CBasePlayer::GetLocalPlayer() )
+		if ( !event.pLocalPlayer )
 			return;
 
-		if ( Q_strstr(event->GetName(), "player_") )
+		if ( event.iType == GE_ACHEVENT_PLAYER_HURT || event.iType == GE_ACHEVENT_PLAYER_DEATH )
 		{
-			if ( event->GetInt("userid") == CBasePlayer::GetLocalPlayer()->GetUserID() )
+			if ( event.bLocalVictim )
 				m_iKillCount = 0;
 		}
-		else if ( !Q_stricmp(event->GetName(), "round_start") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_iKillCount = 0;
 		}
@@ -193,17 +193,17 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !CBasePlayer::GetLocalPlayer() )
+		if ( !event.pLocalPlayer )
 			return;
 
-		if ( !Q_stricmp(event->GetName(), "player_death") )
+		if ( event.iType == GE_ACHEVENT_PLAYER_DEATH )
 		{
-			if ( event->GetInt("userid") == CBasePlayer::GetLocalPlayer()->GetUserID() )
+			if ( event.bLocalVictim )
 				m_iKillCount = 0;
 		}
-		else if ( !Q_stricmp(event->GetName(), "round_start") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_iKillCount = 0;
 		}
@@ -253,33 +253,33 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
-		if ( !Q_stricmp( event->GetName(), "player_death" ) )
+		if ( event.iType == GE_ACHEVENT_PLAYER_DEATH )
 		{
-			if ( event->GetInt("userid") == pPlayer->GetUserID() )
+			if ( event.bLocalVictim )
 				m_bHasDied = true;
 		}
-		else if ( !Q_stricmp(event->GetName(), "player_team") )
+		else if ( event.iType == GE_ACHEVENT_PLAYER_TEAM )
 		{
-			if ( event->GetInt("userid") == pPlayer->GetUserID() && event->GetInt("team") == TEAM_SPECTATOR )
+			if ( event.bLocalVictim && event.pEvent->GetInt("team") == TEAM_SPECTATOR )
 				m_bHasDied = true;
 		}
-		else if ( !Q_stricmp(event->GetName(), "round_start") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			if ( pPlayer->GetTeamNumber() == TEAM_SPECTATOR )
 				m_bHasDied = true;
 			else
 				m_bHasDied = false;
 		}
-		else if ( !Q_stricmp( event->GetName(), "round_end" ) && event->GetBool("showreport") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_END && event.bShowReport )
 		{
 			// If we haven't died at all and the round was more than 4 minutes long and we scored at least 10 kills
-			if ( !m_bHasDied && event->GetInt("roundlength") > 240 && g_PR->GetFrags(pPlayer->entindex()) >= 10 )
+			if ( !m_bHasDied && event.iRoundLength > 240 && g_PR->GetFrags(pPlayer->entindex()) >= 10 )
 				IncrementCount();
 		}
 	}
@@ -309,23 +309,20 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !CBasePlayer::GetLocalPlayer() )
-			return;
-
-		if ( event->GetInt("userid") != CBasePlayer::GetLocalPlayer()->GetUserID() )
+		if ( !event.bLocalVictim )
 			return;
 
 		// Always reset the count when we spawn
-		if ( !Q_stricmp(event->GetName(), "player_spawn") )
+		if ( event.iType == GE_ACHEVENT_PLAYER_SPAWN )
 		{
 			m_iKillCount = 0;
 			return;
 		}
 
 		// Reset the kill count when we reload the magnum only (so we don't reset on weapon pickup)
-		if ( event->GetInt("weaponid") == WEAPON_COUGAR_MAGNUM && event->GetInt("eventid") == WEAPON_EVENT_RELOAD )	
+		if ( event.iWeaponID == WEAPON_COUGAR_MAGNUM && event.pEvent->GetInt("eventid") == WEAPON_EVENT_RELOAD )	
 			m_iKillCount = 0;
 	}
 
@@ -361,23 +358,23 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !Q_stricmp(event->GetName(), "round_start") )
+		if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_bExplosivesOnly = true;
 		}
-		else if ( !Q_stricmp(event->GetName(), "round_end") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			CBasePlayer *pLocalPlayer = C_BasePlayer::GetLocalPlayer();
-			if (!pLocalPlayer || !event->GetBool("showreport"))
+			CBasePlayer *pLocalPlayer = event.pLocalPlayer;
+			if (!pLocalPlayer || !event.bShowReport)
 				return;
 
 			int localid = pLocalPlayer->entindex();
 
 			// If we made it the whole round only using explosives AND we won the round they get it!
-			if ( localid == event->GetInt("winnerid") && m_bExplosivesOnly && CalcPlayerCount() >= 4 
-				&& event->GetInt("roundlength") > 30 && GEPlayerRes()->GetFrags( localid ) >= 15 )
+			if ( localid == event.iWinnerID && m_bExplosivesOnly && CalcPlayerCount() >= 4 
+				&& event.iRoundLength > 30 && GEPlayerRes()->GetFrags( localid ) >= 15 )
 				IncrementCount();
 		}
 	}
@@ -469,16 +466,16 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
 		// Reset conditions on death
-		if ( Q_stricmp( event->GetName(), "player_death" ) == 0 )
+		if ( event.iType == GE_ACHEVENT_PLAYER_DEATH )
 		{
-			if ( event->GetInt("userid") == pPlayer->GetUserID() )
+			if ( event.bLocalVictim )
 			{
 				m_flDmgExpTime = 0;
 				m_iDmgTaken = 0;
@@ -487,7 +484,7 @@ protected:
 			return;
 		}
 
-		if ( event->GetInt("userid") == pPlayer->GetUserID() && event->GetInt("dmgtype") == DMG_BLAST )
+		if ( event.bLocalVictim && event.pEvent->GetInt("dmgtype") == DMG_BLAST )
 		{
 			// If we received damage past our expiration, clear our accumulator and set a new dmg expiration
 			if ( gpGlobals->curtime > m_flDmgExpTime )
@@ -497,12 +494,12 @@ protected:
 			}
 
 			// Accumulate our damage amount
-			m_iDmgTaken += event->GetInt("damage");
+			m_iDmgTaken += event.iDamage;
 			
 			// If our accumulated damage is more than a third our max health and we are still alive
 			// give us some creds
 			int healthThreshold = pPlayer->GetMaxHealth()*0.333f;
-			int currHealth = event->GetInt("health");
+			int currHealth = event.iHealth;
 			if ( m_iDmgTaken >= healthThreshold && currHealth > 0 )
 			{
 				IncrementCount();
@@ -536,16 +533,16 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
 		// Only care about our kills
-		if ( event->GetInt("attacker") == pPlayer->GetUserID() )
+		if ( event.bLocalAttacker )
 		{
-			if ( event->GetBool("penetrated") && gpGlobals->curtime <= m_flLastKillTime + 0.2f )
+			if ( event.pEvent->GetBool("penetrated") && gpGlobals->curtime <= m_flLastKillTime + 0.2f )
 				IncrementCount();
 
 			m_flLastKillTime = gpGlobals->curtime;
@@ -572,15 +569,15 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !Q_stricmp(event->GetName(), "round_end") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			if ( !CBasePlayer::GetLocalPlayer() || !event->GetBool("showreport") || !IsScenario( "yolt" ) || CalcPlayerCount() < 4 )
+			if ( !event.pLocalPlayer || !event.bShowReport || !IsScenario( "yolt" ) || CalcPlayerCount() < 4 )
 				return;
 
 			// If we won we get cred
-			if ( event->GetInt("winnerid") == CBasePlayer::GetLocalPlayer()->entindex() )
+			if ( event.iWinnerID == event.pLocalPlayer->entindex() )
 				IncrementCount();
 		}
 	}
@@ -613,34 +610,34 @@ protected:
 		CGEAchBaseAwardType::ListenForEvents();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		C_BasePlayer *pPlayer = C_BasePlayer::GetLocalPlayer();
+		C_BasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
-		if ( !Q_stricmp(event->GetName(), "player_hurt") )
+		if ( event.iType == GE_ACHEVENT_PLAYER_HURT )
 		{
-			if ( pPlayer->GetUserID() == event->GetInt("attacker") && event->GetInt("userid") != event->GetInt("attacker") )
+			if ( event.bLocalAttacker && event.iUserID != event.iAttackerID )
 			{
-				if ( event->GetInt("weaponid") != WEAPON_DD44 )
+				if ( event.iWeaponID != WEAPON_DD44 )
 					m_bDD44Only = false;
 			}
 		}
-		else if ( !Q_stricmp(event->GetName(), "round_end") )
+		else if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			if ( !event->GetBool("showreport") || !IsScenario( "yolt" ) )
+			if ( !event.bShowReport || !IsScenario( "yolt" ) )
 				return;
 
 			// If we won with DD44 only and with 4+ kills we get cred
-			if ( event->GetInt("winnerid") == pPlayer->entindex() && WasCharForRound() 
+			if ( event.iWinnerID == pPlayer->entindex() && WasCharForRound() 
 					&& m_bDD44Only && g_PR->GetFrags(pPlayer->entindex()) >= 4 )
 				IncrementCount();
 		}
-		else if (!Q_stricmp(event->GetName(), "round_start"))
+		else if (event.iType == GE_ACHEVENT_ROUND_START)
 			m_bDD44Only = true; //Reset our status on round start.
 
-		CGEAchBaseAwardType::FireGameEvent_Internal( event );
+		CGEAchBaseAwardType::FireGEEvent( event );
 	}
 
 private:
@@ -671,14 +668,14 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
 		// Only care about our attacks
-		if ( event->GetInt("attacker") == pPlayer->GetUserID() )
+		if ( event.bLocalAttacker )
 		{
 			// Reset our duel parameters if we passed our duel limit
 			if ( gpGlobals->curtime > m_flLastKnifeTime + ACH_FLESHWOUND_TIMEOUT )
@@ -687,13 +684,13 @@ protected:
 				m_nLastVictim = 0;
 			}
 
-			if ( event->GetInt("weaponid") == WEAPON_KNIFE )
+			if ( event.iWeaponID == WEAPON_KNIFE )
 			{
 				m_flLastKnifeTime = gpGlobals->curtime;
-				m_nLastVictim = event->GetInt("userid");
+				m_nLastVictim = event.iUserID;
 
 				// Check to see if our victim also has a knife. If they do we are dueling!
-				CBasePlayer *pVictim = USERID2PLAYER( event->GetInt("userid") );
+				CBasePlayer *pVictim = event.pVictim;
 				if ( pVictim && pVictim->GetActiveWeapon() )
 				{
 					if ( ToGEWeapon(pVictim->GetActiveWeapon())->GetWeaponID() == WEAPON_KNIFE )
@@ -797,22 +794,22 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
 		// This message must be about a Klobb and we have to have an active weapon
-		if ( !pPlayer->GetActiveWeapon() || event->GetInt("weaponid") != WEAPON_KLOBB )
+		if ( !pPlayer->GetActiveWeapon() || event.iWeaponID != WEAPON_KLOBB )
 			return;
 
-		int localid = pPlayer->GetUserID();
+		int localid = event.iLocalUserID;
 
 		// We must be holding the Klobb
 		if ( ToGEWeapon(pPlayer->GetActiveWeapon())->GetWeaponID() == WEAPON_KLOBB )
 		{
-			if ( !Q_stricmp(event->GetName(), "player_hurt") )
+			if ( event.iType == GE_ACHEVENT_PLAYER_HURT )
 			{
 				// Reset our parameters if we timed out
 				if ( gpGlobals->curtime > (m_flLastKlobbTime + ACH_TWOKLOBBS_TIMEOUT) )
@@ -823,8 +820,8 @@ protected:
 
 				// We have filtered out all non-klobb attacks and we must be holding the klobb
 				// get the information from the event
-				int attacker = event->GetInt("attacker");
-				int victim = event->GetInt("userid");
+				int attacker = event.iAttackerID;
+				int victim = event.iUserID;
 
 				// Set our current victim
 				if ( attacker == localid )
@@ -845,13 +842,13 @@ protected:
 				else if ( attacker == localid || attacker == m_nHelper )
 					m_bInAssist = false;
 			}
-			else if ( !Q_stricmp(event->GetName(), "player_death") )
+			else if ( event.iType == GE_ACHEVENT_PLAYER_DEATH )
 			{
 				if ( gpGlobals->curtime > (m_flLastKlobbTime + ACH_TWOKLOBBS_TIMEOUT) )
 					return;
 
 				// We must be in a assisting a fellow klobber and be attacking the same victim
-				if ( m_bInAssist && event->GetInt("userid") == m_nVictim )
+				if ( m_bInAssist && event.iUserID == m_nVictim )
 				{
 					m_flLastKlobbTime = 0;
 					m_nHelper = m_nVictim = INVALID_ID;
@@ -902,24 +899,24 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if ( !pPlayer )
 			return;
 
 		// Ignore suicide
-		if ( event->GetInt("attacker") == event->GetInt("userid") )
+		if ( event.iAttackerID == event.iUserID )
 			return;
 
 		// Only care about our attacks (ignore blast damage)
-		if ( event->GetInt("attacker") == pPlayer->GetUserID() && event->GetInt("dmgtype") != DMG_BLAST )
+		if ( event.bLocalAttacker && event.pEvent->GetInt("dmgtype") != DMG_BLAST )
 		{
 			// Check if we have a new victim or we timed out
-			if ( gpGlobals->curtime > m_flTimeout || m_nVictim != event->GetInt("userid") )
+			if ( gpGlobals->curtime > m_flTimeout || m_nVictim != event.iUserID )
 			{
 				// This is a NEW victim
-				m_nVictim = event->GetInt("userid");
+				m_nVictim = event.iUserID;
 				m_iTotHits = m_iLegHits = 0;
 			}
 
@@ -927,11 +924,11 @@ protected:
 
 			// Check our hit group
 			m_iTotHits++;
-			if ( event->GetInt("hitgroup") == HITGROUP_LEFTLEG || event->GetInt("hitgroup") == HITGROUP_RIGHTLEG )
+			if ( event.pEvent->GetInt("hitgroup") == HITGROUP_LEFTLEG || event.pEvent->GetInt("hitgroup") == HITGROUP_RIGHTLEG )
 				m_iLegHits++;
 
 			// Check for a death and award if we kept with all leg hits
-			if ( event->GetInt("health") <= 0 )
+			if ( event.iHealth <= 0 )
 			{
 				float ratio = (float)m_iLegHits / (float)m_iTotHits;
 				if ( m_iTotHits > 1 && ratio > ACH_BREAKLEG_RATIO )
@@ -965,17 +962,17 @@ protected:
 		ListenForGameEvent( "round_end" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		if ( !Q_stricmp(event->GetName(), "round_end") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
-			if ( !pPlayer || !event->GetBool("showreport") || !IsScenario( "yolt" ) || CalcPlayerCount() < 4 )
+			CBasePlayer *pPlayer = event.pLocalPlayer;
+			if ( !pPlayer || !event.bShowReport || !IsScenario( "yolt" ) || CalcPlayerCount() < 4 )
 				return;
 
 			// If we won, got 4+ kills, and earned marksmanship get the cred
-			if ( event->GetInt("winnerid") == pPlayer->entindex() && g_PR->GetFrags( pPlayer->entindex() ) >= 4 
-					&& FindAwardForPlayer( event, GE_AWARD_MARKSMANSHIP, pPlayer->entindex() ) )
+			if ( event.iWinnerID == pPlayer->entindex() && g_PR->GetFrags( pPlayer->entindex() ) >= 4 
+					&& FindAwardForPlayer( event.pEvent, GE_AWARD_MARKSMANSHIP, pPlayer->entindex() ) )
 				IncrementCount();
 		}
 	}
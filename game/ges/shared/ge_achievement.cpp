@@ -14,6 +14,7 @@
 
 #ifdef CLIENT_DLL
 #include "c_ge_gameplayresource.h"
+#include "c_ge_player.h"
 #endif
 
 // memdbgon must be the last include file in a .cpp file!!!
@@ -26,6 +27,9 @@ END_DATADESC()
 CGEAchievement::CGEAchievement( void )
 {
 	m_iDependentID = -1;
+#ifdef CLIENT_DLL
+	m_iRoutedEvents = 0;
+#endif
 }
 
 void CGEAchievement::SetDependent( int id )
@@ -67,6 +71,26 @@ bool CGEAchievement::ShouldHideUntilAchieved( void )
 	return false;
 }
 
+#ifdef CLIENT_DLL
+void CGEAchievement::ListenForGameEvent( const char *name )
+{
+	if ( !GEAchievementRouter()->AddListener( this, name ) )
+		BaseClass::ListenForGameEvent( name );
+}
+
+void CGEAchievement::RouteGameEvent( const GEAchEvent_t &event )
+{
+	// Same filtering CBaseAchievement::FireGameEvent does for us
+	if ( !IsActive() )
+		return;
+
+	if ( m_pMapNameFilter && Q_strcmp( m_pAchievementMgr->GetMapName(), m_pMapNameFilter ) )
+		return;
+
+	FireGEEvent( event );
+}
+#endif
+
 void CGEAchievement::HandleProgressUpdate()
 {
 	// We are a hidden achievement and this is our first increment
@@ -160,3 +184,128 @@ bool IsScenario( const char *ident, bool official /*=true*/ )
 	return false;
 }
 #endif
+
+#ifdef CLIENT_DLL
+static const char *g_szGEAchEventNames[GE_ACHEVENT_COUNT] =
+{
+	"player_death",
+	"player_hurt",
+	"player_spawn",
+	"player_team",
+	"round_start",
+	"round_end",
+	"weapon_event",
+	"gameplay_event",
+	"player_changeident",
+};
+
+static CGEAchievementRouter g_GEAchievementRouter;
+CGEAchievementRouter *GEAchievementRouter() { return &g_GEAchievementRouter; }
+
+int CGEAchievementRouter::EventTypeForName( const char *name )
+{
+	for ( int i=0; i < GE_ACHEVENT_COUNT; i++ )
+	{
+		if ( !Q_strcmp( name, g_szGEAchEventNames[i] ) )
+			return i;
+	}
+
+	return -1;
+}
+
+bool CGEAchievementRouter::AddListener( CGEAchievement *pAchievement, const char *name )
+{
+	int type = EventTypeForName( name );
+	if ( type == -1 )
+		return false;
+
+	// Achievements re-register whenever they are reset or their dependent is achieved
+	if ( pAchievement->m_iRoutedEvents & (1 << type) )
+		return true;
+
+	// First one in subscribes us to the event
+	if ( !m_vListeners[type].Count() )
+		ListenForGameEvent( name );
+
+	m_vListeners[type].AddToTail( pAchievement );
+	pAchievement->m_iRoutedEvents |= (1 << type);
+	return true;
+}
+
+void CGEAchievementRouter::Reset( void )
+{
+	StopListeningForAllEvents();
+
+	for ( int type=0; type < GE_ACHEVENT_COUNT; type++ )
+	{
+		for ( int i=0; i < m_vListeners[type].Count(); i++ )
+			m_vListeners[type][i]->m_iRoutedEvents = 0;
+
+		m_vListeners[type].RemoveAll();
+	}
+}
+
+void CGEAchievementRouter::DecodeEvent( IGameEvent *event, GEAchEvent_t &out )
+{
+	out.pEvent = event;
+	out.pLocalPlayer = ToGEPlayer( C_BasePlayer::GetLocalPlayer() );
+	out.iLocalUserID = out.pLocalPlayer ? out.pLocalPlayer->GetUserID() : -1;
+
+	switch ( out.iType )
+	{
+	case GE_ACHEVENT_PLAYER_DEATH:
+	case GE_ACHEVENT_PLAYER_HURT:
+	case GE_ACHEVENT_WEAPON_EVENT:
+		out.iWeaponID = event->GetInt( "weaponid" );
+		out.bHeadshot = event->GetBool( "headshot" );
+		out.iDist	  = event->GetInt( "dist" );
+		out.iCustom	  = event->GetInt( "custom" );
+		out.iDamage	  = event->GetInt( "damage" );
+		out.iHealth	  = event->GetInt( "health" );
+		// Fall through for the players
+
+	case GE_ACHEVENT_PLAYER_SPAWN:
+	case GE_ACHEVENT_PLAYER_TEAM:
+		out.iUserID		= event->GetInt( "userid" );
+		out.iAttackerID	= event->GetInt( "attacker" );
+		out.pVictim		= UTIL_PlayerByIndex( engine->GetPlayerForUserID( out.iUserID ) );
+		out.pAttacker	= out.iAttackerID ? UTIL_PlayerByIndex( engine->GetPlayerForUserID( out.iAttackerID ) ) : NULL;
+		out.bLocalVictim	= out.pLocalPlayer && out.iUserID == out.iLocalUserID;
+		out.bLocalAttacker	= out.pLocalPlayer && out.iAttackerID == out.iLocalUserID;
+		break;
+
+	case GE_ACHEVENT_ROUND_END:
+		out.iWinnerID	 = event->GetInt( "winnerid" );
+		out.iRoundLength = event->GetInt( "roundlength" );
+		out.bShowReport	 = event->GetBool( "showreport" );
+		break;
+
+	case GE_ACHEVENT_GAMEPLAY_EVENT:
+		out.szName		= event->GetString( "name" );
+		out.szValue[0]	= event->GetString( "value1" );
+		out.szValue[1]	= event->GetString( "value2" );
+		out.szValue[2]	= event->GetString( "value3" );
+		out.szValue[3]	= event->GetString( "value4" );
+		out.iValue1		= Q_atoi( out.szValue[0] );
+		out.iValue2		= Q_atoi( out.szValue[1] );
+		break;
+	}
+}
+
+void CGEAchievementRouter::FireGameEvent( IGameEvent *event )
+{
+	int type = EventTypeForName( event->GetName() );
+	if ( type == -1 || !m_vListeners[type].Count() )
+		return;
+
+	GEAchEvent_t decoded;
+	memset( &decoded, 0, sizeof(decoded) );
+	decoded.iType = type;
+	DecodeEvent( event, decoded );
+
+	// Awarding an achievement can subscribe its dependents, they start with the next event
+	int count = m_vListeners[type].Count();
+	for ( int i=0; i < count; i++ )
+		m_vListeners[type][i]->RouteGameEvent( decoded );
+}
+#endif
@@ -17,6 +17,65 @@
 #include "baseachievement.h"
 #include "ge_achievement_defs.h"
 
+#ifdef CLIENT_DLL
+class C_BasePlayer;
+class C_GEPlayer;
+
+// Game events our achievements can listen for through the router
+enum GEAchEventType
+{
+	GE_ACHEVENT_PLAYER_DEATH = 0,
+	GE_ACHEVENT_PLAYER_HURT,
+	GE_ACHEVENT_PLAYER_SPAWN,
+	GE_ACHEVENT_PLAYER_TEAM,
+	GE_ACHEVENT_ROUND_START,
+	GE_ACHEVENT_ROUND_END,
+	GE_ACHEVENT_WEAPON_EVENT,
+	GE_ACHEVENT_GAMEPLAY_EVENT,
+	GE_ACHEVENT_PLAYER_CHANGEIDENT,
+
+	GE_ACHEVENT_COUNT,
+};
+
+// A game event decoded once by the router and handed to every interested achievement,
+// only the fields relevant to iType are filled in
+struct GEAchEvent_t
+{
+	int			 iType;
+	IGameEvent	*pEvent;			// The raw event for anything not decoded below
+
+	C_GEPlayer	*pLocalPlayer;
+	int			 iLocalUserID;		// -1 if we don't have a local player
+
+	// player_death, player_hurt, player_spawn, player_team
+	int			 iUserID;
+	int			 iAttackerID;
+	C_BasePlayer *pVictim;			// Resolved from userid
+	C_BasePlayer *pAttacker;		// Resolved from attacker
+	bool		 bLocalVictim;		// userid is us
+	bool		 bLocalAttacker;	// attacker is us
+
+	// player_death, player_hurt
+	int			 iWeaponID;
+	bool		 bHeadshot;
+	int			 iDist;
+	int			 iCustom;
+	int			 iDamage;
+	int			 iHealth;
+
+	// round_end
+	int			 iWinnerID;
+	int			 iRoundLength;
+	bool		 bShowReport;
+
+	// gameplay_event
+	const char	*szName;
+	const char	*szValue[4];
+	int			 iValue1;			// Numeric value1 and value2, usually user ids
+	int			 iValue2;
+};
+#endif
+
 class CGEAchievement : public CBaseAchievement
 {
 	DECLARE_CLASS( CGEAchievement, CBaseAchievement );
@@ -38,14 +97,58 @@ public:
 	// This will hide the achievement until our dependent has been achieved
 	virtual bool ShouldHideUntilAchieved( void );
 
+#ifdef CLIENT_DLL
+	// Subscribes through CGEAchievementRouter instead of the event manager
+	// so each event is only decoded once no matter how many of us listen
+	void ListenForGameEvent( const char *name );
+
+	// Called by the router, applies the usual filters then calls FireGEEvent
+	void RouteGameEvent( const GEAchEvent_t &event );
+#endif
+
 protected:
 	virtual void HandleProgressUpdate();
 	virtual void ShowUnlockedNotification();
 
+#ifdef CLIENT_DLL
+	// Override this instead of FireGameEvent_Internal to use the decoded event
+	virtual void FireGEEvent( const GEAchEvent_t &event ) { FireGameEvent_Internal( event.pEvent ); }
+#endif
+
 private:
 	int		m_iDependentID;
+
+#ifdef CLIENT_DLL
+	friend class CGEAchievementRouter;
+
+	// Bit per GEAchEventType we are subscribed to with the router
+	int		m_iRoutedEvents;
+#endif
 };
 
+#ifdef CLIENT_DLL
+// Listens for each game event type once on behalf of all our achievements
+class CGEAchievementRouter : public CGameEventListener
+{
+public:
+	// Returns false if the router doesn't handle this event name
+	bool AddListener( CGEAchievement *pAchievement, const char *name );
+
+	// Drops every subscription, called when the level shuts down
+	void Reset( void );
+
+	virtual void FireGameEvent( IGameEvent *event );
+
+private:
+	int  EventTypeForName( const char *name );
+	void DecodeEvent( IGameEvent *event, GEAchEvent_t &out );
+
+	CUtlVector<CGEAchievement*> m_vListeners[ GE_ACHEVENT_COUNT ];
+};
+
+CGEAchievementRouter *GEAchievementRouter();
+#endif
+
 #ifdef CLIENT_DLL
 
 #define DECLARE_GE_ACHIEVEMENT_( className, achievementID, achievementName, gameDirFilter, iPointValue, bHidden, dependentID  ) \
@@ -121,13 +224,12 @@ protected:
 		ListenForGameEvent( "player_changeident" );
 	}
 
-	virtual void FireGameEvent_Internal( IGameEvent *event )
+	virtual void FireGEEvent( const GEAchEvent_t &event )
 	{
-		CBasePlayer *pLocalPlayer = CBasePlayer::GetLocalPlayer();
-		if (!pLocalPlayer) return;
-		int localid = pLocalPlayer->entindex();
+		if (!event.pLocalPlayer) return;
+		int localid = GetLocalPlayerIndex();
 
-		if ( Q_strcmp( event->GetName(), "round_end" ) == 0 && event->GetBool("showreport"))
+		if ( event.iType == GE_ACHEVENT_ROUND_END && event.bShowReport)
 		{
 			// See if we met all of our requirements
 			bool bAchieved = false;
@@ -137,7 +239,7 @@ protected:
 
 				for ( int i=0; i < m_vAwardsReq.Count(); i++ )
 				{
-					if ( !FindAwardForPlayer(event, m_vAwardsReq[i], localid) )
+					if ( !FindAwardForPlayer(event.pEvent, m_vAwardsReq[i], localid) )
 						bAchieved = false;
 				}
 			}
@@ -150,14 +252,14 @@ protected:
 			if ( m_bIsChar )
 				m_bWasCharForRound = true;
 		}
-		else if ( Q_strcmp( event->GetName(), "player_changeident" ) == 0 )
+		else if ( event.iType == GE_ACHEVENT_PLAYER_CHANGEIDENT )
 		{
 			// This is not us, ignore
-			if ( !m_szCharReq || localid != event->GetInt("playerid") )
+			if ( !m_szCharReq || localid != event.pEvent->GetInt("playerid") )
 				return;
 
 			// See if we changed to our required character
-			if ( !Q_stricmp( event->GetString("ident"), m_szCharReq ) )
+			if ( !Q_stricmp( event.pEvent->GetString("ident"), m_szCharReq ) )
 			{
 				// If this is our first character change for the round then we set our flag
 				if ( !m_iCharChangeCnt )
@@ -124,6 +124,8 @@ bool SimpleLessFunc( const int &lhs, const int &rhs )
 #endif
 
 #ifdef GAME_DLL
+ConVar ge_authlist_file( "ge_authlist_file", "", FCVAR_GAMEDLL | FCVAR_CHEAT, "Load the auth status lists from this file in the mod directory instead of the auth server, takes effect on map load" );
+
 CGEWebRequest *g_pStatusListWebRequest = NULL;
 CGEWebRequest *g_pVersionWebRequest = NULL;
 
@@ -174,6 +176,7 @@ CGERules::CGERules()
 #ifdef GAME_DLL
 	m_vSpawnerLocations.SetLessFunc( SimpleLessFunc );
 	m_vSpawnerStats.SetLessFunc( SimpleLessFunc );
+	m_iSpawnerLocationsVersion = 0;
 
 	strcpy(m_pKickTargetID, "NULLID");
 	m_pLastKickCaller = NULL;
@@ -284,9 +287,9 @@ void CGERules::Think()
 		{
 			Warning( "Failed Status Check: %s\n", g_pStatusListWebRequest->GetError() );
 		}
-		else
+		else if ( SwapStatusLists() )
 		{
-			UpdateStatusLists( g_pStatusListWebRequest->GetResult() );
+			// The new generation was already built on the request thread
 			GEMPRules()->SetSpecialEventCode( iAwardEventCode );
 		}
 
@@ -411,7 +414,8 @@ void CGERules::LevelInitPostEntity()
 	UpdateSpawnerLocations();
 
 	// We do this every map load
-	g_pStatusListWebRequest = new CGEWebRequest( GES_AUTH_URL );
+	const char *authAddr = ge_authlist_file.GetString()[0] ? ge_authlist_file.GetString() : GES_AUTH_URL;
+	g_pStatusListWebRequest = new CGEWebRequest( authAddr, OnStatusListsLoaded );
 
 	// We only do this once per server run cycle
 	if ( engine->IsDedicatedServer() && !g_pVersionWebRequest )
@@ -912,7 +916,7 @@ void CGERules::UpdateSpawnerLocations()
 		// Troll through our entity list building our vector
 		vEnts = new CUtlVector<EHANDLE>;
 		pStats = new SpawnerStats;
-		pEnt = gEntList.FindEntityByClassname( NULL, classname );
+		pEnt = gEntList.NextEntByClassname( NULL, classname );
 		while( pEnt )
 		{
 			vEnts->AddToTail( pEnt );
@@ -922,7 +926,7 @@ void CGERules::UpdateSpawnerLocations()
 			pStats->mins = pStats->mins.Min( origin );
 			pStats->centroid += origin;
 
-			pEnt = gEntList.FindEntityByClassname( pEnt, classname );
+			pEnt = gEntList.NextEntByClassname( pEnt, classname );
 		}
 
 		if ( vEnts->Count() > 0 )
@@ -931,6 +935,9 @@ void CGERules::UpdateSpawnerLocations()
 		m_vSpawnerStats.Insert( i, pStats );
 		m_vSpawnerLocations.Insert( i, vEnts );
 	}
+
+	// Let anyone indexing our lists know they need to rebuild
+	m_iSpawnerLocationsVersion++;
 }
 
 const CUtlVector<EHANDLE>* CGERules::GetSpawnersOfType( int type )
@@ -46,6 +46,7 @@ public:
 	const CUtlVector<EHANDLE> *GetSpawnersOfType( int type );
 	void UpdateSpawnerLocations();
 	bool GetSpawnerStats( int spawn_type, Vector &mins, Vector &maxs, Vector &centroid );
+	int  GetSpawnerLocationsVersion() { return m_iSpawnerLocationsVersion; }
 
 	// Respawns all active players
 	void SpawnPlayers();
@@ -136,6 +137,7 @@ private:
 	};
 	CUtlMap<int, SpawnerStats*> m_vSpawnerStats;
 	CUtlMap<int,CUtlVector<EHANDLE>*> m_vSpawnerLocations;
+	int m_iSpawnerLocationsVersion;
 #endif
 };
 
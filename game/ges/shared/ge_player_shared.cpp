@@ -38,6 +38,7 @@
 #include "SoundEmitterSystem/isoundemittersystembase.h"
 #include "particle_parse.h"
 #include "gemp_gamerules.h"
+#include "tier0/fasttimer.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -257,11 +258,140 @@ void CGEPlayer::FireBullets( const FireBulletsInfo_t &info )
 	}
 }
 
+// Maximum number of surfaces (including the first) a single bullet can pass through
+#define MAX_BULLET_SEGMENTS		8
+
+ConVar ge_bullet_broadphase( "ge_bullet_broadphase", "1", FCVAR_REPLICATED, "Trace every pellet of a multi-pellet volley against one shared broad phase query." );
+ConVar ge_bullet_broadphase_range( "ge_bullet_broadphase_range", "1024", FCVAR_REPLICATED, "Distance along each pellet covered by the shared broad phase query, pellets that travel further are traced on their own.", true, 64.0f, true, MAX_TRACE_LENGTH );
+
+struct GEBulletStats_t
+{
+	int iVolleys;
+	int iPellets;
+	int iTraces;
+	int iListTraces;
+	int iListMisses;
+};
+
+//-----------------------------------------------------------------------------
+// Per volley state, lives on the stack of FireBullets and is handed down to the
+// penetration handlers. Multi-pellet volleys gather the leaves and entities along
+// the swept volume of the whole volley once so each pellet only has to be tested
+// against that list.
+//-----------------------------------------------------------------------------
+class CGEBulletContext
+{
+public:
+	CGEBulletContext( GEBulletStats_t *pStats ) : m_pStats( pStats ), m_pList( NULL ), m_flRange( 0 ) {}
+	~CGEBulletContext();
+
+	void SetupBroadPhase( const Vector &vecSrc, const Vector *pDirs, int count, float flDistance );
+
+	// Traces a pellet from the volley's source, falls back to a regular trace if nothing
+	// was hit inside the range the list covers
+	void TracePellet( const Vector &vecDir, float flDistance, ITraceFilter *pFilter, trace_t *ptr );
+
+	void TraceLine( const Vector &vecStart, const Vector &vecEnd, ITraceFilter *pFilter, trace_t *ptr );
+
+private:
+	GEBulletStats_t	*m_pStats;
+
+	// Only constructed for multi-pellet volleys, the list allocates its leaf and entity arrays
+	CTraceListData	*m_pList;
+	ALIGN16 byte	m_ListStorage[ sizeof(CTraceListData) ];
+	float			m_flRange;
+	Vector			m_vecSrc;
+};
+
+CGEBulletContext::~CGEBulletContext()
+{
+	if ( m_pList )
+		m_pList->~CTraceListData();
+}
+
+void CGEBulletContext::SetupBroadPhase( const Vector &vecSrc, const Vector *pDirs, int count, float flDistance )
+{
+	m_vecSrc = vecSrc;
+
+	if ( m_pStats )
+	{
+		m_pStats->iVolleys++;
+		m_pStats->iPellets += count;
+	}
+
+	if ( count < 2 || !ge_bullet_broadphase.GetBool() )
+		return;
+
+	m_flRange = min( flDistance, ge_bullet_broadphase_range.GetFloat() );
+
+	// Sweep a box down the average pellet direction that is big enough to contain every pellet
+	Vector vecCenter = vec3_origin;
+	for ( int i=0; i < count; i++ )
+		vecCenter += pDirs[i];
+	vecCenter /= count;
+
+	Vector vecExtents( 1.0f, 1.0f, 1.0f );
+	for ( int i=0; i < count; i++ )
+	{
+		for ( int axis=0; axis < 3; axis++ )
+			vecExtents[axis] = max( vecExtents[axis], fabs( pDirs[i][axis] - vecCenter[axis] ) * m_flRange + 1.0f );
+	}
+
+	Ray_t ray;
+	ray.Init( vecSrc, vecSrc + vecCenter * m_flRange, -vecExtents, vecExtents );
+
+	m_pList = new ( m_ListStorage ) CTraceListData;
+	enginetrace->SetupLeafAndEntityListRay( ray, *m_pList );
+}
+
+void CGEBulletContext::TracePellet( const Vector &vecDir, float flDistance, ITraceFilter *pFilter, trace_t *ptr )
+{
+	if ( m_pList )
+	{
+		if ( m_pStats )
+		{
+			m_pStats->iTraces++;
+			m_pStats->iListTraces++;
+		}
+
+		Ray_t ray;
+		ray.Init( m_vecSrc, m_vecSrc + vecDir * m_flRange );
+		enginetrace->TraceRayAgainstLeafAndEntityList( ray, *m_pList, MASK_SHOT, pFilter, ptr );
+
+		if ( ptr->fraction < 1.0f || ptr->startsolid || m_flRange >= flDistance )
+		{
+			// Put the fractions back in terms of the full length shot
+			float flScale = m_flRange / flDistance;
+			ptr->fraction *= flScale;
+			ptr->fractionleftsolid *= flScale;
+			return;
+		}
+
+		if ( m_pStats )
+			m_pStats->iListMisses++;
+	}
+
+	TraceLine( m_vecSrc, m_vecSrc + vecDir * flDistance, pFilter, ptr );
+}
+
+void CGEBulletContext::TraceLine( const Vector &vecStart, const Vector &vecEnd, ITraceFilter *pFilter, trace_t *ptr )
+{
+	if ( m_pStats )
+		m_pStats->iTraces++;
+
+	UTIL_TraceLine( vecStart, vecEnd, MASK_SHOT, pFilter, ptr );
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Fire's bullets
 // Input  : bullet information
 //-----------------------------------------------------------------------------
 void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
+{
+	FireBullets( info, NULL );
+}
+
+void CBaseEntity::FireBullets( const FireBulletsInfo_t &info, GEBulletStats_t *pStats )
 {
 	FireBulletsInfo_t modinfo = info;
 	CGEWeapon *pWeapon = NULL;
@@ -286,7 +416,6 @@ void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
 	modinfo.m_iPlayerDamage = modinfo.m_iDamage;
 
 	// Now we handle the entire sequence so that we can implement bullet penetration properly
-	static int	tracerCount;
 	trace_t		tr;
 	CAmmoDef*	pAmmoDef	= GetAmmoDef();
 	int			nDamageType	= pAmmoDef->DamageType(modinfo.m_iAmmoType);
@@ -294,30 +423,12 @@ void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
 	// the default attacker is ourselves
 	CBaseEntity *pAttacker = modinfo.m_pAttacker ? modinfo.m_pAttacker : this;
 
-	// Make sure we don't have a dangling damage target from a recursive call
-	if ( g_MultiDamage.GetTarget() != NULL )
-	{
-		ApplyMultiDamage();
-	}
-	  
-	ClearMultiDamage();
-	g_MultiDamage.SetDamageType( nDamageType | DMG_NEVERGIB );
-	g_MultiDamage.SetDamageStats( modinfo.m_nFlags );
-
-	Vector vecDir;
-	Vector vecEnd;
-	
 	// Skip multiple entities when tracing
 	CBulletsTraceFilter traceFilter( COLLISION_GROUP_NONE );
 	traceFilter.SetPassEntity( this ); // Standard pass entity for THIS so that it can be easily removed from the list after passing through a portal
 	traceFilter.AddEntityToIgnore( modinfo.m_pAdditionalIgnoreEnt );
 
 	bool bUnderwaterBullets = ShouldDrawUnderwaterBulletBubbles();
-	bool bStartedInWater = false;
-	if ( bUnderwaterBullets )
-	{
-		bStartedInWater = ( enginetrace->GetPointContents( modinfo.m_vecSrc ) & (CONTENTS_WATER|CONTENTS_SLIME) ) != 0;
-	}
 
 #ifdef GAME_DLL
 	// Prediction seed
@@ -348,10 +459,13 @@ void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
 	RandomSeed(iSeed);
 	int ishotmatrixID = rand() % 4;
 
-	// Now we actually fire the shot(s)
+	// Work out where every shot is going first so they can all share one broad phase query
+	CUtlVectorFixedGrowable<Vector, 16> vecShotDirs;
+	vecShotDirs.EnsureCapacity( modinfo.m_iShots );
+
 	for (int iShot = 0; iShot < modinfo.m_iShots; iShot++)
 	{
-		bool bHitWater = false;
+		Vector vecDir;
 
 		// Prediction seed
 		RandomSeed( iSeed );
@@ -370,7 +484,7 @@ void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
 			// This code projects one shot down the center that is fairly accurate, and then 4 more shots at each corner
 			// that are substancially less so.  Overlap between the shot spreads is minimal, meaning across the map instant
 			// kills and point blank misses are much less likely.
-			if (isWepShotgun)
+			if (isWepShotgun && iShot < 5)
 			{
 				Vector vecRight, vecUp;
 
@@ -396,188 +510,256 @@ void CBaseEntity::FireBullets( const FireBulletsInfo_t &info )
 #endif
 		}
 
-		vecEnd = modinfo.m_vecSrc + vecDir * modinfo.m_flDistance;
-		AI_TraceLine(modinfo.m_vecSrc, vecEnd, MASK_SHOT, &traceFilter, &tr);
+		vecShotDirs.AddToTail( vecDir );
+		iSeed++;
+	}
 
-		// Tracker 70354/63250:  ywb 8/2/07
-		// Fixes bug where trace from turret with attachment point outside of Vcollide
-		//  starts solid so doesn't hit anything else in the world and the final coord 
-		//  is outside of the MAX_COORD_FLOAT range.  This cause trying to send the end pos
-		//  of the tracer down to the client with an origin which is out-of-range for networking
-		if ( tr.startsolid )
-		{
-			tr.endpos = tr.startpos;
-			tr.fraction = 0.0f;
-		}
+	CGEBulletContext ctx( pStats );
+	ctx.SetupBroadPhase( modinfo.m_vecSrc, vecShotDirs.Base(), vecShotDirs.Count(), modinfo.m_flDistance );
 
-	#ifdef GAME_DLL
-		if ( ai_debug_shoot_positions.GetBool() || ai_debug_aim_positions.GetInt() > 1 )
-			NDebugOverlay::Line(modinfo.m_vecSrc, vecEnd, 255, 255, 255, false, 1.0f );
-	#endif
+	// Make sure we don't have a dangling damage target from a previous volley
+	if ( g_MultiDamage.GetTarget() != NULL )
+	{
+		ApplyMultiDamage();
+	}
 
-		if ( bStartedInWater )
-		{
-		#ifdef GAME_DLL
-			Vector vBubbleStart = modinfo.m_vecSrc;
-			Vector vBubbleEnd = tr.endpos;
-			CreateBubbleTrailTracer( vBubbleStart, vBubbleEnd, vecDir );
-		#endif
-			bHitWater = true;
-		}
+	ClearMultiDamage();
+	g_MultiDamage.SetDamageType( nDamageType | DMG_NEVERGIB );
+	g_MultiDamage.SetDamageStats( modinfo.m_nFlags );
 
-		// Now hit all triggers along the ray that respond to shots...
-		// Clip the ray to the first collided solid returned from traceline
-		CTakeDamageInfo triggerInfo( pAttacker, pAttacker, modinfo.m_iDamage, nDamageType );
-		CalculateBulletDamageForce( &triggerInfo, modinfo.m_iAmmoType, vecDir, tr.endpos );
-		triggerInfo.ScaleDamageForce( modinfo.m_flDamageForceScale );
-		triggerInfo.SetAmmoType( modinfo.m_iAmmoType );
-	#ifdef GAME_DLL
-		TraceAttackToTriggers( triggerInfo, tr.startpos, tr.endpos, vecDir );
-	#endif
+	// Now we actually fire the shot(s)
+	for (int iShot = 0; iShot < vecShotDirs.Count(); iShot++)
+	{
+		const Vector &vecDir = vecShotDirs[iShot];
+
+		// Each surface the bullet passes through continues it as a new segment from the far side,
+		// segments alternate between these so the one we are firing is never overwritten
+		FireBulletsInfo_t refireInfo[2];
+		FireBulletsInfo_t *pInfo = &modinfo;
 
-		// Make sure given a valid bullet type
-		if (modinfo.m_iAmmoType == -1)
+		for ( int iSegment = 0; iSegment < MAX_BULLET_SEGMENTS; iSegment++ )
 		{
-			DevMsg("ERROR: Undefined ammo type!\n");
-			return;
-		}
+			FireBulletsInfo_t &segInfo = *pInfo;
+			bool bHitWater = false;
 
-		Vector vecTracerDest = tr.endpos;
+			// Penetrated segments get their own filter so they can skip what they just passed through
+			CBulletsTraceFilter segFilter( COLLISION_GROUP_NONE );
+			ITraceFilter *pTraceFilter = &traceFilter;
 
-		// do damage, paint decals
-		if (tr.fraction != 1.0)
-		{
-		#ifdef GAME_DLL
-			UpdateShotStatistics( tr );
+			if ( iSegment > 0 )
+			{
+				segFilter.SetPassEntity( this );
+				segFilter.AddEntityToIgnore( segInfo.m_pAdditionalIgnoreEnt );
+				pTraceFilter = &segFilter;
 
-			// For shots that don't need persistance
-			int soundEntChannel = ( modinfo.m_nFlags&FIRE_BULLETS_TEMPORARY_DANGER_SOUND ) ? SOUNDENT_CHANNEL_BULLET_IMPACT : SOUNDENT_CHANNEL_UNSPECIFIED;
-			CSoundEnt::InsertSound( SOUND_BULLET_IMPACT, tr.endpos, 200, 0.5, this, soundEntChannel );
-		#endif
+				// Make sure we don't have a dangling damage target from the last segment
+				if ( g_MultiDamage.GetTarget() != NULL )
+				{
+					ApplyMultiDamage();
+				}
+
+				ClearMultiDamage();
+				g_MultiDamage.SetDamageType( nDamageType | DMG_NEVERGIB );
+				g_MultiDamage.SetDamageStats( segInfo.m_nFlags );
+			}
 
-			// See if the bullet ended up underwater + started out of the water
-			if ( !bHitWater && ( enginetrace->GetPointContents( tr.endpos ) & (CONTENTS_WATER|CONTENTS_SLIME) ) )
+			bool bStartedInWater = false;
+			if ( bUnderwaterBullets )
 			{
-				bHitWater = HandleShotImpactingWater( modinfo, vecEnd, &traceFilter, &vecTracerDest );
+				bStartedInWater = ( enginetrace->GetPointContents( segInfo.m_vecSrc ) & (CONTENTS_WATER|CONTENTS_SLIME) ) != 0;
 			}
 
-			float flActualDamage = modinfo.m_iDamage;
-			
-			if ( tr.m_pEnt && tr.m_pEnt->IsPlayer() )
+			Vector vecEnd = segInfo.m_vecSrc + vecDir * segInfo.m_flDistance;
+
+			if ( iSegment == 0 )
+				ctx.TracePellet( vecDir, segInfo.m_flDistance, pTraceFilter, &tr );
+			else
+				ctx.TraceLine( segInfo.m_vecSrc, vecEnd, pTraceFilter, &tr );
+
+			// Tracker 70354/63250:  ywb 8/2/07
+			// Fixes bug where trace from turret with attachment point outside of Vcollide
+			//  starts solid so doesn't hit anything else in the world and the final coord 
+			//  is outside of the MAX_COORD_FLOAT range.  This cause trying to send the end pos
+			//  of the tracer down to the client with an origin which is out-of-range for networking
+			if ( tr.startsolid )
 			{
-				// If we hit a player set them as ignored for any possible next round of
-				// bullet firing so that they do not get "double penetrated" through multiple
-				// hitboxes
-				modinfo.m_pAdditionalIgnoreEnt = tr.m_pEnt;
+				tr.endpos = tr.startpos;
+				tr.fraction = 0.0f;
 			}
 
-			int nActualDamageType = nDamageType;
-			if ( flActualDamage == 0.0 )
+		#ifdef GAME_DLL
+			if ( ai_debug_shoot_positions.GetBool() || ai_debug_aim_positions.GetInt() > 1 )
+				NDebugOverlay::Line(segInfo.m_vecSrc, vecEnd, 255, 255, 255, false, 1.0f );
+		#endif
+
+			if ( bStartedInWater )
 			{
-				flActualDamage = g_pGameRules->GetAmmoDamage( pAttacker, tr.m_pEnt, modinfo.m_iAmmoType );
+			#ifdef GAME_DLL
+				Vector vBubbleStart = segInfo.m_vecSrc;
+				Vector vBubbleEnd = tr.endpos;
+				CreateBubbleTrailTracer( vBubbleStart, vBubbleEnd, vecDir );
+			#endif
+				bHitWater = true;
 			}
-			else
+
+			// Now hit all triggers along the ray that respond to shots...
+			// Clip the ray to the first collided solid returned from traceline
+			CTakeDamageInfo triggerInfo( pAttacker, pAttacker, segInfo.m_iDamage, nDamageType );
+			CalculateBulletDamageForce( &triggerInfo, segInfo.m_iAmmoType, vecDir, tr.endpos );
+			triggerInfo.ScaleDamageForce( segInfo.m_flDamageForceScale );
+			triggerInfo.SetAmmoType( segInfo.m_iAmmoType );
+		#ifdef GAME_DLL
+			TraceAttackToTriggers( triggerInfo, tr.startpos, tr.endpos, vecDir );
+		#endif
+
+			// Make sure given a valid bullet type
+			if (segInfo.m_iAmmoType == -1)
 			{
-				nActualDamageType = nDamageType | ((flActualDamage > 16) ? DMG_ALWAYSGIB : DMG_NEVERGIB );
+				DevMsg("ERROR: Undefined ammo type!\n");
+				return;
 			}
 
-			if ( tr.m_pEnt && (!bHitWater || ((modinfo.m_nFlags & FIRE_BULLETS_DONT_HIT_UNDERWATER) == 0)) )
+			Vector vecTracerDest = tr.endpos;
+
+			// do damage, paint decals
+			if (tr.fraction != 1.0)
 			{
-				// Damage specified by function parameter
-				CTakeDamageInfo dmgInfo( this, pAttacker, flActualDamage, nActualDamageType );
-				CalculateBulletDamageForce( &dmgInfo, modinfo.m_iAmmoType, vecDir, tr.endpos );
-				dmgInfo.ScaleDamageForce( modinfo.m_flDamageForceScale );
-				dmgInfo.SetAmmoType( modinfo.m_iAmmoType );
-				dmgInfo.SetWeapon( pWeapon );
-				dmgInfo.SetDamageStats( modinfo.m_nFlags );
-				tr.m_pEnt->DispatchTraceAttack( dmgInfo, vecDir, &tr );
-			
-				if ( ToBaseCombatCharacter( tr.m_pEnt ) )
+			#ifdef GAME_DLL
+				UpdateShotStatistics( tr );
+
+				// For shots that don't need persistance
+				int soundEntChannel = ( segInfo.m_nFlags&FIRE_BULLETS_TEMPORARY_DANGER_SOUND ) ? SOUNDENT_CHANNEL_BULLET_IMPACT : SOUNDENT_CHANNEL_UNSPECIFIED;
+				CSoundEnt::InsertSound( SOUND_BULLET_IMPACT, tr.endpos, 200, 0.5, this, soundEntChannel );
+			#endif
+
+				// See if the bullet ended up underwater + started out of the water
+				if ( !bHitWater && ( enginetrace->GetPointContents( tr.endpos ) & (CONTENTS_WATER|CONTENTS_SLIME) ) )
+				{
+					bHitWater = HandleShotImpactingWater( segInfo, vecEnd, pTraceFilter, &vecTracerDest );
+				}
+
+				float flActualDamage = segInfo.m_iDamage;
+				
+				if ( tr.m_pEnt && tr.m_pEnt->IsPlayer() )
+				{
+					// If we hit a player set them as ignored for any possible next round of
+					// bullet firing so that they do not get "double penetrated" through multiple
+					// hitboxes
+					segInfo.m_pAdditionalIgnoreEnt = tr.m_pEnt;
+				}
+
+				int nActualDamageType = nDamageType;
+				if ( flActualDamage == 0.0 )
+				{
+					flActualDamage = g_pGameRules->GetAmmoDamage( pAttacker, tr.m_pEnt, segInfo.m_iAmmoType );
+				}
+				else
 				{
-					flCumulativeDamage += dmgInfo.GetDamage();
+					nActualDamageType = nDamageType | ((flActualDamage > 16) ? DMG_ALWAYSGIB : DMG_NEVERGIB );
 				}
 
-				// Do our impact effect
-				if ( bStartedInWater || !bHitWater || (modinfo.m_nFlags & FIRE_BULLETS_ALLOW_WATER_SURFACE_IMPACTS) )
+				if ( tr.m_pEnt && (!bHitWater || ((segInfo.m_nFlags & FIRE_BULLETS_DONT_HIT_UNDERWATER) == 0)) )
 				{
-					surfacedata_t *psurf = physprops->GetSurfaceData( tr.surface.surfaceProps );
-					if ( psurf && psurf->game.material == CHAR_TEX_GLASS )
+					// Damage specified by function parameter
+					CTakeDamageInfo dmgInfo( this, pAttacker, flActualDamage, nActualDamageType );
+					CalculateBulletDamageForce( &dmgInfo, segInfo.m_iAmmoType, vecDir, tr.endpos );
+					dmgInfo.ScaleDamageForce( segInfo.m_flDamageForceScale );
+					dmgInfo.SetAmmoType( segInfo.m_iAmmoType );
+					dmgInfo.SetWeapon( pWeapon );
+					dmgInfo.SetDamageStats( segInfo.m_nFlags );
+					tr.m_pEnt->DispatchTraceAttack( dmgInfo, vecDir, &tr );
+				
+					if ( ToBaseCombatCharacter( tr.m_pEnt ) )
 					{
-						// We'll handle the impact decal in HandleBulletPenetration(...)
-						// to determine if we show bullet proof or penetrated decals on glass
+						flCumulativeDamage += dmgInfo.GetDamage();
 					}
-					else
-					{
-						DoImpactEffect( tr, nDamageType );
 
-						if ( psurf && (psurf->game.material == CHAR_TEX_WOOD || psurf->game.material == CHAR_TEX_TILE || psurf->game.material == CHAR_TEX_CONCRETE ||
-									   psurf->game.material == CHAR_TEX_COMPUTER || psurf->game.material == CHAR_TEX_PLASTIC) )
+					// Do our impact effect
+					if ( bStartedInWater || !bHitWater || (segInfo.m_nFlags & FIRE_BULLETS_ALLOW_WATER_SURFACE_IMPACTS) )
+					{
+						surfacedata_t *psurf = physprops->GetSurfaceData( tr.surface.surfaceProps );
+						if ( psurf && psurf->game.material == CHAR_TEX_GLASS )
+						{
+							// We'll handle the impact decal in HandleBulletPenetration(...)
+							// to determine if we show bullet proof or penetrated decals on glass
+						}
+						else
 						{
-							DispatchParticleEffect( "ge_impact_add", tr.endpos + tr.plane.normal, vec3_angle );
+							DoImpactEffect( tr, nDamageType );
+
+							if ( psurf && (psurf->game.material == CHAR_TEX_WOOD || psurf->game.material == CHAR_TEX_TILE || psurf->game.material == CHAR_TEX_CONCRETE ||
+										   psurf->game.material == CHAR_TEX_COMPUTER || psurf->game.material == CHAR_TEX_PLASTIC) )
+							{
+								DispatchParticleEffect( "ge_impact_add", tr.endpos + tr.plane.normal, vec3_angle );
+							}
 						}
 					}
+					else
+					{
+						// We may not impact, but we DO need to affect ragdolls on the client
+						CEffectData data;
+						data.m_vStart = tr.startpos;
+						data.m_vOrigin = tr.endpos;
+						data.m_nDamageType = nDamageType;
+						
+						DispatchEffect( "RagdollImpact", data );
+					}
 				}
-				else
+			}
+
+			// Create a tracer, penetrated shots only get a tracer if they started with one
+			if ( segInfo.m_nFlags & FIRE_BULLETS_PENETRATED_SHOT )
+			{
+				if ( segInfo.m_nFlags & FIRE_BULLETS_FORCE_TRACER )
 				{
-					// We may not impact, but we DO need to affect ragdolls on the client
-					CEffectData data;
-					data.m_vStart = tr.startpos;
-					data.m_vOrigin = tr.endpos;
-					data.m_nDamageType = nDamageType;
-					
-					DispatchEffect( "RagdollImpact", data );
+					trace_t Tracer;
+					Tracer = tr;
+					Tracer.endpos = vecTracerDest;
+
+					MakeTracer( segInfo.m_vecSrc, Tracer, pAmmoDef->TracerType(segInfo.m_iAmmoType) );
 				}
 			}
-		}
-
-		// Create a tracer, penetrated shots only get a tracer if they started with one
-		if ( modinfo.m_nFlags & FIRE_BULLETS_PENETRATED_SHOT )
-		{
-			if ( modinfo.m_nFlags & FIRE_BULLETS_FORCE_TRACER )
+			else if ( ( segInfo.m_iTracerFreq != 0 ) && ( (pWeapon ? pWeapon->GetNextTracerCount() : gpGlobals->tickcount + iShot) % segInfo.m_iTracerFreq ) == 0 )
 			{
+				Vector vecTracerSrc = vec3_origin;
+				ComputeTracerStartPosition( segInfo.m_vecSrc, &vecTracerSrc );
+
 				trace_t Tracer;
 				Tracer = tr;
 				Tracer.endpos = vecTracerDest;
+				// Make sure any penetrated shots get a tracer
+				segInfo.m_nFlags = segInfo.m_nFlags | FIRE_BULLETS_FORCE_TRACER;
 
-				MakeTracer( modinfo.m_vecSrc, Tracer, pAmmoDef->TracerType(modinfo.m_iAmmoType) );
+				MakeTracer( vecTracerSrc, Tracer, pAmmoDef->TracerType(segInfo.m_iAmmoType) );
 			}
-		}
-		else if ( ( modinfo.m_iTracerFreq != 0 ) && ( tracerCount++ % modinfo.m_iTracerFreq ) == 0 )
-		{
-			Vector vecTracerSrc = vec3_origin;
-			ComputeTracerStartPosition( modinfo.m_vecSrc, &vecTracerSrc );
-
-			trace_t Tracer;
-			Tracer = tr;
-			Tracer.endpos = vecTracerDest;
-			// Make sure any penetrated shots get a tracer
-			modinfo.m_nFlags = modinfo.m_nFlags | FIRE_BULLETS_FORCE_TRACER;
 
-			MakeTracer( vecTracerSrc, Tracer, pAmmoDef->TracerType(modinfo.m_iAmmoType) );
-		}
+			// Do bullet penetration if applicable, the last segment never gets the chance
+			FireBulletsInfo_t *pNextInfo = &refireInfo[ iSegment & 1 ];
+			bool bPenetrated = iSegment + 1 < MAX_BULLET_SEGMENTS && HandleBulletPenetration( pWeapon, segInfo, tr, vecDir, pTraceFilter, ctx, *pNextInfo );
 
-		// Do bullet penetration if applicable
-		HandleBulletPenetration( pWeapon, modinfo, tr, vecDir, &traceFilter );
-
-	#ifdef GAME_DLL
-		// Per bullet damage!
-		ApplyMultiDamage();
+		#ifdef GAME_DLL
+			// Per bullet damage!
+			ApplyMultiDamage();
 
-		if ( IsPlayer() && flCumulativeDamage > 0.0f )
-		{
-			CBasePlayer *pPlayer = static_cast< CBasePlayer * >( this );
-			if ( pWeapon )
+			if ( IsPlayer() && flCumulativeDamage > 0.0f )
 			{
-				CTakeDamageInfo dmgInfo( this, pAttacker, flCumulativeDamage, nDamageType );
-				dmgInfo.SetWeapon( pWeapon );
-				gamestats->Event_WeaponHit( pPlayer, true, pWeapon->GetClassname(), dmgInfo );
+				CBasePlayer *pPlayer = static_cast< CBasePlayer * >( this );
+				if ( pWeapon )
+				{
+					CTakeDamageInfo dmgInfo( this, pAttacker, flCumulativeDamage, nDamageType );
+					dmgInfo.SetWeapon( pWeapon );
+					gamestats->Event_WeaponHit( pPlayer, true, pWeapon->GetClassname(), dmgInfo );
+				}
+
+				flCumulativeDamage = 0.0f;
 			}
+		#endif
 
-			flCumulativeDamage = 0.0f;
-		}
-	#endif
+			if ( !bPenetrated )
+				break;
 
-		iSeed++;
+			pInfo = pNextInfo;
+		}
 	} // end fire bullets loop
 }
 
@@ -627,25 +809,18 @@ inline const Vector CBaseEntity::ApplySpreadGauss(const Vector &vecSpread, const
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: Handle bullet penetrations
+// Purpose: Handle bullet penetrations, fills in refireInfo and returns true
+//			if the bullet should continue on from the other side
 //-----------------------------------------------------------------------------
 #ifdef GAME_DLL
 ConVar ge_debug_penetration( "ge_debug_penetration", "0", FCVAR_GAMEDLL | FCVAR_CHEAT );
 #endif
-void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter )
+bool CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &refireInfo )
 {
 	// Store the index of bullet proof glass for future use
 	static int sBPGlassSurfaceIdx = physprops->GetSurfaceIndex( "bulletproof_glass" );
-	static int recurse_index = 0;
-
-	if ( !(info.m_nFlags & FIRE_BULLETS_PENETRATED_SHOT) )
-		recurse_index = 0;
-
-	// Protect against infinite recursion!
-	if ( ++recurse_index >= 8 )
-		return;
 
-	FireBulletsInfo_t refireInfo;
+	refireInfo = FireBulletsInfo_t();
 	surfacedata_t *psurf = physprops->GetSurfaceData( tr.surface.surfaceProps );
 
 #ifdef GAME_DLL
@@ -666,7 +841,7 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 			DoImpactEffect( tr, DMG_BULLET );
 		}
 
-		return;
+		return false;
 	}
 
 	// Check if we have hit glass so we can do proper effects
@@ -674,20 +849,19 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 	// unless it is bullet-proof (handled above)
 	if ( psurf && psurf->game.material == CHAR_TEX_GLASS )
 	{
-		refireInfo = info;
-		refireInfo.m_nFlags |= FIRE_BULLETS_PENETRATED_SHOT;
-		HandleShotImpactingGlass( refireInfo, tr, vecDir, pTraceFilter );
-		return;
+		FireBulletsInfo_t glassInfo = info;
+		glassInfo.m_nFlags |= FIRE_BULLETS_PENETRATED_SHOT;
+		return HandleShotImpactingGlass( glassInfo, tr, vecDir, pTraceFilter, ctx, refireInfo );
 	}
 
 	// We are done if we can't penetrate further than 1 unit
 	if ( info.m_flPenetrateDepth < 1.0f )
-		return;
+		return false;
 
 	// Also give up if trace is from outside world.
 #ifdef GAME_DLL
 	if (engine->GetClusterForOrigin(tr.endpos) == -1)
-		return;
+		return false;
 #endif
 
 	//Entities get penetrated twice as far.
@@ -700,7 +874,7 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 
 	trace_t	passTrace;
 	// Re-trace as if the bullet had passed right through
-	UTIL_TraceLine( testPos, tr.endpos, MASK_SHOT, pTraceFilter, &passTrace );
+	ctx.TraceLine( testPos, tr.endpos, pTraceFilter, &passTrace );
 
 	float depth = info.m_flPenetrateDepth * (1.0 - passTrace.fraction);
 
@@ -711,7 +885,7 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 		if (passTrace.DidHitNonWorldEntity() && passTrace.m_pEnt != tr.m_pEnt)
 			refireInfo.m_flPenetrateDepth = 0;
 		else // If we ended up inside the world or the entity we hit with the first trace there's no point in hitting it again.
-			return;
+			return false;
 	}
 	else
 		refireInfo.m_flPenetrateDepth = info.m_flPenetrateDepth - depth;
@@ -745,7 +919,7 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 	}
 #endif
 
-	// Refire the round, as if starting from behind the glass
+	// Continue the round from the other side of the object
 	refireInfo.m_iShots			= 1;
 	refireInfo.m_vecSrc			= passTrace.endpos;
 	refireInfo.m_vecDirShooting = vecDir;
@@ -757,17 +931,16 @@ void CBaseEntity::HandleBulletPenetration( CBaseCombatWeapon *pWeapon, const Fir
 	refireInfo.m_pAttacker		= info.m_pAttacker ? info.m_pAttacker : this;
 	refireInfo.m_nFlags			= info.m_nFlags | FIRE_BULLETS_PENETRATED_SHOT;
 
-	// Refire the shot from the other side of the object
-	FireBullets( refireInfo );
+	return true;
 }
 
 #define	MAX_GLASS_PENETRATION_DEPTH	16.0f
 //-----------------------------------------------------------------------------
-// Specific handling of glass impacts
+// Specific handling of glass impacts, fills in behindGlassInfo and returns true
+// if the bullet should continue on from behind the glass
 //-----------------------------------------------------------------------------
-void CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter)
+bool CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &behindGlassInfo)
 {
-	static int sBPGlassSurfaceIdx = physprops->GetSurfaceIndex("bulletproof_glass");
 	// Move through the glass until we're at the other side
 	Vector	testPos = tr.endpos + (vecDir * MAX_GLASS_PENETRATION_DEPTH);
 
@@ -779,14 +952,14 @@ void CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_
 	DispatchEffect("GlassImpact", data);
 
 	trace_t	penetrationTrace;
-	FireBulletsInfo_t behindGlassInfo;
+	behindGlassInfo = FireBulletsInfo_t();
 
 	// Re-trace as if the bullet had passed right through
-	UTIL_TraceLine(testPos, tr.endpos, MASK_SHOT, pTraceFilter, &penetrationTrace);
+	ctx.TraceLine(testPos, tr.endpos, pTraceFilter, &penetrationTrace);
 
 	// We somehow didn't hit anything, ragequit.
 	if (penetrationTrace.fraction == 1.0f)
-		return;
+		return false;
 
 	// We got stuck inside of something
 	if (penetrationTrace.startsolid || tr.fraction == 0.0f)
@@ -795,7 +968,7 @@ void CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_
 		if (penetrationTrace.DidHitWorld())
 		{
 			DoImpactEffect(tr, DMG_BULLET);
-			return;
+			return false;
 		}
 
 		// We got stuck inside an entity, ignore it and keep going.
@@ -825,7 +998,7 @@ void CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_
 	}
 #endif
 
-	// Refire the round, as if starting from behind the glass
+	// Continue the round, as if starting from behind the glass
 	behindGlassInfo.m_iShots = 1;
 	behindGlassInfo.m_vecSrc = penetrationTrace.endpos;
 	behindGlassInfo.m_vecDirShooting = vecDir;
@@ -838,9 +1011,58 @@ void CBaseEntity::HandleShotImpactingGlass(const FireBulletsInfo_t &info, trace_
 	behindGlassInfo.m_nFlags = info.m_nFlags;
 	behindGlassInfo.m_flPenetrateDepth = info.m_flPenetrateDepth;
 
-	FireBullets( behindGlassInfo );
+	return true;
 }
 
+#ifdef GAME_DLL
+CON_COMMAND_F( ge_bullet_benchmark, "Fires scripted volleys from your active weapon and reports traces and time per shot.\nUsage: ge_bullet_benchmark [volleys] [pellets]", FCVAR_CHEAT )
+{
+	CGEPlayer *pPlayer = ToGEPlayer( UTIL_GetCommandClient() );
+	if ( !pPlayer )
+		return;
+
+	CGEWeapon *pWeapon = ToGEWeapon( pPlayer->GetActiveWeapon() );
+	if ( !pWeapon )
+	{
+		Msg( "You need an active weapon to run the bullet benchmark\n" );
+		return;
+	}
+
+	int volleys = args.ArgC() > 1 ? clamp( atoi( args[1] ), 1, 10000 ) : 100;
+	int pellets = args.ArgC() > 2 ? clamp( atoi( args[2] ), 1, 64 ) : ( pWeapon->IsShotgun() ? 5 : 1 );
+
+	Vector vecSrc = pPlayer->Weapon_ShootPosition();
+	Vector vecAim;
+	pPlayer->EyeVectors( &vecAim );
+
+	// Every volley uses the same spread and seed so runs can be compared against each other
+	FireBulletsInfo_t info( pellets, vecSrc, vecAim, pWeapon->GetBulletSpread(), MAX_TRACE_LENGTH, pWeapon->GetPrimaryAmmoType() );
+	info.m_iGaussFactor = pWeapon->GetGaussFactor();
+	info.m_iTracerFreq = 0;
+	info.m_pAttacker = pPlayer;
+	info.m_flPenetrateDepth = max( MIN_PENETRATION_DEPTH, pWeapon->GetMaxPenetrationDepth() );
+
+	GEBulletStats_t stats;
+	memset( &stats, 0, sizeof(stats) );
+
+	CFastTimer timer;
+	timer.Start();
+
+	// Skip the player's own FireBullets so we don't lag compensate or record stats outside of a user command
+	for ( int i=0; i < volleys; i++ )
+		pPlayer->CBaseEntity::FireBullets( info, &stats );
+
+	timer.End();
+
+	float usPerVolley = timer.GetDuration().GetMicrosecondsF() / volleys;
+
+	Msg( "Bullet benchmark: %i volleys of %i pellets, broad phase %s\n", volleys, pellets, ge_bullet_broadphase.GetBool() ? "on" : "off" );
+	Msg( "  %0.2f traces per shot, %0.2f per pellet (%i against the shared list, %i missed it)\n", 
+		stats.iTraces / (float) volleys, stats.iTraces / (float) stats.iPellets, stats.iListTraces, stats.iListMisses );
+	Msg( "  %0.2f us per shot, %0.2f us per pellet\n", usPerVolley, usPerVolley / pellets );
+}
+#endif
+
 bool CGEPlayer::Weapon_Switch( CBaseCombatWeapon *pWeapon, int viewmodelindex /*= GE_RIGHT_HAND*/ )
 {
 	if ( !pWeapon )
@@ -27,6 +27,9 @@
 #define MAX_ENTITY_NAME 32
 #define MAX_MODEL_PATH	512
 
+// Number of gameplay progress bars the HUD can show at once
+#define GE_HUD_NUMPROGRESSBARS 8
+
 #define GES_AUTH_URL		"http://update.geshl2.com/gesauth.txt"
 #define GES_VERSION_URL		"http://update.geshl2.com/gesupdate.txt"
 
@@ -461,14 +464,6 @@ extern bool GetAwardSort( int id );
 #define GE_GOLDACH 5
 
 #ifdef GAME_DLL
-extern CUtlVector<unsigned int> vDevsHash;
-extern CUtlVector<unsigned int> vTestersHash;
-extern CUtlVector<unsigned int> vContributorsHash;
-extern CUtlVector<unsigned int> vBannedHash;
-
-extern CUtlVector<unsigned int> vSkinsHash;
-extern CUtlVector<uint64> vSkinsValues;
-
 extern int iAwardEventCode; // Code for giving special event rewards.
 extern uint64 iAllowedClientSkins;
 extern int iAlertCode; // Code for giving special event rewards.
@@ -524,9 +519,13 @@ static const unsigned int _vTestersHash[] = {
 };
 
 void InitStatusLists( void );
-void UpdateStatusLists( const char *data );
+// Web request callback, builds a new generation of the lists on the loader thread
+void OnStatusListsLoaded( const char *result, const char *error );
+// Makes the newest loaded generation live, returns false if nothing new was loaded
+bool SwapStatusLists( void );
 
 bool IsOnList( int listnum, const unsigned int hash );
+bool GetListSkins( const unsigned int hash, uint64 &skins );
 #endif
 
 // Gameplay Tips Type
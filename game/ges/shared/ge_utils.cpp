@@ -33,97 +33,56 @@ void GEUTIL_EncryptICE( unsigned char * buffer, int size, const unsigned char *k
 	IceKey ice( 0 ); // level 0 = 64bit (8B) key
 	ice.set( key ); // set key
 
-	int blockSize = ice.blockSize();
-
-	unsigned char *temp = (unsigned char *)_alloca( PAD_NUMBER( size, blockSize ) );
-	unsigned char *p1 = buffer;
-	unsigned char *p2 = temp;
-
-	// encrypt data in 8 byte blocks
-	int bytesLeft = size;
-
-	while ( bytesLeft >= blockSize )
-	{
-		ice.encrypt( p1, p2 );
-
-		bytesLeft -= blockSize;
-		p1+=blockSize;
-		p2+=blockSize;
-	}
-
-	// copy encrypted data back to original buffer
-	Q_memcpy( buffer, temp, size-bytesLeft );
+	// encrypt data in 8 byte blocks, any tail is left as is
+	ice.encryptBlocks( buffer, buffer, size / ice.blockSize() );
 }
 
-bool GEUTIL_DEncryptFile(const char* filename, const unsigned char* key, bool bEncrypt = true, bool bChangeExt = false)
+bool GEUTIL_DEncryptBuffer( CUtlBuffer &buf, const unsigned char *key, bool bEncrypt /*= true*/ )
 {
-	//Open up the file and load it into memory!
-	FileHandle_t fileHandle = filesystem->Open( filename, "rb", "MOD" );
-	if(!fileHandle)
+	if ( !key || buf.IsReadOnly() )
 		return false;
 
-	// load file into a null-terminated buffer
-	int fileSize = filesystem->Size(fileHandle);
-
-	unsigned char *pBuff; // Holds the input
-	unsigned char *pOutBuff; //Holds the output goodies
-
-	// allocate memory to contain the whole file.
-	pBuff = (unsigned char*) malloc (fileSize);
-	pOutBuff = (unsigned char*) malloc (fileSize);
-
-	if (pBuff == NULL || pOutBuff == NULL)
-	{
-		filesystem->Close( fileHandle );
-        return false;
-	}
-
-	// copy the file into the buffer.
-	filesystem->Read( pBuff, fileSize, fileHandle ); // read into local buffer
-	
-	//clean the output buffer
-	memset( pOutBuff, NULL, fileSize );
-
-	filesystem->Close( fileHandle );
-
-	//Lets start the ice goodies!
 	IceKey ice( 0 ); // level 0 = 64bit (8B) key
-	ice.set( key ); // set key
+	ice.set( key );
 
-	int blockSize = ice.blockSize();
+	// The end chunk doesn't get an encryption, same as the files we have out there
+	unsigned char *pData = (unsigned char*) buf.Base();
+	int blocks = buf.TellPut() / ice.blockSize();
 
-	unsigned char *p1 = pBuff;
-	unsigned char *p2 = pOutBuff;
-
-	// encrypt data in 8 byte blocks
-	int bytesLeft = fileSize;
+	if ( bEncrypt )
+		ice.encryptBlocks( pData, pData, blocks );
+	else
+		ice.decryptBlocks( pData, pData, blocks );
 
-	while ( bytesLeft >= blockSize )
-	{
-		if ( bEncrypt )
-			ice.encrypt( p1, p2 );
-		else
-			ice.decrypt( p1, p2 );
+	return true;
+}
 
-		bytesLeft -= blockSize;
-		p1+=blockSize;
-		p2+=blockSize;
-	}
+bool GEUTIL_ReadEncryptedFile( const char *filename, const char *pathID, const unsigned char *key, CUtlBuffer &buf )
+{
+	if ( !filesystem->ReadFile( filename, pathID, buf ) )
+		return false;
 
-	//The end chunk doesn't get an encryption?  that sux...
-	memcpy( p2, p1, bytesLeft );
+	return GEUTIL_DEncryptBuffer( buf, key, false );
+}
 
-	fileHandle = filesystem->Open( filename, "wb", "MOD" );
-	if ( !fileHandle )
+bool GEUTIL_WriteEncryptedFile( const char *filename, const char *pathID, const unsigned char *key, CUtlBuffer &buf )
+{
+	if ( !GEUTIL_DEncryptBuffer( buf, key, true ) )
 		return false;
 
-	filesystem->Write( pOutBuff, fileSize, fileHandle );
-	filesystem->Close( fileHandle );
+	return filesystem->WriteFile( filename, pathID, buf );
+}
+
+bool GEUTIL_DEncryptFile(const char* filename, const unsigned char* key, bool bEncrypt = true, bool bChangeExt = false)
+{
+	CUtlBuffer buf;
+	if ( !filesystem->ReadFile( filename, "MOD", buf ) )
+		return false;
 
-	free(pBuff);
-	free(pOutBuff);
+	if ( !GEUTIL_DEncryptBuffer( buf, key, bEncrypt ) )
+		return false;
 
-	return true;
+	return filesystem->WriteFile( filename, "MOD", buf );
 }
 
 void GEUTIL_OverrideCommand( const char *real_name, const char *new_name, const char *override_name, const char *override_desc /* = "" */ )
@@ -756,144 +715,288 @@ unsigned int RSHash(const char *str)
 }
 
 #ifdef GAME_DLL
-bool IsOnList( int listnum, const unsigned int hash )
+// Open addressing set of Steam ID hashes with linear probing. Each member carries a
+// 64 bit value that is OR'd together on repeat inserts, which is how authed skins
+// for several weapons end up in a single bitfield.
+class CGEStatusHashSet
 {
-	switch ( listnum ) {
-	case LIST_DEVELOPERS:
-		return vDevsHash.Find(hash) != -1;
-	case LIST_TESTERS:
-		return vTestersHash.Find(hash) != -1;
-	case LIST_CONTRIBUTORS:
-		return vContributorsHash.Find(hash) != -1;
-	case LIST_SKINS:
-		return vSkinsHash.Find(hash) != -1;
-	case LIST_BANNED:
-		return vBannedHash.Find(hash) != -1;
+public:
+	CGEStatusHashSet() { m_iCount = 0; }
+
+	void Insert( unsigned int hash, uint64 value = 0 )
+	{
+		// HASHLIST_END marks our empty slots so it can never be a member
+		if ( hash == HASHLIST_END )
+			return;
+
+		// Keep the table at most half full so probe chains stay short
+		if ( (m_iCount + 1) * 2 > m_Slots.Count() )
+			Grow();
+
+		int i = Probe( hash );
+		if ( m_Slots[i].hash == HASHLIST_END )
+		{
+			m_Slots[i].hash = hash;
+			m_Slots[i].value = 0;
+			m_iCount++;
+		}
+
+		m_Slots[i].value |= value;
 	}
 
-	return false;
+	bool Find( unsigned int hash, uint64 *pValue = NULL ) const
+	{
+		if ( m_iCount == 0 || hash == HASHLIST_END )
+			return false;
+
+		int i = Probe( hash );
+		if ( m_Slots[i].hash == HASHLIST_END )
+			return false;
+
+		if ( pValue )
+			*pValue = m_Slots[i].value;
+
+		return true;
+	}
+
+	int Count() const { return m_iCount; }
+
+private:
+	// Returns the slot holding hash, or the empty slot it would go in
+	int Probe( unsigned int hash ) const
+	{
+		unsigned int mask = m_Slots.Count() - 1;
+		unsigned int i = ((hash ^ (hash >> 16)) * 0x45d9f3bu) & mask;
+
+		while ( m_Slots[i].hash != HASHLIST_END && m_Slots[i].hash != hash )
+			i = (i + 1) & mask;
+
+		return i;
+	}
+
+	void Grow()
+	{
+		CUtlVector<Slot_t> old;
+		old.Swap( m_Slots );
+
+		// Capacity is always a power of two so we can mask instead of mod
+		m_Slots.SetCount( max( 64, old.Count() * 2 ) );
+		for ( int i=0; i < m_Slots.Count(); i++ )
+			m_Slots[i].hash = HASHLIST_END;
+
+		for ( int i=0; i < old.Count(); i++ )
+		{
+			if ( old[i].hash != HASHLIST_END )
+				m_Slots[ Probe( old[i].hash ) ] = old[i];
+		}
+	}
+
+	struct Slot_t
+	{
+		unsigned int hash;
+		uint64 value;
+	};
+
+	CUtlVector<Slot_t> m_Slots;
+	int m_iCount;
+};
+
+// One generation of the status lists. Generations are built in full (off the main thread
+// when they come from the auth feed) and never modified once they go live.
+struct GEStatusLists_t
+{
+	GEStatusLists_t()
+	{
+		bHasEventCode = bHasAllowedSkins = bHasAlertCode = bHasVotekickThresh = false;
+		iAwardEventCode = iAlertCode = iVotekickThresh = 0;
+		iAllowedClientSkins = 0;
+	}
+
+	CGEStatusHashSet lists[LIST_BANNED+1];
+
+	// Feed values that get copied into the globals when this generation is swapped in
+	bool bHasEventCode, bHasAllowedSkins, bHasAlertCode, bHasVotekickThresh;
+	int iAwardEventCode;
+	uint64 iAllowedClientSkins;
+	int iAlertCode;
+	int iVotekickThresh;
+};
+
+// Live generation, only ever touched on the main thread
+static GEStatusLists_t *s_pStatusLists = NULL;
+// Generation handed over by the loader thread, waiting for SwapStatusLists
+static GEStatusLists_t * volatile s_pPendingStatusLists = NULL;
+
+bool IsOnList( int listnum, const unsigned int hash )
+{
+	if ( !s_pStatusLists || listnum < LIST_DEVELOPERS || listnum > LIST_BANNED )
+		return false;
+
+	return s_pStatusLists->lists[listnum].Find( hash );
 }
 
-// These are extern'd in shareddefs.h
-CUtlVector<unsigned int> vDevsHash;
-CUtlVector<unsigned int> vTestersHash;
-CUtlVector<unsigned int> vContributorsHash;
-CUtlVector<unsigned int> vBannedHash;
+bool GetListSkins( const unsigned int hash, uint64 &skins )
+{
+	if ( !s_pStatusLists )
+		return false;
 
-CUtlVector<unsigned int> vSkinsHash;
-CUtlVector<uint64> vSkinsValues;
+	return s_pStatusLists->lists[LIST_SKINS].Find( hash, &skins );
+}
 
 int iAwardEventCode = 0;
 uint64 iAllowedClientSkins = 0;
 int iAlertCode = 31; // bit 1 = worry about spread, bit 2 = non-srand based GERandom, bit 3 = seed srand uniquely, bit 4 = votekick, bit 5 = namechange kick, bit 6 = martial law.  May we never use this one.
 int iVotekickThresh = 70;
 
-void InitStatusLists( void )
+// Every generation starts out with our hardcoded developers and testers
+static GEStatusLists_t *CreateStatusLists( void )
 {
-	int i = 0;
-	while ( _vDevsHash[i] != HASHLIST_END )
-	{
-		vDevsHash.AddToTail( _vDevsHash[i] );
-		i++;
-	}
+	GEStatusLists_t *pLists = new GEStatusLists_t;
 
-	i = 0;
-	while ( _vTestersHash[i] != HASHLIST_END )
-	{
-		vTestersHash.AddToTail( _vTestersHash[i] );
-		i++;
-	}
+	for ( int i=0; _vDevsHash[i] != HASHLIST_END; i++ )
+		pLists->lists[LIST_DEVELOPERS].Insert( _vDevsHash[i] );
+
+	for ( int i=0; _vTestersHash[i] != HASHLIST_END; i++ )
+		pLists->lists[LIST_TESTERS].Insert( _vTestersHash[i] );
+
+	return pLists;
 }
 
-extern ConVar ge_alertcodeoverride;
+void InitStatusLists( void )
+{
+	delete s_pStatusLists;
+	s_pStatusLists = CreateStatusLists();
+}
 
-void UpdateStatusLists( const char *data )
+// Parses the auth feed into a new generation, safe to call from any thread
+static GEStatusLists_t *BuildStatusLists( const char *data )
 {
 	KeyValues *kv = new KeyValues("hashes");
 	if ( !kv->LoadFromBuffer( "hashes", data ) )
 	{
 		Warning( "Failed Status Check: KeyValues Corrupted!\n" );
 		kv->deleteThis();
-		return;
+		return NULL;
 	}
 
-	// Parse Developers
-	KeyValues *hash = kv->GetFirstSubKey();
-	while ( hash )
+	GEStatusLists_t *pLists = CreateStatusLists();
+
+	for ( KeyValues *hash = kv->GetFirstSubKey(); hash; hash = hash->GetNextKey() )
 	{
+		const char *name = hash->GetName();
 		unsigned int uHash = strtoul( hash->GetString(), NULL, 0 );
-		
-		if ( !Q_stricmp("dev", hash->GetName()) )
+
+		if ( !Q_stricmp("dev", name) )
 		{
-			if ( vDevsHash.Find( uHash ) == -1 )
-				vDevsHash.AddToTail( uHash );
+			pLists->lists[LIST_DEVELOPERS].Insert( uHash );
 		}
-		else if ( !Q_stricmp("bt", hash->GetName()) )
+		else if ( !Q_stricmp("bt", name) )
 		{
-			if ( vTestersHash.Find( uHash ) == -1 )
-				vTestersHash.AddToTail( uHash );
+			pLists->lists[LIST_TESTERS].Insert( uHash );
 		}
-		else if ( !Q_stricmp("cont", hash->GetName()) )
+		else if ( !Q_stricmp("cont", name) )
 		{
-			if ( vContributorsHash.Find( uHash ) == -1 )
-				vContributorsHash.AddToTail( uHash );
+			pLists->lists[LIST_CONTRIBUTORS].Insert( uHash );
 		}
-		else if ( !Q_stricmp("ban", hash->GetName()) )
+		else if ( !Q_stricmp("ban", name) )
 		{
-			if ( vBannedHash.Find( uHash ) == -1 )
-				vBannedHash.AddToTail( uHash );
+			pLists->lists[LIST_BANNED].Insert( uHash );
 		}
 		// Format is skin_x_y where x is the weapon to be skinned and y is the skin value of that weapon.
-		else if ( !Q_strnicmp("skin_", hash->GetName(), 5) )
+		else if ( !Q_strnicmp("skin_", name, 5) )
 		{
-			CUtlVector <char*> skindata;
-			Q_SplitString(hash->GetName(), "_", skindata);
+			const char *skin = Q_strstr( name + 5, "_" );
 
-			if (skindata.Count() > 2)
+			if ( skin )
 			{
-				uint64 skinvalue = atoi(skindata[2]); // Have to transfer it here so we have a 64 bit value to shift.
-				uint64 bits = skinvalue << (atoi(skindata[1]) * 2); //2 bits per weapon.  
-
-				int plIndex = vSkinsHash.Find(uHash);
+				uint64 skinvalue = atoi( skin + 1 ); // Have to transfer it here so we have a 64 bit value to shift.
+				uint64 bits = skinvalue << (atoi( name + 5 ) * 2); //2 bits per weapon.
 
-				if (plIndex == -1) // We have no skins registered yet.
-				{
-					vSkinsHash.AddToTail(uHash);
-					vSkinsValues.AddToTail(bits);
-				}
-				else // We already have a skin so we need to adjust our bitflags.
-				{
-					uint64 newbits = vSkinsValues[plIndex] | bits; //Bitwise OR to combine our bitflags. 100 | 010 = 110
-					vSkinsValues[plIndex] = newbits;
-				}
+				// Repeat entries for the same player OR their bitflags together
+				pLists->lists[LIST_SKINS].Insert( uHash, bits );
 			}
 			else
-				Warning("Error parsing skin auth %s, Please bother E-S\n", hash->GetName());
-
-			skindata.PurgeAndDeleteElements();
+				Warning("Error parsing skin auth %s, Please bother E-S\n", name);
 		}
-		else if (!Q_stricmp("event_code", hash->GetName()))
+		else if (!Q_stricmp("event_code", name))
 		{
-			iAwardEventCode = uHash; //Not really a hash this time but oh well.
+			pLists->iAwardEventCode = uHash; //Not really a hash this time but oh well.
+			pLists->bHasEventCode = true;
 		}
-		else if (!Q_stricmp("allowed_skins", hash->GetName()))
+		else if (!Q_stricmp("allowed_skins", name))
 		{
-			iAllowedClientSkins = strtoull(hash->GetString(), NULL, 0); //Need to get the long long of the hash this time.
+			pLists->iAllowedClientSkins = strtoull(hash->GetString(), NULL, 0); //Need to get the long long of the hash this time.
+			pLists->bHasAllowedSkins = true;
 		}
-		else if (!Q_stricmp( "alert_code", hash->GetName() ))
+		else if (!Q_stricmp( "alert_code", name ))
 		{
-			if (ge_alertcodeoverride.GetInt() < 0)
-				iAlertCode = uHash;
+			pLists->iAlertCode = uHash;
+			pLists->bHasAlertCode = true;
 		}
-		else if (!Q_stricmp("vote_percent", hash->GetName()))
+		else if (!Q_stricmp("vote_percent", name))
 		{
-			iVotekickThresh = uHash;
+			pLists->iVotekickThresh = uHash;
+			pLists->bHasVotekickThresh = true;
 		}
-
-		hash = hash->GetNextKey();
 	}
 
 	kv->deleteThis();
+	return pLists;
+}
+
+void OnStatusListsLoaded( const char *result, const char *error )
+{
+	if ( (error && error[0] != '\0') || !result )
+		return;
+
+	GEStatusLists_t *pLists = BuildStatusLists( result );
+	if ( !pLists )
+		return;
+
+	// Publish for the main thread, if an older load was never picked up it is stale now
+	GEStatusLists_t *pOld = (GEStatusLists_t*) ThreadInterlockedExchangePointer( (void * volatile *) &s_pPendingStatusLists, pLists );
+	delete pOld;
+}
+
+extern ConVar ge_alertcodeoverride;
+
+bool SwapStatusLists( void )
+{
+	GEStatusLists_t *pLists = (GEStatusLists_t*) ThreadInterlockedExchangePointer( (void * volatile *) &s_pPendingStatusLists, NULL );
+	if ( !pLists )
+		return false;
+
+	if ( pLists->bHasEventCode )
+		iAwardEventCode = pLists->iAwardEventCode;
+	if ( pLists->bHasAllowedSkins )
+		iAllowedClientSkins = pLists->iAllowedClientSkins;
+	if ( pLists->bHasAlertCode && ge_alertcodeoverride.GetInt() < 0 )
+		iAlertCode = pLists->iAlertCode;
+	if ( pLists->bHasVotekickThresh )
+		iVotekickThresh = pLists->iVotekickThresh;
+
+	// Lookups only happen on the main thread so the old generation has no readers left
+	delete s_pStatusLists;
+	s_pStatusLists = pLists;
+
+	return true;
+}
+
+CON_COMMAND( ge_statuslists, "Prints the number of entries on each auth status list" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	if ( !s_pStatusLists )
+	{
+		Msg( "Status lists have not been initialized\n" );
+		return;
+	}
+
+	Msg( "Status lists: %i developers, %i testers, %i contributors, %i skins, %i banned\n",
+		s_pStatusLists->lists[LIST_DEVELOPERS].Count(), s_pStatusLists->lists[LIST_TESTERS].Count(),
+		s_pStatusLists->lists[LIST_CONTRIBUTORS].Count(), s_pStatusLists->lists[LIST_SKINS].Count(),
+		s_pStatusLists->lists[LIST_BANNED].Count() );
 }
 #endif
 
@@ -12,6 +12,7 @@
 
 #include "mathlib/IceKey.H"
 #include "filesystem.h"
+#include "utlbuffer.h"
 
 // Convience function to iterate over a CUtlDict
 #define FOR_EACH_DICT( dictName, iterName ) \
@@ -21,6 +22,13 @@
 void GEUTIL_EncryptICE( unsigned char * buffer, int size, const unsigned char *key );
 bool GEUTIL_DEncryptFile(const char* filename, const unsigned char* key, bool bEncrypt = true, bool bChangeExt = false);
 
+// Encrypt/Decrypt the contents of a buffer in memory, the data is changed in place
+bool GEUTIL_DEncryptBuffer( CUtlBuffer &buf, const unsigned char *key, bool bEncrypt = true );
+// Read an encrypted file straight into a decrypted buffer, nothing is written back to disk
+bool GEUTIL_ReadEncryptedFile( const char *filename, const char *pathID, const unsigned char *key, CUtlBuffer &buf );
+// Encrypts buf in place and writes it out in one go
+bool GEUTIL_WriteEncryptedFile( const char *filename, const char *pathID, const unsigned char *key, CUtlBuffer &buf );
+
 // Get the secret hash we use for encryption
 const unsigned char *GEUTIL_GetSecretHash();
 
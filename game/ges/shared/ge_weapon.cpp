@@ -113,6 +113,7 @@ CGEWeapon::CGEWeapon()
 
 	m_flSmokeRate = m_flLastShotTime = 0;
 	m_iShotsFired = 0;
+	m_iTracerCount = 0;
 
 #ifdef GAME_DLL
 	m_flDeployTime = 0.0f;
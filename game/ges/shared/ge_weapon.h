@@ -100,6 +100,7 @@ public:
 	virtual int				GetGaussFactor( void );
 	virtual float			GetFireDelay( void );
 	virtual int				GetTracerFreq( void ) { return GetGEWpnData().m_iTracerFreq; };
+	int						GetNextTracerCount( void ) { return m_iTracerCount++; }
 	virtual const char*		GetSpecAttString(void) { return GetGEWpnData().m_szSpecialAttributes; };
 
 	virtual int		GetDamageCap(void) { return GetGEWpnData().m_iDamageCap; };
@@ -187,6 +188,9 @@ protected:
 	int				m_iShotsFired;
 	float			m_flLastShotTime;
 
+	// Bullets fired since we were created, decides which ones get a tracer
+	int				m_iTracerCount;
+
 private:
 #ifdef GAME_DLL
 	void SetEnableGlow( bool state );
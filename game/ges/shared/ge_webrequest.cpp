@@ -3,7 +3,8 @@
 // File: ge_webrequest.h
 // Description:
 //      Initializes a web request in an asynchronous thread calling a defined
-//      callback when the load is finished for processing
+//      callback when the load is finished for processing. Addresses without
+//      a scheme are read from the mod directory instead.
 //
 // Created On: 09 Oct 2011
 // Created By: Jonathan White <killermonkey> 
@@ -11,6 +12,7 @@
 
 #include "cbase.h"
 #include "ge_webrequest.h"
+#include "filesystem.h"
 
 #pragma warning( disable : 4005 )
 #include "curl.h"
@@ -59,7 +61,8 @@ void CGEWebRequest::Destroy()
 size_t CGEWebRequest::WriteData( void *ptr, size_t size, size_t nmemb, void *userdata )
 {
 	CUtlBuffer *result = (CUtlBuffer*) userdata;
-	result->PutString( (char*)ptr );
+	// Chunks are not null terminated, Run terminates the whole result once we are done
+	result->Put( ptr, size * nmemb );
 	return size * nmemb;
 }
 
@@ -68,8 +71,13 @@ int CGEWebRequest::Run()
 	CURL *curl;
 	CURLcode res;
 
-	curl = curl_easy_init();
-	if ( curl )
+	// Anything that isn't a url is a file in the mod directory, used to test without the web
+	if ( !Q_strstr( m_pAddress, "://" ) )
+	{
+		if ( !filesystem->ReadFile( m_pAddress, "MOD", m_Result ) )
+			Q_snprintf( m_pError, CURL_ERROR_SIZE, "Failed to read %s", m_pAddress );
+	}
+	else if ( (curl = curl_easy_init()) != NULL )
 	{
 		curl_easy_setopt( curl, CURLOPT_URL, m_pAddress );
 		curl_easy_setopt( curl, CURLOPT_WRITEDATA, &m_Result );
@@ -88,12 +96,12 @@ int CGEWebRequest::Run()
 		Q_strncpy( m_pError, "Failed to start CURL", CURL_ERROR_SIZE );
 	}
 
-	m_bFinished = true;
-	return 0;
-}
+	m_Result.PutChar( '\0' );
 
-void CGEWebRequest::OnExit()
-{
+	// Run the callback before we report finished so whoever polls us can't destroy us mid call
 	if ( m_pCallback )
-		m_pCallback( (char*) m_Result.Base(), m_pError );
+		m_pCallback( GetResult(), m_pError );
+
+	m_bFinished = true;
+	return 0;
 }
\ No newline at end of file
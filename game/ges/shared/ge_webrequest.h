@@ -3,7 +3,8 @@
 // File: ge_webrequest.h
 // Description:
 //      Initializes a web request in an asynchronous thread calling a defined
-//      callback when the load is finished for processing
+//      callback when the load is finished for processing. Addresses without
+//      a scheme are read from the mod directory instead.
 //
 // Created On: 09 Oct 2011
 // Created By: Jonathan White <killermonkey> 
@@ -35,7 +36,6 @@ protected:
 	static size_t WriteData( void *ptr, size_t size, size_t nmemb, void *userdata );
 
 	virtual int Run();
-	virtual void OnExit();
 
 	bool m_bFinished;
 
@@ -41,8 +41,11 @@
 	#include "ge_tokenmanager.h"
 	#include "ge_loadoutmanager.h"
 	#include "ge_mapmanager.h"
+	#include "ge_setuprecord.h"
+	#include "ge_spawngrid.h"
 	#include "ge_stats_recorder.h"
 	#include "ge_bot.h"
+	#include "ge_benchmark.h"
 
 	#include "ge_triggers.h"
 	#include "ge_door.h"
@@ -482,6 +485,9 @@ CGEMPRules::CGEMPRules()
 	m_pMapManager = new CGEMapManager;
 	m_pMapManager->ParseMapSelectionData();
 
+	// Create the spatial index used for spawn point selection
+	m_pSpawnGrid = new CGESpawnGrid;
+
 	// Figure out what day it is
 	//int day, month, year;
 	//GetCurrentDate(&day, &month, &year);
@@ -522,6 +528,7 @@ CGEMPRules::~CGEMPRules()
 	g_Teams.Purge();
 	delete m_pLoadoutManager;
 	delete m_pTokenManager;
+	delete m_pSpawnGrid;
 
 	// These are deleted with the rest of the entities
 	g_pPlayerResource = NULL;
@@ -1064,6 +1071,8 @@ void CGEMPRules::FrameUpdatePreEntityThink()
 
 void CGEMPRules::Think()
 {
+	GE_BENCH_SCOPE( GEBENCH_GAMERULES );
+
 	BaseClass::Think();
 
 	// Let our gameplay think
@@ -1324,7 +1333,6 @@ void CGEMPRules::SetupChangeLevel( const char *next_level /*= NULL*/ )
 		CUtlVector<const char*> vModes;
 		CUtlVector<const char*> vWepnames;
 		CUtlVector<CGELoadout*> vWeapons;
-		char linebuffer[128];
 
 		GetMapManager()->GetRecentMaps(vMaps);
 		GEGameplay()->GetRecentModes(vModes);
@@ -1333,36 +1341,8 @@ void CGEMPRules::SetupChangeLevel( const char *next_level /*= NULL*/ )
 		for (int i = 0; i < vWeapons.Count(); i++)
 			vWepnames.AddToTail(vWeapons[i]->GetIdent());
 
-		FileHandle_t file = filesystem->Open("gamesetuprecord.txt", "w", "MOD");
-
-		if (file)
-		{
-			filesystem->Write("Maps:\n", V_strlen("Maps:\n"), file);
-			for (int i = 0; i < vMaps.Count(); i++)
-			{
-				Q_snprintf(linebuffer, 128, "%s\n", vMaps[i]);
-				filesystem->Write(linebuffer, V_strlen(linebuffer), file);
-			}
-			filesystem->Write("-\n", V_strlen("-\n"), file);
-
-			filesystem->Write("Modes:\n", V_strlen("Modes:\n"), file);
-			for (int i = 0; i < vModes.Count(); i++)
-			{
-				Q_snprintf(linebuffer, 128, "%s\n", vModes[i]);
-				filesystem->Write(linebuffer, V_strlen(linebuffer), file);
-			}
-			filesystem->Write("-\n", V_strlen("-\n"), file);
-
-			filesystem->Write("Weps:\n", V_strlen("Weps:\n"), file);
-			for (int i = 0; i < vWepnames.Count(); i++)
-			{
-				Q_snprintf(linebuffer, 128, "%s\n", vWepnames[i]);
-				filesystem->Write(linebuffer, V_strlen(linebuffer), file);
-			}
-			filesystem->Write("-\n", V_strlen("-\n"), file);
-
-			filesystem->Close(file);
-		}
+		// The next map's managers read this back from memory, the file is written in the background
+		GESetupRecord()->SetRecord(vMaps, vModes, vWepnames);
 	}
 
 	// Notify everyone
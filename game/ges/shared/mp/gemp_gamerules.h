@@ -24,6 +24,7 @@
 	class CGETokenManager;
 	class CGELoadoutManager;
 	class CGEMapManager;
+	class CGESpawnGrid;
 #endif
 
 class CGEGameTimer;
@@ -104,6 +105,7 @@ public:
 	CGELoadoutManager *GetLoadoutManager()  { return m_pLoadoutManager; }
 	CGETokenManager   *GetTokenManager()	{ return m_pTokenManager;	}
 	CGEMapManager	  *GetMapManager()		{ return m_pMapManager; }
+	CGESpawnGrid	  *GetSpawnGrid()		{ return m_pSpawnGrid; }
 
 	int	  GetSpawnPointType( CGEPlayer *pPlayer );
 	float GetSpeedMultiplier( CGEPlayer *pPlayer );
@@ -231,6 +233,7 @@ private:
 	CGELoadoutManager	*m_pLoadoutManager;
 	CGETokenManager		*m_pTokenManager;
 	CGEMapManager		*m_pMapManager;
+	CGESpawnGrid		*m_pSpawnGrid;
 
 	ConVar				*m_pAllTalkVar;
 
@@ -395,7 +395,7 @@ void CWeaponRemoteMine::PrimaryAttack( void )
 
 #ifdef GAME_DLL
 		int minesblown = 0;
-		CGEMine *pMine = static_cast<CGEMine*>(gEntList.FindEntityByClassname( NULL, "npc_mine_remote" ));
+		CGEMine *pMine = static_cast<CGEMine*>(gEntList.NextEntByClassname( NULL, "npc_mine_remote" ));
 		while ( pMine != NULL)
 		{
 			if ( pMine->GetThrower() == GetOwner() )
@@ -403,7 +403,7 @@ void CWeaponRemoteMine::PrimaryAttack( void )
 				g_EventQueue.AddEvent( pMine, "Explode", 0.30, GetOwner(), pMine );
 				minesblown++;
 			}
-			pMine = static_cast<CGEMine*>(gEntList.FindEntityByClassname( pMine, "npc_mine_remote" ));
+			pMine = static_cast<CGEMine*>(gEntList.NextEntByClassname( pMine, "npc_mine_remote" ));
 		}
 
 		// if we actually blew something up send us to our mines again so we can start throwing!
@@ -476,7 +476,7 @@ void CWeaponRemoteMine::ItemPreFrame( void )
 
 #ifdef GAME_DLL
 		int detonated = 0;
-		CGEMine *pMine = (CGEMine*) gEntList.FindEntityByClassname( NULL, "npc_mine_remote" );
+		CGEMine *pMine = (CGEMine*) gEntList.NextEntByClassname( NULL, "npc_mine_remote" );
 		while ( pMine )
 		{
 			if ( !pMine->m_bPreExplode && pMine->GetThrower() == GetOwner() )
@@ -486,7 +486,7 @@ void CWeaponRemoteMine::ItemPreFrame( void )
 				detonated++;
 			}
 
-			pMine = (CGEMine*) gEntList.FindEntityByClassname( pMine, "npc_mine_remote" );
+			pMine = (CGEMine*) gEntList.NextEntByClassname( pMine, "npc_mine_remote" );
 		}
 
 		
@@ -57,6 +57,10 @@ class C_BaseCombatCharacter;
 class CEntityMapData;
 class ConVar;
 class C_BaseCombatWeapon;
+#ifdef GE_DLL
+class CGEBulletContext;
+struct GEBulletStats_t;
+#endif
 
 struct CSoundParameters;
 
@@ -191,13 +195,17 @@ public:
 	
 	// FireBullets uses shared code for prediction.
 	virtual void					FireBullets( const FireBulletsInfo_t &info );
+#ifdef GE_DLL
+	// Counts traces into pStats, for benchmarking
+	void							FireBullets( const FireBulletsInfo_t &info, GEBulletStats_t *pStats );
+#endif
 	virtual bool					ShouldDrawUnderwaterBulletBubbles();
 	virtual bool					ShouldDrawWaterImpacts( void ) { return true; }
 #ifdef GE_DLL
 	// Base this so it can be used by NPC's as well
-	virtual void					HandleBulletPenetration( C_BaseCombatWeapon *pBaseWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter );
+	virtual bool					HandleBulletPenetration( C_BaseCombatWeapon *pBaseWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &refireInfo );
 	inline const Vector				ApplySpreadGauss(const Vector &vecSpread, const Vector &vecShotDir, int gfactor, int pseed);
-	virtual void					HandleShotImpactingGlass( const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter );
+	virtual bool					HandleShotImpactingGlass( const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &behindGlassInfo );
 #endif
 	virtual bool					HandleShotImpactingWater( const FireBulletsInfo_t &info, 
 		const Vector &vecEnd, ITraceFilter *pTraceFilter, Vector *pVecTracerDest );
@@ -11366,10 +11366,6 @@ CAI_BaseNPC::CAI_BaseNPC(void)
 	m_bInChoreo = true; // assume so until call to UpdateEfficiency()
 	
 	SetCollisionGroup( COLLISION_GROUP_NPC );
-
-#ifdef GE_DLL
-	m_LagTrack = new CUtlFixedLinkedList< LagRecordNPC >();
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -11379,11 +11375,6 @@ CAI_BaseNPC::CAI_BaseNPC(void)
 //-----------------------------------------------------------------------------
 CAI_BaseNPC::~CAI_BaseNPC(void)
 {
-#ifdef GE_DLL
-	m_LagTrack->Purge();
-	delete m_LagTrack;
-#endif
-
 	g_AI_Manager.RemoveAI( this );
 
 	delete m_pLockedBestSound;
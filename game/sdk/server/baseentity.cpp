@@ -530,6 +530,9 @@ CBaseEntity *CBaseEntity::GetFollowedEntity()
 void CBaseEntity::SetClassname( const char *className )
 {
 	m_iClassname = AllocPooledString( className );
+#ifdef GE_DLL
+	gEntList.UpdateClassnameIndex( this );
+#endif
 }
 
 // position to shoot at
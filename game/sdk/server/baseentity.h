@@ -78,6 +78,10 @@ class CEventAction;
 typedef struct KeyValueData_s KeyValueData;
 class CUserCmd;
 class CSkyCamera;
+#ifdef GE_DLL
+class CGEBulletContext;
+struct GEBulletStats_t;
+#endif
 class CEntityMapData;
 
 typedef CUtlVector< CBaseEntity* > EntityList_t;
@@ -1039,6 +1043,10 @@ public:
 	virtual void MakeTracer( const Vector &vecTracerSrc, const trace_t &tr, int iTracerType );
 	virtual int	GetTracerAttachment( void );
 	virtual void FireBullets( const FireBulletsInfo_t &info );
+#ifdef GE_DLL
+	// Counts traces into pStats, for benchmarking
+	void FireBullets( const FireBulletsInfo_t &info, GEBulletStats_t *pStats );
+#endif
 	virtual void DoImpactEffect( trace_t &tr, int nDamageType ); // give shooter a chance to do a custom impact.
 
 	// OLD VERSION! Use the struct version
@@ -1536,7 +1544,7 @@ protected:
 
 #ifdef GE_DLL
 	// Base this so it can be used by NPC's as well
-	virtual void HandleBulletPenetration( CBaseCombatWeapon *pBaseWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter );
+	virtual bool HandleBulletPenetration( CBaseCombatWeapon *pBaseWeapon, const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &refireInfo );
 
 	inline const Vector ApplySpreadGauss(const Vector &vecSpread, const Vector &vecShotDir, int gfactor, int pseed);
 #endif
@@ -1545,7 +1553,11 @@ protected:
 	bool HandleShotImpactingWater( const FireBulletsInfo_t &info, const Vector &vecEnd, ITraceFilter *pTraceFilter, Vector *pVecTracerDest );
 
 	// Handle shot entering water
+#ifdef GE_DLL
+	virtual bool HandleShotImpactingGlass( const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter, CGEBulletContext &ctx, FireBulletsInfo_t &behindGlassInfo );
+#else
 	virtual void HandleShotImpactingGlass( const FireBulletsInfo_t &info, trace_t &tr, const Vector &vecDir, ITraceFilter *pTraceFilter );
+#endif
 
 	// Should we draw bubbles underwater?
 	bool ShouldDrawUnderwaterBulletBubbles();
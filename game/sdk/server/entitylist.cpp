@@ -327,6 +327,14 @@ CGlobalEntityList::CGlobalEntityList()
 {
 	m_iHighestEnt = m_iNumEnts = m_iNumEdicts = 0;
 	m_bClearingEntities = false;
+
+#ifdef GE_DLL
+	for ( int i=0; i < NUM_ENT_ENTRIES; i++ )
+	{
+		m_iClassBucket[i] = m_iClassNext[i] = m_iClassPrev[i] = -1;
+		m_iszClassIndexed[i] = NULL_STRING;
+	}
+#endif
 }
 
 
@@ -541,6 +549,147 @@ CBaseEntity *CGlobalEntityList::FindEntityByClassname( CBaseEntity *pStartEntity
 	return NULL;
 }
 
+#ifdef GE_DLL
+//-----------------------------------------------------------------------------
+// Classname index
+//-----------------------------------------------------------------------------
+void CGlobalEntityList::LinkClassname( CBaseEntity *pEnt, int entry )
+{
+	string_t iszClass = pEnt->m_iClassname;
+	m_iszClassIndexed[entry] = iszClass;
+
+	if ( iszClass == NULL_STRING )
+		return;
+
+	int bucket = m_ClassBuckets.Find( STRING(iszClass) );
+	if ( bucket == m_ClassBuckets.InvalidIndex() )
+	{
+		bucket = m_ClassBuckets.Insert( STRING(iszClass) );
+		m_ClassBuckets[bucket].iHead = m_ClassBuckets[bucket].iTail = -1;
+	}
+
+	ClassBucket_t &list = m_ClassBuckets[bucket];
+
+	m_iClassBucket[entry] = bucket;
+	m_iClassNext[entry] = -1;
+	m_iClassPrev[entry] = list.iTail;
+
+	if ( list.iTail != -1 )
+		m_iClassNext[list.iTail] = entry;
+	else
+		list.iHead = entry;
+
+	list.iTail = entry;
+}
+
+void CGlobalEntityList::UnlinkClassname( int entry )
+{
+	int bucket = m_iClassBucket[entry];
+	m_iszClassIndexed[entry] = NULL_STRING;
+
+	if ( bucket == -1 )
+		return;
+
+	ClassBucket_t &list = m_ClassBuckets[bucket];
+
+	if ( m_iClassPrev[entry] != -1 )
+		m_iClassNext[ m_iClassPrev[entry] ] = m_iClassNext[entry];
+	else
+		list.iHead = m_iClassNext[entry];
+
+	if ( m_iClassNext[entry] != -1 )
+		m_iClassPrev[ m_iClassNext[entry] ] = m_iClassPrev[entry];
+	else
+		list.iTail = m_iClassPrev[entry];
+
+	m_iClassBucket[entry] = m_iClassNext[entry] = m_iClassPrev[entry] = -1;
+}
+
+void CGlobalEntityList::UpdateClassnameIndex( CBaseEntity *pEnt )
+{
+	// Not in the list yet, OnAddEntity will take care of it
+	const CBaseHandle &handle = pEnt->GetRefEHandle();
+	if ( handle == INVALID_EHANDLE_INDEX || LookupEntity( handle ) != pEnt )
+		return;
+
+	int entry = handle.GetEntryIndex();
+	if ( m_iszClassIndexed[entry] == pEnt->m_iClassname )
+		return;
+
+	UnlinkClassname( entry );
+	LinkClassname( pEnt, entry );
+}
+
+// Buckets are sorted by name so everything matching a wildcard prefix is contiguous
+int CGlobalEntityList::FirstClassBucket( const char *szName, int prefixLen )
+{
+	if ( prefixLen < 0 )
+		return m_ClassBuckets.Find( szName );
+
+	for ( int i = m_ClassBuckets.First(); i != m_ClassBuckets.InvalidIndex(); i = m_ClassBuckets.Next(i) )
+	{
+		if ( !Q_strnicmp( m_ClassBuckets.GetElementName(i), szName, prefixLen ) )
+			return i;
+	}
+
+	return m_ClassBuckets.InvalidIndex();
+}
+
+int CGlobalEntityList::NextClassBucket( int bucket, const char *szName, int prefixLen )
+{
+	if ( prefixLen < 0 )
+		return m_ClassBuckets.InvalidIndex();
+
+	bucket = m_ClassBuckets.Next( bucket );
+	if ( bucket != m_ClassBuckets.InvalidIndex() && !Q_strnicmp( m_ClassBuckets.GetElementName(bucket), szName, prefixLen ) )
+		return bucket;
+
+	return m_ClassBuckets.InvalidIndex();
+}
+
+CBaseEntity *CGlobalEntityList::NextEntByClassname( CBaseEntity *pCurrentEnt, const char *szName )
+{
+	// Anything after the first '*' is ignored, same as CBaseEntity::ClassMatches
+	const char *pWildcard = Q_strstr( szName, "*" );
+	int prefixLen = pWildcard ? pWildcard - szName : -1;
+
+	int bucket, entry;
+	if ( pCurrentEnt )
+	{
+		int cur = pCurrentEnt->GetRefEHandle().GetEntryIndex();
+		bucket = m_iClassBucket[cur];
+		if ( bucket == -1 )
+			return NULL;
+
+		entry = m_iClassNext[cur];
+	}
+	else
+	{
+		bucket = FirstClassBucket( szName, prefixLen );
+		if ( bucket == m_ClassBuckets.InvalidIndex() )
+			return NULL;
+
+		entry = m_ClassBuckets[bucket].iHead;
+	}
+
+	while ( true )
+	{
+		for ( ; entry != -1; entry = m_iClassNext[entry] )
+		{
+			CBaseEntity *pEntity = (CBaseEntity *)GetEntInfoPtrByIndex( entry )->m_pEntity;
+			if ( pEntity && pEntity->ClassMatches( szName ) )
+				return pEntity;
+		}
+
+		bucket = NextClassBucket( bucket, szName, prefixLen );
+		if ( bucket == m_ClassBuckets.InvalidIndex() )
+			return NULL;
+
+		entry = m_ClassBuckets[bucket].iHead;
+	}
+}
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Purpose: Finds an entity given a procedural name.
@@ -1152,6 +1301,10 @@ void CGlobalEntityList::OnAddEntity( IHandleEntity *pEnt, CBaseHandle handle )
 	
 	// NOTE: Must be a CBaseEntity on server
 	Assert( pBaseEnt );
+
+#ifdef GE_DLL
+	LinkClassname( pBaseEnt, handle.GetEntryIndex() );
+#endif
 	//DevMsg(2,"Created %s\n", pBaseEnt->GetClassname() );
 	for ( i = m_entityListeners.Count()-1; i >= 0; i-- )
 	{
@@ -1182,6 +1335,10 @@ void CGlobalEntityList::OnRemoveEntity( IHandleEntity *pEnt, CBaseHandle handle
 	if ( pBaseEnt->edict() )
 		m_iNumEdicts--;
 
+#ifdef GE_DLL
+	UnlinkClassname( handle.GetEntryIndex() );
+#endif
+
 	m_iNumEnts--;
 }
 
@@ -1202,6 +1359,11 @@ void CGlobalEntityList::NotifySpawn( CBaseEntity *pEnt )
 	if ( !pEnt )
 		return;
 
+#ifdef GE_DLL
+	// Map keyvalues can overwrite the classname we were created with
+	UpdateClassnameIndex( pEnt );
+#endif
+
 	//DevMsg(2,"Deleted %s\n", pBaseEnt->GetClassname() );
 	for ( int i = m_entityListeners.Count()-1; i >= 0; i-- )
 	{
@@ -14,6 +14,9 @@
 #endif
 
 #include "baseentity.h"
+#ifdef GE_DLL
+#include "utldict.h"
+#endif
 
 class IEntityListener;
 
@@ -142,6 +145,16 @@ public:
 		return NULL;
 	}
 
+#ifdef GE_DLL
+	// returns the next entity after pCurrentEnt whose classname matches szName, if pCurrentEnt is NULL, return the first one
+	// Only walks the classname index so the cost depends on the number of matches, not the size of the entity list.
+	// Supports the same trailing '*' wildcard as FindEntityByClassname. Order is creation order within a classname.
+	CBaseEntity *NextEntByClassname( CBaseEntity *pCurrentEnt, const char *szName );
+
+	// Moves the entity to the index bucket of its current classname, called when m_iClassname changes
+	void UpdateClassnameIndex( CBaseEntity *pEnt );
+#endif
+
 	// search functions
 	bool		 IsEntityPtr( void *pTest );
 	CBaseEntity *FindEntityByClassname( CBaseEntity *pStartEntity, const char *szName );
@@ -177,6 +190,26 @@ protected:
 	virtual void OnAddEntity( IHandleEntity *pEnt, CBaseHandle handle );
 	virtual void OnRemoveEntity( IHandleEntity *pEnt, CBaseHandle handle );
 
+#ifdef GE_DLL
+private:
+	void LinkClassname( CBaseEntity *pEnt, int entry );
+	void UnlinkClassname( int entry );
+	int  FirstClassBucket( const char *szName, int prefixLen );
+	int  NextClassBucket( int bucket, const char *szName, int prefixLen );
+
+	struct ClassBucket_t
+	{
+		int iHead;
+		int iTail;
+	};
+
+	// Entities are linked into a bucket per classname, in creation order
+	CUtlDict<ClassBucket_t, int> m_ClassBuckets;
+	int		 m_iClassBucket[NUM_ENT_ENTRIES];	// -1 if the entry is not indexed
+	int		 m_iClassNext[NUM_ENT_ENTRIES];
+	int		 m_iClassPrev[NUM_ENT_ENTRIES];
+	string_t m_iszClassIndexed[NUM_ENT_ENTRIES];	// Classname the entry was bucketed under
+#endif
 };
 
 extern CGlobalEntityList gEntList;
@@ -71,6 +71,7 @@ public:
 	virtual int OnTakeDamage( const CTakeDamageInfo &inputInfo );
 	// GE_DLL
 	virtual bool WantsLagCompensationOnEntity( const CBaseEntity *pPlayer, const CUserCmd *pCmd, const CBitVec<MAX_EDICTS> *pEntityTransmitBits ) const;
+	int GetLastWeaponFireUsercmd( void ) const { return m_iLastWeaponFireUsercmd; }
 	virtual void FireBullets ( const FireBulletsInfo_t &info );
 	virtual bool Weapon_Switch( CBaseCombatWeapon *pWeapon, int viewmodelindex = 0);
 	virtual bool BumpWeapon( CBaseCombatWeapon *pWeapon );
@@ -10,13 +10,15 @@
 #include "igamesystem.h"
 #include "ilagcompensationmanager.h"
 #include "inetchannelinfo.h"
-#include "utllinkedlist.h"
 #include "BaseAnimatingOverlay.h"
 #include "tier0/vprof.h"
+#include "tier0/fasttimer.h"
 //GE_DLL
 #include "ai_basenpc.h"
 #include "ge_gamerules.h"
 #include "gebot_player.h"
+#include "filesystem.h"
+#include "utlbuffer.h"
 
 // memdbgon must be the last include file in a .cpp file!!!
 #include "tier0/memdbgon.h"
@@ -119,6 +121,222 @@ public:
 };
 
 
+// Records kept past sv_maxunlag so the oldest one can still be interpolated against
+#define LAG_TRACK_SLACK		2
+
+//-----------------------------------------------------------------------------
+// Purpose: Fixed capacity lag history for a single entity. Records live in a
+//			ring buffer with one array per field so searching by simulation time
+//			only ever touches the times. Allocated once, never on the usercmd path.
+//-----------------------------------------------------------------------------
+class CLagTrack
+{
+public:
+	CLagTrack()
+	{
+		m_iCapacity = 0;
+		m_flSimulationTime = NULL;
+		m_fFlags = NULL;
+		m_vecOrigin = NULL;
+		m_vecAngles = NULL;
+		m_vecMins = NULL;
+		m_vecMaxs = NULL;
+		m_masterSequence = NULL;
+		m_masterCycle = NULL;
+		m_layerRecords = NULL;
+		Clear();
+	}
+
+	~CLagTrack()
+	{
+		Free();
+	}
+
+	void Init( int capacity )
+	{
+		Free();
+
+		m_iCapacity = capacity;
+		m_flSimulationTime = new float[ capacity ];
+		m_fFlags = new int[ capacity ];
+		m_vecOrigin = new Vector[ capacity ];
+		m_vecAngles = new QAngle[ capacity ];
+		m_vecMins = new Vector[ capacity ];
+		m_vecMaxs = new Vector[ capacity ];
+		m_masterSequence = new int[ capacity ];
+		m_masterCycle = new float[ capacity ];
+		m_layerRecords = new LayerRecord[ capacity * MAX_LAYER_RECORDS ];
+
+		Clear();
+	}
+
+	void Free()
+	{
+		delete [] m_flSimulationTime;
+		delete [] m_fFlags;
+		delete [] m_vecOrigin;
+		delete [] m_vecAngles;
+		delete [] m_vecMins;
+		delete [] m_vecMaxs;
+		delete [] m_masterSequence;
+		delete [] m_masterCycle;
+		delete [] m_layerRecords;
+
+		m_iCapacity = 0;
+		m_flSimulationTime = NULL;
+		m_fFlags = NULL;
+		m_vecOrigin = NULL;
+		m_vecAngles = NULL;
+		m_vecMins = NULL;
+		m_vecMaxs = NULL;
+		m_masterSequence = NULL;
+		m_masterCycle = NULL;
+		m_layerRecords = NULL;
+		Clear();
+	}
+
+	void Clear()
+	{
+		m_iHead = -1;
+		m_iCount = 0;
+		m_iBreakDepth = -1;
+	}
+
+	int Count() const		{ return m_iCount; }
+	int Capacity() const	{ return m_iCapacity; }
+
+	// Storage slot of the i'th newest record (0 is the newest)
+	int Slot( int i ) const { return ( m_iHead - i + m_iCapacity ) % m_iCapacity; }
+
+	LayerRecord *GetLayers( int slot ) { return &m_layerRecords[ slot * MAX_LAYER_RECORDS ]; }
+
+	float GetNewestTime() const { return m_iCount > 0 ? m_flSimulationTime[ Slot(0) ] : -1; }
+
+	void Record( CBaseAnimatingOverlay *pEntity );
+	void RemoveOlderThan( float flDeadtime );
+	int  FindRecord( const Vector &vecCurOrigin, float flTargetTime ) const;
+
+	// Structure of arrays, indexed by Slot()
+	float			*m_flSimulationTime;
+	int				*m_fFlags;
+	Vector			*m_vecOrigin;
+	QAngle			*m_vecAngles;
+	Vector			*m_vecMins;
+	Vector			*m_vecMaxs;
+	int				*m_masterSequence;
+	float			*m_masterCycle;
+	LayerRecord		*m_layerRecords;	// MAX_LAYER_RECORDS per slot
+
+	// Who this history belongs to (NPC tracks are shared by edict index)
+	EHANDLE			m_hEntity;
+
+	// Scratchpad for the current usercmd
+	LagRecord		m_RestoreData;		// entity data before we moved it back
+	LagRecord		m_ChangeData;		// entity data where we moved it back
+
+private:
+	int m_iCapacity;
+	int m_iHead;
+	int m_iCount;
+
+	// Age of the newest record we can't walk past (death or teleport), -1 for none
+	int m_iBreakDepth;
+};
+
+void CLagTrack::Record( CBaseAnimatingOverlay *pEntity )
+{
+	Assert( m_iCapacity > 0 );
+
+	bool bAlive = pEntity->IsAlive();
+	const Vector &vecOrigin = pEntity->GetLocalOrigin();
+
+	// Work out how far back the history stays continuous now rather than on every backtrack
+	if ( !bAlive )
+		m_iBreakDepth = 0;
+	else if ( m_iCount > 0 && (m_vecOrigin[ Slot(0) ] - vecOrigin).LengthSqr() > LAG_COMPENSATION_TELEPORTED_DISTANCE_SQR )
+		m_iBreakDepth = 1;
+	else if ( m_iBreakDepth != -1 )
+		m_iBreakDepth++;
+
+	// Overwrite the oldest record once we are full
+	m_iHead = ( m_iHead + 1 ) % m_iCapacity;
+	m_iCount = min( m_iCount + 1, m_iCapacity );
+
+	if ( m_iBreakDepth >= m_iCount )
+		m_iBreakDepth = -1;
+
+	int slot = m_iHead;
+
+	m_fFlags[slot]				= bAlive ? LC_ALIVE : 0;
+	m_flSimulationTime[slot]	= pEntity->GetSimulationTime();
+	m_vecAngles[slot]			= pEntity->GetLocalAngles();
+	m_vecOrigin[slot]			= vecOrigin;
+	m_vecMaxs[slot]				= pEntity->WorldAlignMaxs();
+	m_vecMins[slot]				= pEntity->WorldAlignMins();
+
+	LayerRecord *layers = GetLayers( slot );
+	int layerCount = pEntity->GetNumAnimOverlays();
+	for( int layerIndex = 0; layerIndex < MAX_LAYER_RECORDS; ++layerIndex )
+	{
+		CAnimationLayer *currentLayer = layerIndex < layerCount ? pEntity->GetAnimOverlay(layerIndex) : NULL;
+		if( currentLayer )
+		{
+			layers[layerIndex].m_cycle = currentLayer->m_flCycle;
+			layers[layerIndex].m_order = currentLayer->m_nOrder;
+			layers[layerIndex].m_sequence = currentLayer->m_nSequence;
+			layers[layerIndex].m_weight = currentLayer->m_flWeight;
+		}
+		else
+		{
+			layers[layerIndex] = LayerRecord();
+		}
+	}
+	m_masterSequence[slot] = pEntity->GetSequence();
+	m_masterCycle[slot] = pEntity->GetCycle();
+}
+
+void CLagTrack::RemoveOlderThan( float flDeadtime )
+{
+	while ( m_iCount > 0 && m_flSimulationTime[ Slot(m_iCount - 1) ] < flDeadtime )
+		m_iCount--;
+
+	if ( m_iBreakDepth >= m_iCount )
+		m_iBreakDepth = -1;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Returns the age of the newest record at or before flTargetTime (or
+//			the oldest record we have), -1 if we lost track on the way there.
+//-----------------------------------------------------------------------------
+int CLagTrack::FindRecord( const Vector &vecCurOrigin, float flTargetTime ) const
+{
+	if ( m_iCount <= 0 )
+		return -1;
+
+	// Simulation times strictly decrease with age
+	int lo = 0, hi = m_iCount;
+	while ( lo < hi )
+	{
+		int mid = ( lo + hi ) / 2;
+		if ( m_flSimulationTime[ Slot(mid) ] <= flTargetTime )
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	if ( lo == m_iCount )
+		lo = m_iCount - 1;
+
+	// Entity must be alive and not teleport anywhere between now and then
+	if ( m_iBreakDepth != -1 && m_iBreakDepth <= lo )
+		return -1;
+
+	if ( (m_vecOrigin[ Slot(0) ] - vecCurOrigin).LengthSqr() > LAG_COMPENSATION_TELEPORTED_DISTANCE_SQR )
+		return -1;
+
+	return lo;
+}
+
 //
 // Try to take the player from his current origin to vWantedPos.
 // If it can't get there, leave the player where he is.
@@ -217,12 +435,18 @@ class CLagCompensationManager : public CAutoGameSystemPerFrame, public ILagCompe
 public:
 	CLagCompensationManager( char const *name ) : CAutoGameSystemPerFrame( name )
 	{
+#ifdef GE_DLL
+		memset( m_EntityTrack, 0, sizeof( m_EntityTrack ) );
+#endif
+		m_bRecording = false;
+		ResetStats();
 	}
 
 	// IServerSystem stuff
 	virtual void Shutdown()
 	{
 		ClearHistory();
+		FreeHistory();
 	}
 
 	virtual void LevelShutdownPostEntity()
@@ -239,34 +463,154 @@ public:
 	void			StartLagCompensation( CBasePlayer *player, CUserCmd *cmd );
 	void			FinishLagCompensation( CBasePlayer *player );
 
+	void			PrintStats();
+	void			ResetStats();
+
+	// Usercmd capture for sv_unlag_record, replayed by sv_unlag_replay in benchmark builds
+	void			StartRecording( const char *filename );
+	void			StopRecording();
+#ifdef GES_BENCHMARK
+	void			Replay( const char *filename, int iterations );
+#endif
+
 private:
+	void			StartLagCompensationInternal( CBasePlayer *player, CUserCmd *cmd );
+	void			FinishLagCompensationInternal( CBasePlayer *player );
+
+	void			BeginRestore( CBasePlayer *player );
+	void			BacktrackAll( CBasePlayer *player, CUserCmd *cmd, float latency, int lerpTicks );
+
 	void			BacktrackPlayer( CBasePlayer *player, float flTargetTime );
 #ifdef GE_DLL
 	void BacktrackEntity( CAI_BaseNPC *entity, float flTargetTime );
+	CLagTrack *GetEntityTrack( CAI_BaseNPC *pEntity, bool bCreate );
 #endif
 
 	void ClearHistory()
 	{
 		for ( int i=0; i<MAX_PLAYERS; i++ )
-			m_PlayerTrack[i].Purge();
+			m_PlayerTrack[i].Clear();
+#ifdef GE_DLL
+		for ( int i=0; i<MAX_EDICTS; i++ )
+		{
+			if ( m_EntityTrack[i] )
+				m_EntityTrack[i]->Clear();
+		}
+#endif
+	}
+
+	void FreeHistory()
+	{
+		for ( int i=0; i<MAX_PLAYERS; i++ )
+			m_PlayerTrack[i].Free();
+#ifdef GE_DLL
+		for ( int i=0; i<MAX_EDICTS; i++ )
+		{
+			delete m_EntityTrack[i];
+			m_EntityTrack[i] = NULL;
+		}
+#endif
 	}
 
-	// keep a list of lag records for each player
-	CUtlFixedLinkedList< LagRecord >	m_PlayerTrack[ MAX_PLAYERS ];
+	// keep a ring of lag records for each player
+	CLagTrack				m_PlayerTrack[ MAX_PLAYERS ];
 
 	// Scratchpad for determining what needs to be restored
 	CBitVec<MAX_PLAYERS>	m_RestorePlayer;
 	bool					m_bNeedToRestore;
-	
-	LagRecord				m_RestoreData[ MAX_PLAYERS ];	// player data before we moved him back
-	LagRecord				m_ChangeData[ MAX_PLAYERS ];	// player data where we moved him back
+
+#ifdef GE_DLL
+	// NPC history, allocated the first time an NPC shows up in each edict slot
+	CLagTrack				*m_EntityTrack[ MAX_EDICTS ];
+	CBitVec<MAX_EDICTS>		m_RestoreEntity;
+#endif
 
 	CBasePlayer				*m_pCurrentPlayer;	// The player we are doing lag compensation for
+
+	// Time spent in Start/FinishLagCompensation since the last sv_unlag_stats
+	CCycleCount				m_StartTime;
+	CCycleCount				m_FinishTime;
+	int						m_iStartCount;
+	int						m_iFinishCount;
+	int						m_iBacktrackCount;
+
+	// Everything StartLagCompensation reads from the command and the shooter, tick and
+	// weapon fire numbers are stored relative so they can be replayed on any server
+	struct ReplayCmd_t
+	{
+		int		iPlayer;
+		int		iTickDelta;
+		int		iFireAge;
+		int		iLerpTicks;
+		float	flLatency;
+		QAngle	viewangles;
+		int		buttons;
+	};
+
+	void			RecordCommand( CBasePlayer *player, CUserCmd *cmd, float latency, int lerpTicks );
+
+	CUtlVector<ReplayCmd_t>	m_ReplayCmds;
+	char					m_szRecordFile[MAX_PATH];
+	bool					m_bRecording;
 };
 
 static CLagCompensationManager g_LagCompensationManager( "CLagCompensationManager" );
 ILagCompensationManager *lagcompensation = &g_LagCompensationManager;
 
+CON_COMMAND( sv_unlag_stats, "Prints and resets the time spent in lag compensation" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	g_LagCompensationManager.PrintStats();
+	g_LagCompensationManager.ResetStats();
+}
+
+void CLagCompensationManager::ResetStats()
+{
+	m_StartTime.Init();
+	m_FinishTime.Init();
+	m_iStartCount = m_iFinishCount = m_iBacktrackCount = 0;
+}
+
+void CLagCompensationManager::PrintStats()
+{
+	int nAIs = 0;
+#ifdef GE_DLL
+	nAIs = g_AI_Manager.NumAIs();
+#endif
+
+	Msg( "Lag compensation: %i players, %i NPCs, %i history records per entity\n", gpGlobals->maxClients, nAIs, TIME_TO_TICKS( sv_maxunlag.GetFloat() ) + LAG_TRACK_SLACK );
+	Msg( "  Start:  %i calls, %0.3f ms total, %0.4f ms avg, %i entities backtracked\n", m_iStartCount, m_StartTime.GetMillisecondsF(),
+		m_iStartCount ? m_StartTime.GetMillisecondsF() / m_iStartCount : 0.0, m_iBacktrackCount );
+	Msg( "  Finish: %i calls, %0.3f ms total, %0.4f ms avg\n", m_iFinishCount, m_FinishTime.GetMillisecondsF(),
+		m_iFinishCount ? m_FinishTime.GetMillisecondsF() / m_iFinishCount : 0.0 );
+}
+
+#ifdef GE_DLL
+CLagTrack *CLagCompensationManager::GetEntityTrack( CAI_BaseNPC *pEntity, bool bCreate )
+{
+	int idx = pEntity->entindex();
+	if ( idx < 0 || idx >= MAX_EDICTS )
+		return NULL;
+
+	CLagTrack *track = m_EntityTrack[idx];
+	if ( !bCreate )
+		return ( track && track->m_hEntity.Get() == pEntity ) ? track : NULL;
+
+	if ( !track )
+		track = m_EntityTrack[idx] = new CLagTrack;
+
+	// Edict got reused, the old history means nothing to us
+	if ( track->m_hEntity.Get() != pEntity )
+	{
+		track->Clear();
+		track->m_hEntity = pEntity;
+	}
+
+	return track;
+}
+#endif
 
 //-----------------------------------------------------------------------------
 // Purpose: Called once per frame after all entities have had a chance to think
@@ -282,81 +626,36 @@ void CLagCompensationManager::FrameUpdatePostEntityThink()
 	VPROF_BUDGET( "FrameUpdatePostEntityThink", "CLagCompensationManager" );
 
 	// remove all records before that time:
-	int flDeadtime = gpGlobals->curtime - sv_maxunlag.GetFloat();
+	float flDeadtime = gpGlobals->curtime - sv_maxunlag.GetFloat();
+
+	// We never hold more than one record per tick
+	int capacity = TIME_TO_TICKS( sv_maxunlag.GetFloat() ) + LAG_TRACK_SLACK;
 
 	// Iterate all active players
 	for ( int i = 1; i <= gpGlobals->maxClients; i++ )
 	{
 		CBasePlayer *pPlayer = UTIL_PlayerByIndex( i );
 
-		CUtlFixedLinkedList< LagRecord > *track = &m_PlayerTrack[i-1];
+		CLagTrack *track = &m_PlayerTrack[i-1];
 
 		if ( !pPlayer )
 		{
-			if ( track->Count() > 0 )
-			{
-				track->RemoveAll();
-			}
-
+			track->Clear();
 			continue;
 		}
 
-		Assert( track->Count() < 1000 ); // insanity check
+		if ( track->Capacity() != capacity )
+			track->Init( capacity );
 
 		// remove tail records that are too old
-		int tailIndex = track->Tail();
-		while ( track->IsValidIndex( tailIndex ) )
-		{
-			LagRecord &tail = track->Element( tailIndex );
-
-			// if tail is within limits, stop
-			if ( tail.m_flSimulationTime >= flDeadtime )
-				break;
-			
-			// remove tail, get new tail
-			track->Remove( tailIndex );
-			tailIndex = track->Tail();
-		}
+		track->RemoveOlderThan( flDeadtime );
 
-		// check if head has same simulation time
-		if ( track->Count() > 0 )
-		{
-			LagRecord &head = track->Element( track->Head() );
-
-			// check if player changed simulation time since last time updated
-			if ( head.m_flSimulationTime >= pPlayer->GetSimulationTime() )
-				continue; // don't add new entry for same or older time
-		}
+		// check if player changed simulation time since last time updated
+		if ( track->Count() > 0 && track->GetNewestTime() >= pPlayer->GetSimulationTime() )
+			continue; // don't add new entry for same or older time
 
 		// add new record to player track
-		LagRecord &record = track->Element( track->AddToHead() );
-
-		record.m_fFlags = 0;
-		if ( pPlayer->IsAlive() )
-		{
-			record.m_fFlags |= LC_ALIVE;
-		}
-
-		record.m_flSimulationTime	= pPlayer->GetSimulationTime();
-		record.m_vecAngles			= pPlayer->GetLocalAngles();
-		record.m_vecOrigin			= pPlayer->GetLocalOrigin();
-		record.m_vecMaxs			= pPlayer->WorldAlignMaxs();
-		record.m_vecMins			= pPlayer->WorldAlignMins();
-
-		int layerCount = pPlayer->GetNumAnimOverlays();
-		for( int layerIndex = 0; layerIndex < layerCount; ++layerIndex )
-		{
-			CAnimationLayer *currentLayer = pPlayer->GetAnimOverlay(layerIndex);
-			if( currentLayer )
-			{
-				record.m_layerRecords[layerIndex].m_cycle = currentLayer->m_flCycle;
-				record.m_layerRecords[layerIndex].m_order = currentLayer->m_nOrder;
-				record.m_layerRecords[layerIndex].m_sequence = currentLayer->m_nSequence;
-				record.m_layerRecords[layerIndex].m_weight = currentLayer->m_flWeight;
-			}
-		}
-		record.m_masterSequence = pPlayer->GetSequence();
-		record.m_masterCycle = pPlayer->GetCycle();
+		track->Record( pPlayer );
 	}
 
 #ifdef GE_DLL
@@ -370,86 +669,52 @@ void CLagCompensationManager::FrameUpdatePostEntityThink()
 		if ( !pNPC )
 			continue;
  
-		CUtlFixedLinkedList< LagRecordNPC > *track = pNPC->GetLagTrack();
- 
-		Assert( track->Count() < 1000 ); // insanity check
- 
+		CLagTrack *track = GetEntityTrack( pNPC, true );
+		if ( !track )
+			continue;
+
+		if ( track->Capacity() != capacity )
+			track->Init( capacity );
+
 		// remove tail records that are too old
-		int tailIndex = track->Tail();
-		while ( track->IsValidIndex( tailIndex ) )
-		{
-			LagRecordNPC &tail = track->Element( tailIndex );
- 
-			// if tail is within limits, stop
-			if ( tail.m_flSimulationTime >= flDeadtime )
-				break;
- 
-			// remove tail, get new tail
-			track->Remove( tailIndex );
-			tailIndex = track->Tail();
-		}
+		track->RemoveOlderThan( flDeadtime );
  
-		// check if head has same simulation time
-		if ( track->Count() > 0 )
-		{
-			LagRecordNPC &head = track->Element( track->Head() );
- 
-			// check if entity changed simulation time since last time updated
-			if ( &head && head.m_flSimulationTime >= pNPC->GetSimulationTime() )
-				continue; // don't add new entry for same or older time
- 
-			// Simulation Time is set when an entity moves or rotates ...
-			// this error occurs when whatever entity it is that breaks it moves or rotates then, presumably?
-		}
+		// check if entity changed simulation time since last time updated
+		// Simulation Time is set when an entity moves or rotates ...
+		if ( track->Count() > 0 && track->GetNewestTime() >= pNPC->GetSimulationTime() )
+			continue; // don't add new entry for same or older time
  
 		// add new record to track
-		LagRecordNPC &record = track->Element( track->AddToHead() );
- 
-		record.m_fFlags = 0;
-		if ( pNPC->IsAlive() )
-		{
-			record.m_fFlags |= LC_ALIVE;
-		}
- 
-		record.m_flSimulationTime	= pNPC->GetSimulationTime();
-		record.m_vecAngles			= pNPC->GetLocalAngles();
-		record.m_vecOrigin			= pNPC->GetLocalOrigin();
-		record.m_vecMaxs			= pNPC->WorldAlignMaxs();
-		record.m_vecMins			= pNPC->WorldAlignMins();
- 
-		int layerCount = pNPC->GetNumAnimOverlays();
-		for( int layerIndex = 0; layerIndex < layerCount; ++layerIndex )
-		{
-			CAnimationLayer *currentLayer = pNPC->GetAnimOverlay(layerIndex);
-			if( currentLayer )
-			{
-				record.m_layerRecords[layerIndex].m_cycle = currentLayer->m_flCycle;
-				record.m_layerRecords[layerIndex].m_order = currentLayer->m_nOrder;
-				record.m_layerRecords[layerIndex].m_sequence = currentLayer->m_nSequence;
-				record.m_layerRecords[layerIndex].m_weight = currentLayer->m_flWeight;
-			}
-		}
-		record.m_masterSequence = pNPC->GetSequence();
-		record.m_masterCycle = pNPC->GetCycle();
+		track->Record( pNPC );
 	}
 #endif
 }
 
 // Called during player movement to set up/restore after lag compensation
 void CLagCompensationManager::StartLagCompensation( CBasePlayer *player, CUserCmd *cmd )
+{
+	m_iStartCount++;
+	CTimeAdder timer( &m_StartTime );
+
+	StartLagCompensationInternal( player, cmd );
+}
+
+void CLagCompensationManager::BeginRestore( CBasePlayer *player )
 {
 	// Assume no players need to be restored
 	m_RestorePlayer.ClearAll();
 #ifdef GE_DLL
-	int nAIs = g_AI_Manager.NumAIs();
-	CAI_BaseNPC **ppAIs = g_AI_Manager.AccessAIs();
-	for (int i=0; i<nAIs; i++)
-		ppAIs[ i ]->FlagForLagCompensation(false);
+	m_RestoreEntity.ClearAll();
 #endif
 
 	m_bNeedToRestore = false;
 
 	m_pCurrentPlayer = player;
+}
+
+void CLagCompensationManager::StartLagCompensationInternal( CBasePlayer *player, CUserCmd *cmd )
+{
+	BeginRestore( player );
 	
 	if ( !player->m_bLagCompensation		// Player not wanting lag compensation
 		 || (gpGlobals->maxClients <= 1)	// no lag compensation in single player
@@ -461,25 +726,32 @@ void CLagCompensationManager::StartLagCompensation( CBasePlayer *player, CUserCm
 
 	// NOTE: Put this here so that it won't show up in single player mode.
 	VPROF_BUDGET( "StartLagCompensation", VPROF_BUDGETGROUP_OTHER_NETWORKING );
-	Q_memset( m_RestoreData, 0, sizeof( m_RestoreData ) );
-	Q_memset( m_ChangeData, 0, sizeof( m_ChangeData ) );
 
 	// Get true latency
-
-	// correct is the amout of time we have to correct game time
-	float correct = 0.0f;
+	float latency = 0.0f;
 
 	INetChannelInfo *nci = engine->GetPlayerNetInfo( player->entindex() ); 
 
 	if ( nci )
 	{
 		// add network latency
-		correct+= nci->GetLatency( FLOW_OUTGOING );
+		latency = nci->GetLatency( FLOW_OUTGOING );
 	}
 
 	// calc number of view interpolation ticks - 1
 	int lerpTicks = TIME_TO_TICKS( player->m_fLerpTime );
 
+	if ( m_bRecording )
+		RecordCommand( player, cmd, latency, lerpTicks );
+
+	BacktrackAll( player, cmd, latency, lerpTicks );
+}
+
+void CLagCompensationManager::BacktrackAll( CBasePlayer *player, CUserCmd *cmd, float latency, int lerpTicks )
+{
+	// correct is the amout of time we have to correct game time
+	float correct = latency;
+
 	// add view interpolation latency see C_BaseEntity::GetInterpolationAmount()
 	correct += TICKS_TO_TIME( lerpTicks );
 	
@@ -525,6 +797,9 @@ void CLagCompensationManager::StartLagCompensation( CBasePlayer *player, CUserCm
 	}
 #ifdef GE_DLL
 	// also iterate all monsters
+	CAI_BaseNPC **ppAIs = g_AI_Manager.AccessAIs();
+	int nAIs = g_AI_Manager.NumAIs();
+
 	for ( int i = 0; i < nAIs; i++ )
 	{
 		CAI_BaseNPC *pNPC = ppAIs[i];
@@ -547,93 +822,50 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 	int pl_index = pPlayer->entindex() - 1;
 
 	// get track history of this player
-	CUtlFixedLinkedList< LagRecord > *track = &m_PlayerTrack[ pl_index ];
+	CLagTrack *track = &m_PlayerTrack[ pl_index ];
 
 	// check if we have at leat one entry
 	if ( track->Count() <= 0 )
 		return;
 
-	int curr = track->Head();
-
-	LagRecord *prevRecord = NULL;
-	LagRecord *record = NULL;
-
-	Vector prevOrg = pPlayer->GetLocalOrigin();
-	
-	// Walk context looking for any invalidating event
-	while( track->IsValidIndex(curr) )
-	{
-		// remember last record
-		prevRecord = record;
-
-		// get next record
-		record = &track->Element( curr );
-
-		if ( !(record->m_fFlags & LC_ALIVE) )
-		{
-			// player most be alive, lost track
-			return;
-		}
-
-		Vector delta = record->m_vecOrigin - prevOrg;
-		if ( delta.LengthSqr() > LAG_COMPENSATION_TELEPORTED_DISTANCE_SQR )
-		{
-			// lost track, too much difference
-			return; 
-		}
-
-		// did we find a context smaller than target time ?
-		if ( record->m_flSimulationTime <= flTargetTime )
-			break; // hurra, stop
-
-		prevOrg = record->m_vecOrigin;
-
-		// go one step back
-		curr = track->Next( curr );
-	}
+	// Find the record at our target time, the player must be alive and can't have teleported since
+	int age = track->FindRecord( pPlayer->GetLocalOrigin(), flTargetTime );
+	if ( age < 0 )
+		return; // lost track
 
-	Assert( record );
-
-	if ( !record )
-	{
-		if ( sv_unlag_debug.GetBool() )
-		{
-			DevMsg( "No valid positions in history for BacktrackPlayer client ( %s )\n", pPlayer->GetPlayerName() );
-		}
-
-		return; // that should never happen
-	}
+	int record = track->Slot( age );
+	int prevRecord = age > 0 ? track->Slot( age - 1 ) : -1;
 
 	float frac = 0.0f;
-	if ( prevRecord && 
-		 (record->m_flSimulationTime < flTargetTime) &&
-		 (record->m_flSimulationTime < prevRecord->m_flSimulationTime) )
+	if ( prevRecord != -1 && 
+		 (track->m_flSimulationTime[record] < flTargetTime) &&
+		 (track->m_flSimulationTime[record] < track->m_flSimulationTime[prevRecord]) )
 	{
 		// we didn't find the exact time but have a valid previous record
 		// so interpolate between these two records;
 
-		Assert( prevRecord->m_flSimulationTime > record->m_flSimulationTime );
-		Assert( flTargetTime < prevRecord->m_flSimulationTime );
+		Assert( track->m_flSimulationTime[prevRecord] > track->m_flSimulationTime[record] );
+		Assert( flTargetTime < track->m_flSimulationTime[prevRecord] );
 
 		// calc fraction between both records
-		frac = ( flTargetTime - record->m_flSimulationTime ) / 
-			( prevRecord->m_flSimulationTime - record->m_flSimulationTime );
+		frac = ( flTargetTime - track->m_flSimulationTime[record] ) / 
+			( track->m_flSimulationTime[prevRecord] - track->m_flSimulationTime[record] );
 
 		Assert( frac > 0 && frac < 1 ); // should never extrapolate
 
-		ang  = Lerp( frac, record->m_vecAngles, prevRecord->m_vecAngles );
-		org  = Lerp( frac, record->m_vecOrigin, prevRecord->m_vecOrigin  );
-		mins = Lerp( frac, record->m_vecMins, prevRecord->m_vecMins  );
-		maxs = Lerp( frac, record->m_vecMaxs, prevRecord->m_vecMaxs );
+		ang  = Lerp( frac, track->m_vecAngles[record], track->m_vecAngles[prevRecord] );
+		org  = Lerp( frac, track->m_vecOrigin[record], track->m_vecOrigin[prevRecord]  );
+		mins = Lerp( frac, track->m_vecMins[record], track->m_vecMins[prevRecord]  );
+		maxs = Lerp( frac, track->m_vecMaxs[record], track->m_vecMaxs[prevRecord] );
 	}
 	else
 	{
 		// we found the exact record or no other record to interpolate with
 		// just copy these values since they are the best we have
-		ang  = record->m_vecAngles;
-		org  = record->m_vecOrigin;
-		mins = record->m_vecMins;
-		maxs = record->m_vecMaxs;
+		ang  = track->m_vecAngles[record];
+		org  = track->m_vecOrigin[record];
+		mins = track->m_vecMins[record];
+		maxs = track->m_vecMaxs[record];
 	}
 
 	// See if this is still a valid position for us to teleport to
@@ -673,32 +905,19 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 			else
 			{
 				CAI_BaseNPC *pHitEntity = dynamic_cast<CAI_BaseNPC *>( tr.m_pEnt );
-				if ( pHitEntity )
+				// If we haven't backtracked this entity, do it now
+				// this deliberately ignores WantsLagCompensationOnEntity.
+				if ( pHitEntity && !m_RestoreEntity.Get( pHitEntity->entindex() ) )
 				{
-					CAI_BaseNPC *pNPC = NULL;
-					CAI_BaseNPC **ppAIs = g_AI_Manager.AccessAIs();
-					int nAIs = g_AI_Manager.NumAIs();
-					for ( int i = 0; i < nAIs; i++ ) // we'll have to find this entity's index though :(
-					{
-						pNPC = ppAIs[i];
-						if ( pNPC == pHitEntity )
-							break;
-					}
-					// If we haven't backtracked this player, do it now
-					// this deliberately ignores WantsLagCompensationOnEntity.
-					if ( pNPC && !pNPC->IsLagFlagged() )
-					{
-						// prevent recursion - save a copy of m_RestoreEntity,
-						// pretend that this player is off-limits
+					// prevent recursion - pretend that we are off-limits
  
-						// Temp turn this flag on
-						pNPC->FlagForLagCompensation(true);
+					// Temp turn this flag on
+					m_RestorePlayer.Set( pl_index );
  
-						BacktrackEntity( pHitEntity, flTargetTime );
+					BacktrackEntity( pHitEntity, flTargetTime );
  
-						// Remove the temp flag
-						pNPC->FlagForLagCompensation(false);
-					}
+					// Remove the temp flag
+					m_RestorePlayer.Clear( pl_index );
 				}
 			}
 #endif
@@ -730,8 +949,8 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 	
 	// See if this represents a change for the player
 	int flags = 0;
-	LagRecord *restore = &m_RestoreData[ pl_index ];
-	LagRecord *change  = &m_ChangeData[ pl_index ];
+	LagRecord *restore = &track->m_RestoreData;
+	LagRecord *change  = &track->m_ChangeData;
 
 	QAngle angdiff = pPlayer->GetLocalAngles() - ang;
 	Vector orgdiff = pPlayer->GetLocalOrigin() - org;
@@ -776,7 +995,7 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 	restore->m_masterCycle = pPlayer->GetCycle();
 
 	bool interpolationAllowed = false;
-	if( prevRecord && (record->m_masterSequence == prevRecord->m_masterSequence) )
+	if( prevRecord != -1 && (track->m_masterSequence[record] == track->m_masterSequence[prevRecord]) )
 	{
 		// If the master state changes, all layers will be invalid too, so don't interp (ya know, interp barely ever happens anyway)
 		interpolationAllowed = true;
@@ -788,25 +1007,25 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 	if( frac > 0.0f && interpolationAllowed )
 	{
 		interpolatedMasters = true;
-		pPlayer->SetSequence( Lerp( frac, record->m_masterSequence, prevRecord->m_masterSequence ) );
-		pPlayer->SetCycle( Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle ) );
+		pPlayer->SetSequence( Lerp( frac, track->m_masterSequence[record], track->m_masterSequence[prevRecord] ) );
+		pPlayer->SetCycle( Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] ) );
 
-		if( record->m_masterCycle > prevRecord->m_masterCycle )
+		if( track->m_masterCycle[record] > track->m_masterCycle[prevRecord] )
 		{
 			// the older record is higher in frame than the newer, it must have wrapped around from 1 back to 0
 			// add one to the newer so it is lerping from .9 to 1.1 instead of .9 to .1, for example.
-			float newCycle = Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle + 1 );
+			float newCycle = Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] + 1 );
 			pPlayer->SetCycle(newCycle < 1 ? newCycle : newCycle - 1 );// and make sure .9 to 1.2 does not end up 1.05
 		}
 		else
 		{
-			pPlayer->SetCycle( Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle ) );
+			pPlayer->SetCycle( Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] ) );
 		}
 	}
 	if( !interpolatedMasters )
 	{
-		pPlayer->SetSequence(record->m_masterSequence);
-		pPlayer->SetCycle(record->m_masterCycle);
+		pPlayer->SetSequence(track->m_masterSequence[record]);
+		pPlayer->SetCycle(track->m_masterCycle[record]);
 	}
 
 	////////////////////////
@@ -825,8 +1044,8 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 			bool interpolated = false;
 			if( (frac > 0.0f)  &&  interpolationAllowed )
 			{
-				LayerRecord &recordsLayerRecord = record->m_layerRecords[layerIndex];
-				LayerRecord &prevRecordsLayerRecord = prevRecord->m_layerRecords[layerIndex];
+				LayerRecord &recordsLayerRecord = track->GetLayers( record )[layerIndex];
+				LayerRecord &prevRecordsLayerRecord = track->GetLayers( prevRecord )[layerIndex];
 				if( (recordsLayerRecord.m_order == prevRecordsLayerRecord.m_order)
 					&& (recordsLayerRecord.m_sequence == prevRecordsLayerRecord.m_sequence)
 					)
@@ -852,10 +1071,10 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 			if( !interpolated )
 			{
 				//Either no interp, or interp failed.  Just use record.
-				currentLayer->m_flCycle = record->m_layerRecords[layerIndex].m_cycle;
-				currentLayer->m_nOrder = record->m_layerRecords[layerIndex].m_order;
-				currentLayer->m_nSequence = record->m_layerRecords[layerIndex].m_sequence;
-				currentLayer->m_flWeight = record->m_layerRecords[layerIndex].m_weight;
+				currentLayer->m_flCycle = track->GetLayers( record )[layerIndex].m_cycle;
+				currentLayer->m_nOrder = track->GetLayers( record )[layerIndex].m_order;
+				currentLayer->m_nSequence = track->GetLayers( record )[layerIndex].m_sequence;
+				currentLayer->m_flWeight = track->GetLayers( record )[layerIndex].m_weight;
 			}
 		}
 	}
@@ -872,6 +1091,7 @@ void CLagCompensationManager::BacktrackPlayer( CBasePlayer *pPlayer, float flTar
 	NDebugOverlay::EntityBounds( pPlayer, 255, 0, 0, 32, 10 ); */
 
 	m_RestorePlayer.Set( pl_index ); //remember that we changed this player
+	m_iBacktrackCount++;
 	m_bNeedToRestore = true;  // we changed at least one player
 	restore->m_fFlags = flags; // we need to restore these flags
 	change->m_fFlags = flags; // we have changed these flags
@@ -899,94 +1119,57 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 	VPROF_BUDGET( "BacktrackEntity", "CLagCompensationManager" );
  
 	// get track history of this entity
-	CUtlFixedLinkedList< LagRecordNPC > *track = pEntity->GetLagTrack();
- 
+	CLagTrack *track = GetEntityTrack( pEntity, false );
+	if ( !track )
+		return;
+
 	// check if we have at leat one entry
 	if ( track->Count() <= 0 )
 		return;
- 
-	int curr = track->Head();
- 
-	LagRecordNPC *prevRecord = NULL;
-	LagRecordNPC *record = NULL;
- 
-	Vector prevOrg = pEntity->GetLocalOrigin();
- 
-	// Walk context looking for any invalidating event
-	while( track->IsValidIndex(curr) )
-	{
-		// remember last record
-		prevRecord = record;
- 
-		// get next record
-		record = &track->Element( curr );
- 
-		if ( !(record->m_fFlags & LC_ALIVE) )
-		{
-			// entity must be alive, lost track
-			return;
-		}
- 
-		Vector delta = record->m_vecOrigin - prevOrg;
-		if ( delta.LengthSqr() > LAG_COMPENSATION_TELEPORTED_DISTANCE_SQR )
-		{
-			// lost track, moved too far (may have teleported)
-			if ( sv_unlag_debug.GetBool() )
-				Msg( "Failed to unlag AI at position (%0.1f, %0.1f, %0.1f)\n", pEntity->GetAbsOrigin().x, pEntity->GetAbsOrigin().y, pEntity->GetAbsOrigin().z );
-			
-			return; 
-		}
- 
-		// did we find a context smaller than target time ?
-		if ( record->m_flSimulationTime <= flTargetTime )
-			break; // hurra, stop
- 
-		prevOrg = record->m_vecOrigin;
- 
-		// go one step back in time
-		curr = track->Next( curr );
-	}
- 
-	Assert( record );
- 
-	if ( !record )
+
+	// Find the record at our target time, the entity must be alive and can't have teleported since
+	int age = track->FindRecord( pEntity->GetLocalOrigin(), flTargetTime );
+	if ( age < 0 )
 	{
 		if ( sv_unlag_debug.GetBool() )
-			Msg( "No valid positions in history for BacktrackEntity ( %s )\n", pEntity->GetClassname() );
- 
-		return; // that should never happen
+			Msg( "Failed to unlag AI at position (%0.1f, %0.1f, %0.1f)\n", pEntity->GetAbsOrigin().x, pEntity->GetAbsOrigin().y, pEntity->GetAbsOrigin().z );
+
+		return; // lost track
 	}
- 
+
+	int record = track->Slot( age );
+	int prevRecord = age > 0 ? track->Slot( age - 1 ) : -1;
+
 	float frac = 0.0f;
- 	if ( prevRecord && 
-		 (record->m_flSimulationTime < flTargetTime) &&
-		 (record->m_flSimulationTime < prevRecord->m_flSimulationTime) )
+ 	if ( prevRecord != -1 && 
+		 (track->m_flSimulationTime[record] < flTargetTime) &&
+		 (track->m_flSimulationTime[record] < track->m_flSimulationTime[prevRecord]) )
 	{
 		// we didn't find the exact time but have a valid previous record
 		// so interpolate between these two records;
  
-		Assert( prevRecord->m_flSimulationTime > record->m_flSimulationTime );
-		Assert( flTargetTime < prevRecord->m_flSimulationTime );
+		Assert( track->m_flSimulationTime[prevRecord] > track->m_flSimulationTime[record] );
+		Assert( flTargetTime < track->m_flSimulationTime[prevRecord] );
  
 		// calc fraction between both records
-		frac = ( flTargetTime - record->m_flSimulationTime ) / 
-			( prevRecord->m_flSimulationTime - record->m_flSimulationTime );
+		frac = ( flTargetTime - track->m_flSimulationTime[record] ) / 
+			( track->m_flSimulationTime[prevRecord] - track->m_flSimulationTime[record] );
  
 		Assert( frac > 0 && frac < 1 ); // should never extrapolate
  
-		ang  = Lerp( frac, record->m_vecAngles, prevRecord->m_vecAngles );
-		org  = Lerp( frac, record->m_vecOrigin, prevRecord->m_vecOrigin  );
-		mins = Lerp( frac, record->m_vecMins, prevRecord->m_vecMins  );
-		maxs = Lerp( frac, record->m_vecMaxs, prevRecord->m_vecMaxs );
+		ang  = Lerp( frac, track->m_vecAngles[record], track->m_vecAngles[prevRecord] );
+		org  = Lerp( frac, track->m_vecOrigin[record], track->m_vecOrigin[prevRecord]  );
+		mins = Lerp( frac, track->m_vecMins[record], track->m_vecMins[prevRecord]  );
+		maxs = Lerp( frac, track->m_vecMaxs[record], track->m_vecMaxs[prevRecord] );
 	}
 	else
  	{
 		// we found the exact record or no other record to interpolate with
 		// just copy these values since they are the best we have
-		ang  = record->m_vecAngles;
-		org  = record->m_vecOrigin;
-		mins = record->m_vecMins;
-		maxs = record->m_vecMaxs;
+		ang  = track->m_vecAngles[record];
+		org  = track->m_vecOrigin[record];
+		mins = track->m_vecMins[record];
+		maxs = track->m_vecMaxs[record];
 	}
  
 	// See if this is still a valid position for us to teleport to
@@ -1009,48 +1192,33 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 				// this deliberately ignores WantsLagCompensationOnEntity.
 				if ( !m_RestorePlayer.Get( pHitPlayer->entindex() - 1 ) )
 				{
-					// prevent recursion - save a copy of m_RestorePlayer,
-					// pretend that this player is off-limits
-					int pl_index = pEntity->entindex() - 1;
+					// prevent recursion - pretend that we are off-limits
  
 					// Temp turn this flag on
-					m_RestorePlayer.Set( pl_index );
+					m_RestoreEntity.Set( pEntity->entindex() );
  
 					BacktrackPlayer( pHitPlayer, flTargetTime );
  
 					// Remove the temp flag
-					m_RestorePlayer.Clear( pl_index );
+					m_RestoreEntity.Clear( pEntity->entindex() );
 				}				
 			}
 			else
 			{
 				CAI_BaseNPC *pHitEntity = dynamic_cast<CAI_BaseNPC *>( tr.m_pEnt );
-				if ( pHitEntity )
+				// If we haven't backtracked this entity, do it now
+				// this deliberately ignores WantsLagCompensationOnEntity.
+				if ( pHitEntity && !m_RestoreEntity.Get( pHitEntity->entindex() ) )
 				{
-					CAI_BaseNPC *pNPC = NULL;
-					CAI_BaseNPC **ppAIs = g_AI_Manager.AccessAIs();
-					int nAIs = g_AI_Manager.NumAIs();
-					for ( int i = 0; i < nAIs; i++ ) // we'll have to find this entity's index though :(
-					{
-						pNPC = ppAIs[i];
-						if ( pNPC == pHitEntity )
-							break;
-					}
-					// If we haven't backtracked this player, do it now
-					// this deliberately ignores WantsLagCompensationOnEntity.
-					if ( pNPC && !pNPC->IsLagFlagged() )
-					{
-						// prevent recursion - save a copy of m_RestoreEntity,
-						// pretend that this player is off-limits
+					// prevent recursion - pretend that we are off-limits
  
-						// Temp turn this flag on
-						pNPC->FlagForLagCompensation(true);
+					// Temp turn this flag on
+					m_RestoreEntity.Set( pEntity->entindex() );
  
-						BacktrackEntity( pHitEntity, flTargetTime );
+					BacktrackEntity( pHitEntity, flTargetTime );
  
-						// Remove the temp flag
-						pNPC->FlagForLagCompensation(false);
-					}
+					// Remove the temp flag
+					m_RestoreEntity.Clear( pEntity->entindex() );
 				}
 			}
  
@@ -1081,8 +1249,8 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
  
 	// See if this represents a change for the entity
 	int flags = 0;
-	LagRecordNPC *restore = new LagRecordNPC();//pEntity->GetLagRestoreData();
-	LagRecordNPC *change  = new LagRecordNPC();//pEntity->GetLagChangeData();
+	LagRecord *restore = &track->m_RestoreData;
+	LagRecord *change  = &track->m_ChangeData;
  
 	QAngle angdiff = pEntity->GetLocalAngles() - ang;
 	Vector orgdiff = pEntity->GetLocalOrigin() - org;
@@ -1127,7 +1295,7 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 	restore->m_masterCycle = pEntity->GetCycle();
  
 	bool interpolationAllowed = false;
-	if( prevRecord && (record->m_masterSequence == prevRecord->m_masterSequence) )
+	if( prevRecord != -1 && (track->m_masterSequence[record] == track->m_masterSequence[prevRecord]) )
 	{
 		// If the master state changes, all layers will be invalid too, so don't interp (ya know, interp barely ever happens anyway)
 		interpolationAllowed = true;
@@ -1139,25 +1307,25 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 	if( frac > 0.0f && interpolationAllowed )
  	{
   		interpolatedMasters = true;
-		pEntity->SetSequence( Lerp( frac, record->m_masterSequence, prevRecord->m_masterSequence ) );
-		pEntity->SetCycle( Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle ) );
+		pEntity->SetSequence( Lerp( frac, track->m_masterSequence[record], track->m_masterSequence[prevRecord] ) );
+		pEntity->SetCycle( Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] ) );
  
-		if( record->m_masterCycle > prevRecord->m_masterCycle )
+		if( track->m_masterCycle[record] > track->m_masterCycle[prevRecord] )
 		{
 			// the older record is higher in frame than the newer, it must have wrapped around from 1 back to 0
 			// add one to the newer so it is lerping from .9 to 1.1 instead of .9 to .1, for example.
-			float newCycle = Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle + 1 );
+			float newCycle = Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] + 1 );
 			pEntity->SetCycle(newCycle < 1 ? newCycle : newCycle - 1 );// and make sure .9 to 1.2 does not end up 1.05
 		}
 		else
 		{
-			pEntity->SetCycle( Lerp( frac, record->m_masterCycle, prevRecord->m_masterCycle ) );
+			pEntity->SetCycle( Lerp( frac, track->m_masterCycle[record], track->m_masterCycle[prevRecord] ) );
 		}
 	}
  	if( !interpolatedMasters )
 	{
-		pEntity->SetSequence(record->m_masterSequence);
-		pEntity->SetCycle(record->m_masterCycle);
+		pEntity->SetSequence(track->m_masterSequence[record]);
+		pEntity->SetCycle(track->m_masterCycle[record]);
 	}
  
 	////////////////////////
@@ -1176,8 +1344,8 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 			bool interpolated = false;
 			if( (frac > 0.0f)  &&  interpolationAllowed )
 			{
-				LayerRecordNPC &recordsLayerRecord = record->m_layerRecords[layerIndex];
-				LayerRecordNPC &prevRecordsLayerRecord = prevRecord->m_layerRecords[layerIndex];
+				LayerRecord &recordsLayerRecord = track->GetLayers( record )[layerIndex];
+				LayerRecord &prevRecordsLayerRecord = track->GetLayers( prevRecord )[layerIndex];
 				if( (recordsLayerRecord.m_order == prevRecordsLayerRecord.m_order)
 					&& (recordsLayerRecord.m_sequence == prevRecordsLayerRecord.m_sequence)
 					)
@@ -1203,10 +1371,10 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 			if( !interpolated )
 			{
 				//Either no interp, or interp failed.  Just use record.
-				currentLayer->m_flCycle = record->m_layerRecords[layerIndex].m_cycle;
-				currentLayer->m_nOrder = record->m_layerRecords[layerIndex].m_order;
-				currentLayer->m_nSequence = record->m_layerRecords[layerIndex].m_sequence;
-				currentLayer->m_flWeight = record->m_layerRecords[layerIndex].m_weight;
+				currentLayer->m_flCycle = track->GetLayers( record )[layerIndex].m_cycle;
+				currentLayer->m_nOrder = track->GetLayers( record )[layerIndex].m_order;
+				currentLayer->m_nSequence = track->GetLayers( record )[layerIndex].m_sequence;
+				currentLayer->m_flWeight = track->GetLayers( record )[layerIndex].m_weight;
 			}
 		}
 	}
@@ -1222,15 +1390,13 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 	NDebugOverlay::Text( org, text, false, 10 );
 	NDebugOverlay::EntityBounds( pEntity, 255, 0, 0, 32, 10 ); */
  
-	pEntity->FlagForLagCompensation(true); //remember that we changed this entity
+	m_RestoreEntity.Set( pEntity->entindex() ); //remember that we changed this entity
+	m_iBacktrackCount++;
  
 	m_bNeedToRestore = true;  // we changed at least one player / entity
 	restore->m_fFlags = flags; // we need to restore these flags
 	change->m_fFlags = flags; // we have changed these flags
  
-	pEntity->SetLagRestoreData(restore);
-	pEntity->SetLagChangeData(change);
- 
 	if( sv_showlagcompensation.GetInt() == 1 )
 	{
 		pEntity->DrawServerHitboxes(4, true);
@@ -1247,6 +1413,14 @@ void CLagCompensationManager::BacktrackEntity( CAI_BaseNPC *pEntity, float flTar
 #endif
 
 void CLagCompensationManager::FinishLagCompensation( CBasePlayer *player )
+{
+	m_iFinishCount++;
+	CTimeAdder timer( &m_FinishTime );
+
+	FinishLagCompensationInternal( player );
+}
+
+void CLagCompensationManager::FinishLagCompensationInternal( CBasePlayer *player )
 {
 	VPROF_BUDGET_FLAGS( "FinishLagCompensation", VPROF_BUDGETGROUP_OTHER_NETWORKING, BUDGETFLAG_CLIENT|BUDGETFLAG_SERVER );
 	if ( !m_bNeedToRestore )
@@ -1295,8 +1469,8 @@ void CLagCompensationManager::FinishLagCompensation( CBasePlayer *player )
 		}
 #endif
 
-		LagRecord *restore = &m_RestoreData[ pl_index ];
-		LagRecord *change  = &m_ChangeData[ pl_index ];
+		LagRecord *restore = &m_PlayerTrack[ pl_index ].m_RestoreData;
+		LagRecord *change  = &m_PlayerTrack[ pl_index ].m_ChangeData;
 
 		bool restoreSimulationTime = false;
 
@@ -1374,14 +1548,18 @@ void CLagCompensationManager::FinishLagCompensation( CBasePlayer *player )
 	{
 		CAI_BaseNPC *pNPC = ppAIs[i];
  
-		if ( !pNPC->IsLagFlagged() )
+		if ( !pNPC || !m_RestoreEntity.Get( pNPC->entindex() ) )
 		{
 			// entity wasn't changed by lag compensation
 			continue;
 		}
  
-		LagRecordNPC *restore = pNPC->GetLagRestoreData();
-		LagRecordNPC *change  = pNPC->GetLagChangeData();
+		CLagTrack *track = GetEntityTrack( pNPC, false );
+		if ( !track )
+			continue;
+
+		LagRecord *restore = &track->m_RestoreData;
+		LagRecord *change  = &track->m_ChangeData;
  
 		bool restoreSimulationTime = false;
  
@@ -1453,3 +1631,190 @@ void CLagCompensationManager::FinishLagCompensation( CBasePlayer *player )
 }
 
 
+
+// Recordings are capped so a forgotten recording can't eat the server's memory
+#define LAG_REPLAY_MAX_CMDS		131072
+#define LAG_REPLAY_VERSION		1
+
+void CLagCompensationManager::RecordCommand( CBasePlayer *player, CUserCmd *cmd, float latency, int lerpTicks )
+{
+	CHL2MP_Player *pHL2MPPlayer = ToHL2MPPlayer( player );
+
+	int idx = m_ReplayCmds.AddToTail();
+	ReplayCmd_t &rec = m_ReplayCmds[idx];
+	rec.iPlayer = player->entindex();
+	rec.iTickDelta = gpGlobals->tickcount - cmd->tick_count;
+	rec.iFireAge = pHL2MPPlayer ? cmd->command_number - pHL2MPPlayer->GetLastWeaponFireUsercmd() : 0;
+	rec.iLerpTicks = lerpTicks;
+	rec.flLatency = latency;
+	rec.viewangles = cmd->viewangles;
+	rec.buttons = cmd->buttons;
+
+	if ( m_ReplayCmds.Count() >= LAG_REPLAY_MAX_CMDS )
+		StopRecording();
+}
+
+void CLagCompensationManager::StartRecording( const char *filename )
+{
+	Q_strncpy( m_szRecordFile, filename, sizeof(m_szRecordFile) );
+	m_ReplayCmds.RemoveAll();
+	m_bRecording = true;
+
+	Msg( "Recording lag compensated usercmds to %s\n", m_szRecordFile );
+}
+
+void CLagCompensationManager::StopRecording()
+{
+	if ( !m_bRecording )
+		return;
+
+	m_bRecording = false;
+
+	CUtlBuffer buf;
+	buf.PutInt( LAG_REPLAY_VERSION );
+	buf.PutInt( m_ReplayCmds.Count() );
+
+	for ( int i=0; i < m_ReplayCmds.Count(); i++ )
+	{
+		const ReplayCmd_t &rec = m_ReplayCmds[i];
+		buf.PutInt( rec.iPlayer );
+		buf.PutInt( rec.iTickDelta );
+		buf.PutInt( rec.iFireAge );
+		buf.PutInt( rec.iLerpTicks );
+		buf.PutFloat( rec.flLatency );
+		buf.PutFloat( rec.viewangles.x );
+		buf.PutFloat( rec.viewangles.y );
+		buf.PutFloat( rec.viewangles.z );
+		buf.PutInt( rec.buttons );
+	}
+
+	if ( filesystem->WriteFile( m_szRecordFile, "MOD", buf ) )
+		Msg( "Recorded %i usercmds to %s\n", m_ReplayCmds.Count(), m_szRecordFile );
+	else
+		Warning( "Failed to write %s\n", m_szRecordFile );
+
+	m_ReplayCmds.RemoveAll();
+}
+
+CON_COMMAND( sv_unlag_record, "Records lag compensated usercmds for sv_unlag_replay.\n\tUsage: sv_unlag_record <file> to start, sv_unlag_record to stop and save" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	if ( args.ArgC() > 1 )
+		g_LagCompensationManager.StartRecording( args[1] );
+	else
+		g_LagCompensationManager.StopRecording();
+}
+
+#ifdef GES_BENCHMARK
+void CLagCompensationManager::Replay( const char *filename, int iterations )
+{
+	if ( m_bRecording )
+	{
+		Warning( "Stop recording before replaying\n" );
+		return;
+	}
+
+	CUtlBuffer buf;
+	if ( !filesystem->ReadFile( filename, "MOD", buf ) || buf.GetInt() != LAG_REPLAY_VERSION )
+	{
+		Warning( "Failed to load usercmd recording %s\n", filename );
+		return;
+	}
+
+	int count = buf.GetInt();
+	for ( int i=0; i < count && buf.IsValid(); i++ )
+	{
+		int idx = m_ReplayCmds.AddToTail();
+		ReplayCmd_t &rec = m_ReplayCmds[idx];
+		rec.iPlayer = buf.GetInt();
+		rec.iTickDelta = buf.GetInt();
+		rec.iFireAge = buf.GetInt();
+		rec.iLerpTicks = buf.GetInt();
+		rec.flLatency = buf.GetFloat();
+		rec.viewangles.x = buf.GetFloat();
+		rec.viewangles.y = buf.GetFloat();
+		rec.viewangles.z = buf.GetFloat();
+		rec.buttons = buf.GetInt();
+	}
+
+	// Recorded shooters are mapped onto whoever is playing now, bots included, the
+	// recording only has to come from a server with real clients
+	CUtlVector<CBasePlayer*> shooters;
+	for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+	{
+		CBasePlayer *pPlayer = UTIL_PlayerByIndex( i );
+		if ( pPlayer && pPlayer->IsAlive() && !pPlayer->IsObserver() )
+			shooters.AddToTail( pPlayer );
+	}
+
+	if ( !m_ReplayCmds.Count() || !shooters.Count() )
+	{
+		Warning( "Nothing to replay (%i usercmds, %i live players)\n", m_ReplayCmds.Count(), shooters.Count() );
+		m_ReplayCmds.RemoveAll();
+		return;
+	}
+
+	CCycleCount startTime, finishTime;
+	int backtracked = m_iBacktrackCount;
+
+	for ( int n=0; n < iterations; n++ )
+	{
+		for ( int i=0; i < m_ReplayCmds.Count(); i++ )
+		{
+			const ReplayCmd_t &rec = m_ReplayCmds[i];
+			CBasePlayer *pPlayer = shooters[ rec.iPlayer % shooters.Count() ];
+			CHL2MP_Player *pHL2MPPlayer = ToHL2MPPlayer( pPlayer );
+
+			CUserCmd cmd;
+			cmd.tick_count = gpGlobals->tickcount - rec.iTickDelta;
+			cmd.command_number = (pHL2MPPlayer ? pHL2MPPlayer->GetLastWeaponFireUsercmd() : 0) + rec.iFireAge;
+			cmd.viewangles = rec.viewangles;
+			cmd.buttons = rec.buttons;
+
+			// Same work as StartLagCompensation past the per player gate, which would skip bots
+			{
+				CTimeAdder timer( &startTime );
+				BeginRestore( pPlayer );
+				BacktrackAll( pPlayer, &cmd, rec.flLatency, rec.iLerpTicks );
+			}
+
+			{
+				CTimeAdder timer( &finishTime );
+				FinishLagCompensationInternal( pPlayer );
+			}
+		}
+	}
+
+	int total = m_ReplayCmds.Count() * iterations;
+	backtracked = m_iBacktrackCount - backtracked;
+
+	int nAIs = 0;
+#ifdef GE_DLL
+	nAIs = g_AI_Manager.NumAIs();
+#endif
+
+	Msg( "Lag compensation replay: %i usercmds x %i iterations over %i players, %i NPCs\n", m_ReplayCmds.Count(), iterations, shooters.Count(), nAIs );
+	Msg( "  Start:  %0.3f ms total, %0.4f ms avg, %0.2f entities backtracked per usercmd\n", startTime.GetMillisecondsF(),
+		startTime.GetMillisecondsF() / total, (float)backtracked / total );
+	Msg( "  Finish: %0.3f ms total, %0.4f ms avg\n", finishTime.GetMillisecondsF(), finishTime.GetMillisecondsF() / total );
+
+	m_ReplayCmds.RemoveAll();
+}
+
+CON_COMMAND( sv_unlag_replay, "Replays recorded usercmds through lag compensation and times it.\n\tUsage: sv_unlag_replay <file> [iterations]" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	if ( args.ArgC() < 2 )
+	{
+		Msg( "Usage: sv_unlag_replay <file> [iterations]\n" );
+		return;
+	}
+
+	int iterations = args.ArgC() > 2 ? atoi( args[2] ) : 1;
+	g_LagCompensationManager.Replay( args[1], iterations < 1 ? 1 : iterations );
+}
+#endif
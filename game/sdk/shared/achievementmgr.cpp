@@ -89,10 +89,8 @@ static void WriteAchievementGlobalState( KeyValues *pKV )
 #else
 	CUtlBuffer buffer;
 	pKV->WriteAsBinary( buffer );
-	filesystem->WriteFile( szFilename, "MOD", buffer );
+	GEUTIL_WriteEncryptedFile( szFilename, "MOD", CAchievementMgr::GetEncryptionKey(), buffer );
 	pKV->deleteThis();
-
-	GEUTIL_DEncryptFile( szFilename, CAchievementMgr::GetEncryptionKey() );
 #endif
 
 #ifdef _X360
@@ -440,6 +438,11 @@ void CAchievementMgr::LevelShutdownPreEntity()
 		pAchievement->StopListeningForAllEvents();
 	}
 
+#if defined( GE_DLL ) && defined( CLIENT_DLL )
+	// Our achievements listen through the router, drop those too
+	GEAchievementRouter()->Reset();
+#endif
+
 	// save global state if we have any changes
 	SaveGlobalStateIfDirty();
 
@@ -665,13 +668,8 @@ void CAchievementMgr::LoadGlobalState()
 	m_iCompletionCount = 0;
 
 	CUtlBuffer buffer;
-	// Decrypt the file so we can read it
-	GEUTIL_DEncryptFile( szFilename, CAchievementMgr::GetEncryptionKey(), false );
-	filesystem->ReadFile( szFilename, "MOD", buffer );
-	// Don't let people edit their file while in game
-	GEUTIL_DEncryptFile( szFilename, CAchievementMgr::GetEncryptionKey() );
-
-	if ( pKV->ReadAsBinary( buffer ) )
+	// Decrypt the file in memory so it never sits on disk unencrypted
+	if ( GEUTIL_ReadEncryptedFile( szFilename, "MOD", CAchievementMgr::GetEncryptionKey(), buffer ) && pKV->ReadAsBinary( buffer ) )
 #else
 	if ( pKV->LoadFromFile( filesystem, szFilename, "MOD" ) )
 #endif
@@ -49,6 +49,7 @@ void RegisterUserMessages( void )
 	usermessages->Register( "RemoveProgressBar", 1 );
 	usermessages->Register( "UpdateProgressBar", 5 );
 	usermessages->Register( "ConfigProgressBar", -1 );
+	usermessages->Register( "ProgressBarBatch", -1 );
 	// Gameplay Popup Message
 	usermessages->Register( "PopupMessage", -1 );
 	// Scenario Help
@@ -0,0 +1,276 @@
+#include "ge_pyprecom.h"
+#include "ge_pyprofile.h"
+#include "filesystem.h"
+#include "vstdlib/random.h"
+
+#include "ge_benchmark.h"
+#include "ge_gameplay.h"
+#include "gemp_gamerules.h"
+#include "gebot_player.h"
+
+// memdbgon must be the last include file in a .cpp file!!!
+#include "tier0/memdbgon.h"
+
+// Headless tick benchmark, built into the server with -DGES_BENCHMARK=ON.
+//
+// Run it on a dedicated server so no client is needed, eg:
+//   srcds_run -game gesource +sv_lan 1 +map ge_archives +ge_benchmark_quit 1 +ge_benchmark 16 2000 deathmatch
+//
+// The engine is put in benchmark mode so every frame runs exactly one tick, game randomness is
+// seeded from the command line and the bots are given a fixed number of warmup ticks before we
+// start measuring. Section times are inclusive, gamerules think contains the scenario's Python.
+
+ConVar ge_benchmark_warmup( "ge_benchmark_warmup", "200", FCVAR_GAMEDLL, "Ticks to run after adding the bots before ge_benchmark starts measuring", true, 0, false, 0 );
+ConVar ge_benchmark_out( "ge_benchmark_out", "", FCVAR_GAMEDLL, "CSV file in the mod directory that ge_benchmark results are written to, blank for none" );
+ConVar ge_benchmark_quit( "ge_benchmark_quit", "0", FCVAR_GAMEDLL, "Quit the server once ge_benchmark finishes" );
+
+bool g_bGEBenchmarking = false;
+
+static const char *s_szSectionNames[GEBENCH_SECTION_COUNT] =
+{
+	"gamerules_think",
+	"spawn_selection",
+	"token_enforcement",
+	"radar",
+};
+
+class CGEBenchmark : public CAutoGameSystemPerFrame
+{
+public:
+	CGEBenchmark() : CAutoGameSystemPerFrame( "CGEBenchmark" )
+	{
+		m_iState = STATE_IDLE;
+	}
+
+	bool IsActive() { return m_iState != STATE_IDLE; }
+
+	void Start( int bots, int ticks, int seed )
+	{
+		m_iTicks = ticks;
+		m_iTicksRun = 0;
+		m_iSeed = seed;
+		m_bWasPyProfiling = g_bGEPyProfiling;
+		m_iWarmup = ge_benchmark_warmup.GetInt();
+
+		// Everything from here on out draws from the same sequence every run
+		srand( seed );
+		RandomSeed( seed );
+
+		int count = 0;
+		FOR_EACH_BOTPLAYER( pBot )
+			count++;
+		END_OF_PLAYER_LOOP()
+
+		for ( ; count < bots; count++ )
+		{
+			if ( !CGEMPRules::CreateBot() )
+			{
+				Warning( "[Benchmark] Could only add %i of %i bots\n", count, bots );
+				break;
+			}
+		}
+
+		m_iBots = count;
+		m_iState = STATE_WARMUP;
+
+		engine->SetDedicatedServerBenchmarkMode( true );
+		Msg( "[Benchmark] Warming up %i bots for %i ticks\n", m_iBots, m_iWarmup );
+	}
+
+	void Stop( bool aborted )
+	{
+		g_bGEBenchmarking = false;
+		g_bGEPyProfiling = m_bWasPyProfiling;
+		m_iState = STATE_IDLE;
+
+		engine->SetDedicatedServerBenchmarkMode( false );
+
+		if ( aborted )
+		{
+			Warning( "[Benchmark] Aborted after %i of %i ticks\n", m_iTicksRun, m_iTicks );
+			return;
+		}
+
+		Report();
+
+		if ( ge_benchmark_quit.GetBool() )
+			engine->ServerCommand( "quit\n" );
+	}
+
+	void AddSample( int section, const CCycleCount &duration )
+	{
+		Section_t &s = m_Sections[section];
+		s.iCalls++;
+		s.total += duration;
+		if ( s.max.IsLessThan( duration ) )
+			s.max = duration;
+	}
+
+	virtual void FrameUpdatePreEntityThink()
+	{
+		if ( m_iState == STATE_WARMUP )
+		{
+			if ( m_iWarmup-- > 0 )
+				return;
+
+			for ( int i=0; i < GEBENCH_SECTION_COUNT + 1; i++ )
+			{
+				m_Sections[i].iCalls = 0;
+				m_Sections[i].total.Init();
+				m_Sections[i].max.Init();
+			}
+
+			// Python hooks are measured by the Python profiler
+			GEPyProfiler()->Reset();
+			g_bGEPyProfiling = true;
+
+			g_bGEBenchmarking = true;
+			m_iState = STATE_RUNNING;
+			m_FrameTimer.Start();
+			return;
+		}
+
+		if ( m_iState != STATE_RUNNING )
+			return;
+
+		// In benchmark mode the engine runs ticks back to back, so this is the whole server frame
+		m_FrameTimer.End();
+		AddSample( GEBENCH_SECTION_COUNT, m_FrameTimer.GetDuration() );
+
+		if ( ++m_iTicksRun >= m_iTicks )
+			Stop( false );
+		else
+			m_FrameTimer.Start();
+	}
+
+	virtual void LevelShutdownPreEntity()
+	{
+		if ( IsActive() )
+			Stop( true );
+	}
+
+private:
+	void Report()
+	{
+		const char *scenario = GEGameplay() && GEGameplay()->GetScenario() ? GEGameplay()->GetScenario()->GetIdent() : "none";
+		const CCycleCount &python = GEPyProfiler()->GetTopLevelTotal();
+
+		Msg( "[Benchmark] %s, %s, %i bots, %i ticks, seed %i\n", STRING( gpGlobals->mapname ), scenario, m_iBots, m_iTicksRun, m_iSeed );
+		Msg( "%-20s %8s %10s %12s %8s\n", "Section", "Calls", "Total ms", "Per tick ms", "Max ms" );
+		PrintSection( "server_frame", m_Sections[GEBENCH_SECTION_COUNT] );
+		for ( int i=0; i < GEBENCH_SECTION_COUNT; i++ )
+			PrintSection( s_szSectionNames[i], m_Sections[i] );
+		Msg( "%-20s %8s %10.2f %12.4f %8s\n", "python_hooks", "-", python.GetMillisecondsF(), python.GetMillisecondsF() / m_iTicksRun, "-" );
+
+		Msg( "\nTop Python hooks:\n" );
+		GEPyProfiler()->Print( 10 );
+
+		const char *filename = ge_benchmark_out.GetString();
+		if ( !filename[0] )
+			return;
+
+		FileHandle_t file = filesystem->Open( filename, "w", "MOD" );
+		if ( !file )
+		{
+			Warning( "[Benchmark] Failed to write %s\n", filename );
+			return;
+		}
+
+		filesystem->FPrintf( file, "section,calls,total_ms,per_tick_ms,max_ms\n" );
+		WriteSection( file, "server_frame", m_Sections[GEBENCH_SECTION_COUNT] );
+		for ( int i=0; i < GEBENCH_SECTION_COUNT; i++ )
+			WriteSection( file, s_szSectionNames[i], m_Sections[i] );
+		filesystem->FPrintf( file, "python_hooks,,%.4f,%.4f,\n", python.GetMillisecondsF(), python.GetMillisecondsF() / m_iTicksRun );
+
+		filesystem->Close( file );
+		Msg( "[Benchmark] Results written to %s\n", filename );
+	}
+
+	struct Section_t
+	{
+		int			iCalls;
+		CCycleCount	total;
+		CCycleCount	max;
+	};
+
+	void PrintSection( const char *name, const Section_t &s )
+	{
+		Msg( "%-20s %8i %10.2f %12.4f %8.3f\n", name, s.iCalls, s.total.GetMillisecondsF(),
+			s.total.GetMillisecondsF() / m_iTicksRun, s.max.GetMillisecondsF() );
+	}
+
+	void WriteSection( FileHandle_t file, const char *name, const Section_t &s )
+	{
+		filesystem->FPrintf( file, "%s,%i,%.4f,%.4f,%.4f\n", name, s.iCalls, s.total.GetMillisecondsF(),
+			s.total.GetMillisecondsF() / m_iTicksRun, s.max.GetMillisecondsF() );
+	}
+
+	enum
+	{
+		STATE_IDLE = 0,
+		STATE_WARMUP,
+		STATE_RUNNING,
+	};
+
+	int m_iState;
+	int m_iBots;
+	int m_iTicks;
+	int m_iTicksRun;
+	int m_iWarmup;
+	int m_iSeed;
+	bool m_bWasPyProfiling;
+
+	// The extra section holds the whole server frame
+	Section_t	m_Sections[GEBENCH_SECTION_COUNT + 1];
+	CFastTimer	m_FrameTimer;
+};
+
+static CGEBenchmark g_GEBenchmark;
+
+void GEBench_AddSample( int section, const CCycleCount &duration )
+{
+	g_GEBenchmark.AddSample( section, duration );
+}
+
+CON_COMMAND( ge_benchmark, "Adds bots and times a fixed number of server ticks.\n\tUsage: ge_benchmark <bots> <ticks> [scenario] [seed]" )
+{
+	if ( !UTIL_IsCommandIssuedByServerAdmin() )
+		return;
+
+	if ( args.ArgC() < 3 )
+	{
+		Msg( "Usage: ge_benchmark <bots> <ticks> [scenario] [seed]\n" );
+		return;
+	}
+
+	if ( !GEMPRules() || !GEGameplay() )
+	{
+		Warning( "[Benchmark] A map must be loaded first\n" );
+		return;
+	}
+
+	if ( g_GEBenchmark.IsActive() )
+	{
+		Warning( "[Benchmark] A benchmark is already running\n" );
+		return;
+	}
+
+	int bots = clamp( atoi( args[1] ), 0, gpGlobals->maxClients );
+	int ticks = atoi( args[2] );
+	int seed = args.ArgC() > 4 ? atoi( args[4] ) : 1;
+
+	if ( ticks < 1 )
+	{
+		Warning( "[Benchmark] Need at least one tick to measure\n" );
+		return;
+	}
+
+	// Loading the scenario goes through the same path as a server operator changing it
+	if ( args.ArgC() > 3 && GEGameplay()->GetScenario() && Q_stricmp( args[3], GEGameplay()->GetScenario()->GetIdent() ) )
+	{
+		static ConVarRef ge_gameplay( "ge_gameplay" );
+		ge_gameplay.SetValue( args[3] );
+	}
+
+	g_GEBenchmark.Start( bots, ticks, seed );
+}
@@ -46,14 +46,14 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CBasePlayer *pPlayer = CBasePlayer::GetLocalPlayer();
+		CBasePlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// Only care about our kills
-		if ( event->GetInt("attacker") == pPlayer->GetUserID() && event->GetInt("weaponid") == WEAPON_SHOTGUN )
+		if ( event.bLocalAttacker && event.iWeaponID == WEAPON_SHOTGUN )
 		{
 			if (gpGlobals->curtime <= m_flLastKillTime + 0.2f)
 			{
@@ -97,18 +97,18 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us getting hurt we don't care
-		if (event->GetInt("userid") != pPlayer->GetUserID())
+		if (!event.bLocalVictim)
 			return;
 
 		// Reset conditions on spawn because only losers die and this acheivement is for winners.
-		if (Q_stricmp(event->GetName(), "player_spawn") == 0)
+		if (event.iType == GE_ACHEVENT_PLAYER_SPAWN)
 		{
 			m_iDmgTaken = 0;
 			return;
@@ -116,9 +116,9 @@ protected:
 
 		// If we made it this far then the event is just the damage event, so we should add the damage we took to our total.
 		// Provided that we're still alive, anyway.
-		if (event->GetInt("health") > 0)
+		if (event.iHealth > 0)
 		{
-			m_iDmgTaken += event->GetInt("damage");
+			m_iDmgTaken += event.iDamage;
 
 			if (m_iDmgTaken >= 1280) //160 * 8 = 1280
 				IncrementCount();
@@ -147,18 +147,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the remote mines and the victim isn't within our PVS, we did it!
-		if (event->GetInt("weaponid") == WEAPON_REMOTEMINE && !event->GetBool("InPVS"))
+		if (event.iWeaponID == WEAPON_REMOTEMINE && !event.pEvent->GetBool("InPVS"))
 			IncrementCount();
 	}
 };
@@ -179,18 +179,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the rocket launcher and the victim registered a direct hit, we did it!
-		if (event->GetInt("weaponid") == WEAPON_ROCKET_LAUNCHER && event->GetBool("headshot"))
+		if (event.iWeaponID == WEAPON_ROCKET_LAUNCHER && event.bHeadshot)
 			IncrementCount();
 	}
 };
@@ -212,18 +212,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the grenade launcher, the victim isn't within our PVS, and the game registered a headshot, we did it!
-		if (event->GetInt("weaponid") == WEAPON_GRENADE_LAUNCHER && event->GetBool("headshot"))
+		if (event.iWeaponID == WEAPON_GRENADE_LAUNCHER && event.bHeadshot)
 			IncrementCount();
 	}
 };
@@ -245,18 +245,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the throwing knives, and the victim is over 60 feet(720 inches) away, we did it!
-		if (event->GetInt("weaponid") == WEAPON_KNIFE_THROWING && event->GetInt("dist") > 720)
+		if (event.iWeaponID == WEAPON_KNIFE_THROWING && event.iDist > 720)
 			IncrementCount();
 	}
 };
@@ -278,18 +278,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the grenade launcher, got a direct hit, and the victim is over 100 feet(1200 inches) away, we did it!
-		if (event->GetInt("weaponid") == WEAPON_GRENADE_LAUNCHER && event->GetBool("headshot") && event->GetInt("dist") > 1200)
+		if (event.iWeaponID == WEAPON_GRENADE_LAUNCHER && event.bHeadshot && event.iDist > 1200)
 			IncrementCount();
 	}
 };
@@ -311,18 +311,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the grenade launcher, the victim isn't within our PVS, and the game registered a headshot, we did it!
-		if (event->GetInt("weaponid") == WEAPON_GRENADE_LAUNCHER && event->GetBool("headshot") && !event->GetBool("InPVS"))
+		if (event.iWeaponID == WEAPON_GRENADE_LAUNCHER && event.bHeadshot && !event.pEvent->GetBool("InPVS"))
 			IncrementCount();
 	}
 };
@@ -344,18 +344,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the shotgun, and the victim is less than 8 feet(96 inches) away, we did it!
-		if (event->GetInt("weaponid") == WEAPON_SHOTGUN && event->GetInt("dist") < 60)
+		if (event.iWeaponID == WEAPON_SHOTGUN && event.iDist < 60)
 			IncrementCount();
 	}
 };
@@ -377,18 +377,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing or we killed ourselves, we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID() || event->GetInt("attacker") == event->GetInt("userid"))
+		if (!event.bLocalAttacker || event.iAttackerID == event.iUserID)
 			return;
 
 		// If we killed them with an envionmental explosion, we did it!
-		if (event->GetInt("weaponid") == WEAPON_EXPLOSION)
+		if (event.iWeaponID == WEAPON_EXPLOSION)
 			IncrementCount();
 	}
 };
@@ -438,18 +438,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing, we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we killed them with the klobb, and the klobb has one of the dev skins, we did it!
-		if (event->GetInt("weaponid") == WEAPON_KLOBB && event->GetInt("weaponskin") > 0)
+		if (event.iWeaponID == WEAPON_KLOBB && event.pEvent->GetInt("weaponskin") > 0)
 			IncrementCount();
 	}
 };
@@ -470,18 +470,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the proximity mines, and the victim is less than 100 feet(1200 inches) away, we did it!
-		if (event->GetInt("weaponid") == WEAPON_PROXIMITYMINE && event->GetInt("dist") > 1200)
+		if (event.iWeaponID == WEAPON_PROXIMITYMINE && event.iDist > 1200)
 			IncrementCount();
 	}
 };
@@ -508,18 +508,18 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If we're using the grenade launcher, and the game registered a headshot, we can consider this a kill.
-		if (event->GetInt("weaponid") == WEAPON_GRENADE_LAUNCHER && event->GetBool("headshot"))
+		if (event.iWeaponID == WEAPON_GRENADE_LAUNCHER && event.bHeadshot)
 		{
 			if (gpGlobals->curtime - m_flLastKillTime < 0.1 && CalcPlayerCount() >= 4)
 				IncrementCount();
@@ -548,18 +548,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If the victim died to a trap, we did it.
-		if ( event->GetInt("weaponid") == WEAPON_TRAP )
+		if ( event.iWeaponID == WEAPON_TRAP )
 			IncrementCount();
 	}
 };
@@ -581,16 +581,16 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "ar_levelsteal"))
+		if (!Q_stricmp(event.szName, "ar_levelsteal"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
 			// If we're the one that triggered the event, we did it!
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && IsScenario("arsenal"))
+			if (event.iValue1 == event.iLocalUserID && IsScenario("arsenal"))
 				IncrementCount();
 		}
 	}
@@ -622,33 +622,33 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if (!Q_stricmp(event->GetName(), "player_death"))
+		if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
 			// If this isn't us doing the killing we don't care
-			if (event->GetInt("attacker") != pPlayer->GetUserID())
+			if (!event.bLocalAttacker)
 				return;
 
 			// If the victim died to a trap, we did it.
-			if (event->GetInt("weaponid") != WEAPON_SLAPPERS)
+			if (event.iWeaponID != WEAPON_SLAPPERS)
 				m_bOnlySlappers = false;
 		}
 
-		else if (!Q_stricmp(event->GetName(), "gameplay_event"))
+		else if (event.iType == GE_ACHEVENT_GAMEPLAY_EVENT)
 		{
-			if (!Q_stricmp(event->GetString("name"), "ar_completedarsenal"))
+			if (!Q_stricmp(event.szName, "ar_completedarsenal"))
 			{
 				// If we completed the arsenal (no force round end victories), there are more than 3 players, and we only used slappers, we did it!
-				if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && m_bOnlySlappers && CalcPlayerCount() > 3 && IsScenario("arsenal"))
+				if (event.iValue1 == event.iLocalUserID && m_bOnlySlappers && CalcPlayerCount() > 3 && IsScenario("arsenal"))
 					IncrementCount();
 			}
 		}
-		else if (!Q_stricmp(event->GetName(), "round_start"))
+		else if (event.iType == GE_ACHEVENT_ROUND_START)
 			m_bOnlySlappers = true; //Reset our status on round start.
 	}
 private:
@@ -672,18 +672,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
 		// If the kill was with a grenade, and it has the droppedondeath bitflag set, we did it!
-		if (event->GetInt("weaponid") == WEAPON_GRENADE && event->GetInt("custom") & 2)
+		if (event.iWeaponID == WEAPON_GRENADE && event.iCustom & 2)
 			IncrementCount();
 	}
 };
@@ -705,18 +705,18 @@ protected:
 		ListenForGameEvent("player_death");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// If this isn't us doing the killing or we killed ourselves we don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID() || event->GetInt("attacker") == event->GetInt("userid"))
+		if (!event.bLocalAttacker || event.iAttackerID == event.iUserID)
 			return;
 
 		// If the kill was with a grenade, and it has the inair bitflag set, we did it!
-		if (event->GetInt("weaponid") == WEAPON_GRENADE && event->GetInt("custom") & 1)
+		if (event.iWeaponID == WEAPON_GRENADE && event.iCustom & 1)
 			IncrementCount();
 	}
 };
@@ -738,16 +738,16 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "yolt_eliminated"))
+		if (!Q_stricmp(event.szName, "yolt_eliminated"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
 			// If we're the one that triggered the event, and the weapon is slappers, we did it!
-			if (Q_atoi(event->GetString("value2")) == pPlayer->GetUserID() && !Q_stricmp(event->GetString("value3"), "weapon_slappers") 
+			if (event.iValue2 == event.iLocalUserID && !Q_stricmp(event.szValue[2], "weapon_slappers") 
 				&& IsScenario("yolt") && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
@@ -780,33 +780,33 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if (!Q_stricmp(event->GetName(), "player_death"))
+		if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
 			// If this isn't us doing the killing we don't care
-			if (event->GetInt("attacker") != pPlayer->GetUserID())
+			if (!event.bLocalAttacker)
 				return;
 
 			// But if it is...
 			m_iKillCount++;
 		}
 
-		else if (!Q_stricmp(event->GetName(), "gameplay_event"))
+		else if (event.iType == GE_ACHEVENT_GAMEPLAY_EVENT)
 		{
-			if (!Q_stricmp(event->GetString("name"), "yolt_lastmanstanding"))
+			if (!Q_stricmp(event.szName, "yolt_lastmanstanding"))
 			{
 				// If we were the last man standing, we had less than 2 kills, and there were more than 3 players in the round, we did it!
-				if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && m_iKillCount < 2 && Q_atoi(event->GetString("value2")) > 3 && IsScenario("yolt"))
+				if (event.iValue1 == event.iLocalUserID && m_iKillCount < 2 && event.iValue2 > 3 && IsScenario("yolt"))
 					IncrementCount();
 			}
 		}
 
-		else if (!Q_stricmp(event->GetName(), "round_start"))
+		else if (event.iType == GE_ACHEVENT_ROUND_START)
 			m_iKillCount = 0; //Reset our killcount.
 	}
 private:
@@ -830,16 +830,16 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "gt_weaponswap"))
+		if (!Q_stricmp(event.szName, "gt_weaponswap"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
 			// If we're the one that triggered the event, and the grenade was traded for the golden gun, we did it!
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && !Q_stricmp(event->GetString("value3"), "weapon_grenade") && (!Q_strnicmp(event->GetString("value4"), "weapon_gold", 11)) && IsScenario("guntrade"))
+			if (event.iValue1 == event.iLocalUserID && !Q_stricmp(event.szValue[2], "weapon_grenade") && (!Q_strnicmp(event.szValue[3], "weapon_gold", 11)) && IsScenario("guntrade"))
 				IncrementCount();
 		}
 	}
@@ -869,42 +869,42 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "gt_weaponswap"))
+		if (!Q_stricmp(event.szName, "gt_weaponswap"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
 			// If it's not us we don't care
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID())
+			if (event.iValue1 == event.iLocalUserID)
 			{
 				if (!m_bState) // We're on PP7
 				{
-					if (!Q_strnicmp(event->GetString("value3"), "weapon_pp7", 10) && (!Q_stricmp(event->GetString("value4"), "weapon_silver_pp7")))
+					if (!Q_strnicmp(event.szValue[2], "weapon_pp7", 10) && (!Q_stricmp(event.szValue[3], "weapon_silver_pp7")))
 						m_bState = true;
 
 				}
 				else if (m_bState) // We're on Silver PP7
 				{
-					if (!Q_stricmp(event->GetString("value3"), "weapon_silver_pp7") && (!Q_stricmp(event->GetString("value4"), "weapon_golden_pp7")) && IsScenario("guntrade"))
+					if (!Q_stricmp(event.szValue[2], "weapon_silver_pp7") && (!Q_stricmp(event.szValue[3], "weapon_golden_pp7")) && IsScenario("guntrade"))
 						IncrementCount(); // We got to gold PP7!
 					else
 						m_bState = false; // Killed with wrong weapon or started with wrong weapon somehow.
 				}
 			}
 			// But we're also allowed to trade by dying
-			else if (Q_atoi(event->GetString("value2")) == pPlayer->GetUserID())
+			else if (event.iValue2 == event.iLocalUserID)
 			{
 				if (!m_bState) // We're on PP7
 				{
-					if (!Q_strnicmp(event->GetString("value4"), "weapon_pp7", 10) && (!Q_stricmp(event->GetString("value3"), "weapon_silver_pp7")))
+					if (!Q_strnicmp(event.szValue[3], "weapon_pp7", 10) && (!Q_stricmp(event.szValue[2], "weapon_silver_pp7")))
 						m_bState = true;
 				}
 				else if (m_bState) // We're on Silver PP7
 				{
-					if (!Q_stricmp(event->GetString("value4"), "weapon_silver_pp7") && (!Q_stricmp(event->GetString("value3"), "weapon_golden_pp7")) && IsScenario("guntrade"))
+					if (!Q_stricmp(event.szValue[3], "weapon_silver_pp7") && (!Q_stricmp(event.szValue[2], "weapon_golden_pp7")) && IsScenario("guntrade"))
 						IncrementCount(); // We got to gold PP7!
 					else
 						m_bState = false; // Killed with wrong weapon or started with wrong weapon somehow.
@@ -942,11 +942,11 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "gt_weaponswap"))
+		if (!Q_stricmp(event.szName, "gt_weaponswap"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
@@ -954,15 +954,15 @@ protected:
 			if (!pPlayer->IsAlive())
 				return;
 
-			if (Q_atoi(event->GetString("value2")) == pPlayer->GetUserID())
+			if (event.iValue2 == event.iLocalUserID)
 			{
-				m_iKillerID = atoi(event->GetString("value1"));
-				Q_strncpy(m_sWeapon, event->GetString("value3"), 32);
+				m_iKillerID = event.iValue1;
+				Q_strncpy(m_sWeapon, event.szValue[2], 32);
 			}
-			else if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID())
+			else if (event.iValue1 == event.iLocalUserID)
 			{
 				// If our weapon was the weapon we were killed with, and the victim was our previous killer, we did it!
-				if (m_iKillerID == atoi(event->GetString("value2")) && !Q_stricmp(event->GetString("value3"), m_sWeapon) && IsScenario("guntrade"))
+				if (m_iKillerID == event.iValue2 && !Q_stricmp(event.szValue[2], m_sWeapon) && IsScenario("guntrade"))
 					IncrementCount();
 			}
 		}
@@ -1000,28 +1000,28 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if (!Q_stricmp(event->GetName(), "gameplay_event"))
+		if (event.iType == GE_ACHEVENT_GAMEPLAY_EVENT)
 		{
-			if (!Q_stricmp(event->GetString("name"), "mwgg_ggpickup") && Q_atoi(event->GetString("value1")) == pPlayer->GetUserID())
+			if (!Q_stricmp(event.szName, "mwgg_ggpickup") && event.iValue1 == event.iLocalUserID)
 				m_bHasGG = true;
 		}
-		else if (!Q_stricmp(event->GetName(), "player_death"))
+		else if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
 			// If we died we need to reset our golden gun status and kill count.
-			if (event->GetInt("userid") == pPlayer->GetUserID())
+			if (event.bLocalVictim)
 			{
 				m_iKillCount = 0;
 				m_bHasGG = false;
 			}
-			else if ( m_bHasGG && event->GetInt("attacker") == pPlayer->GetUserID() )
+			else if ( m_bHasGG && event.bLocalAttacker )
 			{
-				if (event->GetInt("weaponid") != WEAPON_GOLDENGUN)
+				if (event.iWeaponID != WEAPON_GOLDENGUN)
 				{
 					m_iKillCount++;
 
@@ -1036,7 +1036,7 @@ protected:
 				}
 			}
 		}
-		else if (!Q_stricmp(event->GetName(), "round_start"))
+		else if (event.iType == GE_ACHEVENT_ROUND_START)
 		{
 			m_iKillCount = 0; //Reset our killcount.
 			m_bHasGG = false;
@@ -1074,30 +1074,30 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if ( !Q_stricmp(event->GetName(), "round_start") )
+		if ( event.iType == GE_ACHEVENT_ROUND_START )
 			m_bOnlyUsedGG = true;
 		else if (!m_bOnlyUsedGG)
 			return;
 		else if (!IsScenario("mwgg"))
 			m_bOnlyUsedGG = false;
-		else if (!Q_stricmp(event->GetName(), "player_death"))
+		else if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
-			if (event->GetInt("attacker") == pPlayer->GetUserID())
+			if (event.bLocalAttacker)
 			{
-				if (event->GetInt("weaponid") != WEAPON_GOLDENGUN)
+				if (event.iWeaponID != WEAPON_GOLDENGUN)
 					m_bOnlyUsedGG = false;
 			}
 		}
-		else if (!Q_stricmp(event->GetName(), "round_end"))
+		else if (event.iType == GE_ACHEVENT_ROUND_END)
 		{
-			if (pPlayer->entindex() == event->GetInt("winnerid") && IsScenario("mwgg") 
-				&& event->GetInt("roundlength") > 120 && CalcPlayerCount() >= 4)
+			if (pPlayer->entindex() == event.iWinnerID && IsScenario("mwgg") 
+				&& event.iRoundLength > 120 && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
 	}
@@ -1123,15 +1123,15 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "mwgg_ggpickup"))
+		if (!Q_stricmp(event.szName, "mwgg_ggpickup"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && IsScenario("mwgg"))
+			if (event.iValue1 == event.iLocalUserID && IsScenario("mwgg"))
 				IncrementCount();
 		}
 	}
@@ -1163,20 +1163,20 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if ( !Q_stricmp(event->GetName(), "round_start") )
+		if ( event.iType == GE_ACHEVENT_ROUND_START )
 		{
 			m_vecLastKillPos = (0, 0, 0);
 			m_iKillCount = 0;
 		}
-		else if (!Q_stricmp(event->GetName(), "player_death"))
+		else if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
-			if (event->GetInt("attacker") == pPlayer->GetUserID())
+			if (event.bLocalAttacker)
 			{
 				if ( !IsScenario("ltk") )
 					return;
@@ -1227,20 +1227,20 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if (!Q_stricmp(event->GetName(), "round_start"))
+		if (event.iType == GE_ACHEVENT_ROUND_START)
 		{
 			m_flKillTime = 0;
 			m_iKillCount = 0;
 		}
-		else if (!Q_stricmp(event->GetName(), "player_death"))
+		else if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
-			if (event->GetInt("attacker") == pPlayer->GetUserID())
+			if (event.bLocalAttacker)
 			{
 				if (!IsScenario("ltk"))
 					return;
@@ -1292,27 +1292,27 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if (!Q_stricmp(event->GetName(), "player_death"))
+		if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
 			// If this isn't us doing the killing we don't care
-			if (event->GetInt("attacker") != pPlayer->GetUserID())
+			if (!event.bLocalAttacker)
 				return;
 
 			// But if it is...
 			m_bKilledSomeone = true;
 		}
-		else if (!Q_stricmp(event->GetName(), "round_start"))
+		else if (event.iType == GE_ACHEVENT_ROUND_START)
 			m_bKilledSomeone = false; //Reset our kill flag.
-		else if (!Q_stricmp(event->GetName(), "round_end"))
+		else if (event.iType == GE_ACHEVENT_ROUND_END)
 		{
-			if (!m_bKilledSomeone && pPlayer->entindex() == event->GetInt("winnerid") && IsScenario("viewtoakill")
-				&& event->GetInt("roundlength") > 120 && CalcPlayerCount() >= 4)
+			if (!m_bKilledSomeone && pPlayer->entindex() == event.iWinnerID && IsScenario("viewtoakill")
+				&& event.iRoundLength > 120 && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
 	}
@@ -1337,15 +1337,15 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "vtak_certainvictory"))
+		if (!Q_stricmp(event.szName, "vtak_certainvictory"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && IsScenario("viewtoakill") && CalcPlayerCount() >= 4)
+			if (event.iValue1 == event.iLocalUserID && IsScenario("viewtoakill") && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
 	}
@@ -1375,18 +1375,18 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "vtak_stealtime"))
+		if (!Q_stricmp(event.szName, "vtak_stealtime"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
-			if ( Q_atoi(event->GetString("value1")) != pPlayer->GetUserID() )
+			if ( event.iValue1 != event.iLocalUserID )
 				return;
 
-			m_iStolenSeconds += max( Q_atoi(event->GetString("value3")), 0 );
+			m_iStolenSeconds += max( Q_atoi(event.szValue[2]), 0 );
 
 			while ( m_iStolenSeconds >= 60 && IsScenario("viewtoakill") )
 			{
@@ -1417,15 +1417,15 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "ld_flagpoint"))
+		if (!Q_stricmp(event.szName, "ld_flagpoint"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && !Q_stricmp(event->GetString("value3"), "flaghit") && IsScenario("livingdaylights"))
+			if (event.iValue1 == event.iLocalUserID && !Q_stricmp(event.szValue[2], "flaghit") && IsScenario("livingdaylights"))
 				IncrementCount();
 		}
 	}
@@ -1447,16 +1447,16 @@ protected:
 		ListenForGameEvent("round_end");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
-		if ( !Q_stricmp(event->GetName(), "round_end") )
+		if ( event.iType == GE_ACHEVENT_ROUND_END )
 		{
-			if (pPlayer->entindex() == event->GetInt("winnerid") && event->GetInt("winnerscore") <= 10 && IsScenario("livingdaylights")
-				&& event->GetInt("roundlength") > 120 && CalcPlayerCount() >= 4)
+			if (pPlayer->entindex() == event.iWinnerID && event.pEvent->GetInt("winnerscore") <= 10 && IsScenario("livingdaylights")
+				&& event.iRoundLength > 120 && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
 	}
@@ -1479,15 +1479,15 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if ( !Q_stricmp(event->GetString("name"), "ctf_tokencapture") )
+		if ( !Q_stricmp(event.szName, "ctf_tokencapture") )
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && IsScenario("capturetheflag") && CalcPlayerCount() >= 4)
+			if (event.iValue1 == event.iLocalUserID && IsScenario("capturetheflag") && CalcPlayerCount() >= 4)
 				IncrementCount();
 		}
 	}
@@ -1509,16 +1509,16 @@ protected:
 		ListenForGameEvent("gameplay_event");
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		if (!Q_stricmp(event->GetString("name"), "ctf_tokendefended"))
+		if (!Q_stricmp(event.szName, "ctf_tokendefended"))
 		{
-			CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+			CGEPlayer *pPlayer = event.pLocalPlayer;
 			if (!pPlayer)
 				return;
 
 			// If we defended our flag using a flag, we killed their token holder while we were a token holder!
-			if (Q_atoi(event->GetString("value1")) == pPlayer->GetUserID() && !Q_strnicmp(event->GetString("value4"), "token_", 6) && IsScenario("capturetheflag"))
+			if (event.iValue1 == event.iLocalUserID && !Q_strnicmp(event.szValue[3], "token_", 6) && IsScenario("capturetheflag"))
 				IncrementCount();
 		}
 	}
@@ -1549,24 +1549,24 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// Not us, don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
-		if ( event->GetInt("weaponid") == WEAPON_COUGAR_MAGNUM && event->GetInt("hitgroup") == HITGROUP_HEAD )
+		if ( event.iWeaponID == WEAPON_COUGAR_MAGNUM && event.pEvent->GetInt("hitgroup") == HITGROUP_HEAD )
 		{
-			if (event->GetInt("userid") == m_iVictimID && gpGlobals->curtime <= m_flLastHitTime + 1.0f)
+			if (event.iUserID == m_iVictimID && gpGlobals->curtime <= m_flLastHitTime + 1.0f)
 				IncrementCount();
 			else
 			{
 				m_flLastHitTime = gpGlobals->curtime;
-				m_iVictimID = event->GetInt("userid");
+				m_iVictimID = event.iUserID;
 			}
 		}
 	}
@@ -1600,28 +1600,28 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// We died or respawned, reset our progress
-		if (event->GetInt("userid") == pPlayer->GetUserID())
+		if (event.bLocalVictim)
 		{
 			m_iWeaponFlags = 0;
 			return;
 		}
 
 		// If it was the player spawn event there's no need to go further.
-		if (Q_stricmp(event->GetName(), "player_spawn") == 0)
+		if (event.iType == GE_ACHEVENT_PLAYER_SPAWN)
 			return;
 
 		// Not us doing the killing, don't care
-		if (event->GetInt("attacker") != pPlayer->GetUserID())
+		if (!event.bLocalAttacker)
 			return;
 
-		int weapid = event->GetInt("weaponid");
+		int weapid = event.iWeaponID;
 
 		if (weapid == WEAPON_TOKEN)
 			weapid = WEAPON_SPAWNMAX; // Assign tokens to an unused bit.
@@ -1670,26 +1670,26 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// We got hurt or died, reset the count.
-		if ( event->GetInt("userid") == pPlayer->GetUserID() )
+		if ( event.bLocalVictim )
 		{
 			m_iKillcount = 0;
 			return;
 		}
 
 		// Not us attacking
-		if ( event->GetInt("attacker") != pPlayer->GetUserID() )
+		if ( !event.bLocalAttacker )
 			return;
 
-		if (!Q_stricmp(event->GetName(), "player_death"))
+		if (event.iType == GE_ACHEVENT_PLAYER_DEATH)
 		{
-			if ( event->GetInt("weaponid") == WEAPON_PP7_SILENCED )
+			if ( event.iWeaponID == WEAPON_PP7_SILENCED )
 			{
 				m_iKillcount++;
 
@@ -1726,14 +1726,14 @@ protected:
 		VarInit();
 	}
 
-	virtual void FireGameEvent_Internal(IGameEvent *event)
+	virtual void FireGEEvent(const GEAchEvent_t &event)
 	{
-		CGEPlayer *pPlayer = ToGEPlayer(CBasePlayer::GetLocalPlayer());
+		CGEPlayer *pPlayer = event.pLocalPlayer;
 		if (!pPlayer)
 			return;
 
 		// Not us attacking
-		if ( event->GetInt("attacker") != pPlayer->GetUserID() )
+		if ( !event.bLocalAttacker )
 			return;
 
 		m_iKillInterp++;
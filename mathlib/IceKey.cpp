@@ -300,6 +300,121 @@ IceKey::decrypt (
 }
 
 
+/*
+ * Load and store the big-endian 32-bit halves of a block.
+ */
+
+static inline unsigned long
+ice_load32 (
+	const unsigned char	*p
+) {
+	return ((((unsigned long) p[0]) << 24) | (((unsigned long) p[1]) << 16)
+				| (((unsigned long) p[2]) << 8) | p[3]);
+}
+
+static inline void
+ice_store32 (
+	unsigned char	*p,
+	unsigned long	x
+) {
+	p[0] = (x >> 24) & 0xff;
+	p[1] = (x >> 16) & 0xff;
+	p[2] = (x >> 8) & 0xff;
+	p[3] = x & 0xff;
+}
+
+
+/*
+ * Run count blocks through the rounds, walking the key schedule from
+ * first by step. Two blocks go through each round together so the
+ * S-box lookups of one can overlap with the other.
+ */
+
+void
+IceKey::cryptBlocks (
+	const unsigned char	*in,
+	unsigned char		*out,
+	int			count,
+	int			first,
+	int			step
+) const
+{
+	register int		i;
+
+	for (; count >= 2; count -= 2, in += 16, out += 16) {
+	    register unsigned long	l0, r0, l1, r1;
+	    const IceSubkey		*sk = &_keysched[first];
+
+	    l0 = ice_load32 (in);
+	    r0 = ice_load32 (in + 4);
+	    l1 = ice_load32 (in + 8);
+	    r1 = ice_load32 (in + 12);
+
+	    for (i = 0; i < _rounds; i += 2) {
+		l0 ^= ice_f (r0, sk);
+		l1 ^= ice_f (r1, sk);
+		sk += step;
+		r0 ^= ice_f (l0, sk);
+		r1 ^= ice_f (l1, sk);
+		sk += step;
+	    }
+
+	    ice_store32 (out, r0);
+	    ice_store32 (out + 4, l0);
+	    ice_store32 (out + 8, r1);
+	    ice_store32 (out + 12, l1);
+	}
+
+	if (count) {
+	    register unsigned long	l, r;
+	    const IceSubkey		*sk = &_keysched[first];
+
+	    l = ice_load32 (in);
+	    r = ice_load32 (in + 4);
+
+	    for (i = 0; i < _rounds; i += 2) {
+		l ^= ice_f (r, sk);
+		sk += step;
+		r ^= ice_f (l, sk);
+		sk += step;
+	    }
+
+	    ice_store32 (out, r);
+	    ice_store32 (out + 4, l);
+	}
+}
+
+
+/*
+ * Encrypt count blocks of 8 bytes of data with the given ICE key.
+ */
+
+void
+IceKey::encryptBlocks (
+	const unsigned char	*ptext,
+	unsigned char		*ctext,
+	int			count
+) const
+{
+	cryptBlocks (ptext, ctext, count, 0, 1);
+}
+
+
+/*
+ * Decrypt count blocks of 8 bytes of data with the given ICE key.
+ */
+
+void
+IceKey::decryptBlocks (
+	const unsigned char	*ctext,
+	unsigned char		*ptext,
+	int			count
+) const
+{
+	cryptBlocks (ctext, ptext, count, _rounds - 1, -1);
+}
+
+
 /*
  * Set 8 rounds [n, n+7] of the key schedule of an ICE key.
  */
@@ -9,6 +9,7 @@ int main()
 	ng.parseFile("simple_box.vmf");
 	ng.saveFile("simple_box_map.obj");
 	ng.genNavFile("simple_box_nav.obj");
+	ng.printTimings();
 
 	getchar();
 }
\ No newline at end of file
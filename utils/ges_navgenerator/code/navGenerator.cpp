@@ -16,20 +16,22 @@
 
 #include "navGenerator.h"
 #include "util_fs.h"
+#include "threadPool.h"
+#include "vertexWelder.h"
 
 #include <exception>
 #include <string>
-#include <map>
+#include <ctype.h>
 
 #include "Recast\Include\Recast.h"
+#include "Recast\Include\RecastTimer.h"
 
 using namespace UTIL::FS;
 
-typedef struct
-{
-	std::string name;
-	std::vector<std::string> tokens;
-} TokenData;
+// Half size of the quad every brush face is cut down from, bigger than any map
+#define WINDING_SIZE	65536.0
+// Points this close to a clipping plane count as on it
+#define CLIP_EPSILON	0.01
 
 const char* SpawnNames [] =
 {
@@ -53,80 +55,155 @@ bool IsSpawnEntity(const char* name)
 	return false;
 }
 
-void Tokenize(const std::string& str, std::vector<std::string>& tokens, const std::string& delimiters = " ")
+// Pulls tokens straight out of the VMF text one at a time so we never
+// hold more than the current key/value in memory on top of the file
+class CVMFReader
 {
-    // Skip delimiters at beginning.
-    std::string::size_type lastPos = str.find_first_not_of(delimiters, 0);
-    // Find first "non-delimiter".
-    std::string::size_type pos     = str.find_first_of(delimiters, lastPos);
-
-    while (std::string::npos != pos || std::string::npos != lastPos)
-    {
-		std::string sub = str.substr(lastPos, pos - lastPos);
-
-		// Found a token, add it to the vector.
-		if (sub.length() != 0)
-			tokens.push_back(sub);
-
-        // Skip delimiters.  Note the "not_of"
-        lastPos = str.find_first_not_of(delimiters, pos);
-        // Find next "non-delimiter"
-        pos = str.find_first_of(delimiters, lastPos);
-    }
-}
+public:
+	enum
+	{
+		TK_END = 0,
+		TK_WORD,	// block name, ie: world, solid, side
+		TK_STRING,	// quoted key or value
+		TK_OPEN,
+		TK_CLOSE,
+	};
+
+	CVMFReader(const char* buff)
+	{
+		m_pPos = buff;
+	}
 
-void Group(std::vector<std::string>& tokens, std::vector<TokenData*>& groups, std::vector<std::string>& delimiters)
-{
-	TokenData *curData = NULL;
-	
-	for (size_t t=0; t<tokens.size(); t++)
+	int next(std::string &token)
 	{
-		bool tokenHeader = false;
+		while (*m_pPos && isspace((unsigned char)*m_pPos))
+			m_pPos++;
+
+		if (!*m_pPos)
+			return TK_END;
 
-		for (size_t d=0; d<delimiters.size(); d++)
+		if (*m_pPos == '{')
 		{
-			if (tokens[t] == delimiters[d])
-			{
-				if (curData)
-					groups.push_back(curData);
+			m_pPos++;
+			return TK_OPEN;
+		}
 
-				curData = new TokenData;
-				curData->name = tokens[t];
+		if (*m_pPos == '}')
+		{
+			m_pPos++;
+			return TK_CLOSE;
+		}
 
+		const char* start;
 
-				tokenHeader = true;
-				break;
-			}
+		if (*m_pPos == '"')
+		{
+			start = ++m_pPos;
+			while (*m_pPos && *m_pPos != '"')
+				m_pPos++;
+
+			token.assign(start, m_pPos - start);
+
+			if (*m_pPos)
+				m_pPos++;
+
+			return TK_STRING;
 		}
 
-		if (tokenHeader)
-			continue;
+		start = m_pPos;
+		while (*m_pPos && !isspace((unsigned char)*m_pPos) && *m_pPos != '{' && *m_pPos != '}' && *m_pPos != '"')
+			m_pPos++;
+
+		token.assign(start, m_pPos - start);
+		return TK_WORD;
+	}
 
-		if (!curData)
+	// Skips the rest of the block we are in, including any children
+	void skipBlock()
+	{
+		std::string token;
+		int depth = 1;
+
+		while (depth > 0)
 		{
-			curData = new TokenData;
-			curData->name = "__default__";
+			int tk = next(token);
+
+			if (tk == TK_END)
+				break;
+			else if (tk == TK_OPEN)
+				depth++;
+			else if (tk == TK_CLOSE)
+				depth--;
 		}
+	}
+
+	// Reads the name of a child block and steps inside it, false if the block ended
+	bool nextChild(std::string &name, std::string &key, std::string &value)
+	{
+		while (true)
+		{
+			int tk = next(name);
+
+			if (tk == TK_END || tk == TK_CLOSE)
+				return false;
+
+			if (tk == TK_STRING)
+			{
+				// Key value pair, let the caller look at it
+				key = name;
+				if (next(value) != TK_STRING)
+					value.clear();
+
+				name.clear();
+				return true;
+			}
+
+			if (tk == TK_WORD)
+			{
+				std::string open;
+				if (next(open) != TK_OPEN)
+					return false;
 
-		if (tokens[t] != " ")
-			curData->tokens.push_back(tokens[t]);
+				key.clear();
+				value.clear();
+				return true;
+			}
+		}
 	}
 
-	if (curData)
-		groups.push_back(curData);
-}
+private:
+	const char* m_pPos;
+};
 
 NavGenerator::NavGenerator()
 {
 }
 
+void NavGenerator::addTiming(const char* stage, int usec)
+{
+	m_vTimings.push_back(std::pair<std::string, int>(stage, usec));
+}
+
+void NavGenerator::printTimings()
+{
+	int total = 0;
+
+	printf("\nStage timings:\n");
+
+	for (size_t x=0; x<m_vTimings.size(); x++)
+	{
+		printf("  %-36s %10.2f ms\n", m_vTimings[x].first.c_str(), m_vTimings[x].second / 1000.0);
+		total += m_vTimings[x].second;
+	}
+
+	printf("  %-36s %10.2f ms\n", "Total", total / 1000.0);
+}
+
 void NavGenerator::parseFile(const char* name)
 {
-	std::vector<std::string> tokens;
-	std::vector<TokenData*> groups;
-	
 	char* buff = NULL;
-	uint32 size = 0;
+
+	rcTimeVal start = rcGetPerformanceTimer();
 
 	try
 	{
@@ -138,307 +215,282 @@ void NavGenerator::parseFile(const char* name)
 		exit(-1);
 	}
 
-	Tokenize(std::string(buff), tokens, "{}\"\n\r\t");
+	rcTimeVal readTime = rcGetPerformanceTimer();
+	addTiming("Read VMF", rcGetDeltaTimeUsec(start, readTime));
 
-	delete [] buff;
+	CVMFReader reader(buff);
+	std::string token;
 
-	size_t x=0;
+	int tk;
+	while ((tk = reader.next(token)) != CVMFReader::TK_END)
+	{
+		if (tk != CVMFReader::TK_WORD)
+			continue;
 
-	std::vector<std::string> delimiters;
+		std::string open;
+		if (reader.next(open) != CVMFReader::TK_OPEN)
+			continue;
 
-	delimiters.push_back("versioninfo");
-	delimiters.push_back("viewsettings");
-	delimiters.push_back("world");
-	delimiters.push_back("entity");
-	delimiters.push_back("cameras");
-	delimiters.push_back("cordon");
+		if (token == "world")
+			parseWorld(reader);
+		else if (token == "entity")
+			parseEntity(reader);
+		else
+			reader.skipBlock();
+	}
 
-	Group(tokens, groups, delimiters);
+	delete [] buff;
 
-	for (size_t x=0; x<groups.size(); x++)
-	{
-		if (groups[x]->name == "versioninfo")
-		{
-			parseVersionInfo(groups[x]->tokens);
-		}
-		else if (groups[x]->name == "viewsettings")
-		{
-			parseViewSettings(groups[x]->tokens);
-		}
-		else if (groups[x]->name == "world")
-		{
-			parseWorld(groups[x]->tokens);
-		}
-		else if (groups[x]->name == "entity")
-		{
-			parseEntity(groups[x]->tokens);
-		}
-		else if (groups[x]->name == "cameras")
-		{
-			parseCameras(groups[x]->tokens);
-		}
-		else if (groups[x]->name == "cordon")
-		{
-			parseCordon(groups[x]->tokens);
-		}
-	}
+	rcTimeVal parseTime = rcGetPerformanceTimer();
+	addTiming("Parse VMF", rcGetDeltaTimeUsec(readTime, parseTime));
+
+	processSolids();
+
+	addTiming("Process brushes", rcGetDeltaTimeUsec(parseTime, rcGetPerformanceTimer()));
 
 	Vector res =  m_vTR - m_vBL;
 	printf( "World size: %.2f by %.2f by %.2f\n", res.getX(), res.getY(), res.getZ());
 }
 
-
-void NavGenerator::parseVersionInfo(std::vector<std::string> &tokens)
+void NavGenerator::parseWorld(CVMFReader &reader)
 {
+	std::string name, key, value;
 
-}
-
-void NavGenerator::parseViewSettings(std::vector<std::string> &tokens)
-{
+	while (reader.nextChild(name, key, value))
+	{
+		if (name.empty())
+			continue;
 
+		if (name == "solid")
+			parseSolid(reader);
+		else
+			reader.skipBlock();
+	}
 }
 
-void NavGenerator::parseWorld(std::vector<std::string> &tokens)
+void NavGenerator::parseSolid(CVMFReader &reader)
 {
-	std::vector<TokenData*> groups;
-	std::vector<std::string> delimiters;
-	delimiters.push_back("solid");
-
-	Group(tokens, groups, delimiters);
+	std::vector< CPlane > sideList;
+	std::string name, key, value;
 
-	for (size_t x=0; x<groups.size(); x++)
+	while (reader.nextChild(name, key, value))
 	{
-		if (groups[x]->name == "solid")
-		{
-			//printf("Found Solid!\n");
-
-			std::vector<TokenData*> solidGroups;
-			std::vector<std::string> solidDelimiters;
-			solidDelimiters.push_back("side");
-
-			Group(groups[x]->tokens, solidGroups, solidDelimiters);
+		if (name.empty())
+			continue;
 
-			std::vector< CPlane > sideList;
+		if (name != "side")
+		{
+			reader.skipBlock();
+			continue;
+		}
 
-			for (size_t x=0; x<solidGroups.size(); x++)
+		std::string sideName;
+		while (reader.nextChild(sideName, key, value))
+		{
+			if (!sideName.empty())
 			{
-				if (solidGroups[x]->name == "side")
-				{
-					std::string plane;
-
-					for (size_t y=0; x<solidGroups[x]->tokens.size(); y++)
-					{
-						if (solidGroups[x]->tokens[y] == "plane")
-						{
-							plane = solidGroups[x]->tokens[y+1];
-							break;
-						}
-					}
-
-					std::vector<std::string> planePos;
-					Tokenize(plane, planePos, "() ");
-
-					if (planePos.size() == 9)
-					{
-						Vector a[3];
-
-						for (size_t y=0; y<3; y++)
-						{
-							int z = y*3;
-							double i = atof(planePos[z+0].c_str());
-							double j = atof(planePos[z+1].c_str());
-							double k = atof(planePos[z+2].c_str());
-
-							a[y] = Vector(i,j,k);
-
-						}
-
-						sideList.push_back(CPlane(a[0], a[1], a[2]));
-					}
-				}
+				reader.skipBlock();
+				continue;
 			}
 
-			processSolid(sideList);
+			if (key != "plane")
+				continue;
+
+			double p[9];
+			if (sscanf(value.c_str(), "(%lf %lf %lf) (%lf %lf %lf) (%lf %lf %lf)", &p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6], &p[7], &p[8]) == 9)
+				sideList.push_back(CPlane(Vector(p[0], p[1], p[2]), Vector(p[3], p[4], p[5]), Vector(p[6], p[7], p[8])));
 		}
 	}
 
+	m_vSolids.push_back(sideList);
 }
 
-void NavGenerator::parseEntity(std::vector<std::string> &tokens)
+void NavGenerator::parseEntity(CVMFReader &reader)
 {
 	std::string classname;
 	std::string pos;
+	std::string name, key, value;
 
-	for (size_t x=0; x<tokens.size(); x++)
+	while (reader.nextChild(name, key, value))
 	{
-		if (tokens[x] == "classname")
-			classname = tokens[x+1];
-		else if (tokens[x] == "origin")
-			pos = tokens[x+1];
+		if (!name.empty())
+		{
+			reader.skipBlock();
+			continue;
+		}
+
+		if (key == "classname")
+			classname = value;
+		else if (key == "origin")
+			pos = value;
 	}
 
 	if ( IsSpawnEntity(classname.c_str()) )
 	{
-		std::vector<std::string> posList;
-		Tokenize(pos, posList, " ");
+		double x, y, z;
 
-		if (posList.size() == 3)
+		if (sscanf(pos.c_str(), "%lf %lf %lf", &x, &y, &z) == 3)
 		{
 			printf("Found spawn spot!\n");
-
-			double x = atof(posList[0].c_str());
-			double y = atof(posList[1].c_str());
-			double z = atof(posList[2].c_str());
-
 			m_vSpawnPoints.push_back(Vector(x,y,z));
 		}
 	}
 }
 
-void NavGenerator::parseCameras(std::vector<std::string> &tokens)
+// Big quad lying on the plane that the other sides of the brush get to chop down
+static void BaseWindingForPlane(const Vector& normal, double dist, std::vector<Vector>& points)
 {
-
+	double ax = fabs(normal.getX());
+	double ay = fabs(normal.getY());
+	double az = fabs(normal.getZ());
+
+	// Build the quad off whichever axis the normal is furthest from
+	Vector up = (az >= ax && az >= ay) ? Vector(1, 0, 0) : Vector(0, 0, 1);
+	up = up - normal * up.dot(normal);
+	up.normalize();
+
+	Vector right = up.cross(normal);
+	Vector org = normal * dist;
+
+	up = up * WINDING_SIZE;
+	right = right * WINDING_SIZE;
+
+	points.clear();
+	points.push_back(org - right + up);
+	points.push_back(org + right + up);
+	points.push_back(org + right - up);
+	points.push_back(org - right - up);
 }
 
-void NavGenerator::parseCordon(std::vector<std::string> &tokens)
+// Keeps the part of the winding on the front side of the plane
+static void ClipWinding(std::vector<Vector>& points, const Vector& normal, double dist)
 {
+	size_t count = points.size();
+	std::vector<Vector> out;
+	out.reserve(count + 1);
 
-}
-
-
-void NavGenerator::processSolid(std::vector< CPlane >& sideList)
-{
-	for (size_t x=0; x<sideList.size(); x++)
+	for (size_t x=0; x<count; x++)
 	{
-		CPolygon poly;
+		const Vector& p1 = points[x];
+		const Vector& p2 = points[(x+1) % count];
 
-		Vector norm = sideList[x].getNormal();
-		std::vector< CPlane > planeList;
+		double d1 = normal.dot(p1) - dist;
+		double d2 = normal.dot(p2) - dist;
 
-		//remove prallel sides from current side
-		for (size_t y=0; y<sideList.size(); y++)
-		{
-			if (x==y)
-				continue;
-
-			Vector norm2 = sideList[y].getNormal();
-			double ang = norm.angle(norm2);
-
-			if (ang > 0.001 && ang < 179.999)
-				planeList.push_back(sideList[y]);
-		}
+		if (d1 >= -CLIP_EPSILON)
+			out.push_back(p1);
 
+		// Edge crosses the plane, split it
+		if ((d1 > CLIP_EPSILON && d2 < -CLIP_EPSILON) || (d1 < -CLIP_EPSILON && d2 > CLIP_EPSILON))
+			out.push_back(p1 + (p2 - p1) * (d1 / (d1 - d2)));
+	}
 
-		std::vector<CSegment> setList;
-		
-		//find intersection lines of every side to current side
-		for (size_t y=0; y<planeList.size(); y++)
-		{
-			CSegment seg;
-			if (sideList[x].findIntersection(planeList[y], seg))
-			{
-				setList.push_back(seg);
-			}
-		}
+	points.swap(out);
+}
 
-		//find instersection points of every line
-		for (size_t y=0; y<setList.size(); y++)
-		{
-			for (size_t z=0; z<setList.size(); z++)
-			{
-				if (y==z)
-					continue;
-
-				Vector point;
-				if (setList[y].findIntersection(setList[z], point))
-				{
-					poly.addPoint(point);
-				}
-			}
-		}
+typedef struct
+{
+	const std::vector< std::vector< CPlane > >* solids;
+	std::vector< std::vector< CPolygon > >* results;
+} SolidJob;
 
-		//remove dup points
-		poly.removeDupPoints();
-		poly.orderPoints();
+void NavGenerator::processSolids()
+{
+	std::vector< std::vector< CPolygon > > results(m_vSolids.size());
 
+	SolidJob job;
+	job.solids = &m_vSolids;
+	job.results = &results;
 
-		Vector n1 = poly.getNormal();
-		if (n1 != norm)
-			poly.invertNormal();
+	printf("Processing %d brushes on %d threads...\n", (int)m_vSolids.size(), (int)GetWorkerCount());
+	RunParallel(m_vSolids.size(), &NavGenerator::processSolidJob, &job);
 
-		if (poly.isValid())
+	// Merge in brush order so the output doesn't depend on thread timing
+	for (size_t x=0; x<results.size(); x++)
+	{
+		for (size_t y=0; y<results[x].size(); y++)
+		{
+			const CPolygon& poly = results[x][y];
 			m_vFaceList.push_back(poly);
 
+			for (size_t z=0; z<poly.getCount(); z++)
+			{
+				Vector a = poly.getPoint(z);
 
-		for (size_t x=0; x<poly.getCount(); x++)
-		{
-			Vector a = poly.getPoint(x);
-
-			if (a.getX() < m_vBL.getX() )
-				m_vBL.setX(a.getX());
+				if (a.getX() < m_vBL.getX() )
+					m_vBL.setX(a.getX());
 
-			if (a.getX() > m_vTR.getX() )
-				m_vTR.setX(a.getX());
+				if (a.getX() > m_vTR.getX() )
+					m_vTR.setX(a.getX());
 
 
-			if (a.getY() < m_vBL.getY() )
-				m_vBL.setY(a.getY());
+				if (a.getY() < m_vBL.getY() )
+					m_vBL.setY(a.getY());
 
-			if (a.getY() > m_vTR.getY() )
-				m_vTR.setY(a.getY());
+				if (a.getY() > m_vTR.getY() )
+					m_vTR.setY(a.getY());
 
-			if (a.getZ() < m_vBL.getZ() )
-				m_vBL.setZ(a.getZ());
+				if (a.getZ() < m_vBL.getZ() )
+					m_vBL.setZ(a.getZ());
 
-			if (a.getZ() > m_vTR.getZ() )
-				m_vTR.setZ(a.getZ());
+				if (a.getZ() > m_vTR.getZ() )
+					m_vTR.setZ(a.getZ());
+			}
 		}
 	}
-}
-
 
+	m_vSolids.clear();
+}
 
+void NavGenerator::processSolidJob(size_t item, void* data)
+{
+	SolidJob* job = (SolidJob*)data;
+	processSolid((*job->solids)[item], (*job->results)[item]);
+}
 
-int findPoint(std::vector<Vector> &pointList, const Vector &point)
+void NavGenerator::processSolid(const std::vector< CPlane >& sideList, std::vector< CPolygon >& faceList)
 {
-	for (size_t x=0; x<pointList.size(); x++)
+	std::vector<Vector> points;
+
+	for (size_t x=0; x<sideList.size(); x++)
 	{
-		if (pointList[x] == point)
-			return x+1;
-	}
+		// Side normals point into the brush
+		Vector norm = sideList[x].getNormal();
+		BaseWindingForPlane(norm, norm.dot(sideList[x].getX()), points);
 
-	return -1;
-}
+		// Every other side cuts away what is outside the brush, leaving the face already in order
+		for (size_t y=0; y<sideList.size() && points.size() >= 3; y++)
+		{
+			if (x==y)
+				continue;
 
-int index = 1;
+			Vector norm2 = sideList[y].getNormal();
+			ClipWinding(points, norm2, norm2.dot(sideList[y].getX()));
+		}
 
-int findPoint(std::map< double, std::map< double, std::map<double, int> > > &pointList, const Vector &point)
-{
-	double a = point.getX();
-	double b = point.getY();
-	double c = point.getZ();
+		if (points.size() < 3)
+			continue;
 
-	int pos = pointList[a][b][c];
+		CPolygon poly(points);
+		poly.removeDupPoints();
 
-	if (pos == 0)
-	{
-		pointList[a][b][c] = index;
-		index++;
-		return -1;
-	}
-	
-	return pos;
-}
+		if (poly.getCount() < 3)
+			continue;
 
+		if (poly.getNormal().dot(norm) < 0)
+			poly.invertNormal();
 
+		if (poly.isValid())
+			faceList.push_back(poly);
+	}
+}
 
 void NavGenerator::saveFile(const char* name)
 {
-	index = 1;
-
 	FILE* fh = fopen(name, "w");
 
-	std::map< double, std::map< double, std::map<double, int> > > pointList;
+	CVertexWelder welder;
+	std::vector<int> faceIndex;
 
 	for (size_t x=0; x<m_vFaceList.size(); x++)
 	{
@@ -447,15 +499,21 @@ void NavGenerator::saveFile(const char* name)
 
 		for (size_t y=0; y<m_vFaceList[x].getCount(); y++)
 		{
-			Vector v = m_vFaceList[x].getPoint(y);
+			size_t count = welder.getCount();
+			int pos = welder.addPoint(m_vFaceList[x].getPoint(y));
 
-			if ( findPoint(pointList, v) == -1)
+			if (welder.getCount() != count)
 			{
+				const Vector& v = welder.getPoint(pos);
 				fprintf(fh, "v %f %f %f\n", v.getX(), v.getZ(), v.getY());
 			}
+
+			faceIndex.push_back(pos);
 		}
 	}
 
+	size_t cur = 0;
+
 	for (size_t x=0; x<m_vFaceList.size(); x++)
 	{
 		if (m_vFaceList[x].getCount() < 3)
@@ -464,10 +522,7 @@ void NavGenerator::saveFile(const char* name)
 		fprintf(fh, "f");
 
 		for (size_t y=0; y<m_vFaceList[x].getCount(); y++)
-		{
-			Vector v = Vector(m_vFaceList[x].getPoint(y));
-			fprintf(fh, " %d", findPoint(pointList, v));
-		}
+			fprintf(fh, " %d", faceIndex[cur++]+1);
 
 		fprintf(fh, "\n");
 	}
@@ -504,55 +559,39 @@ void saveMesh(float* verts, int nverts, int* tris, int ntris, const char* file)
 
 bool NavGenerator::genNavFile(const char* name)
 {
-	index = 1;
-
 	float* m_verts;
 	int* m_tris;
 
 
 	printf("1: Initialize build config...\n");
 
-	std::map< double, std::map< double, std::map<double, int> > > pointList;
-	std::vector<Vector> vectList;
+	rcTimeVal stageStart = rcGetPerformanceTimer();
+	rcTimeVal stageEnd;
 
-	size_t count = 0;
+	// Weld every face point down to one index per unique vertex
+	CVertexWelder welder;
+	std::vector< std::vector<int> > faceIndex(m_vFaceList.size());
 
 	for (size_t x=0; x<m_vFaceList.size(); x++)
 	{
 		if (m_vFaceList[x].getCount() < 3)
 			continue;
 
-		for (size_t y=0; y<m_vFaceList[x].getCount(); y++)
-		{
-			Vector v = m_vFaceList[x].getPoint(y);
-			if (findPoint(pointList, v) == -1)
-				count++;
-		}
-	}
-
-	vectList.resize(count);
-
-	for (size_t x=0; x<m_vFaceList.size(); x++)
-	{
-		if (m_vFaceList[x].getCount() < 3)
-			continue;
+		faceIndex[x].resize(m_vFaceList[x].getCount());
 
 		for (size_t y=0; y<m_vFaceList[x].getCount(); y++)
-		{
-			Vector v = m_vFaceList[x].getPoint(y);
-
-			int index = findPoint(pointList, v)-1;
-			vectList[index] = v;
-		}
+			faceIndex[x][y] = welder.addPoint(m_vFaceList[x].getPoint(y));
 	}
 
-	m_verts = new float[3*vectList.size()];
+	m_verts = new float[3*welder.getCount()];
 
-	for (size_t x=0; x<vectList.size(); x++)
+	for (size_t x=0; x<welder.getCount(); x++)
 	{
-		m_verts[x*3 + 0] = (float)vectList[x].getX();
-		m_verts[x*3 + 1] = (float)vectList[x].getZ();
-		m_verts[x*3 + 2] = (float)vectList[x].getY();
+		const Vector& v = welder.getPoint(x);
+
+		m_verts[x*3 + 0] = (float)v.getX();
+		m_verts[x*3 + 1] = (float)v.getZ();
+		m_verts[x*3 + 2] = (float)v.getY();
 	}
 
 	
@@ -565,9 +604,9 @@ bool NavGenerator::genNavFile(const char* name)
 			continue;
 
 		threeVert tv;
-		tv.a = findPoint(pointList, m_vFaceList[x].getPoint(0))-1;
-		tv.b = findPoint(pointList, m_vFaceList[x].getPoint(1))-1;
-		tv.c = findPoint(pointList, m_vFaceList[x].getPoint(2))-1;
+		tv.a = faceIndex[x][0];
+		tv.b = faceIndex[x][1];
+		tv.c = faceIndex[x][2];
 
 		if (tv.b == tv.c || tv.a == tv.b || tv.a == tv.c)
 			continue;
@@ -577,7 +616,7 @@ bool NavGenerator::genNavFile(const char* name)
 		for (size_t y=3; y<m_vFaceList[x].getCount(); y++)
 		{
 			tv.b = tv.c;
-			tv.c = findPoint(pointList, m_vFaceList[x].getPoint(y))-1;
+			tv.c = faceIndex[x][y];
 
 			if (tv.c != tv.b)
 				triList.push_back(tv);
@@ -593,9 +632,13 @@ bool NavGenerator::genNavFile(const char* name)
 		m_tris[x*3 + 2] = triList[x].c;
 	}
 
-	int m_nverts = vectList.size();
+	int m_nverts = welder.getCount();
 	int m_ntris = triList.size();
 
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Weld vertices", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 
 	saveMesh(m_verts, m_nverts, m_tris, m_ntris, "test_mesh.obj");
 
@@ -680,6 +723,10 @@ bool NavGenerator::genNavFile(const char* name)
 	//	rcGetLog()->log(RC_LOG_PROGRESS, " - %.1fK verts, %.1fK tris", m_nverts/1000.0f, m_ntris/1000.0f);
 	//}
 	
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Initialize build config", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 2. Rasterize input polygon soup.
 	//
@@ -712,6 +759,10 @@ bool NavGenerator::genNavFile(const char* name)
 	delete [] m_triflags;
 	m_triflags = 0;
 	
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Rasterize triangles", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 3. Filter walkables surfaces.
 	//
@@ -722,6 +773,10 @@ bool NavGenerator::genNavFile(const char* name)
 	rcFilterLedgeSpans(m_cfg.walkableHeight, m_cfg.walkableClimb, m_solid);
 	rcFilterWalkableLowHeightSpans(m_cfg.walkableHeight, m_solid);
 
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Filter walkable surfaces", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 4. Partition walkable surface to simple regions.
 	//
@@ -750,6 +805,10 @@ bool NavGenerator::genNavFile(const char* name)
 		printf("buildNavigation: Could not build regions.");
 	}
 	
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Build regions", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 5. Trace and simplify region contours.
 	//
@@ -762,6 +821,10 @@ bool NavGenerator::genNavFile(const char* name)
 		return false;
 	}
 	
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Build contours", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 6. Build polygons mesh from contours.
 	//
@@ -774,6 +837,10 @@ bool NavGenerator::genNavFile(const char* name)
 		return false;
 	}
 	
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Build polygon mesh", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 	//
 	// Step 7. Create detail mesh which allows to access approximate height on each polygon.
 	//
@@ -785,6 +852,10 @@ bool NavGenerator::genNavFile(const char* name)
 		printf("buildNavigation: Could not build detail mesh.");
 	}
 
+	stageEnd = rcGetPerformanceTimer();
+	addTiming("Build detail mesh", rcGetDeltaTimeUsec(stageStart, stageEnd));
+	stageStart = stageEnd;
+
 
 	printf("Saving file...\n");
 
@@ -843,7 +914,7 @@ bool NavGenerator::genNavFile(const char* name)
 
 	fclose(fh);
 
-
+	addTiming("Save nav file", rcGetDeltaTimeUsec(stageStart, rcGetPerformanceTimer()));
 
 	printf("Total Meshes: %d\n", m_dmesh.nmeshes);
 	printf("Total Tris: %d\n", m_dmesh.ntris);
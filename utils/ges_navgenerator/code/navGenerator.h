@@ -20,9 +20,12 @@
 #include "plane.h"
 #include "segment.h"
 #include <vector>
+#include <string>
 
 typedef std::vector<CPolygon*> PolyPVector;
 
+class CVMFReader;
+
 class NavGenerator
 {
 public:
@@ -33,16 +36,22 @@ public:
 
 	bool genNavFile(const char* name);
 
+	// Prints how long each stage took
+	void printTimings();
+
 protected:
-	void parseVersionInfo(std::vector<std::string> &tokens);
-	void parseViewSettings(std::vector<std::string> &tokens);
-	void parseWorld(std::vector<std::string> &tokens);
-	void parseEntity(std::vector<std::string> &tokens);
-	void parseCameras(std::vector<std::string> &tokens);
-	void parseCordon(std::vector<std::string> &tokens);
+	void parseWorld(CVMFReader &reader);
+	void parseSolid(CVMFReader &reader);
+	void parseEntity(CVMFReader &reader);
+
+	// Turns every parsed brush into faces, spread across all cores
+	void processSolids();
 
-	void processSolid(std::vector< CPlane >& sideList);
+	// Only touches its arguments so it is safe to call from any thread
+	static void processSolid(const std::vector< CPlane >& sideList, std::vector< CPolygon >& faceList);
+	static void processSolidJob(size_t item, void* data);
 
+	void addTiming(const char* stage, int usec);
 
 private:
 	Vector m_vBL;
@@ -50,6 +59,11 @@ private:
 
 	std::vector<Vector> m_vSpawnPoints;
 	std::vector<CPolygon> m_vFaceList;
+
+	// Brushes waiting for processSolids
+	std::vector< std::vector< CPlane > > m_vSolids;
+
+	std::vector< std::pair<std::string, int> > m_vTimings;
 };
 
 
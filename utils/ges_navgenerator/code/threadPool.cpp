@@ -0,0 +1,104 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : ges_navgenerator
+//   File        : threadPool.cpp
+//   Description :
+//      See Header
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+
+#include "threadPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <vector>
+
+#define MAX_WORKERS 32
+
+typedef struct
+{
+	ParallelFunc func;
+	void* data;
+	size_t count;
+	volatile long next;
+} ParallelJob;
+
+static void RunJob(ParallelJob* job)
+{
+	while (true)
+	{
+#ifdef _WIN32
+		size_t item = (size_t)InterlockedIncrement(&job->next) - 1;
+#else
+		size_t item = (size_t)job->next++;
+#endif
+		if (item >= job->count)
+			break;
+
+		job->func(item, job->data);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerThread(LPVOID param)
+{
+	RunJob((ParallelJob*)param);
+	return 0;
+}
+#endif
+
+size_t GetWorkerCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+
+	size_t count = info.dwNumberOfProcessors;
+	if (count < 1)
+		count = 1;
+	if (count > MAX_WORKERS)
+		count = MAX_WORKERS;
+
+	return count;
+#else
+	return 1;
+#endif
+}
+
+void RunParallel(size_t count, ParallelFunc func, void* data)
+{
+	ParallelJob job;
+	job.func = func;
+	job.data = data;
+	job.count = count;
+	job.next = 0;
+
+	size_t workers = GetWorkerCount();
+	if (workers > count)
+		workers = count;
+
+#ifdef _WIN32
+	// This thread does its share too, so we only need workers-1 extra
+	std::vector<HANDLE> threads;
+
+	for (size_t x=1; x<workers; x++)
+	{
+		HANDLE h = CreateThread(NULL, 0, &WorkerThread, &job, 0, NULL);
+		if (h)
+			threads.push_back(h);
+	}
+
+	RunJob(&job);
+
+	if (!threads.empty())
+		WaitForMultipleObjects((DWORD)threads.size(), &threads[0], TRUE, INFINITE);
+
+	for (size_t x=0; x<threads.size(); x++)
+		CloseHandle(threads[x]);
+#else
+	RunJob(&job);
+#endif
+}
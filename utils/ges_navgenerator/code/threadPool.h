@@ -0,0 +1,29 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : ges_navgenerator
+//   File        : threadPool.h
+//   Description :
+//      Runs a function over a range of work items on every core
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef GE_THREADPOOL_H
+#define GE_THREADPOOL_H
+#ifdef _WIN32
+#pragma once
+#endif
+
+#include <stddef.h>
+
+typedef void (*ParallelFunc)(size_t item, void* data);
+
+// Number of worker threads RunParallel will use
+size_t GetWorkerCount();
+
+// Calls func once for every item in [0, count) spread over the worker threads
+// and returns when all of them are done. Items are handed out one at a time
+// so uneven work (big brushes next to small ones) still balances.
+void RunParallel(size_t count, ParallelFunc func, void* data);
+
+#endif //GE_THREADPOOL_H
@@ -0,0 +1,90 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : ges_navgenerator
+//   File        : vertexWelder.cpp
+//   Description :
+//      See Header
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+
+#include "vertexWelder.h"
+
+static long long Quantize(double v)
+{
+	return (long long)floor(v * WELD_QUANTIZE + 0.5);
+}
+
+static size_t HashKey(long long x, long long y, long long z)
+{
+	unsigned long long h = (unsigned long long)x * 73856093ULL;
+	h ^= (unsigned long long)y * 19349663ULL;
+	h ^= (unsigned long long)z * 83492791ULL;
+	return (size_t)(h ^ (h >> 29));
+}
+
+CVertexWelder::CVertexWelder()
+{
+	WeldEntry empty = { 0, 0, 0, -1 };
+	m_vTable.resize(1024, empty);
+}
+
+size_t CVertexWelder::findSlot(long long x, long long y, long long z) const
+{
+	// Open addressing, table size is always a power of two
+	size_t mask = m_vTable.size() - 1;
+	size_t slot = HashKey(x, y, z) & mask;
+
+	while (m_vTable[slot].index != -1)
+	{
+		const WeldEntry& e = m_vTable[slot];
+		if (e.x == x && e.y == y && e.z == z)
+			break;
+
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+void CVertexWelder::grow()
+{
+	std::vector<WeldEntry> old;
+	old.swap(m_vTable);
+
+	WeldEntry empty = { 0, 0, 0, -1 };
+	m_vTable.resize(old.size() * 2, empty);
+
+	for (size_t x=0; x<old.size(); x++)
+	{
+		if (old[x].index != -1)
+			m_vTable[findSlot(old[x].x, old[x].y, old[x].z)] = old[x];
+	}
+}
+
+int CVertexWelder::addPoint(const Vector& point)
+{
+	long long x = Quantize(point.getX());
+	long long y = Quantize(point.getY());
+	long long z = Quantize(point.getZ());
+
+	size_t slot = findSlot(x, y, z);
+	if (m_vTable[slot].index != -1)
+		return m_vTable[slot].index;
+
+	// Keep the load under half so probes stay short
+	if ((m_vPoints.size() + 1) * 2 > m_vTable.size())
+	{
+		grow();
+		slot = findSlot(x, y, z);
+	}
+
+	WeldEntry& e = m_vTable[slot];
+	e.x = x;
+	e.y = y;
+	e.z = z;
+	e.index = (int)m_vPoints.size();
+
+	m_vPoints.push_back(point);
+	return e.index;
+}
@@ -0,0 +1,58 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : ges_navgenerator
+//   File        : vertexWelder.h
+//   Description :
+//      Merges vertices that land on the same quantized grid point and
+//      hands out a stable index for each unique one
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef GE_VERTEXWELDER_H
+#define GE_VERTEXWELDER_H
+#ifdef _WIN32
+#pragma once
+#endif
+
+#include "vector.h"
+#include <vector>
+
+// Vertices closer than 1/WELD_QUANTIZE units on every axis are welded together
+#define WELD_QUANTIZE 128.0
+
+class CVertexWelder
+{
+public:
+	CVertexWelder();
+
+	// Returns the 0 based index of the point, adding it if it is new
+	int addPoint(const Vector& point);
+
+	size_t getCount() const
+	{
+		return m_vPoints.size();
+	}
+
+	const Vector& getPoint(size_t index) const
+	{
+		return m_vPoints[index];
+	}
+
+private:
+	typedef struct
+	{
+		long long x;
+		long long y;
+		long long z;
+		int index;
+	} WeldEntry;
+
+	void grow();
+	size_t findSlot(long long x, long long y, long long z) const;
+
+	std::vector<WeldEntry> m_vTable;
+	std::vector<Vector> m_vPoints;
+};
+
+#endif //GE_VERTEXWELDER_H
@@ -0,0 +1,210 @@
+///////////// Copyright  2016 GoldenEye: Source, All rights reserved. /////////////
+//
+//   Project     : ges_telemetryreader
+//   File        : main.cpp
+//   Description :
+//      Aggregates the binary match telemetry files written by the server
+//      (ge_telemetry 1) into per weapon and per player totals.
+//
+//   Created On: 10/17/2016
+////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include "ge_telemetry_format.h"
+
+// Records are read in chunks so huge matches don't need to fit in memory
+#define READ_CHUNK 4096
+
+struct WeaponTotals
+{
+	unsigned int fires;
+	unsigned int hits;
+	unsigned int kills;
+	unsigned int headshots;
+	double damage;
+};
+
+struct PlayerTotals
+{
+	unsigned int kills;
+	unsigned int deaths;
+	unsigned int suicides;
+	unsigned int fires;
+	unsigned int hits;
+	double damageDealt;
+	double damageTaken;
+	double armor;
+	double ammo;
+};
+
+struct Totals
+{
+	unsigned int files;
+	unsigned int records;
+	unsigned int rounds;
+	unsigned int byType[GE_TELEMETRY_TYPE_COUNT];
+	std::map<int, WeaponTotals> weapons;
+	std::map<int, PlayerTotals> players;
+};
+
+static void addRecord(Totals& totals, const GETelemetryRecord_t& rec)
+{
+	if (rec.type >= GE_TELEMETRY_TYPE_COUNT)
+		return;
+
+	totals.records++;
+	totals.byType[rec.type]++;
+
+	WeaponTotals& wep = totals.weapons[rec.weapon];
+
+	switch (rec.type)
+	{
+	case GE_TELEMETRY_ROUNDSTART:
+		totals.rounds++;
+		break;
+
+	case GE_TELEMETRY_KILL:
+		if (rec.flags & GE_TELEMETRY_FL_SUICIDE)
+		{
+			totals.players[rec.target].suicides++;
+			totals.players[rec.target].deaths++;
+			break;
+		}
+
+		wep.kills++;
+		if (rec.flags & GE_TELEMETRY_FL_HEADSHOT)
+			wep.headshots++;
+
+		totals.players[rec.actor].kills++;
+		totals.players[rec.target].deaths++;
+		break;
+
+	case GE_TELEMETRY_DAMAGE:
+		totals.players[rec.target].damageTaken += rec.amount;
+
+		// Hurting yourself isn't a hit
+		if ((rec.flags & GE_TELEMETRY_FL_SUICIDE) || rec.actor == rec.target)
+			break;
+
+		wep.hits++;
+		wep.damage += rec.amount;
+
+		totals.players[rec.actor].hits++;
+		totals.players[rec.actor].damageDealt += rec.amount;
+		break;
+
+	case GE_TELEMETRY_FIRE:
+		wep.fires++;
+		totals.players[rec.actor].fires++;
+		break;
+
+	case GE_TELEMETRY_ARMOR:
+		totals.players[rec.actor].armor += rec.amount;
+		break;
+
+	case GE_TELEMETRY_AMMO:
+		totals.players[rec.actor].ammo += rec.amount;
+		break;
+	}
+}
+
+static bool readFile(Totals& totals, const char* path)
+{
+	FILE* fh = fopen(path, "rb");
+	if (!fh)
+	{
+		fprintf(stderr, "%s: unable to open\n", path);
+		return false;
+	}
+
+	GETelemetryHeader_t header;
+	if (fread(&header, sizeof(header), 1, fh) != 1 || header.magic != GE_TELEMETRY_MAGIC)
+	{
+		fprintf(stderr, "%s: not a telemetry file\n", path);
+		fclose(fh);
+		return false;
+	}
+
+	if (header.version != GE_TELEMETRY_VERSION || header.recordSize != sizeof(GETelemetryRecord_t))
+	{
+		fprintf(stderr, "%s: unsupported version %u\n", path, header.version);
+		fclose(fh);
+		return false;
+	}
+
+	// Newer writers may grow the header, skip whatever we don't know about
+	fseek(fh, header.headerSize, SEEK_SET);
+
+	header.map[sizeof(header.map)-1] = '\0';
+	header.gameplay[sizeof(header.gameplay)-1] = '\0';
+	printf("%s: %s / %s, part %u\n", path, header.map, header.gameplay, header.part);
+
+	std::vector<GETelemetryRecord_t> chunk(READ_CHUNK);
+	size_t count;
+
+	// A trailing partial record means the server was still writing, ignore it
+	while ((count = fread(&chunk[0], sizeof(GETelemetryRecord_t), READ_CHUNK, fh)) > 0)
+	{
+		for (size_t x=0; x<count; x++)
+			addRecord(totals, chunk[x]);
+	}
+
+	fclose(fh);
+	totals.files++;
+	return true;
+}
+
+static void printTotals(const Totals& totals)
+{
+	printf("\n%u files, %u records, %u rounds\n", totals.files, totals.records, totals.rounds);
+
+	printf("\n%-8s %10s %10s %8s %10s %8s %12s %8s\n", "weapon", "fires", "hits", "acc%", "kills", "hs%", "damage", "dmg/hit");
+	for (std::map<int, WeaponTotals>::const_iterator it = totals.weapons.begin(); it != totals.weapons.end(); ++it)
+	{
+		const WeaponTotals& wep = it->second;
+		if (!wep.fires && !wep.hits && !wep.kills)
+			continue;
+
+		printf("%-8d %10u %10u %8.1f %10u %8.1f %12.0f %8.1f\n", it->first, wep.fires, wep.hits,
+			wep.fires ? 100.0 * wep.hits / wep.fires : 0.0, wep.kills,
+			wep.kills ? 100.0 * wep.headshots / wep.kills : 0.0, wep.damage,
+			wep.hits ? wep.damage / wep.hits : 0.0);
+	}
+
+	printf("\n%-8s %8s %8s %8s %10s %10s %12s %12s %10s %10s\n", "userid", "kills", "deaths", "suicides", "fires", "hits", "dealt", "taken", "armor", "ammo");
+	for (std::map<int, PlayerTotals>::const_iterator it = totals.players.begin(); it != totals.players.end(); ++it)
+	{
+		if (it->first == 0)
+			continue;
+
+		const PlayerTotals& plr = it->second;
+		printf("%-8d %8u %8u %8u %10u %10u %12.0f %12.0f %10.0f %10.0f\n", it->first, plr.kills, plr.deaths,
+			plr.suicides, plr.fires, plr.hits, plr.damageDealt, plr.damageTaken, plr.armor, plr.ammo);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("usage: ges_telemetryreader <file" GE_TELEMETRY_EXTENSION "> [more files...]\n");
+		return 1;
+	}
+
+	Totals totals;
+	totals.files = totals.records = totals.rounds = 0;
+	memset(totals.byType, 0, sizeof(totals.byType));
+
+	for (int x=1; x<argc; x++)
+		readFile(totals, argv[x]);
+
+	if (!totals.files)
+		return 1;
+
+	printTotals(totals);
+	return 0;
+}